@@ -59,6 +59,8 @@ DEFINE_string(control_local_view_topic, "/apollo/control/localview",
               "control local view topic name");
 DEFINE_string(control_core_command_topic, "/apollo/control/controlcore",
               "control command core algorithm topic name");
+DEFINE_string(control_latency_topic, "/apollo/control/latency",
+              "control loop latency summary topic name");
 DEFINE_string(pointcloud_topic,
               "/apollo/sensor/lidar128/compensator/PointCloud2",
               "pointcloud topic name");
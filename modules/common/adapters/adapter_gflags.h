@@ -43,6 +43,7 @@ DECLARE_string(chassis_command_topic);
 DECLARE_string(control_preprocessor_topic);
 DECLARE_string(control_local_view_topic);
 DECLARE_string(control_core_command_topic);
+DECLARE_string(control_latency_topic);
 DECLARE_string(pointcloud_topic);
 DECLARE_string(pointcloud_16_topic);
 DECLARE_string(pointcloud_16_raw_topic);
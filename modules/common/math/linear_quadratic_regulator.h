@@ -21,7 +21,11 @@
 
 #pragma once
 
+#include <cmath>
+#include <limits>
+
 #include "Eigen/Core"
+#include "Eigen/LU"
 
 /**
  * @namespace apollo::common::math
@@ -66,6 +70,51 @@ void SolveLQRProblem(const Eigen::MatrixXd &A, const Eigen::MatrixXd &B,
                      const double tolerance, const uint max_num_iteration,
                      Eigen::MatrixXd *ptr_K);
 
+/**
+ * @brief Fixed size version of the solver above for models whose state and
+ *        control dimensions are known at compile time. The iteration works on
+ *        the stack only and Eigen unrolls the small products.
+ * @param A The system dynamic matrix
+ * @param B The control matrix
+ * @param Q The cost matrix for system state
+ * @param R The cost matrix for control output
+ * @param tolerance The numerical tolerance for solving Discrete
+ *        Algebraic Riccati equation (DARE)
+ * @param max_num_iteration The maximum iterations for solving ARE
+ * @param ptr_K The feedback control matrix (pointer)
+ */
+template <int N, int M>
+void SolveLQRProblem(const Eigen::Matrix<double, N, N> &A,
+                     const Eigen::Matrix<double, N, M> &B,
+                     const Eigen::Matrix<double, N, N> &Q,
+                     const Eigen::Matrix<double, M, M> &R,
+                     const double tolerance, const uint max_num_iteration,
+                     Eigen::Matrix<double, M, N> *ptr_K)
+{
+    static_assert(N > 0 && M > 0,
+                  "dynamic sizes are solved by the Eigen::MatrixXd version");
+    const Eigen::Matrix<double, N, N> AT = A.transpose();
+    const Eigen::Matrix<double, M, N> BT = B.transpose();
+
+    // Calculate Matrix Difference Riccati Equation, initialize P and Q
+    Eigen::Matrix<double, N, N> P = Q;
+    uint num_iteration = 0;
+    double diff = std::numeric_limits<double>::max();
+    while (num_iteration++ < max_num_iteration && diff > tolerance)
+    {
+        const Eigen::Matrix<double, M, N> BTP = BT * P;
+        // B'PA, its transpose is A'PB as P stays symmetric
+        const Eigen::Matrix<double, M, N> BTPA = BTP * A;
+        const Eigen::Matrix<double, N, N> P_next =
+                AT * P * A - BTPA.transpose() * (R + BTP * B).inverse() * BTPA +
+                Q;
+        // check the difference between P and P_next
+        diff = std::fabs((P_next - P).maxCoeff());
+        P = P_next;
+    }
+    *ptr_K = (R + BT * P * B).inverse() * (BT * P * A);
+}
+
 }  // namespace math
 }  // namespace common
 }  // namespace apollo
@@ -66,6 +66,15 @@ DEFINE_double(steer_angle_rate, 100.0,
               "Steer angle change rate in percentage.");
 DEFINE_bool(enable_gain_scheduler, false,
             "Enable gain scheduler for higher vehicle speed");
+
+DEFINE_bool(enable_lat_controller_gain_table, true,
+            "Look the lateral LQR gain up in a table solved at init instead "
+            "of solving the Riccati equation every control cycle");
+DEFINE_double(lat_controller_gain_table_max_speed, 30.0,
+              "Maximal speed of the lateral LQR gain table, in m/s. Faster "
+              "speeds are solved online");
+DEFINE_double(lat_controller_gain_table_speed_step, 0.05,
+              "Speed resolution of the lateral LQR gain table, in m/s");
 DEFINE_bool(set_steer_limit, false, "Set steer limit");
 
 DEFINE_bool(enable_slope_offset, false, "Enable slope offset compensation");
@@ -107,6 +116,15 @@ DEFINE_bool(query_time_nearest_point_only, false,
 DEFINE_bool(query_forward_time_point_only, false,
             "only use the trajectory point in future");
 
+DEFINE_bool(enable_trajectory_match_hint, true,
+            "start the nearest trajectory point search from the previous "
+            "match and skip trajectory segments that cannot be closer, "
+            "--noenable_trajectory_match_hint falls back to the linear "
+            "scan");
+
+DEFINE_int32(trajectory_match_window_size, 10,
+             "number of points searched on each side of the previous match");
+
 DEFINE_bool(enable_feedback_augment_on_high_speed, false,
             "Enable augmented control on lateral error on high speed");
 
@@ -117,6 +135,13 @@ DEFINE_bool(
 DEFINE_bool(use_control_submodules, false,
             "use control submodules instead of controller agent");
 
+DEFINE_int32(control_latency_window_size, 1000,
+             "number of latest control cycles in the latency histograms");
+
+DEFINE_int32(control_latency_report_period, 50,
+             "publish the control latency summary every this many cycles, "
+             "0 to disable");
+
 DEFINE_bool(control_viz_enable, false,
             "use control_viz_enable");
 
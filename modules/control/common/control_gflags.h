@@ -50,6 +50,9 @@ DECLARE_bool(use_preview_speed_for_table);
 
 DECLARE_double(steer_angle_rate);
 DECLARE_bool(enable_gain_scheduler);
+DECLARE_bool(enable_lat_controller_gain_table);
+DECLARE_double(lat_controller_gain_table_max_speed);
+DECLARE_double(lat_controller_gain_table_speed_step);
 DECLARE_bool(set_steer_limit);
 DECLARE_bool(enable_slope_offset);
 
@@ -73,11 +76,17 @@ DECLARE_bool(enable_maximum_steer_rate_limit);
 DECLARE_bool(query_time_nearest_point_only);
 DECLARE_bool(query_forward_time_point_only);
 
+DECLARE_bool(enable_trajectory_match_hint);
+DECLARE_int32(trajectory_match_window_size);
+
 DECLARE_bool(enable_feedback_augment_on_high_speed);
 
 DECLARE_bool(enable_gear_drive_negative_speed_protection);
 
 DECLARE_bool(use_control_submodules);
+DECLARE_int32(control_latency_window_size);
+DECLARE_int32(control_latency_report_period);
+
 DECLARE_bool(control_viz_enable);
 
 DECLARE_int32(lateral_control_type);
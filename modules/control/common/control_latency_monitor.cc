@@ -0,0 +1,293 @@
+/******************************************************************************
+ * Copyright 2023 The Apollo Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *****************************************************************************/
+
+#include "modules/control/common/control_latency_monitor.h"
+
+#include <algorithm>
+#include <cmath>
+#include <sstream>
+#include <string>
+
+#include "cyber/common/log.h"
+#include "cyber/time/clock.h"
+#include "modules/control/common/control_gflags.h"
+
+namespace apollo
+{
+namespace control
+{
+namespace
+{
+// values below 2^kSubBucketBits us have a bucket each, larger ones are split
+// into kSubBucketHalf buckets per power of two
+constexpr int kSubBucketBits = 5;
+constexpr int64_t kSubBucketCount = 1 << kSubBucketBits;
+constexpr int64_t kSubBucketHalf = kSubBucketCount / 2;
+// larger values are clamped
+constexpr int64_t kMaxValueUs = 60 * 1000 * 1000;
+
+const double kReportPercentiles[] = {50.0, 90.0, 99.0, 100.0};
+const char *const kReportPercentileNames[] = {"p50", "p90", "p99", "max"};
+
+}  // namespace
+
+LatencyHistogram::LatencyHistogram(const size_t window_size) :
+    counts_(BucketIndex(kMaxValueUs) + 1, 0),
+    samples_(std::max<size_t>(window_size, 1), 0)
+{
+}
+
+size_t LatencyHistogram::BucketIndex(const int64_t value_us)
+{
+    const int64_t value = std::min(std::max<int64_t>(value_us, 0), kMaxValueUs);
+    if (value < kSubBucketCount)
+    {
+        return static_cast<size_t>(value);
+    }
+    const int msb = 63 - __builtin_clzll(static_cast<uint64_t>(value));
+    const int shift = msb - (kSubBucketBits - 1);
+    return static_cast<size_t>(shift * kSubBucketHalf + (value >> shift));
+}
+
+double LatencyHistogram::BucketUpperBoundMs(const size_t index)
+{
+    const int64_t bucket = static_cast<int64_t>(index);
+    if (bucket < kSubBucketCount)
+    {
+        return static_cast<double>(bucket + 1) * 1e-3;
+    }
+    const int64_t shift = bucket / kSubBucketHalf - 1;
+    const int64_t sub_bucket = bucket % kSubBucketHalf + kSubBucketHalf;
+    return static_cast<double>((sub_bucket + 1) << shift) * 1e-3;
+}
+
+void LatencyHistogram::Add(const double value_ms)
+{
+    const auto bucket = static_cast<uint16_t>(
+            BucketIndex(static_cast<int64_t>(std::llround(value_ms * 1e3))));
+    const size_t window_size = samples_.size();
+    if (size_ == window_size)
+    {
+        // drop the oldest sample, its slot takes the new one
+        --counts_[samples_[head_]];
+        samples_[head_] = bucket;
+        head_ = (head_ + 1) % window_size;
+    }
+    else
+    {
+        samples_[(head_ + size_) % window_size] = bucket;
+        ++size_;
+    }
+    ++counts_[bucket];
+}
+
+void LatencyHistogram::Clear()
+{
+    std::fill(counts_.begin(), counts_.end(), 0);
+    head_ = 0;
+    size_ = 0;
+}
+
+double LatencyHistogram::Percentile(const double percentile) const
+{
+    if (size_ == 0)
+    {
+        return 0.0;
+    }
+    const double ratio = std::min(std::max(percentile, 0.0), 100.0) / 100.0;
+    const uint64_t rank = std::max<uint64_t>(
+            static_cast<uint64_t>(std::ceil(ratio * static_cast<double>(size_))),
+            1);
+    uint64_t accumulated = 0;
+    for (size_t i = 0; i < counts_.size(); ++i)
+    {
+        accumulated += counts_[i];
+        if (accumulated >= rank)
+        {
+            return BucketUpperBoundMs(i);
+        }
+    }
+    return BucketUpperBoundMs(counts_.size() - 1);
+}
+
+ControlLatencyMonitor::ControlLatencyMonitor() :
+    histograms_(NUM_ITEMS,
+                LatencyHistogram(static_cast<size_t>(
+                        std::max(FLAGS_control_latency_window_size, 1)))),
+    current_(NUM_ITEMS, -1.0)
+{
+}
+
+const char *ControlLatencyMonitor::ItemName(const Item item)
+{
+    switch (item)
+    {
+        case PROC:
+            return "proc";
+        case PREPROCESSOR:
+            return "preprocessor";
+        case CONTROLLER:
+            return "controller";
+        case POSTPROCESSOR:
+            return "postprocessor";
+        case CYCLE_INTERVAL:
+            return "cycle_interval";
+        case CHASSIS_AGE:
+            return "chassis_age";
+        case LOCALIZATION_AGE:
+            return "localization_age";
+        case TRAJECTORY_AGE:
+            return "trajectory_age";
+        default:
+            return "unknown";
+    }
+}
+
+void ControlLatencyMonitor::BeginCycle()
+{
+    const auto now = cyber::Clock::Now();
+    std::lock_guard<std::mutex> lock(mutex_);
+    std::fill(current_.begin(), current_.end(), -1.0);
+    if (has_cycle_start_)
+    {
+        RecordLocked(CYCLE_INTERVAL, (now - cycle_start_time_).ToSecond() * 1e3);
+    }
+    cycle_start_time_ = now;
+    has_cycle_start_ = true;
+}
+
+void ControlLatencyMonitor::Record(const Item item, const double time_ms)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    RecordLocked(item, time_ms);
+}
+
+void ControlLatencyMonitor::Record(const Item item,
+                                   const cyber::Time &start_time,
+                                   const cyber::Time &end_time)
+{
+    Record(item, (end_time - start_time).ToSecond() * 1e3);
+}
+
+void ControlLatencyMonitor::RecordInputAges(
+        const common::Header &chassis_header,
+        const common::Header &localization_header,
+        const common::Header &trajectory_header)
+{
+    const double now = cyber::Clock::NowInSeconds();
+    std::lock_guard<std::mutex> lock(mutex_);
+    // inputs without a header have no meaningful age
+    if (chassis_header.has_timestamp_sec())
+    {
+        RecordLocked(CHASSIS_AGE,
+                     (now - chassis_header.timestamp_sec()) * 1e3);
+    }
+    if (localization_header.has_timestamp_sec())
+    {
+        RecordLocked(LOCALIZATION_AGE,
+                     (now - localization_header.timestamp_sec()) * 1e3);
+    }
+    if (trajectory_header.has_timestamp_sec())
+    {
+        RecordLocked(TRAJECTORY_AGE,
+                     (now - trajectory_header.timestamp_sec()) * 1e3);
+    }
+}
+
+bool ControlLatencyMonitor::EndCycle(const double budget_ms,
+                                     planning::LatencyStats *summary)
+{
+    const auto now = cyber::Clock::Now();
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (has_cycle_start_)
+    {
+        RecordLocked(PROC, (now - cycle_start_time_).ToSecond() * 1e3);
+    }
+    ++num_cycles_;
+
+    if (budget_ms > 0.0 && current_[PROC] > budget_ms)
+    {
+        ++num_overruns_;
+        // all items of the cycle in one line, to correlate the overrun with
+        // the stage that took long or the input that was late
+        std::ostringstream oss;
+        for (int i = 0; i < NUM_ITEMS; ++i)
+        {
+            if (current_[i] >= 0.0)
+            {
+                oss << " " << ItemName(static_cast<Item>(i)) << ": "
+                    << current_[i];
+            }
+        }
+        AWARN_EVERY(10) << "Control cycle overran the " << budget_ms
+                        << " ms budget (" << num_overruns_ << " of "
+                        << num_cycles_ << " cycles)," << oss.str();
+    }
+
+    if (summary == nullptr || FLAGS_control_latency_report_period <= 0 ||
+        num_cycles_ % FLAGS_control_latency_report_period != 0)
+    {
+        return false;
+    }
+    FillSummaryLocked(summary);
+    return true;
+}
+
+void ControlLatencyMonitor::Reset()
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (auto &histogram : histograms_)
+    {
+        histogram.Clear();
+    }
+    std::fill(current_.begin(), current_.end(), -1.0);
+    has_cycle_start_ = false;
+    num_cycles_ = 0;
+    num_overruns_ = 0;
+}
+
+void ControlLatencyMonitor::RecordLocked(const Item item,
+                                         const double time_ms)
+{
+    current_[item] = std::max(time_ms, 0.0);
+    histograms_[item].Add(current_[item]);
+}
+
+void ControlLatencyMonitor::FillSummaryLocked(
+        planning::LatencyStats *summary) const
+{
+    summary->Clear();
+    summary->set_total_time_ms(std::max(current_[PROC], 0.0));
+    for (int i = 0; i < NUM_ITEMS; ++i)
+    {
+        const auto &histogram = histograms_[i];
+        if (histogram.count() == 0)
+        {
+            continue;
+        }
+        const std::string item_name = ItemName(static_cast<Item>(i));
+        for (size_t k = 0; k < sizeof(kReportPercentiles) / sizeof(double);
+             ++k)
+        {
+            auto *task_stats = summary->add_task_stats();
+            task_stats->set_name(item_name + "." + kReportPercentileNames[k]);
+            task_stats->set_time_ms(histogram.Percentile(kReportPercentiles[k]));
+        }
+    }
+}
+
+}  // namespace control
+}  // namespace apollo
@@ -0,0 +1,154 @@
+/******************************************************************************
+ * Copyright 2023 The Apollo Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *****************************************************************************/
+
+/**
+ * @file
+ * @brief Per stage timing and input age statistics of the control loop
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <mutex>
+#include <vector>
+
+#include "modules/common/proto/header.pb.h"
+#include "modules/planning/proto/planning.pb.h"
+
+#include "cyber/common/macros.h"
+#include "cyber/time/time.h"
+
+namespace apollo
+{
+namespace control
+{
+/**
+ * @class LatencyHistogram
+ * @brief Histogram of the latest samples with log-linear buckets of about 3%
+ * relative precision, same layout as an HDR histogram with 5 significant bits.
+ * The samples are kept in a ring buffer so that old ones leave the histogram.
+ */
+class LatencyHistogram
+{
+public:
+    /**
+     * @param window_size Number of latest samples in the histogram
+     */
+    explicit LatencyHistogram(const size_t window_size);
+
+    void Add(const double value_ms);
+
+    void Clear();
+
+    size_t count() const { return size_; }
+
+    /**
+     * @brief Upper bound of the bucket holding the given percentile
+     * @param percentile In [0, 100]
+     */
+    double Percentile(const double percentile) const;
+
+    double Max() const { return Percentile(100.0); }
+
+private:
+    static size_t BucketIndex(const int64_t value_us);
+
+    static double BucketUpperBoundMs(const size_t index);
+
+private:
+    std::vector<uint32_t> counts_;
+    // bucket of each sample in the window, the oldest one is at head_
+    std::vector<uint16_t> samples_;
+    size_t head_ = 0;
+    size_t size_ = 0;
+};
+
+/**
+ * @class ControlLatencyMonitor
+ * @brief Collects the time spent in each stage of a control cycle and how old
+ * the inputs were when they were used. ControlComponent and the control
+ * submodules of one process share the instance.
+ */
+class ControlLatencyMonitor
+{
+public:
+    enum Item
+    {
+        PROC = 0,
+        PREPROCESSOR,
+        CONTROLLER,
+        POSTPROCESSOR,
+        CYCLE_INTERVAL,
+        CHASSIS_AGE,
+        LOCALIZATION_AGE,
+        TRAJECTORY_AGE,
+        NUM_ITEMS
+    };
+
+    static const char *ItemName(const Item item);
+
+    /**
+     * @brief Start a control cycle, the distance to the previous start is
+     * recorded as CYCLE_INTERVAL.
+     */
+    void BeginCycle();
+
+    /**
+     * @brief Record the time of a stage of the current cycle
+     */
+    void Record(const Item item, const double time_ms);
+
+    void Record(const Item item, const cyber::Time &start_time,
+                const cyber::Time &end_time);
+
+    /**
+     * @brief Record the age of the inputs used by the current cycle
+     */
+    void RecordInputAges(const common::Header &chassis_header,
+                         const common::Header &localization_header,
+                         const common::Header &trajectory_header);
+
+    /**
+     * @brief Finish the current cycle, records PROC since BeginCycle and logs
+     * all items of the cycle if it overran the budget.
+     * @param budget_ms Control period
+     * @param summary Filled every FLAGS_control_latency_report_period cycles
+     * @return If the summary is filled
+     */
+    bool EndCycle(const double budget_ms, planning::LatencyStats *summary);
+
+    void Reset();
+
+private:
+    void RecordLocked(const Item item, const double time_ms);
+
+    void FillSummaryLocked(planning::LatencyStats *summary) const;
+
+private:
+    std::mutex mutex_;
+    std::vector<LatencyHistogram> histograms_;
+    // values of the current cycle, negative if not recorded
+    std::vector<double> current_;
+    cyber::Time cycle_start_time_;
+    bool has_cycle_start_ = false;
+    uint64_t num_cycles_ = 0;
+    uint64_t num_overruns_ = 0;
+
+    DECLARE_SINGLETON(ControlLatencyMonitor)
+};
+
+}  // namespace control
+}  // namespace apollo
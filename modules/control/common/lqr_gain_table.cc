@@ -0,0 +1,78 @@
+/******************************************************************************
+ * Copyright 2023 The Apollo Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *****************************************************************************/
+
+#include "modules/control/common/lqr_gain_table.h"
+
+#include <algorithm>
+#include <cmath>
+
+#include "cyber/common/log.h"
+
+namespace apollo
+{
+namespace control
+{
+bool LqrGainTable::Build(const double min_speed, const double max_speed,
+                         const double speed_step, const Solver &solver)
+{
+    Clear();
+    if (speed_step <= 0.0 || max_speed < min_speed)
+    {
+        AERROR << "Invalid LQR gain table speed range [" << min_speed << ", "
+               << max_speed << "] with step " << speed_step;
+        return false;
+    }
+
+    const int num_points =
+            static_cast<int>(std::ceil((max_speed - min_speed) / speed_step)) +
+            1;
+    gains_.resize(num_points);
+    for (int i = 0; i < num_points; ++i)
+    {
+        solver(min_speed + speed_step * i, &gains_[i]);
+    }
+    min_speed_ = min_speed;
+    max_speed_ = min_speed + speed_step * (num_points - 1);
+    speed_step_ = speed_step;
+    return true;
+}
+
+void LqrGainTable::Clear()
+{
+    min_speed_ = 0.0;
+    max_speed_ = 0.0;
+    speed_step_ = 0.0;
+    gains_.clear();
+}
+
+bool LqrGainTable::Lookup(const double speed, Eigen::MatrixXd *gain) const
+{
+    if (gains_.empty() || speed < min_speed_ || speed > max_speed_)
+    {
+        return false;
+    }
+
+    const double index = (speed - min_speed_) / speed_step_;
+    const int lower = std::min(static_cast<int>(index),
+                               static_cast<int>(gains_.size()) - 1);
+    const int upper = std::min(lower + 1, static_cast<int>(gains_.size()) - 1);
+    const double ratio = index - lower;
+    *gain = gains_[lower] + ratio * (gains_[upper] - gains_[lower]);
+    return true;
+}
+
+}  // namespace control
+}  // namespace apollo
@@ -0,0 +1,82 @@
+/******************************************************************************
+ * Copyright 2023 The Apollo Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *****************************************************************************/
+
+/**
+ * @file
+ * @brief LQR feedback gains precomputed on a speed grid
+ */
+
+#pragma once
+
+#include <functional>
+#include <vector>
+
+#include "Eigen/Core"
+
+namespace apollo
+{
+namespace control
+{
+/**
+ * @class LqrGainTable
+ * @brief Feedback gains of an LQR problem which only depends on the speed,
+ * solved once on an evenly spaced speed grid and linearly interpolated in
+ * between.
+ */
+class LqrGainTable
+{
+public:
+    /**
+     * @brief Solves the LQR problem at one speed, returns the feedback gain.
+     */
+    using Solver = std::function<void(double speed, Eigen::MatrixXd *gain)>;
+
+    /**
+     * @brief Solve the gains on all grid speeds
+     * @param min_speed Speed of the first grid point
+     * @param max_speed Speed of the last grid point
+     * @param speed_step Distance of the grid points
+     * @param solver LQR solver at one speed
+     * @return If the table is usable
+     */
+    bool Build(const double min_speed, const double max_speed,
+               const double speed_step, const Solver &solver);
+
+    void Clear();
+
+    bool empty() const { return gains_.empty(); }
+
+    /**
+     * @brief Interpolate the gain at a speed
+     * @param speed Speed to look up
+     * @param gain Interpolated feedback gain
+     * @return False if the speed is out of the table
+     */
+    bool Lookup(const double speed, Eigen::MatrixXd *gain) const;
+
+    double min_speed() const { return min_speed_; }
+
+    double max_speed() const { return max_speed_; }
+
+private:
+    double min_speed_ = 0.0;
+    double max_speed_ = 0.0;
+    double speed_step_ = 0.0;
+    std::vector<Eigen::MatrixXd> gains_;
+};
+
+}  // namespace control
+}  // namespace apollo
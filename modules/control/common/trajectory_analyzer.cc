@@ -18,6 +18,8 @@
 
 #include <algorithm>
 #include <cmath>
+#include <limits>
+#include <mutex>
 #include <utility>
 
 #include "Eigen/Core"
@@ -46,6 +48,93 @@ double PointDistanceSquare(const TrajectoryPoint &point, const double x,
     return dx * dx + dy * dy;
 }
 
+// Lower bound of the squared distance from (x, y) to any point in the box.
+double BoxDistanceSquare(const double min_x, const double max_x,
+                         const double min_y, const double max_y,
+                         const double x, const double y)
+{
+    const double dx = std::max({min_x - x, 0.0, x - max_x});
+    const double dy = std::max({min_y - y, 0.0, y - max_y});
+    return dx * dx + dy * dy;
+}
+
+// Number of consecutive trajectory points covered by one segment box.
+constexpr size_t kSegmentSize = 16;
+
+// Matched index of the last position query per trajectory, so that the
+// analyzers rebuilt by each controller on every tick start their search where
+// the previous query ended. Only used as a hint, the search stays exact.
+struct SharedMatch
+{
+    bool valid = false;
+    unsigned int seq_num = 0;
+    double header_time = 0.0;
+    double com_distance = 0.0;
+    size_t num_points = 0;
+    size_t index = 0;
+};
+
+constexpr size_t kNumSharedMatches = 4;
+
+std::mutex shared_match_mutex;
+SharedMatch shared_matches[kNumSharedMatches];
+size_t next_shared_match = 0;
+
+bool IsSameTrajectory(const SharedMatch &match, const unsigned int seq_num,
+                      const double header_time, const double com_distance,
+                      const size_t num_points)
+{
+    return match.valid && match.seq_num == seq_num &&
+           match.header_time == header_time &&
+           match.com_distance == com_distance &&
+           match.num_points == num_points;
+}
+
+bool LookupSharedMatch(const unsigned int seq_num, const double header_time,
+                       const double com_distance, const size_t num_points,
+                       size_t *index)
+{
+    std::lock_guard<std::mutex> lock(shared_match_mutex);
+    for (const auto &match : shared_matches)
+    {
+        if (IsSameTrajectory(match, seq_num, header_time, com_distance,
+                             num_points))
+        {
+            *index = match.index;
+            return true;
+        }
+    }
+    return false;
+}
+
+void UpdateSharedMatch(const unsigned int seq_num, const double header_time,
+                       const double com_distance, const size_t num_points,
+                       const size_t index)
+{
+    std::lock_guard<std::mutex> lock(shared_match_mutex);
+    SharedMatch *slot = nullptr;
+    for (auto &match : shared_matches)
+    {
+        if (IsSameTrajectory(match, seq_num, header_time, com_distance,
+                             num_points))
+        {
+            slot = &match;
+            break;
+        }
+    }
+    if (slot == nullptr)
+    {
+        slot = &shared_matches[next_shared_match];
+        next_shared_match = (next_shared_match + 1) % kNumSharedMatches;
+    }
+    slot->valid = true;
+    slot->seq_num = seq_num;
+    slot->header_time = header_time;
+    slot->com_distance = com_distance;
+    slot->num_points = num_points;
+    slot->index = index;
+}
+
 PathPoint TrajectoryPointToPathPoint(const TrajectoryPoint &point)
 {
     if (point.has_path_point())
@@ -79,18 +168,7 @@ PathPoint TrajectoryAnalyzer::QueryMatchedPathPoint(const double x,
 {
     CHECK_GT(trajectory_points_.size(), 0U);
 
-    double d_min = PointDistanceSquare(trajectory_points_.front(), x, y);
-    size_t index_min = 0;
-
-    for (size_t i = 1; i < trajectory_points_.size(); ++i)
-    {
-        double d_temp = PointDistanceSquare(trajectory_points_[i], x, y);
-        if (d_temp < d_min)
-        {
-            d_min = d_temp;
-            index_min = i;
-        }
-    }
+    const size_t index_min = QueryNearestIndexByPosition(x, y);
 
     size_t index_start = index_min == 0 ? index_min : index_min - 1;
     size_t index_end = index_min + 1 == trajectory_points_.size()
@@ -208,36 +286,13 @@ TrajectoryPoint TrajectoryAnalyzer::QueryNearestPointByRelativeTime(
 TrajectoryPoint TrajectoryAnalyzer::QueryNearestPointByPosition(
         const double x, const double y) const
 {
-    double d_min = PointDistanceSquare(trajectory_points_.front(), x, y);
-    size_t index_min = 0;
-
-    for (size_t i = 1; i < trajectory_points_.size(); ++i)
-    {
-        double d_temp = PointDistanceSquare(trajectory_points_[i], x, y);
-        if (d_temp < d_min)
-        {
-            d_min = d_temp;
-            index_min = i;
-        }
-    }
-    return trajectory_points_[index_min];
+    return trajectory_points_[QueryNearestIndexByPosition(x, y)];
 }
 
 TrajectoryPoint TrajectoryAnalyzer::QueryNearestFrontPointByPosition(
         const double x, const double y, const double move_dist) const
 {
-    double d_min = PointDistanceSquare(trajectory_points_.front(), x, y);
-    size_t index_min = 0;
-
-    for (size_t i = 1; i < trajectory_points_.size(); ++i)
-    {
-        double d_temp = PointDistanceSquare(trajectory_points_[i], x, y);
-        if (d_temp < d_min)
-        {
-            d_min = d_temp;
-            index_min = i;
-        }
-    }
+    const size_t index_min = QueryNearestIndexByPosition(x, y);
 
     // find front point
     double neasrest_point_s  = trajectory_points_[index_min].path_point().s();
@@ -267,6 +322,146 @@ const std::vector<TrajectoryPoint> &TrajectoryAnalyzer::trajectory_points()
     return trajectory_points_;
 }
 
+size_t TrajectoryAnalyzer::QueryNearestIndexByPosition(const double x,
+                                                       const double y) const
+{
+    CHECK_GT(trajectory_points_.size(), 0U);
+
+    if (!FLAGS_enable_trajectory_match_hint)
+    {
+        double d_min = PointDistanceSquare(trajectory_points_.front(), x, y);
+        size_t index_min = 0;
+        for (size_t i = 1; i < trajectory_points_.size(); ++i)
+        {
+            double d_temp = PointDistanceSquare(trajectory_points_[i], x, y);
+            if (d_temp < d_min)
+            {
+                d_min = d_temp;
+                index_min = i;
+            }
+        }
+        return index_min;
+    }
+
+    // the controllers query the same position several times per tick
+    if (has_last_match_ && last_match_x_ == x && last_match_y_ == y)
+    {
+        return last_match_index_;
+    }
+
+    size_t hint_index = last_match_index_;
+    bool has_hint = has_last_match_;
+    if (!has_hint)
+    {
+        has_hint = LookupSharedMatch(seq_num_, header_time_, com_distance_,
+                                     trajectory_points_.size(), &hint_index);
+    }
+
+    const size_t index_min = SearchNearestIndex(x, y, hint_index, has_hint);
+
+    has_last_match_ = true;
+    last_match_x_ = x;
+    last_match_y_ = y;
+    last_match_index_ = index_min;
+    UpdateSharedMatch(seq_num_, header_time_, com_distance_,
+                      trajectory_points_.size(), index_min);
+    return index_min;
+}
+
+size_t TrajectoryAnalyzer::SearchNearestIndex(const double x, const double y,
+                                              const size_t hint_index,
+                                              const bool has_hint) const
+{
+    BuildSegmentIndex();
+
+    double d_min = std::numeric_limits<double>::infinity();
+    size_t index_min = 0;
+    auto scan = [this, x, y, &d_min, &index_min](const size_t begin,
+                                                 const size_t end) {
+        for (size_t i = begin; i < end; ++i)
+        {
+            const double d_temp =
+                    PointDistanceSquare(trajectory_points_[i], x, y);
+            if (d_temp < d_min || (d_temp == d_min && i < index_min))
+            {
+                d_min = d_temp;
+                index_min = i;
+            }
+        }
+    };
+
+    const size_t num_points = trajectory_points_.size();
+    if (has_hint && hint_index < num_points)
+    {
+        // the vehicle moves a few points per tick, a local window around the
+        // previous match gives a tight bound for pruning the segments below
+        const size_t window =
+                static_cast<size_t>(FLAGS_trajectory_match_window_size);
+        const size_t begin = hint_index > window ? hint_index - window : 0;
+        scan(begin, std::min(hint_index + window + 1, num_points));
+    }
+    else
+    {
+        // relocalize: start with the segment whose box is closest
+        size_t closest_segment = 0;
+        double closest_box_d = std::numeric_limits<double>::infinity();
+        for (size_t k = 0; k < segment_boxes_.size(); ++k)
+        {
+            const auto &box = segment_boxes_[k];
+            const double box_d = BoxDistanceSquare(box.min_x, box.max_x,
+                                                   box.min_y, box.max_y, x, y);
+            if (box_d < closest_box_d)
+            {
+                closest_box_d = box_d;
+                closest_segment = k;
+            }
+        }
+        const size_t begin = closest_segment * kSegmentSize;
+        scan(begin, std::min(begin + kSegmentSize, num_points));
+    }
+
+    // any point closer than the current match must be in a segment whose
+    // box is not farther away, so the result equals a full linear scan
+    for (size_t k = 0; k < segment_boxes_.size(); ++k)
+    {
+        const auto &box = segment_boxes_[k];
+        if (BoxDistanceSquare(box.min_x, box.max_x, box.min_y, box.max_y, x,
+                              y) > d_min)
+        {
+            continue;
+        }
+        const size_t begin = k * kSegmentSize;
+        scan(begin, std::min(begin + kSegmentSize, num_points));
+    }
+    return index_min;
+}
+
+void TrajectoryAnalyzer::BuildSegmentIndex() const
+{
+    if (!segment_boxes_.empty())
+    {
+        return;
+    }
+    const size_t num_points = trajectory_points_.size();
+    segment_boxes_.resize((num_points + kSegmentSize - 1) / kSegmentSize);
+    for (size_t k = 0; k < segment_boxes_.size(); ++k)
+    {
+        auto &box = segment_boxes_[k];
+        const size_t begin = k * kSegmentSize;
+        const size_t end = std::min(begin + kSegmentSize, num_points);
+        box.min_x = box.max_x = trajectory_points_[begin].path_point().x();
+        box.min_y = box.max_y = trajectory_points_[begin].path_point().y();
+        for (size_t i = begin + 1; i < end; ++i)
+        {
+            const auto &path_point = trajectory_points_[i].path_point();
+            box.min_x = std::min(box.min_x, path_point.x());
+            box.max_x = std::max(box.max_x, path_point.x());
+            box.min_y = std::min(box.min_y, path_point.y());
+            box.max_y = std::max(box.max_y, path_point.y());
+        }
+    }
+}
+
 PathPoint TrajectoryAnalyzer::FindMinDistancePoint(const TrajectoryPoint &p0,
                                                    const TrajectoryPoint &p1,
                                                    const double x,
@@ -308,6 +503,9 @@ void TrajectoryAnalyzer::TrajectoryTransformToCOM(
         const double rear_to_com_distance)
 {
     CHECK_GT(trajectory_points_.size(), 0U);
+    com_distance_ += rear_to_com_distance;
+    segment_boxes_.clear();
+    has_last_match_ = false;
     for (size_t i = 0; i < trajectory_points_.size(); ++i)
     {
         auto com = ComputeCOMPosition(rear_to_com_distance,
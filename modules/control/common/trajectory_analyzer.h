@@ -21,6 +21,7 @@
 
 #pragma once
 
+#include <cstddef>
 #include <vector>
 
 #include "modules/planning/proto/planning.pb.h"
@@ -165,6 +166,30 @@ public:
     const std::vector<common::TrajectoryPoint> &trajectory_points() const;
 
 private:
+    /**
+     * @brief Axis aligned bounding box of a block of consecutive trajectory
+     * points, used to skip whole blocks in the nearest point search.
+     */
+    struct SegmentBox
+    {
+        double min_x = 0.0;
+        double max_x = 0.0;
+        double min_y = 0.0;
+        double max_y = 0.0;
+    };
+
+    /**
+     * @brief index of the trajectory point closest to the given position. Ties
+     * resolve to the smallest index, same as a linear scan.
+     */
+    size_t QueryNearestIndexByPosition(const double x, const double y) const;
+
+    size_t SearchNearestIndex(const double x, const double y,
+                              const size_t hint_index,
+                              const bool has_hint) const;
+
+    void BuildSegmentIndex() const;
+
     common::PathPoint FindMinDistancePoint(const common::TrajectoryPoint &p0,
                                            const common::TrajectoryPoint &p1,
                                            const double x,
@@ -174,6 +199,17 @@ private:
 
     double header_time_ = 0.0;
     unsigned int seq_num_ = 0;
+    // accumulated offset applied by TrajectoryTransformToCOM
+    double com_distance_ = 0.0;
+
+    // built lazily on the first position query, reset when points move
+    mutable std::vector<SegmentBox> segment_boxes_;
+
+    // result of the last position query on this trajectory
+    mutable bool has_last_match_ = false;
+    mutable double last_match_x_ = 0.0;
+    mutable double last_match_y_ = 0.0;
+    mutable size_t last_match_index_ = 0;
 };
 
 }  // namespace control
@@ -1,10 +1,14 @@
 
+#include <algorithm>
+#include <cmath>
+
 #include "cyber/time/clock.h"
 #include "modules/common/adapters/adapter_gflags.h"
 // #include "modules/common/latency_recorder/latency_recorder.h"
 #include "modules/common/configs/vehicle_config_helper.h"
 #include "modules/common/vehicle_state/vehicle_state_provider.h"
 #include "modules/control/common/control_gflags.h"
+#include "modules/control/common/control_latency_monitor.h"
 
 #include "modules/common/util/message_util.h"
 
@@ -30,7 +34,16 @@ using apollo::common::VehicleStateProvider;
 using apollo::cyber::Clock;
 
 
-ControlComponent::ControlComponent() {}
+ControlComponent::ControlComponent() :
+    latest_localization_(
+            std::make_shared<apollo::localization::LocalizationEstimate>()),
+    latest_chassis_(std::make_shared<apollo::canbus::Chassis>()),
+    latest_trajectory_(std::make_shared<apollo::planning::ADCTrajectory>())
+{
+    local_view_.localization = latest_localization_;
+    local_view_.chassis = latest_chassis_;
+    local_view_.trajectory = latest_trajectory_;
+}
 
 int ControlComponent::init(std::string config_dir)
 {
@@ -90,13 +103,17 @@ int ControlComponent::init(std::string config_dir)
         return false;
     }
 
+    // The readers only publish a pointer to the received message, the control
+    // cycle takes all of them without copying and without waiting on a lock.
     chassis_reader_ = node_->CreateReader<apollo::canbus::Chassis>(
             FLAGS_chassis_topic,
             [this](const std::shared_ptr<apollo::canbus::Chassis> &chassis)
             {
                 ADEBUG << "Received chassis data: run chassis callback.";
-                std::lock_guard<std::mutex> lock(mutex_);
-                latest_chassis_.CopyFrom(*chassis);
+                std::atomic_store(
+                        &latest_chassis_,
+                        std::shared_ptr<const apollo::canbus::Chassis>(
+                                chassis));
             });
 
     localization_reader_ = node_->CreateReader<
@@ -105,9 +122,10 @@ int ControlComponent::init(std::string config_dir)
             [this](const std::shared_ptr<
                     apollo::localization::LocalizationEstimate> &localization)
             {
-                ADEBUG << "Received chassis data: run chassis callback.";
-                std::lock_guard<std::mutex> lock(mutex_);
-                latest_localization_.CopyFrom(*localization);
+                ADEBUG << "Received localization data: run localization "
+                          "callback.";
+                std::atomic_store(&latest_localization_,
+                                  PrepareLocalization(*localization));
             });
 
     trajectory_reader_ = node_->CreateReader<apollo::planning::ADCTrajectory>(
@@ -115,14 +133,17 @@ int ControlComponent::init(std::string config_dir)
             [this](const std::shared_ptr<apollo::planning::ADCTrajectory>
                            &trajectory)
             {
-                ADEBUG << "Received chassis data: run chassis callback.";
-                std::lock_guard<std::mutex> lock(mutex_);
-                latest_trajectory_.CopyFrom(*trajectory);
+                ADEBUG << "Received trajectory data: run trajectory callback.";
+                std::atomic_store(&latest_trajectory_,
+                                  PrepareTrajectory(trajectory));
             });
 
     control_cmd_writer_ = node_->CreateWriter<apollo::control::ControlCommand>(
             FLAGS_control_command_topic);
 
+    latency_writer_ = node_->CreateWriter<apollo::planning::LatencyStats>(
+            FLAGS_control_latency_topic);
+
     AINFO << "begin wait";
 
     // set initial vehicle state by cmd
@@ -143,50 +164,98 @@ int ControlComponent::init(std::string config_dir)
     return true;
 }
 
-int ControlComponent::update_cyber_rt()
+std::shared_ptr<const apollo::localization::LocalizationEstimate>
+ControlComponent::PrepareLocalization(
+        const apollo::localization::LocalizationEstimate &localization)
 {
-    {
-        // TODO(SHU): to avoid redundent copy
-        std::lock_guard<std::mutex> lock(mutex_);
-        local_view_.mutable_chassis()->CopyFrom(latest_chassis_);
-        local_view_.mutable_trajectory()->CopyFrom(latest_trajectory_);
-        local_view_.mutable_localization()->CopyFrom(latest_localization_);
-
-        // 不使用定位的acc,angular, 设备精度不足，影响控制模块
-        if (1)
-        {
-            apollo::localization::Pose *pose =
-                    local_view_.mutable_localization()->mutable_pose();
+    // The message may be shared with other readers, so the modified one is a
+    // copy. Localization is small compared with the trajectory.
+    auto prepared =
+            std::make_shared<apollo::localization::LocalizationEstimate>(
+                    localization);
+
+    // 不使用定位的acc,angular, 设备精度不足，影响控制模块
+    apollo::localization::Pose *pose = prepared->mutable_pose();
+
+    pose->mutable_linear_acceleration()->set_x(0);
+    pose->mutable_linear_acceleration()->set_y(0);
+    pose->mutable_linear_acceleration()->set_z(0);
+
+    pose->mutable_linear_acceleration_vrf()->set_x(0);
+    pose->mutable_linear_acceleration_vrf()->set_y(0);
+    pose->mutable_linear_acceleration_vrf()->set_z(0);
 
-            pose->mutable_linear_acceleration()->set_x(0);
-            pose->mutable_linear_acceleration()->set_y(0);
-            pose->mutable_linear_acceleration()->set_z(0);
+    pose->mutable_angular_velocity()->set_x(0);
+    pose->mutable_angular_velocity()->set_y(0);
+    pose->mutable_angular_velocity()->set_z(0);
 
-            pose->mutable_linear_acceleration_vrf()->set_x(0);
-            pose->mutable_linear_acceleration_vrf()->set_y(0);
-            pose->mutable_linear_acceleration_vrf()->set_z(0);
+    pose->mutable_angular_velocity_vrf()->set_x(0);
+    pose->mutable_angular_velocity_vrf()->set_y(0);
+    pose->mutable_angular_velocity_vrf()->set_z(0);
 
-            pose->mutable_angular_velocity()->set_x(0);
-            pose->mutable_angular_velocity()->set_y(0);
-            pose->mutable_angular_velocity()->set_z(0);
+    return prepared;
+}
 
-            pose->mutable_angular_velocity_vrf()->set_x(0);
-            pose->mutable_angular_velocity_vrf()->set_y(0);
-            pose->mutable_angular_velocity_vrf()->set_z(0);
+std::shared_ptr<const apollo::planning::ADCTrajectory>
+ControlComponent::PrepareTrajectory(
+        const std::shared_ptr<apollo::planning::ADCTrajectory> &trajectory)
+{
+    auto is_stopped = [this](const apollo::common::TrajectoryPoint &point)
+    {
+        return std::abs(point.v()) < control_conf_.minimum_speed_resolution() &&
+               std::abs(point.a()) <
+                       control_conf_.max_acceleration_when_stopped();
+    };
+
+    // Snap the speed of stopped points to zero. Only trajectories which
+    // actually have such points are copied, once per message instead of once
+    // per control cycle.
+    if (std::none_of(trajectory->trajectory_point().begin(),
+                     trajectory->trajectory_point().end(), is_stopped))
+    {
+        return trajectory;
+    }
+    auto prepared =
+            std::make_shared<apollo::planning::ADCTrajectory>(*trajectory);
+    for (auto &trajectory_point : *prepared->mutable_trajectory_point())
+    {
+        if (is_stopped(trajectory_point))
+        {
+            trajectory_point.set_v(0.0);
+            trajectory_point.set_a(0.0);
         }
     }
+    return prepared;
+}
+
+int ControlComponent::update_cyber_rt()
+{
+    if (!FLAGS_use_control_submodules)
+    {
+        ControlLatencyMonitor::Instance()->BeginCycle();
+    }
+
+    // take a snapshot of the latest inputs, no message is copied here
+    local_view_.chassis = std::atomic_load(&latest_chassis_);
+    local_view_.trajectory = std::atomic_load(&latest_trajectory_);
+    local_view_.localization = std::atomic_load(&latest_localization_);
 
     // use control submodules, 0
     if (FLAGS_use_control_submodules)
     {
-        local_view_.mutable_header()->set_lidar_timestamp(
-                local_view_.trajectory().header().lidar_timestamp());
-        local_view_.mutable_header()->set_camera_timestamp(
-                local_view_.trajectory().header().camera_timestamp());
-        local_view_.mutable_header()->set_radar_timestamp(
-                local_view_.trajectory().header().radar_timestamp());
+        apollo::control::LocalView local_view;
+        local_view.mutable_chassis()->CopyFrom(*local_view_.chassis);
+        local_view.mutable_trajectory()->CopyFrom(*local_view_.trajectory);
+        local_view.mutable_localization()->CopyFrom(
+                *local_view_.localization);
+        local_view.mutable_header()->set_lidar_timestamp(
+                local_view_.trajectory->header().lidar_timestamp());
+        local_view.mutable_header()->set_camera_timestamp(
+                local_view_.trajectory->header().camera_timestamp());
+        local_view.mutable_header()->set_radar_timestamp(
+                local_view_.trajectory->header().radar_timestamp());
         // common::util::FillHeader(FLAGS_control_local_view_topic,
-        // &local_view_);
+        // &local_view);
 
         const auto end_time = Clock::Now();
 
@@ -194,10 +263,10 @@ int ControlComponent::update_cyber_rt()
         // static apollo::common::LatencyRecorder latency_recorder(
         //    FLAGS_control_local_view_topic);
         // latency_recorder.AppendLatencyRecord(
-        //    local_view_.trajectory().header().lidar_timestamp(), start_time,
+        //    local_view_.trajectory->header().lidar_timestamp(), start_time,
         //    end_time);
 
-        local_view_writer_->Write(local_view_);
+        local_view_writer_->Write(local_view);
         return 0;
     }
 
@@ -228,6 +297,7 @@ int ControlComponent::process()
     control_command_.Clear();
 
     Status status = ProduceControlCommand(&control_command_);
+    const auto postprocess_start_time = Clock::Now();
 
     AERROR_IF(!status.ok())
             << "Failed to produce control command:" << status.error_message();
@@ -241,11 +311,11 @@ int ControlComponent::process()
 
     // set header
     control_command_.mutable_header()->set_lidar_timestamp(
-            local_view_.trajectory().header().lidar_timestamp());
+            local_view_.trajectory->header().lidar_timestamp());
     control_command_.mutable_header()->set_camera_timestamp(
-            local_view_.trajectory().header().camera_timestamp());
+            local_view_.trajectory->header().camera_timestamp());
     control_command_.mutable_header()->set_radar_timestamp(
-            local_view_.trajectory().header().radar_timestamp());
+            local_view_.trajectory->header().radar_timestamp());
 
     // apollo::common::util::FillHeader(node_->Name(), &control_command_);
 
@@ -264,15 +334,27 @@ int ControlComponent::process()
     control_command_.mutable_latency_stats()->set_total_time_exceeded(
             time_diff_ms > control_conf_.control_period() * 1e3);
 
+    if (!FLAGS_use_control_submodules)
+    {
+        auto *latency_monitor = ControlLatencyMonitor::Instance();
+        latency_monitor->Record(ControlLatencyMonitor::POSTPROCESSOR,
+                                postprocess_start_time, end_time);
+        if (latency_monitor->EndCycle(control_conf_.control_period() * 1e3,
+                                      &latency_summary_))
+        {
+            latency_writer_->Write(latency_summary_);
+        }
+    }
+
     status.Save(control_command_.mutable_header()->mutable_status());
 
     // measure latency
-    // if (local_view_.trajectory().header().has_lidar_timestamp())
+    // if (local_view_.trajectory->header().has_lidar_timestamp())
     // {
     //     static apollo::common::LatencyRecorder latency_recorder(
     //             FLAGS_control_command_topic);
     //     latency_recorder.AppendLatencyRecord(
-    //             local_view_.trajectory().header().lidar_timestamp(),
+    //             local_view_.trajectory->header().lidar_timestamp(),
     //             start_time, end_time);
     // }
 
@@ -284,7 +366,8 @@ int ControlComponent::process()
 
 Status ControlComponent::ProduceControlCommand(ControlCommand *control_command)
 {
-    Status status = CheckInput(&local_view_);
+    const auto preprocess_start_time = Clock::Now();
+    Status status = CheckInput(local_view_);
 
     // Status status(ErrorCode::OK);
     // check data
@@ -309,7 +392,7 @@ Status ControlComponent::ProduceControlCommand(ControlCommand *control_command)
             AERROR << "Input messages timeout";
             // estop_ = true;
             status = status_ts;
-            if (local_view_.chassis().driving_mode() !=
+            if (local_view_.chassis->driving_mode() !=
                 apollo::canbus::Chassis::COMPLETE_AUTO_DRIVE)
             {
                 control_command->mutable_engage_advice()->set_advice(
@@ -326,24 +409,24 @@ Status ControlComponent::ProduceControlCommand(ControlCommand *control_command)
     }
     // check estop
     estop_ = control_conf_.enable_persistent_estop()
-                     ? estop_ || local_view_.trajectory().estop().is_estop()
-                     : local_view_.trajectory().estop().is_estop();
-    if (local_view_.trajectory().estop().is_estop())
+                     ? estop_ || local_view_.trajectory->estop().is_estop()
+                     : local_view_.trajectory->estop().is_estop();
+    if (local_view_.trajectory->estop().is_estop())
     {
         estop_ = true;
 
         estop_reason_ = "estop from planning : ";
-        estop_reason_ += local_view_.trajectory().estop().reason();
+        estop_reason_ += local_view_.trajectory->estop().reason();
     }
 
-    if (local_view_.trajectory().trajectory_point().empty())
+    if (local_view_.trajectory->trajectory_point().empty())
     {
         AWARN_EVERY(100) << "planning has no trajectory point. ";
         estop_ = true;
 
         estop_reason_ =
                 "estop for empty planning trajectory, planning headers: " +
-                local_view_.trajectory().header().ShortDebugString();
+                local_view_.trajectory->header().ShortDebugString();
 
     }
 
@@ -352,8 +435,8 @@ Status ControlComponent::ProduceControlCommand(ControlCommand *control_command)
     {
         const double kEpsilon = 0.001;
         auto first_trajectory_point =
-                local_view_.trajectory().trajectory_point(0);
-        if (local_view_.chassis().gear_location() == Chassis::GEAR_DRIVE &&
+                local_view_.trajectory->trajectory_point(0);
+        if (local_view_.chassis->gear_location() == Chassis::GEAR_DRIVE &&
             first_trajectory_point.v() < -1 * kEpsilon)
         {
             estop_ = true;
@@ -361,25 +444,35 @@ Status ControlComponent::ProduceControlCommand(ControlCommand *control_command)
         }
     }
 
+    // the submodules track their own stages
+    auto *latency_monitor = FLAGS_use_control_submodules
+                                    ? nullptr
+                                    : ControlLatencyMonitor::Instance();
+    if (latency_monitor != nullptr)
+    {
+        latency_monitor->Record(ControlLatencyMonitor::PREPROCESSOR,
+                                preprocess_start_time, Clock::Now());
+    }
+
     if (!estop_)
     {
-        if (local_view_.chassis().driving_mode() == Chassis::COMPLETE_MANUAL)
+        if (local_view_.chassis->driving_mode() == Chassis::COMPLETE_MANUAL)
         {
             controller_agent_.Reset();
             AINFO_EVERY(100) << "Reset Controllers in Manual Mode";
         }
         auto debug = control_command->mutable_debug()->mutable_input_debug();
         debug->mutable_localization_header()->CopyFrom(
-                local_view_.localization().header());
+                local_view_.localization->header());
         debug->mutable_canbus_header()->CopyFrom(
-                local_view_.chassis().header());
+                local_view_.chassis->header());
         debug->mutable_trajectory_header()->CopyFrom(
-                local_view_.trajectory().header());
+                local_view_.trajectory->header());
 
-        if (local_view_.trajectory().is_replan())
+        if (local_view_.trajectory->is_replan())
         {
             latest_replan_trajectory_header_ =
-                    local_view_.trajectory().header();
+                    local_view_.trajectory->header();
         }
 
         if (latest_replan_trajectory_header_.has_sequence_num())
@@ -388,19 +481,33 @@ Status ControlComponent::ProduceControlCommand(ControlCommand *control_command)
                     latest_replan_trajectory_header_);
         }
 
+        if (latency_monitor != nullptr)
+        {
+            latency_monitor->RecordInputAges(
+                    local_view_.chassis->header(),
+                    local_view_.localization->header(),
+                    local_view_.trajectory->header());
+        }
+
         // controller agent
+        const auto controller_start_time = Clock::Now();
         Status status_compute = controller_agent_.ComputeControlCommand(
-                &local_view_.localization(), &local_view_.chassis(),
-                &local_view_.trajectory(), control_command);
+                local_view_.localization.get(), local_view_.chassis.get(),
+                local_view_.trajectory.get(), control_command);
+        if (latency_monitor != nullptr)
+        {
+            latency_monitor->Record(ControlLatencyMonitor::CONTROLLER,
+                                    controller_start_time, Clock::Now());
+        }
         if (!status_compute.ok())
         {
             AERROR << "Control main function failed"
                    << " with localization: "
-                   << local_view_.localization().ShortDebugString()
+                   << local_view_.localization->ShortDebugString()
                    << " with chassis: "
-                   << local_view_.chassis().ShortDebugString()
+                   << local_view_.chassis->ShortDebugString()
                    << " with trajectory: "
-                   << local_view_.trajectory().ShortDebugString()
+                   << local_view_.trajectory->ShortDebugString()
                    << " with cmd: " << control_command->ShortDebugString()
                    << " status:" << status_compute.error_message();
             estop_ = true;
@@ -425,14 +532,14 @@ Status ControlComponent::ProduceControlCommand(ControlCommand *control_command)
     }
 
     // check signal
-    if (local_view_.trajectory().decision().has_vehicle_signal())
+    if (local_view_.trajectory->decision().has_vehicle_signal())
     {
         control_command->mutable_signal()->CopyFrom(
-                local_view_.trajectory().decision().vehicle_signal());
+                local_view_.trajectory->decision().vehicle_signal());
     }
 
 #if debug_mpc
-    if (local_view_.chassis().driving_mode() == Chassis::COMPLETE_MANUAL)
+    if (local_view_.chassis->driving_mode() == Chassis::COMPLETE_MANUAL)
     {
         AINFO << "munual mode";
     }
@@ -442,7 +549,7 @@ Status ControlComponent::ProduceControlCommand(ControlCommand *control_command)
     }
 
     // AINFO << "debug traj";
-    // for (size_t i = 0; i < local_view_.trajectory().trajectory_point_size();
+    // for (size_t i = 0; i < local_view_.trajectory->trajectory_point_size();
     //      i++)
     // {
     //     if (i > 100)
@@ -450,7 +557,7 @@ Status ControlComponent::ProduceControlCommand(ControlCommand *control_command)
     //         break;
     //     }
 
-    //     AINFO << local_view_.trajectory().trajectory_point(i).DebugString();
+    //     AINFO << local_view_.trajectory->trajectory_point(i).DebugString();
     // }
 
     AINFO << "apollo control messege";
@@ -466,7 +573,7 @@ int ControlComponent::publish_msg()
     control_cmd_writer_->Write(control_command_);
 
 #if debug_pure_pursuit
-    if (local_view_.chassis().driving_mode() == Chassis::COMPLETE_MANUAL)
+    if (local_view_.chassis->driving_mode() == Chassis::COMPLETE_MANUAL)
     {
         AINFO << "munual mode";
     }
@@ -480,43 +587,33 @@ int ControlComponent::publish_msg()
     return 0;
 }
 
-Status ControlComponent::CheckInput(LocalView *local_view)
+Status ControlComponent::CheckInput(const InputSnapshot &local_view)
 {
     ADEBUG << "Received localization:"
-           << local_view->localization().ShortDebugString();
-    ADEBUG << "Received chassis:" << local_view->chassis().ShortDebugString();
+           << local_view.localization->ShortDebugString();
+    ADEBUG << "Received chassis:" << local_view.chassis->ShortDebugString();
 
-    if (!local_view->trajectory().estop().is_estop() &&
-        local_view->trajectory().trajectory_point().empty())
+    if (!local_view.trajectory->estop().is_estop() &&
+        local_view.trajectory->trajectory_point().empty())
     {
         AWARN_EVERY(100) << "planning has no trajectory point. ";
         const std::string msg = absl::StrCat(
                 "planning has no trajectory point. planning_seq_num:",
-                local_view->trajectory().header().sequence_num());
+                local_view.trajectory->header().sequence_num());
 
         return Status(ErrorCode::CONTROL_COMPUTE_ERROR, msg);
     }
 
-    for (auto &trajectory_point :
-         *local_view->mutable_trajectory()->mutable_trajectory_point())
-    {
-        if (std::abs(trajectory_point.v()) <
-                    control_conf_.minimum_speed_resolution() &&
-            std::abs(trajectory_point.a()) <
-                    control_conf_.max_acceleration_when_stopped())
-        {
-            trajectory_point.set_v(0.0);
-            trajectory_point.set_a(0.0);
-        }
-    }
+    // speed of stopped trajectory points is already snapped to zero in
+    // PrepareTrajectory
 
-    injector_->vehicle_state()->Update(local_view->localization(),
-                                       local_view->chassis());
+    injector_->vehicle_state()->Update(*local_view.localization,
+                                       *local_view.chassis);
 
     return Status::OK();
 }
 
-Status ControlComponent::CheckTimestamp(const LocalView &local_view)
+Status ControlComponent::CheckTimestamp(const InputSnapshot &local_view)
 {
     if (!control_conf_.enable_input_timestamp_check() ||
         control_conf_.is_control_test_mode())
@@ -527,7 +624,7 @@ Status ControlComponent::CheckTimestamp(const LocalView &local_view)
     double current_timestamp = Clock::NowInSeconds();
     double localization_diff =
             current_timestamp -
-            local_view.localization().header().timestamp_sec();
+            local_view.localization->header().timestamp_sec();
     if (localization_diff > (control_conf_.max_localization_miss_num() *
                              control_conf_.localization_period()))
     {
@@ -539,7 +636,7 @@ Status ControlComponent::CheckTimestamp(const LocalView &local_view)
     }
 
     double chassis_diff =
-            current_timestamp - local_view.chassis().header().timestamp_sec();
+            current_timestamp - local_view.chassis->header().timestamp_sec();
     if (chassis_diff >
         (control_conf_.max_chassis_miss_num() * control_conf_.chassis_period()))
     {
@@ -550,7 +647,7 @@ Status ControlComponent::CheckTimestamp(const LocalView &local_view)
     }
 
     double trajectory_diff = current_timestamp -
-                             local_view.trajectory().header().timestamp_sec();
+                             local_view.trajectory->header().timestamp_sec();
     if (trajectory_diff > (control_conf_.max_planning_miss_num() *
                            control_conf_.trajectory_period()))
     {
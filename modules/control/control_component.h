@@ -36,24 +36,24 @@ public:
 
     int process();
 
-    apollo::localization::LocalizationEstimate *get_localization()
+    const apollo::localization::LocalizationEstimate *get_localization()
     {
-        return local_view_.mutable_localization();
+        return local_view_.localization.get();
     }
 
-    apollo::canbus::Chassis *get_chassis()
+    const apollo::canbus::Chassis *get_chassis()
     {
-        return local_view_.mutable_chassis();
+        return local_view_.chassis.get();
     }
 
-    apollo::planning::ADCTrajectory *get_trajectory()
+    const apollo::planning::ADCTrajectory *get_trajectory()
     {
-        return local_view_.mutable_trajectory();
+        return local_view_.trajectory.get();
     }
 
     int get_copy_trajectory(apollo::planning::ADCTrajectory *traj)
     {
-        traj->CopyFrom(local_view_.trajectory());
+        traj->CopyFrom(*local_view_.trajectory);
 
         return 0;
     }
@@ -62,7 +62,7 @@ public:
 
     apollo::canbus::Chassis::DrivingMode get_chassis_drive_mode()
     {
-        return latest_chassis_.driving_mode();
+        return std::atomic_load(&latest_chassis_)->driving_mode();
     }
 
     bool control_init_finish() { return init_finish_; }
@@ -73,22 +73,42 @@ public:
     }
 
 protected:
+    // Immutable inputs of one control cycle. The messages are shared with the
+    // reader callbacks and must not be modified.
+    struct InputSnapshot
+    {
+        std::shared_ptr<const apollo::localization::LocalizationEstimate>
+                localization;
+        std::shared_ptr<const apollo::canbus::Chassis> chassis;
+        std::shared_ptr<const apollo::planning::ADCTrajectory> trajectory;
+    };
+
     apollo::common::Status ProduceControlCommand(
             apollo::control::ControlCommand *control_command);
 
-    apollo::common::Status CheckInput(apollo::control::LocalView *local_view);
+    apollo::common::Status CheckInput(const InputSnapshot &local_view);
 
-    apollo::common::Status CheckTimestamp(
-            const apollo::control::LocalView &local_view);
+    apollo::common::Status CheckTimestamp(const InputSnapshot &local_view);
     apollo::common::Status CheckPad();
 
+    // messages are prepared once when received, so that every control cycle
+    // can use them as they are
+    std::shared_ptr<const apollo::localization::LocalizationEstimate>
+    PrepareLocalization(
+            const apollo::localization::LocalizationEstimate &localization);
+
+    std::shared_ptr<const apollo::planning::ADCTrajectory> PrepareTrajectory(
+            const std::shared_ptr<apollo::planning::ADCTrajectory> &trajectory);
+
 protected:
     apollo::cyber::Time init_time_;
 
-    // input
-    apollo::localization::LocalizationEstimate latest_localization_;
-    apollo::canbus::Chassis latest_chassis_;
-    apollo::planning::ADCTrajectory latest_trajectory_;
+    // input, latest messages published by the readers with std::atomic_store
+    // and taken by the control cycle with std::atomic_load
+    std::shared_ptr<const apollo::localization::LocalizationEstimate>
+            latest_localization_;
+    std::shared_ptr<const apollo::canbus::Chassis> latest_chassis_;
+    std::shared_ptr<const apollo::planning::ADCTrajectory> latest_trajectory_;
     // apollo::PadMessage pad_msg_;
     apollo::common::Header latest_replan_trajectory_header_;
 
@@ -108,8 +128,6 @@ protected:
 
     apollo::control::ControlConf control_conf_;
 
-    std::mutex mutex_;
-
     // reader
     std::shared_ptr<apollo::cyber::Reader<apollo::canbus::Chassis>>
             chassis_reader_;
@@ -129,7 +147,11 @@ protected:
     std::shared_ptr<apollo::cyber::Writer<apollo::control::LocalView>>
             local_view_writer_;
 
-    apollo::control::LocalView local_view_;
+    std::shared_ptr<apollo::cyber::Writer<apollo::planning::LatencyStats>>
+            latency_writer_;
+    apollo::planning::LatencyStats latency_summary_;
+
+    InputSnapshot local_view_;
 
     std::shared_ptr<apollo::control::DependencyInjector> injector_;
 
@@ -100,7 +100,7 @@ int main(int argc, char** argv)
         apollo::control::ControlCommand history_command =
                 control.get_control_command();
 
-        apollo::canbus::Chassis *latest_chassis_ = control.get_chassis();
+        const apollo::canbus::Chassis *latest_chassis_ = control.get_chassis();
 
         {
             ret_value = control.process();
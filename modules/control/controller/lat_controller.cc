@@ -215,8 +215,8 @@ Status LatController::Init(std::shared_ptr<DependencyInjector> injector,
     }
     // Matrix init operations.
     const int matrix_size = basic_state_size_ + preview_window_;
-    matrix_a_ = Matrix::Zero(basic_state_size_, basic_state_size_);
-    matrix_ad_ = Matrix::Zero(basic_state_size_, basic_state_size_);
+    matrix_a_.setZero();
+    matrix_ad_.setZero();
     matrix_adc_ = Matrix::Zero(matrix_size, matrix_size);
     /*
     A matrix (Gear Drive)
@@ -232,7 +232,7 @@ Status LatController::Init(std::shared_ptr<DependencyInjector> injector,
     matrix_a_(2, 3) = 1.0;
     matrix_a_(3, 2) = (lf_ * cf_ - lr_ * cr_) / iz_;
 
-    matrix_a_coeff_ = Matrix::Zero(matrix_size, matrix_size);
+    matrix_a_coeff_.setZero();
     matrix_a_coeff_(1, 1) = -(cf_ + cr_) / mass_;
     matrix_a_coeff_(1, 3) = (lr_ * cr_ - lf_ * cf_) / mass_;
     matrix_a_coeff_(3, 1) = (lr_ * cr_ - lf_ * cf_) / iz_;
@@ -241,8 +241,7 @@ Status LatController::Init(std::shared_ptr<DependencyInjector> injector,
     /*
     b = [0.0, c_f / m, 0.0, l_f * c_f / i_z]^T
     */
-    matrix_b_ = Matrix::Zero(basic_state_size_, 1);
-    matrix_bd_ = Matrix::Zero(basic_state_size_, 1);
+    matrix_b_.setZero();
     matrix_bdc_ = Matrix::Zero(matrix_size, 1);
     matrix_b_(1, 0) = cf_ / mass_;
     matrix_b_(3, 0) = lf_ * cf_ / iz_;
@@ -273,10 +272,35 @@ Status LatController::Init(std::shared_ptr<DependencyInjector> injector,
     }
 
     matrix_q_updated_ = matrix_q_;
+
+    // The compound state size only depends on the preview window, pick the
+    // solver specialized on it so that the online solve does not allocate.
+    switch (matrix_size)
+    {
+        case 4:
+            lqr_solver_ = &LatController::SolveFixedSizeLqr<4>;
+            break;
+        case 5:
+            lqr_solver_ = &LatController::SolveFixedSizeLqr<5>;
+            break;
+        case 6:
+            lqr_solver_ = &LatController::SolveFixedSizeLqr<6>;
+            break;
+        case 7:
+            lqr_solver_ = &LatController::SolveFixedSizeLqr<7>;
+            break;
+        case 8:
+            lqr_solver_ = &LatController::SolveFixedSizeLqr<8>;
+            break;
+        default:
+            lqr_solver_ = &LatController::SolveDynamicSizeLqr;
+            break;
+    }
     InitializeFilters(control_conf_);
     auto &lat_controller_conf = control_conf_->lat_controller_conf();
     LoadLatGainScheduler(lat_controller_conf);
     LogInitParameters();
+    BuildGainTables();
 
     enable_leadlag_ = control_conf_->lat_controller_conf()
                               .enable_reverse_leadlag_compensation();
@@ -445,51 +469,9 @@ Status LatController::ComputeControlCommand(
     // Re-build the vehicle dynamic models at reverse driving (in particular,
     // replace the lateral translational motion dynamics with the corresponding
     // kinematic models)
-    if (vehicle_state->gear() == canbus::Chassis::GEAR_REVERSE)
-    {
-        /*
-        A matrix (Gear Reverse)
-        [0.0, 0.0, 1.0 * v 0.0;
-         0.0, (-(c_f + c_r) / m) / v, (c_f + c_r) / m,
-         (l_r * c_r - l_f * c_f) / m / v;
-         0.0, 0.0, 0.0, 1.0;
-         0.0, ((lr * cr - lf * cf) / i_z) / v, (l_f * c_f - l_r * c_r) / i_z,
-         (-1.0 * (l_f^2 * c_f + l_r^2 * c_r) / i_z) / v;]
-        */
-        cf_ = -control_conf_->lat_controller_conf().cf();
-        cr_ = -control_conf_->lat_controller_conf().cr();
-        matrix_a_(0, 1) = 0.0;
-        matrix_a_coeff_(0, 2) = 1.0;
-    }
-    else
-    {
-        /*
-        A matrix (Gear Drive)
-        [0.0, 1.0, 0.0, 0.0;
-         0.0, (-(c_f + c_r) / m) / v, (c_f + c_r) / m,
-         (l_r * c_r - l_f * c_f) / m / v;
-         0.0, 0.0, 0.0, 1.0;
-         0.0, ((lr * cr - lf * cf) / i_z) / v, (l_f * c_f - l_r * c_r) / i_z,
-         (-1.0 * (l_f^2 * c_f + l_r^2 * c_r) / i_z) / v;]
-        */
-        cf_ = control_conf_->lat_controller_conf().cf();
-        cr_ = control_conf_->lat_controller_conf().cr();
-        matrix_a_(0, 1) = 1.0;
-        matrix_a_coeff_(0, 2) = 0.0;
-    }
-    matrix_a_(1, 2) = (cf_ + cr_) / mass_;
-    matrix_a_(3, 2) = (lf_ * cf_ - lr_ * cr_) / iz_;
-    matrix_a_coeff_(1, 1) = -(cf_ + cr_) / mass_;
-    matrix_a_coeff_(1, 3) = (lr_ * cr_ - lf_ * cf_) / mass_;
-    matrix_a_coeff_(3, 1) = (lr_ * cr_ - lf_ * cf_) / iz_;
-    matrix_a_coeff_(3, 3) = -1.0 * (lf_ * lf_ * cf_ + lr_ * lr_ * cr_) / iz_;
-
-    /*
-    b = [0.0, c_f / m, 0.0, l_f * c_f / i_z]^T
-    */
-    matrix_b_(1, 0) = cf_ / mass_;
-    matrix_b_(3, 0) = lf_ * cf_ / iz_;
-    matrix_bd_ = matrix_b_ * ts_;
+    const bool reverse =
+            vehicle_state->gear() == canbus::Chassis::GEAR_REVERSE;
+    UpdateDynamicModel(reverse);
 
     UpdateDrivingOrientation();
 
@@ -501,58 +483,14 @@ Status LatController::ComputeControlCommand(
     // Error Rate, preview lateral error1 , preview lateral error2, ...]
     UpdateState(debug);
 
-    UpdateMatrix();
-
-    // Compound discrete matrix with road preview model
-    UpdateMatrixCompound();
-
-    // Adjust matrix_q_updated when in reverse gear
-    int q_param_size = control_conf_->lat_controller_conf().matrix_q_size();
-    int reverse_q_param_size =
-            control_conf_->lat_controller_conf().reverse_matrix_q_size();
-    if (injector_->vehicle_state()->gear() == canbus::Chassis::GEAR_REVERSE)
-    {
-        for (int i = 0; i < reverse_q_param_size; ++i)
-        {
-            matrix_q_(i, i) =
-                    control_conf_->lat_controller_conf().reverse_matrix_q(i);
-        }
-    }
-    else
-    {
-        for (int i = 0; i < q_param_size; ++i)
-        {
-            matrix_q_(i, i) = control_conf_->lat_controller_conf().matrix_q(i);
-        }
-    }
-
-    // Add gain scheduler for higher speed steering
-    if (FLAGS_enable_gain_scheduler)
-    {
-        matrix_q_updated_(0, 0) =
-                matrix_q_(0, 0) * lat_err_interpolation_->Interpolate(std::fabs(
-                                          vehicle_state->linear_velocity()));
-        matrix_q_updated_(2, 2) =
-                matrix_q_(2, 2) *
-                heading_err_interpolation_->Interpolate(
-                        std::fabs(vehicle_state->linear_velocity()));
-        common::math::SolveLQRProblem(matrix_adc_, matrix_bdc_,
-                                      matrix_q_updated_, matrix_r_, lqr_eps_,
-                                      lqr_max_iteration_, &matrix_k_);
-    }
-    else
-    {
-        common::math::SolveLQRProblem(matrix_adc_, matrix_bdc_, matrix_q_,
-                                      matrix_r_, lqr_eps_, lqr_max_iteration_,
-                                      &matrix_k_);
-    }
+    ComputeFeedbackGain(reverse, vehicle_state->linear_velocity());
 
     // feedback = - K * state
     // Convert vehicle steer angle from rad to degree and then to steer degree
     // then to 100% ratio
     const double steer_angle_feedback =
-            -(matrix_k_ * matrix_state_)(0, 0) * 180 / M_PI * steer_ratio_ /
-            steer_single_direction_max_degree_ * 100;
+            -matrix_k_.row(0).dot(matrix_state_.col(0)) * 180 / M_PI *
+            steer_ratio_ / steer_single_direction_max_degree_ * 100;
 
     const double steer_angle_feedforward =
             ComputeFeedForward(debug->curvature());
@@ -803,31 +741,216 @@ void LatController::UpdateState(SimpleLateralDebug *debug)
 }
 
 void LatController::UpdateMatrix()
+{
+    UpdateMatrix(
+            injector_->vehicle_state()->gear() == canbus::Chassis::GEAR_REVERSE,
+            injector_->vehicle_state()->linear_velocity());
+}
+
+void LatController::UpdateMatrix(const bool reverse,
+                                 const double linear_velocity)
 {
     double v;
     // At reverse driving, replace the lateral translational motion dynamics
     // with the corresponding kinematic models
-    if (injector_->vehicle_state()->gear() == canbus::Chassis::GEAR_REVERSE)
+    if (reverse)
     {
-        v = std::min(injector_->vehicle_state()->linear_velocity(),
-                     -minimum_speed_protection_);
+        v = std::min(linear_velocity, -minimum_speed_protection_);
         matrix_a_(0, 2) = matrix_a_coeff_(0, 2) * v;
     }
     else
     {
-        v = std::max(injector_->vehicle_state()->linear_velocity(),
-                     minimum_speed_protection_);
+        v = std::max(linear_velocity, minimum_speed_protection_);
         matrix_a_(0, 2) = 0.0;
     }
     matrix_a_(1, 1) = matrix_a_coeff_(1, 1) / v;
     matrix_a_(1, 3) = matrix_a_coeff_(1, 3) / v;
     matrix_a_(3, 1) = matrix_a_coeff_(3, 1) / v;
     matrix_a_(3, 3) = matrix_a_coeff_(3, 3) / v;
-    Matrix matrix_i = Matrix::Identity(matrix_a_.cols(), matrix_a_.cols());
+    const Eigen::Matrix4d matrix_i = Eigen::Matrix4d::Identity();
     matrix_ad_ = (matrix_i - ts_ * 0.5 * matrix_a_).inverse() *
                  (matrix_i + ts_ * 0.5 * matrix_a_);
 }
 
+void LatController::UpdateDynamicModel(const bool reverse)
+{
+    if (reverse)
+    {
+        /*
+        A matrix (Gear Reverse)
+        [0.0, 0.0, 1.0 * v 0.0;
+         0.0, (-(c_f + c_r) / m) / v, (c_f + c_r) / m,
+         (l_r * c_r - l_f * c_f) / m / v;
+         0.0, 0.0, 0.0, 1.0;
+         0.0, ((lr * cr - lf * cf) / i_z) / v, (l_f * c_f - l_r * c_r) / i_z,
+         (-1.0 * (l_f^2 * c_f + l_r^2 * c_r) / i_z) / v;]
+        */
+        cf_ = -control_conf_->lat_controller_conf().cf();
+        cr_ = -control_conf_->lat_controller_conf().cr();
+        matrix_a_(0, 1) = 0.0;
+        matrix_a_coeff_(0, 2) = 1.0;
+    }
+    else
+    {
+        /*
+        A matrix (Gear Drive)
+        [0.0, 1.0, 0.0, 0.0;
+         0.0, (-(c_f + c_r) / m) / v, (c_f + c_r) / m,
+         (l_r * c_r - l_f * c_f) / m / v;
+         0.0, 0.0, 0.0, 1.0;
+         0.0, ((lr * cr - lf * cf) / i_z) / v, (l_f * c_f - l_r * c_r) / i_z,
+         (-1.0 * (l_f^2 * c_f + l_r^2 * c_r) / i_z) / v;]
+        */
+        cf_ = control_conf_->lat_controller_conf().cf();
+        cr_ = control_conf_->lat_controller_conf().cr();
+        matrix_a_(0, 1) = 1.0;
+        matrix_a_coeff_(0, 2) = 0.0;
+    }
+    matrix_a_(1, 2) = (cf_ + cr_) / mass_;
+    matrix_a_(3, 2) = (lf_ * cf_ - lr_ * cr_) / iz_;
+    matrix_a_coeff_(1, 1) = -(cf_ + cr_) / mass_;
+    matrix_a_coeff_(1, 3) = (lr_ * cr_ - lf_ * cf_) / mass_;
+    matrix_a_coeff_(3, 1) = (lr_ * cr_ - lf_ * cf_) / iz_;
+    matrix_a_coeff_(3, 3) = -1.0 * (lf_ * lf_ * cf_ + lr_ * lr_ * cr_) / iz_;
+
+    /*
+    b = [0.0, c_f / m, 0.0, l_f * c_f / i_z]^T
+    */
+    matrix_b_(1, 0) = cf_ / mass_;
+    matrix_b_(3, 0) = lf_ * cf_ / iz_;
+    matrix_bd_ = matrix_b_ * ts_;
+}
+
+void LatController::UpdateMatrixQ(const bool reverse, const double speed)
+{
+    // Adjust matrix_q_updated when in reverse gear
+    int q_param_size = control_conf_->lat_controller_conf().matrix_q_size();
+    int reverse_q_param_size =
+            control_conf_->lat_controller_conf().reverse_matrix_q_size();
+    if (reverse)
+    {
+        for (int i = 0; i < reverse_q_param_size; ++i)
+        {
+            matrix_q_(i, i) =
+                    control_conf_->lat_controller_conf().reverse_matrix_q(i);
+        }
+    }
+    else
+    {
+        for (int i = 0; i < q_param_size; ++i)
+        {
+            matrix_q_(i, i) = control_conf_->lat_controller_conf().matrix_q(i);
+        }
+    }
+
+    // Add gain scheduler for higher speed steering
+    if (FLAGS_enable_gain_scheduler)
+    {
+        matrix_q_updated_(0, 0) =
+                matrix_q_(0, 0) * lat_err_interpolation_->Interpolate(speed);
+        matrix_q_updated_(2, 2) =
+                matrix_q_(2, 2) * heading_err_interpolation_->Interpolate(speed);
+    }
+}
+
+void LatController::BuildGainTables()
+{
+    drive_gain_table_.Clear();
+    reverse_gain_table_.Clear();
+    if (!FLAGS_enable_lat_controller_gain_table)
+    {
+        return;
+    }
+
+    // The lateral model only depends on the gear and the speed, the table of
+    // each driving direction is indexed by the speed along it.
+    const auto start_time = Clock::Now();
+    gain_table_gain_scheduler_ = FLAGS_enable_gain_scheduler;
+    gain_table_reverse_heading_ = FLAGS_reverse_heading_control;
+    for (const bool reverse : {false, true})
+    {
+        auto solver = [this, reverse](double speed, Matrix *gain)
+        {
+            // same model as ComputeControlCommand at this gear and speed
+            UpdateDynamicModel(reverse);
+            if (reverse && FLAGS_reverse_heading_control)
+            {
+                matrix_bd_ = -matrix_b_ * ts_;
+            }
+            UpdateMatrix(reverse, reverse ? -speed : speed);
+            UpdateMatrixCompound();
+            UpdateMatrixQ(reverse, speed);
+            // Solved from scratch like the online solver. With the loose
+            // tolerance of the lqr conf, starting from the neighbouring speed
+            // would stop early and drag its error along the table.
+            common::math::SolveLQRProblem(
+                    matrix_adc_, matrix_bdc_,
+                    FLAGS_enable_gain_scheduler ? matrix_q_updated_
+                                                : matrix_q_,
+                    matrix_r_, lqr_eps_, lqr_max_iteration_, gain);
+        };
+        LqrGainTable *table =
+                reverse ? &reverse_gain_table_ : &drive_gain_table_;
+        table->Build(0.0, FLAGS_lat_controller_gain_table_max_speed,
+                     FLAGS_lat_controller_gain_table_speed_step, solver);
+    }
+    // leave the forward driving model of Init behind
+    UpdateDynamicModel(false);
+
+    AINFO << "Lateral LQR gain tables solved up to "
+          << drive_gain_table_.max_speed() << " m/s in "
+          << (Clock::Now() - start_time).ToSecond() * 1e3 << " ms";
+}
+
+void LatController::ComputeFeedbackGain(const bool reverse,
+                                        const double linear_velocity)
+{
+    const bool use_gain_table =
+            FLAGS_enable_lat_controller_gain_table &&
+            gain_table_gain_scheduler_ == FLAGS_enable_gain_scheduler &&
+            gain_table_reverse_heading_ == FLAGS_reverse_heading_control;
+    const LqrGainTable &table =
+            reverse ? reverse_gain_table_ : drive_gain_table_;
+    if (use_gain_table &&
+        table.Lookup(reverse ? -linear_velocity : linear_velocity, &matrix_k_))
+    {
+        return;
+    }
+
+    // Out of the table, solve online from scratch like the table build
+    UpdateMatrix(reverse, linear_velocity);
+
+    // Compound discrete matrix with road preview model
+    UpdateMatrixCompound();
+
+    UpdateMatrixQ(reverse, std::fabs(linear_velocity));
+
+    (this->*lqr_solver_)(FLAGS_enable_gain_scheduler ? matrix_q_updated_
+                                                     : matrix_q_);
+}
+
+template <int N>
+void LatController::SolveFixedSizeLqr(const Matrix &matrix_q)
+{
+    // copies on the stack, Eigen does not allocate for fixed sizes
+    const Eigen::Matrix<double, N, N> matrix_a = matrix_adc_;
+    const Eigen::Matrix<double, N, 1> matrix_b = matrix_bdc_;
+    const Eigen::Matrix<double, N, N> matrix_q_fixed = matrix_q;
+    const Eigen::Matrix<double, 1, 1> matrix_r = matrix_r_;
+    Eigen::Matrix<double, 1, N> matrix_k;
+    common::math::SolveLQRProblem<N, 1>(matrix_a, matrix_b, matrix_q_fixed,
+                                        matrix_r, lqr_eps_, lqr_max_iteration_,
+                                        &matrix_k);
+    // same size as the dynamic member, which keeps its storage
+    matrix_k_ = matrix_k;
+}
+
+void LatController::SolveDynamicSizeLqr(const Matrix &matrix_q)
+{
+    common::math::SolveLQRProblem(matrix_adc_, matrix_bdc_, matrix_q, matrix_r_,
+                                  lqr_eps_, lqr_max_iteration_, &matrix_k_);
+}
+
 void LatController::UpdateMatrixCompound()
 {
     // Initialize preview matrix
@@ -32,6 +32,7 @@
 #include "modules/common/filters/mean_filter.h"
 #include "modules/control/common/interpolation_1d.h"
 #include "modules/control/common/leadlag_controller.h"
+#include "modules/control/common/lqr_gain_table.h"
 #include "modules/control/common/mrac_controller.h"
 #include "modules/control/common/trajectory_analyzer.h"
 #include "modules/control/controller/controller.h"
@@ -112,8 +113,33 @@ protected:
 
     void UpdateMatrix();
 
+    void UpdateMatrix(const bool reverse, const double linear_velocity);
+
     void UpdateMatrixCompound();
 
+    // update the dynamic model of the gear, cf_ and cr_ change sign in reverse
+    void UpdateDynamicModel(const bool reverse);
+
+    // update the state weighting of the gear, with the gain scheduler
+    // applied at speed if enabled
+    void UpdateMatrixQ(const bool reverse, const double speed);
+
+    // solve the gain tables of both driving directions
+    void BuildGainTables();
+
+    // set matrix_k_ from the gain tables, or solve it online if the vehicle
+    // state is out of the tables
+    void ComputeFeedbackGain(const bool reverse, const double linear_velocity);
+
+    // solve matrix_k_ of the compound model online, on fixed
+    // size matrices of the compound state size N
+    template <int N>
+    void SolveFixedSizeLqr(const Eigen::MatrixXd &matrix_q);
+
+    // same on dynamic size matrices, for preview windows without a fixed size
+    // specialization
+    void SolveDynamicSizeLqr(const Eigen::MatrixXd &matrix_q);
+
     double ComputeFeedForward(double ref_curvature) const;
 
     void ComputeLateralErrors(const double x, const double y,
@@ -178,17 +204,17 @@ protected:
 
     // number of states without previews, includes
     // lateral error, lateral error rate, heading error, heading error rate
-    const int basic_state_size_ = 4;
+    static constexpr int basic_state_size_ = 4;
     // vehicle state matrix
-    Eigen::MatrixXd matrix_a_;
+    Eigen::Matrix4d matrix_a_;
     // vehicle state matrix (discrete-time)
-    Eigen::MatrixXd matrix_ad_;
+    Eigen::Matrix4d matrix_ad_;
     // vehicle state matrix compound; related to preview
     Eigen::MatrixXd matrix_adc_;
     // control matrix
-    Eigen::MatrixXd matrix_b_;
+    Eigen::Vector4d matrix_b_;
     // control matrix (discrete-time)
-    Eigen::MatrixXd matrix_bd_;
+    Eigen::Vector4d matrix_bd_;
     // control matrix compound
     Eigen::MatrixXd matrix_bdc_;
     // gain matrix
@@ -200,7 +226,7 @@ protected:
     // updated state weighting matrix
     Eigen::MatrixXd matrix_q_updated_;
     // vehicle state matrix coefficients
-    Eigen::MatrixXd matrix_a_coeff_;
+    Eigen::Matrix4d matrix_a_coeff_;
     // 4 by 1 matrix; state matrix
     Eigen::MatrixXd matrix_state_;
 
@@ -208,6 +234,16 @@ protected:
     int lqr_max_iteration_ = 0;
     // parameters for lqr solver; threshold for computation
     double lqr_eps_ = 0.0;
+    // online lqr solver of the compound state size, chosen at Init
+    void (LatController::*lqr_solver_)(const Eigen::MatrixXd &matrix_q) =
+            &LatController::SolveDynamicSizeLqr;
+
+    // lqr gains indexed by speed along the driving direction
+    LqrGainTable drive_gain_table_;
+    LqrGainTable reverse_gain_table_;
+    // flags the gain tables were solved with
+    bool gain_table_gain_scheduler_ = false;
+    bool gain_table_reverse_heading_ = false;
 
     common::DigitalFilter digital_filter_;
 
@@ -195,8 +195,8 @@ Status MPCController::Init(std::shared_ptr<DependencyInjector> injector,
     }
     injector_ = injector;
     // Matrix init operations.
-    matrix_a_ = Matrix::Zero(basic_state_size_, basic_state_size_);
-    matrix_ad_ = Matrix::Zero(basic_state_size_, basic_state_size_);
+    matrix_a_.setZero();
+    matrix_ad_.setZero();
     matrix_a_(0, 1) = 1.0;
     matrix_a_(1, 2) = (cf_ + cr_) / mass_;
     matrix_a_(2, 3) = 1.0;
@@ -205,30 +205,29 @@ Status MPCController::Init(std::shared_ptr<DependencyInjector> injector,
     matrix_a_(5, 5) = 0.0;
     // TODO(QiL): expand the model to accommodate more combined states.
 
-    matrix_a_coeff_ = Matrix::Zero(basic_state_size_, basic_state_size_);
+    matrix_a_coeff_.setZero();
     matrix_a_coeff_(1, 1) = -(cf_ + cr_) / mass_;
     matrix_a_coeff_(1, 3) = (lr_ * cr_ - lf_ * cf_) / mass_;
     matrix_a_coeff_(2, 3) = 1.0;
     matrix_a_coeff_(3, 1) = (lr_ * cr_ - lf_ * cf_) / iz_;
     matrix_a_coeff_(3, 3) = -1.0 * (lf_ * lf_ * cf_ + lr_ * lr_ * cr_) / iz_;
 
-    matrix_b_ = Matrix::Zero(basic_state_size_, controls_);
-    matrix_bd_ = Matrix::Zero(basic_state_size_, controls_);
+    matrix_b_.setZero();
     matrix_b_(1, 0) = cf_ / mass_;
     matrix_b_(3, 0) = lf_ * cf_ / iz_;
     matrix_b_(4, 1) = 0.0;
     matrix_b_(5, 1) = -1.0;
     matrix_bd_ = matrix_b_ * ts_;
 
-    matrix_c_ = Matrix::Zero(basic_state_size_, 1);
-    matrix_cd_ = Matrix::Zero(basic_state_size_, 1);
+    matrix_c_.setZero();
+    matrix_cd_.setZero();
 
-    matrix_state_ = Matrix::Zero(basic_state_size_, 1);
-    matrix_k_ = Matrix::Zero(1, basic_state_size_);
+    matrix_state_.setZero();
+    matrix_k_.setZero();
 
-    matrix_r_ = Matrix::Identity(controls_, controls_);
+    matrix_r_.setIdentity();
 
-    matrix_q_ = Matrix::Zero(basic_state_size_, basic_state_size_);
+    matrix_q_.setZero();
 
     int r_param_size = control_conf->mpc_controller_conf().matrix_r_size();
     for (int i = 0; i < r_param_size; ++i)
@@ -430,27 +429,22 @@ Status MPCController::ComputeControlCommand(
     debug->add_matrix_r_updated(matrix_r_updated_(0, 0));
     debug->add_matrix_r_updated(matrix_r_updated_(1, 1));
 
-    Matrix control_matrix = Matrix::Zero(controls_, 1);
-    std::vector<Matrix> control(horizon_, control_matrix);
+    // only the first step of the horizon is applied
+    ControlVector control = ControlVector::Zero();
+    const GainMatrix control_gain = GainMatrix::Zero();
+    const ControlVector addition_gain = ControlVector::Zero();
 
-    Matrix control_gain_matrix = Matrix::Zero(controls_, basic_state_size_);
-    std::vector<Matrix> control_gain(horizon_, control_gain_matrix);
+    const StateVector reference_state = StateVector::Zero();
 
-    Matrix addition_gain_matrix = Matrix::Zero(controls_, 1);
-    std::vector<Matrix> addition_gain(horizon_, addition_gain_matrix);
-
-    Matrix reference_state = Matrix::Zero(basic_state_size_, 1);
-    std::vector<Matrix> reference(horizon_, reference_state);
-
-    Matrix lower_bound(controls_, 1);
+    ControlVector lower_bound;
     lower_bound << -wheel_single_direction_max_degree_, max_deceleration_;
 
-    Matrix upper_bound(controls_, 1);
+    ControlVector upper_bound;
     upper_bound << wheel_single_direction_max_degree_, max_acceleration_;
 
     const double max = std::numeric_limits<double>::max();
-    Matrix lower_state_bound(basic_state_size_, 1);
-    Matrix upper_state_bound(basic_state_size_, 1);
+    StateVector lower_state_bound;
+    StateVector upper_state_bound;
 
     // lateral_error, lateral_error_rate, heading_error, heading_error_rate
     // station_error, station_error_rate
@@ -481,42 +475,42 @@ Status MPCController::ComputeControlCommand(
     else
     {
         ADEBUG << "MPC OSQP problem solved! ";
-        control[0](0, 0) = control_cmd.at(0);
-        control[0](1, 0) = control_cmd.at(1);
+        control(0, 0) = control_cmd.at(0);
+        control(1, 0) = control_cmd.at(1);
     }
 
-    steer_angle_feedback = Wheel2SteerPct(control[0](0, 0));
-    acc_feedback = control[0](1, 0);
+    steer_angle_feedback = Wheel2SteerPct(control(0, 0));
+    acc_feedback = control(1, 0);
 
     for (int i = 0; i < basic_state_size_; ++i)
     {
-        unconstrained_control += control_gain[0](0, i) * matrix_state_(i, 0);
+        unconstrained_control += control_gain(0, i) * matrix_state_(i, 0);
     }
-    unconstrained_control += addition_gain[0](0, 0) * v * debug->curvature();
+    unconstrained_control += addition_gain(0, 0) * v * debug->curvature();
 
     // default value is 0
     if (enable_mpc_feedforward_compensation_)
     {
         unconstrained_control_diff =
-                Wheel2SteerPct(control[0](0, 0) - unconstrained_control);
+                Wheel2SteerPct(control(0, 0) - unconstrained_control);
         if (fabs(unconstrained_control_diff) <=
             unconstrained_control_diff_limit_)
         {
             steer_angle_ff_compensation = Wheel2SteerPct(
                     debug->curvature() *
-                    (control_gain[0](0, 2) *
+                    (control_gain(0, 2) *
                              (lr_ - lf_ / cr_ * mass_ * v * v / wheelbase_) -
-                     addition_gain[0](0, 0) * v));
+                     addition_gain(0, 0) * v));
         }
         else
         {
             control_gain_truncation_ratio =
-                    control[0](0, 0) / unconstrained_control;
+                    control(0, 0) / unconstrained_control;
             steer_angle_ff_compensation = Wheel2SteerPct(
                     debug->curvature() *
-                    (control_gain[0](0, 2) *
+                    (control_gain(0, 2) *
                              (lr_ - lf_ / cr_ * mass_ * v * v / wheelbase_) -
-                     addition_gain[0](0, 0) * v) *
+                     addition_gain(0, 0) * v) *
                     control_gain_truncation_ratio);
         }
     }
@@ -773,7 +767,7 @@ void MPCController::UpdateMatrix(SimpleMPCDebug* debug)
     matrix_a_(3, 1) = matrix_a_coeff_(3, 1) / v;
     matrix_a_(3, 3) = matrix_a_coeff_(3, 3) / v;
 
-    Matrix matrix_i = Matrix::Identity(matrix_a_.cols(), matrix_a_.cols());
+    const StateMatrix matrix_i = StateMatrix::Identity();
     matrix_ad_ = (matrix_i - ts_ * 0.5 * matrix_a_).inverse() *
                  (matrix_i + ts_ * 0.5 * matrix_a_);
 
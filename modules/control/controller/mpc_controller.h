@@ -182,40 +182,49 @@ protected:
     // number of states, includes
     // lateral error, lateral error rate, heading error, heading error rate,
     // station error, velocity error,
-    const int basic_state_size_ = 6;
+    static constexpr int basic_state_size_ = 6;
 
-    const int controls_ = 2;
+    static constexpr int controls_ = 2;
 
     const int horizon_ = 10;
+    // the model has fixed sizes, so do its matrices
+    using StateMatrix =
+            Eigen::Matrix<double, basic_state_size_, basic_state_size_>;
+    using ControlMatrix = Eigen::Matrix<double, basic_state_size_, controls_>;
+    using StateVector = Eigen::Matrix<double, basic_state_size_, 1>;
+    using ControlVector = Eigen::Matrix<double, controls_, 1>;
+    using ControlWeightMatrix = Eigen::Matrix<double, controls_, controls_>;
+    using GainMatrix = Eigen::Matrix<double, controls_, basic_state_size_>;
+
     // vehicle state matrix
-    Eigen::MatrixXd matrix_a_;
+    StateMatrix matrix_a_;
     // vehicle state matrix (discrete-time)
-    Eigen::MatrixXd matrix_ad_;
+    StateMatrix matrix_ad_;
 
     // control matrix
-    Eigen::MatrixXd matrix_b_;
+    ControlMatrix matrix_b_;
     // control matrix (discrete-time)
-    Eigen::MatrixXd matrix_bd_;
+    ControlMatrix matrix_bd_;
 
     // offset matrix
-    Eigen::MatrixXd matrix_c_;
+    StateVector matrix_c_;
     // offset matrix (discrete-time)
-    Eigen::MatrixXd matrix_cd_;
+    StateVector matrix_cd_;
 
     // gain matrix
-    Eigen::MatrixXd matrix_k_;
+    Eigen::Matrix<double, 1, basic_state_size_> matrix_k_;
     // control authority weighting matrix
-    Eigen::MatrixXd matrix_r_;
+    ControlWeightMatrix matrix_r_;
     // updated control authority weighting matrix
-    Eigen::MatrixXd matrix_r_updated_;
+    ControlWeightMatrix matrix_r_updated_;
     // state weighting matrix
-    Eigen::MatrixXd matrix_q_;
+    StateMatrix matrix_q_;
     // updated state weighting matrix
-    Eigen::MatrixXd matrix_q_updated_;
+    StateMatrix matrix_q_updated_;
     // vehicle state matrix coefficients
-    Eigen::MatrixXd matrix_a_coeff_;
-    // 4 by 1 matrix; state matrix
-    Eigen::MatrixXd matrix_state_;
+    StateMatrix matrix_a_coeff_;
+    // 6 by 1 matrix; state matrix
+    StateVector matrix_state_;
 
     // heading error of last control cycle
     double previous_heading_error_ = 0.0;
@@ -21,6 +21,7 @@
 //#include "modules/common/latency_recorder/latency_recorder.h"
 #include "modules/common/vehicle_state/vehicle_state_provider.h"
 #include "modules/control/common/control_gflags.h"
+#include "modules/control/common/control_latency_monitor.h"
 
 namespace apollo
 {
@@ -121,6 +122,8 @@ bool LatLonControllerSubmodule::Proc(
     common::util::FillHeader(Name(), &control_core_command);
 
     const auto end_time = Clock::Now();
+    ControlLatencyMonitor::Instance()->Record(
+            ControlLatencyMonitor::CONTROLLER, start_time, end_time);
 
     // static apollo::common::LatencyRecorder latency_recorder(
     //    FLAGS_control_core_command_topic);
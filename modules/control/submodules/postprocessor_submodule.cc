@@ -27,6 +27,7 @@
 #include "modules/common/adapters/adapter_gflags.h"
 //#include "modules/common/latency_recorder/latency_recorder.h"
 #include "modules/control/common/control_gflags.h"
+#include "modules/control/common/control_latency_monitor.h"
 
 namespace apollo
 {
@@ -52,6 +53,10 @@ bool PostprocessorSubmodule::Init()
     postprocessor_writer_ =
             node_->CreateWriter<ControlCommand>(FLAGS_control_command_topic);
     ACHECK(postprocessor_writer_ != nullptr);
+
+    latency_writer_ = node_->CreateWriter<planning::LatencyStats>(
+            FLAGS_control_latency_topic);
+    ACHECK(latency_writer_ != nullptr);
     return true;
 }
 
@@ -92,6 +97,16 @@ bool PostprocessorSubmodule::Proc(
 
     postprocessor_writer_->Write(control_command);
 
+    // the postprocessor ends the cycle started by the preprocessor
+    auto *latency_monitor = ControlLatencyMonitor::Instance();
+    latency_monitor->Record(ControlLatencyMonitor::POSTPROCESSOR, start_time,
+                            end_time);
+    if (latency_monitor->EndCycle(control_common_conf_.control_period() * 1e3,
+                                  &latency_summary_))
+    {
+        latency_writer_->Write(latency_summary_);
+    }
+
     return true;
 }
 
@@ -66,6 +66,8 @@ public:
 
 private:
     std::shared_ptr<cyber::Writer<ControlCommand>> postprocessor_writer_;
+    std::shared_ptr<cyber::Writer<planning::LatencyStats>> latency_writer_;
+    planning::LatencyStats latency_summary_;
     ControlCommonConf control_common_conf_;
 };
 
@@ -27,6 +27,7 @@
 //#include "modules/common/latency_recorder/latency_recorder.h"
 #include "modules/common/vehicle_state/vehicle_state_provider.h"
 #include "modules/control/common/control_gflags.h"
+#include "modules/control/common/control_latency_monitor.h"
 
 namespace apollo
 {
@@ -72,6 +73,11 @@ bool PreprocessorSubmodule::Proc(const std::shared_ptr<LocalView> &local_view)
 {
     ADEBUG << "Preprocessor started ....";
     const auto start_time = Clock::Now();
+    auto *latency_monitor = ControlLatencyMonitor::Instance();
+    latency_monitor->BeginCycle();
+    latency_monitor->RecordInputAges(local_view->chassis().header(),
+                                     local_view->localization().header(),
+                                     local_view->trajectory().header());
 
     Preprocessor control_preprocessor;
     // handling estop
@@ -117,6 +123,8 @@ bool PreprocessorSubmodule::Proc(const std::shared_ptr<LocalView> &local_view)
     common::util::FillHeader(Name(), &control_preprocessor);
 
     const auto end_time = Clock::Now();
+    latency_monitor->Record(ControlLatencyMonitor::PREPROCESSOR, start_time,
+                            end_time);
 
     // static apollo::common::LatencyRecorder latency_recorder(
     //    FLAGS_control_preprocessor_topic);
@@ -0,0 +1,698 @@
+/******************************************************************************
+ * Copyright 2023 The Apollo Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *****************************************************************************/
+
+/**
+ * @file
+ * @brief Headless closed-loop simulation of the control module against the
+ * virtual chassis, faster than real time and many scenarios in parallel, to
+ * tune controller gains offline. Usage:
+ *   closed_loop_sim [--sim_config_dir=./../modules]
+ *       [--sim_trajectory_files=a.pb.txt,b.pb.txt]
+ *       [--sim_num_synthetic_scenarios=1000] [--sim_controllers=lat_lon|mpc]
+ *       [--sim_threads=0] [--sim_result_file=result.csv]
+ * Every recorded trajectory is run --sim_perturbations_per_trajectory times
+ * from a perturbed initial pose, synthetic trajectories are straight roads,
+ * curves, s-curves and lane changes at random speeds.
+ *
+ * All scenarios advance in lock step on the mocked cyber clock, so that the
+ * controllers see consistent message timestamps while the simulation runs as
+ * fast as the cores allow.
+ */
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <condition_variable>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "absl/strings/str_split.h"
+#include "gflags/gflags.h"
+
+#include "cyber/common/file.h"
+#include "cyber/common/log.h"
+#include "cyber/time/clock.h"
+#include "modules/chassis/virtual_chassis.h"
+#include "modules/common/configs/config_gflags.h"
+#include "modules/common/configs/vehicle_config_helper.h"
+#include "modules/common/math/math_utils.h"
+#include "modules/control/common/control_gflags.h"
+#include "modules/control/common/dependency_injector.h"
+#include "modules/control/controller/controller_agent.h"
+
+DEFINE_string(sim_config_dir, "./../modules",
+              "module directory holding control/conf and common/data");
+DEFINE_string(sim_trajectory_files, "",
+              "comma separated recorded ADCTrajectory files");
+DEFINE_int32(sim_perturbations_per_trajectory, 10,
+             "number of perturbed initial poses per recorded trajectory");
+DEFINE_int32(sim_num_synthetic_scenarios, 1000,
+             "number of synthetic scenarios");
+DEFINE_string(sim_controllers, "",
+              "lat_lon or mpc, the active controllers of the config if empty");
+DEFINE_double(sim_duration, 30.0, "simulated time of each scenario in second");
+DEFINE_int32(sim_threads, 0, "number of worker threads, all cores if 0");
+DEFINE_int32(sim_seed, 1, "seed of the scenario generator");
+DEFINE_double(sim_min_speed, 2.0,
+              "minimal cruise speed of synthetic scenarios");
+DEFINE_double(sim_max_speed, 20.0,
+              "maximal cruise speed of synthetic scenarios");
+DEFINE_double(sim_max_initial_lateral_error, 0.5,
+              "maximal lateral offset of the initial pose");
+DEFINE_double(sim_max_initial_heading_error, 0.05,
+              "maximal heading offset of the initial pose in radian");
+DEFINE_double(sim_diverged_lateral_error, 3.0,
+              "a scenario fails once the lateral error exceeds this");
+DEFINE_string(sim_result_file, "", "per scenario results in csv, optional");
+
+namespace apollo
+{
+namespace control
+{
+namespace
+{
+using apollo::common::TrajectoryPoint;
+
+struct Scenario
+{
+    std::string name;
+    planning::ADCTrajectory trajectory;
+    double lateral_offset = 0.0;
+    double heading_offset = 0.0;
+    int num_steps = 0;
+};
+
+struct ScenarioResult
+{
+    int num_steps = 0;
+    bool failed = false;
+    double lateral_error_sum_sqr = 0.0;
+    double lateral_error_max = 0.0;
+    double heading_error_max = 0.0;
+    double station_error_sum_sqr = 0.0;
+    double station_error_max = 0.0;
+    double speed_error_sum_sqr = 0.0;
+    double compute_ms_sum = 0.0;
+    double compute_ms_max = 0.0;
+
+    double Rms(const double sum_sqr) const
+    {
+        return num_steps > 0 ? std::sqrt(sum_sqr / num_steps) : 0.0;
+    }
+};
+
+// Curvature along the path of a synthetic scenario.
+enum class RoadShape
+{
+    STRAIGHT = 0,
+    CURVE,
+    S_CURVE,
+    LANE_CHANGE,
+    NUM_SHAPES
+};
+
+const char *RoadShapeName(const RoadShape shape)
+{
+    switch (shape)
+    {
+        case RoadShape::STRAIGHT:
+            return "straight";
+        case RoadShape::CURVE:
+            return "curve";
+        case RoadShape::S_CURVE:
+            return "s_curve";
+        case RoadShape::LANE_CHANGE:
+            return "lane_change";
+        default:
+            return "unknown";
+    }
+}
+
+struct RoadProfile
+{
+    RoadShape shape = RoadShape::STRAIGHT;
+    // peak curvature of curves, lateral shift of lane changes
+    double amplitude = 0.0;
+    // curve entry, s-curve period, lane change distance
+    double length = 0.0;
+
+    double Kappa(const double s) const
+    {
+        constexpr double kStart = 20.0;
+        const double u = s - kStart;
+        switch (shape)
+        {
+            case RoadShape::CURVE:
+            {
+                // smooth entry into a constant curvature
+                const double ratio = common::math::Clamp(u / length, 0.0, 1.0);
+                return amplitude * ratio * ratio * (3.0 - 2.0 * ratio);
+            }
+            case RoadShape::S_CURVE:
+                return u > 0.0 ? amplitude * std::sin(2.0 * M_PI * u / length)
+                               : 0.0;
+            case RoadShape::LANE_CHANGE:
+                // one period of a sine shifts the path sideways by
+                // amplitude, for small heading changes
+                return u > 0.0 && u < length
+                               ? 2.0 * M_PI * amplitude / (length * length) *
+                                         std::sin(2.0 * M_PI * u / length)
+                               : 0.0;
+            default:
+                return 0.0;
+        }
+    }
+};
+
+planning::ADCTrajectory BuildTrajectory(const RoadProfile &road,
+                                        const double init_speed,
+                                        const double cruise_speed,
+                                        const double horizon)
+{
+    constexpr double kDt = 0.05;
+    constexpr int kSubSteps = 10;
+    constexpr double kMaxAcc = 1.0;
+
+    planning::ADCTrajectory trajectory;
+    double x = 0.0;
+    double y = 0.0;
+    double theta = 0.0;
+    double s = 0.0;
+    double v = init_speed;
+    for (double t = 0.0; t <= horizon; t += kDt)
+    {
+        const double a = common::math::Clamp((cruise_speed - v) / kDt,
+                                             -kMaxAcc, kMaxAcc);
+        auto *point = trajectory.add_trajectory_point();
+        point->set_relative_time(t);
+        point->set_v(v);
+        point->set_a(a);
+        auto *path_point = point->mutable_path_point();
+        path_point->set_x(x);
+        path_point->set_y(y);
+        path_point->set_theta(common::math::NormalizeAngle(theta));
+        path_point->set_kappa(road.Kappa(s));
+        path_point->set_dkappa((road.Kappa(s + 0.1) - road.Kappa(s)) / 0.1);
+        path_point->set_s(s);
+
+        for (int i = 0; i < kSubSteps; ++i)
+        {
+            const double dt = kDt / kSubSteps;
+            const double ds = (v + 0.5 * a * dt) * dt;
+            theta += road.Kappa(s + 0.5 * ds) * ds;
+            x += std::cos(theta) * ds;
+            y += std::sin(theta) * ds;
+            s += ds;
+            v = std::max(v + a * dt, 0.0);
+        }
+    }
+    return trajectory;
+}
+
+void GenerateScenarios(const int num_steps, std::vector<Scenario> *scenarios)
+{
+    std::mt19937 rng(FLAGS_sim_seed);
+    std::uniform_real_distribution<double> unit(0.0, 1.0);
+    auto uniform = [&rng, &unit](const double low, const double high) {
+        return low + (high - low) * unit(rng);
+    };
+    auto perturb = [&uniform](Scenario *scenario) {
+        scenario->lateral_offset = uniform(-FLAGS_sim_max_initial_lateral_error,
+                                           FLAGS_sim_max_initial_lateral_error);
+        scenario->heading_offset = uniform(-FLAGS_sim_max_initial_heading_error,
+                                           FLAGS_sim_max_initial_heading_error);
+    };
+
+    for (const auto &file_name :
+         absl::StrSplit(FLAGS_sim_trajectory_files, ',', absl::SkipEmpty()))
+    {
+        Scenario scenario;
+        scenario.name = std::string(file_name);
+        if (!cyber::common::GetProtoFromFile(scenario.name,
+                                             &scenario.trajectory) ||
+            scenario.trajectory.trajectory_point_size() < 2)
+        {
+            AERROR << "Skip unusable trajectory " << scenario.name;
+            continue;
+        }
+        // run until the end of the recorded trajectory at most
+        const auto &points = scenario.trajectory.trajectory_point();
+        const double duration = points.rbegin()->relative_time() -
+                                points.begin()->relative_time();
+        scenario.num_steps = std::min(
+                num_steps, static_cast<int>(duration / FLAGS_sim_duration *
+                                            num_steps));
+        for (int i = 0; i < FLAGS_sim_perturbations_per_trajectory; ++i)
+        {
+            perturb(&scenario);
+            scenarios->push_back(scenario);
+        }
+    }
+
+    // the trajectory reaches past the end of the simulation, as a planning
+    // trajectory always has some time left
+    const double horizon = FLAGS_sim_duration + 8.0;
+    for (int i = 0; i < FLAGS_sim_num_synthetic_scenarios; ++i)
+    {
+        RoadProfile road;
+        road.shape = static_cast<RoadShape>(
+                i % static_cast<int>(RoadShape::NUM_SHAPES));
+        const double cruise_speed =
+                uniform(FLAGS_sim_min_speed, FLAGS_sim_max_speed);
+        // lateral acceleration up to 2 m/s^2 on curves
+        const double max_kappa = std::min(
+                2.0 / (cruise_speed * cruise_speed), 0.2);
+        switch (road.shape)
+        {
+            case RoadShape::CURVE:
+                road.amplitude = uniform(-max_kappa, max_kappa);
+                road.length = uniform(10.0, 40.0);
+                break;
+            case RoadShape::S_CURVE:
+                road.amplitude = uniform(-max_kappa, max_kappa);
+                road.length = uniform(40.0, 150.0);
+                break;
+            case RoadShape::LANE_CHANGE:
+                road.amplitude = uniform(-3.5, 3.5);
+                road.length = std::max(uniform(2.0, 4.0) * cruise_speed, 15.0);
+                break;
+            default:
+                break;
+        }
+
+        Scenario scenario;
+        scenario.name = std::string(RoadShapeName(road.shape)) + "_" +
+                        std::to_string(i);
+        scenario.trajectory = BuildTrajectory(
+                road, cruise_speed * uniform(0.5, 1.0), cruise_speed, horizon);
+        scenario.num_steps = num_steps;
+        perturb(&scenario);
+        scenarios->push_back(std::move(scenario));
+    }
+
+    for (size_t i = 0; i < scenarios->size(); ++i)
+    {
+        (*scenarios)[i].trajectory.mutable_header()->set_sequence_num(
+                static_cast<unsigned int>(i + 1));
+    }
+}
+
+/**
+ * @brief One scenario in simulation: the controllers of the config and a
+ * virtual chassis, the same steps as ControlComponent does on every cycle.
+ */
+class ScenarioRunner
+{
+public:
+    ScenarioRunner(const Scenario *scenario, const ControlConf *control_conf,
+                   const double period) :
+        scenario_(scenario),
+        injector_(std::make_shared<DependencyInjector>())
+    {
+        ACHECK(agent_.Init(injector_, control_conf).ok())
+                << "Failed to init the controllers";
+
+        const auto &start = scenario_->trajectory.trajectory_point(0);
+        const double theta = start.path_point().theta();
+        chassis_.Init(common::VehicleConfigHelper::GetConfig().vehicle_param());
+        chassis_.SetCommondTimeInterval(period);
+        chassis_.SetInitChassisState(
+                start.path_point().x() -
+                        std::sin(theta) * scenario_->lateral_offset,
+                start.path_point().y() +
+                        std::cos(theta) * scenario_->lateral_offset,
+                0.0,
+                common::math::NormalizeAngle(theta +
+                                             scenario_->heading_offset));
+        chassis_.state_.v_ = start.v();
+        chassis_.history_state_ = chassis_.state_;
+
+        localization_ = std::make_shared<localization::LocalizationEstimate>();
+        chassis_msg_ = std::make_shared<canbus::Chassis>();
+    }
+
+    bool done() const
+    {
+        return result_.failed || result_.num_steps >= scenario_->num_steps;
+    }
+
+    const ScenarioResult &result() const { return result_; }
+
+    void Step(const double now)
+    {
+        chassis_.PublishLocalization(localization_, now);
+        // control does not use the acceleration and angular velocity of
+        // localization, same as ControlComponent::PrepareLocalization
+        auto *pose = localization_->mutable_pose();
+        for (auto *vector : {pose->mutable_linear_acceleration(),
+                             pose->mutable_linear_acceleration_vrf(),
+                             pose->mutable_angular_velocity(),
+                             pose->mutable_angular_velocity_vrf()})
+        {
+            vector->set_x(0.0);
+            vector->set_y(0.0);
+            vector->set_z(0.0);
+        }
+        chassis_.PublishChassis(now, chassis_msg_);
+        chassis_msg_->set_driving_mode(canbus::Chassis::COMPLETE_AUTO_DRIVE);
+
+        injector_->vehicle_state()->Update(*localization_, *chassis_msg_);
+
+        ControlCommand command;
+        const auto start_time = std::chrono::steady_clock::now();
+        agent_.ComputeControlCommand(localization_.get(), chassis_msg_.get(),
+                                     &scenario_->trajectory, &command);
+        const double compute_ms =
+                std::chrono::duration<double, std::milli>(
+                        std::chrono::steady_clock::now() - start_time)
+                        .count();
+
+        Accumulate(command, compute_ms);
+
+        CanCommond can_command;
+        apollo_control_msg_to_virtual_chassis_control_msg(&can_command,
+                                                          command);
+        chassis_.SetInput(can_command);
+        chassis_.Process();
+    }
+
+private:
+    void Accumulate(const ControlCommand &command, const double compute_ms)
+    {
+        const auto &debug = command.debug();
+        double lateral_error = 0.0;
+        double heading_error = 0.0;
+        double station_error = 0.0;
+        double speed_error = 0.0;
+        if (debug.has_simple_mpc_debug())
+        {
+            lateral_error = debug.simple_mpc_debug().lateral_error();
+            heading_error = debug.simple_mpc_debug().heading_error();
+            station_error = debug.simple_mpc_debug().station_error();
+            speed_error = debug.simple_mpc_debug().speed_error();
+        }
+        if (debug.has_simple_lat_debug())
+        {
+            lateral_error = debug.simple_lat_debug().lateral_error();
+            heading_error = debug.simple_lat_debug().heading_error();
+        }
+        if (debug.has_simple_lon_debug())
+        {
+            station_error = debug.simple_lon_debug().station_error();
+            speed_error = debug.simple_lon_debug().speed_error();
+        }
+
+        ++result_.num_steps;
+        result_.lateral_error_sum_sqr += lateral_error * lateral_error;
+        result_.lateral_error_max =
+                std::max(result_.lateral_error_max, std::fabs(lateral_error));
+        result_.heading_error_max =
+                std::max(result_.heading_error_max, std::fabs(heading_error));
+        result_.station_error_sum_sqr += station_error * station_error;
+        result_.station_error_max =
+                std::max(result_.station_error_max, std::fabs(station_error));
+        result_.speed_error_sum_sqr += speed_error * speed_error;
+        result_.compute_ms_sum += compute_ms;
+        result_.compute_ms_max = std::max(result_.compute_ms_max, compute_ms);
+        if (std::fabs(lateral_error) > FLAGS_sim_diverged_lateral_error)
+        {
+            result_.failed = true;
+        }
+    }
+
+private:
+    const Scenario *scenario_ = nullptr;
+    std::shared_ptr<DependencyInjector> injector_;
+    ControllerAgent agent_;
+    VirtualChassis chassis_;
+    std::shared_ptr<localization::LocalizationEstimate> localization_;
+    std::shared_ptr<canbus::Chassis> chassis_msg_;
+    ScenarioResult result_;
+};
+
+// Lets the workers and the clock owner wait for each other on every step.
+class StepBarrier
+{
+public:
+    explicit StepBarrier(const int num_threads) : num_threads_(num_threads) {}
+
+    void Wait()
+    {
+        std::unique_lock<std::mutex> lock(mutex_);
+        const uint64_t generation = generation_;
+        if (++num_waiting_ == num_threads_)
+        {
+            num_waiting_ = 0;
+            ++generation_;
+            cv_.notify_all();
+            return;
+        }
+        cv_.wait(lock, [this, generation]() {
+            return generation != generation_;
+        });
+    }
+
+private:
+    std::mutex mutex_;
+    std::condition_variable cv_;
+    const int num_threads_;
+    int num_waiting_ = 0;
+    uint64_t generation_ = 0;
+};
+
+double Percentile(std::vector<double> values, const double percentile)
+{
+    if (values.empty())
+    {
+        return 0.0;
+    }
+    const size_t rank = std::min(
+            values.size() - 1,
+            static_cast<size_t>(percentile / 100.0 * values.size()));
+    std::nth_element(values.begin(), values.begin() + rank, values.end());
+    return values[rank];
+}
+
+void Report(const std::vector<Scenario> &scenarios,
+            const std::vector<std::unique_ptr<ScenarioRunner>> &runners,
+            const double wall_time_s, const double period)
+{
+    std::vector<double> lateral_rms;
+    std::vector<double> lateral_max;
+    std::vector<double> heading_max;
+    std::vector<double> station_rms;
+    std::vector<double> speed_rms;
+    std::vector<double> compute_mean;
+    double compute_max = 0.0;
+    int num_failed = 0;
+    int64_t num_steps = 0;
+
+    std::ofstream csv;
+    if (!FLAGS_sim_result_file.empty())
+    {
+        csv.open(FLAGS_sim_result_file);
+        csv << "scenario,failed,steps,lateral_error_rms,lateral_error_max,"
+               "heading_error_max,station_error_rms,station_error_max,"
+               "speed_error_rms,compute_ms_mean,compute_ms_max\n";
+    }
+
+    for (size_t i = 0; i < runners.size(); ++i)
+    {
+        const auto &result = runners[i]->result();
+        num_steps += result.num_steps;
+        if (result.failed)
+        {
+            ++num_failed;
+        }
+        const double mean_ms =
+                result.compute_ms_sum / std::max(result.num_steps, 1);
+        lateral_rms.push_back(result.Rms(result.lateral_error_sum_sqr));
+        lateral_max.push_back(result.lateral_error_max);
+        heading_max.push_back(result.heading_error_max);
+        station_rms.push_back(result.Rms(result.station_error_sum_sqr));
+        speed_rms.push_back(result.Rms(result.speed_error_sum_sqr));
+        compute_mean.push_back(mean_ms);
+        compute_max = std::max(compute_max, result.compute_ms_max);
+
+        if (csv.is_open())
+        {
+            csv << scenarios[i].name << "," << result.failed << ","
+                << result.num_steps << "," << lateral_rms.back() << ","
+                << result.lateral_error_max << "," << result.heading_error_max
+                << "," << station_rms.back() << "," << result.station_error_max
+                << "," << speed_rms.back() << "," << mean_ms << ","
+                << result.compute_ms_max << "\n";
+        }
+    }
+
+    auto report = [](const std::string &name,
+                     const std::vector<double> &values) {
+        AINFO << name << ": p50 " << Percentile(values, 50.0) << ", p95 "
+              << Percentile(values, 95.0) << ", max "
+              << Percentile(values, 100.0);
+    };
+    AINFO << "Simulated " << runners.size() << " scenarios, " << num_failed
+          << " diverged, " << num_steps << " control cycles in "
+          << wall_time_s << " s, "
+          << num_steps * period / std::max(wall_time_s, 1e-9)
+          << " times real time";
+    report("lateral error rms (m)", lateral_rms);
+    report("lateral error max (m)", lateral_max);
+    report("heading error max (rad)", heading_max);
+    report("station error rms (m)", station_rms);
+    report("speed error rms (m/s)", speed_rms);
+    report("controller time mean (ms)", compute_mean);
+    AINFO << "controller time max (ms): " << compute_max;
+}
+
+}  // namespace
+}  // namespace control
+}  // namespace apollo
+
+int main(int argc, char *argv[])
+{
+    google::ParseCommandLineFlags(&argc, &argv, true);
+
+    using apollo::control::ControlConf;
+    using apollo::control::Scenario;
+    using apollo::control::ScenarioRunner;
+
+    // same configuration files as ControlComponent::init
+    const std::string control_dir = FLAGS_sim_config_dir + "/control/conf/";
+    FLAGS_control_conf_file = control_dir + "control_conf.pb.txt";
+    FLAGS_control_common_conf_file = control_dir + "control_common_conf.pb.txt";
+    FLAGS_mpc_controller_conf_file = control_dir + "mpc_controller_conf.pb.txt";
+    FLAGS_lateral_controller_conf_file =
+            control_dir + "lateral_controller_conf.pb.txt";
+    FLAGS_longitudinal_controller_conf_file =
+            control_dir + "longitudinal_controller_conf.pb.txt";
+    FLAGS_calibration_table_file = control_dir + "calibration_table.pb.txt";
+    FLAGS_vehicle_config_path =
+            FLAGS_sim_config_dir + "/common/data/vehicle_param.pb.txt";
+    FLAGS_set_steer_limit = true;
+    FLAGS_enable_maximum_steer_rate_limit = true;
+
+    ControlConf control_conf;
+    if (!apollo::cyber::common::GetProtoFromFile(FLAGS_mpc_controller_conf_file,
+                                                 &control_conf))
+    {
+        AERROR << "Unable to load control conf file: "
+               << FLAGS_mpc_controller_conf_file;
+        return -1;
+    }
+    FLAGS_enable_gain_scheduler = control_conf.enable_gain_scheduler();
+    if (FLAGS_sim_controllers == "lat_lon")
+    {
+        control_conf.clear_active_controllers();
+        control_conf.add_active_controllers(ControlConf::LAT_CONTROLLER);
+        control_conf.add_active_controllers(ControlConf::LON_CONTROLLER);
+    }
+    else if (FLAGS_sim_controllers == "mpc")
+    {
+        control_conf.clear_active_controllers();
+        control_conf.add_active_controllers(ControlConf::MPC_CONTROLLER);
+    }
+    else if (!FLAGS_sim_controllers.empty())
+    {
+        AERROR << "Unknown controllers " << FLAGS_sim_controllers;
+        return -1;
+    }
+
+    // load the vehicle config once before the workers share it
+    apollo::common::VehicleConfigHelper::Init();
+
+    const double period = control_conf.control_period() > 0.0
+                                  ? control_conf.control_period()
+                                  : 0.01;
+    const int num_steps = static_cast<int>(FLAGS_sim_duration / period);
+
+    std::vector<Scenario> scenarios;
+    apollo::control::GenerateScenarios(num_steps, &scenarios);
+    if (scenarios.empty())
+    {
+        AERROR << "No scenario to simulate";
+        return -1;
+    }
+
+    std::vector<std::unique_ptr<ScenarioRunner>> runners;
+    runners.reserve(scenarios.size());
+    for (const auto &scenario : scenarios)
+    {
+        runners.emplace_back(
+                new ScenarioRunner(&scenario, &control_conf, period));
+    }
+
+    // The trajectories are stamped at start_time and every step moves the
+    // mocked clock by one control period.
+    apollo::cyber::Clock::SetMode(apollo::cyber::proto::MODE_MOCK);
+    const double start_time = 1e9;
+    for (auto &scenario : scenarios)
+    {
+        scenario.trajectory.mutable_header()->set_timestamp_sec(start_time);
+    }
+
+    const int num_threads =
+            FLAGS_sim_threads > 0
+                    ? FLAGS_sim_threads
+                    : std::max(1, static_cast<int>(
+                                          std::thread::hardware_concurrency()));
+    apollo::control::StepBarrier barrier(num_threads + 1);
+    std::vector<std::thread> workers;
+    for (int w = 0; w < num_threads; ++w)
+    {
+        workers.emplace_back([w, num_threads, num_steps, period, start_time,
+                              &barrier, &runners]() {
+            for (int step = 0; step < num_steps; ++step)
+            {
+                barrier.Wait();
+                const double now = start_time + step * period;
+                for (size_t i = w; i < runners.size(); i += num_threads)
+                {
+                    if (!runners[i]->done())
+                    {
+                        runners[i]->Step(now);
+                    }
+                }
+                barrier.Wait();
+            }
+        });
+    }
+
+    const auto wall_start = std::chrono::steady_clock::now();
+    for (int step = 0; step < num_steps; ++step)
+    {
+        // the workers are waiting, nobody reads the clock meanwhile
+        apollo::cyber::Clock::SetNowInSeconds(start_time + step * period);
+        barrier.Wait();
+        barrier.Wait();
+    }
+    for (auto &worker : workers)
+    {
+        worker.join();
+    }
+    const double wall_time_s = std::chrono::duration<double>(
+                                       std::chrono::steady_clock::now() -
+                                       wall_start)
+                                       .count();
+
+    apollo::control::Report(scenarios, runners, wall_time_s, period);
+    return 0;
+}
@@ -22,6 +22,7 @@
 #include "modules/planning/common/history.h"
 #include "modules/planning/common/learning_based_data.h"
 #include "modules/planning/common/planning_context.h"
+#include "modules/planning/common/speed/st_boundary_cache.h"
 
 namespace apollo
 {
@@ -43,6 +44,7 @@ public:
         return &vehicle_state_;
     }
     LearningBasedData* learning_based_data() { return &learning_based_data_; }
+    STBoundaryCache* st_boundary_cache() { return &st_boundary_cache_; }
 
 private:
     PlanningContext planning_context_;
@@ -55,6 +57,9 @@ private:
     EgoInfo ego_info_;
     apollo::common::VehicleStateProvider vehicle_state_;
     LearningBasedData learning_based_data_;
+
+    // st boundary overlap points, kept across frames
+    STBoundaryCache st_boundary_cache_;
 };
 
 }  // namespace planning
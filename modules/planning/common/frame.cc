@@ -35,6 +35,7 @@
 #include "modules/planning/common/feature_output.h"
 #include "modules/planning/common/planning_context.h"
 #include "modules/planning/common/planning_gflags.h"
+#include "modules/planning/common/util/planning_thread_pool.h"
 #include "modules/planning/common/util/util.h"
 #include "modules/planning/reference_line/reference_line_provider.h"
 #include "modules/routing/proto/routing.pb.h"
@@ -221,9 +222,38 @@ bool Frame::CreateReferenceLineInfo(
     }
 
     bool has_valid_reference_line = false;
+    const auto frame_obstacles = obstacles();
+    if (FLAGS_use_multi_thread_to_init_reference_line_info &&
+        reference_line_info_.size() > 1)
+    {
+        // each ReferenceLineInfo only writes its own path decision
+        std::vector<ReferenceLineInfo *> ref_infos;
+        for (auto &ref_info : reference_line_info_)
+        {
+            ref_infos.push_back(&ref_info);
+        }
+        std::vector<char> results(ref_infos.size(), 0);
+        PlanningThreadPool::Instance()->ParallelFor(
+                ref_infos.size(), 1, [&](const size_t i) {
+                    results[i] = ref_infos[i]->Init(frame_obstacles);
+                });
+        for (const char result : results)
+        {
+            if (!result)
+            {
+                AERROR << "Failed to init reference line";
+            }
+            else
+            {
+                has_valid_reference_line = true;
+            }
+        }
+        return has_valid_reference_line;
+    }
+
     for (auto &ref_info : reference_line_info_)
     {
-        if (!ref_info.Init(obstacles()))
+        if (!ref_info.Init(frame_obstacles))
         {
             AERROR << "Failed to init reference line";
         }
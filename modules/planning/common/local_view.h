@@ -40,9 +40,9 @@ namespace planning
 struct LocalView
 {
     std::shared_ptr<prediction::PredictionObstacles> prediction_obstacles;
-    std::shared_ptr<canbus::Chassis> chassis;
+    std::shared_ptr<const canbus::Chassis> chassis;
     std::shared_ptr<localization::LocalizationEstimate> localization_estimate;
-    std::shared_ptr<perception::TrafficLightDetection> traffic_light;
+    std::shared_ptr<const perception::TrafficLightDetection> traffic_light;
     std::shared_ptr<routing::RoutingResponse> routing;
     std::shared_ptr<relative_map::MapMsg> relative_map;
     std::shared_ptr<PadMessage> pad_msg;
@@ -21,6 +21,9 @@
 #include "modules/planning/common/obstacle.h"
 
 #include <algorithm>
+#include <array>
+#include <cmath>
+#include <limits>
 #include <utility>
 
 #include "cyber/common/log.h"
@@ -47,6 +50,77 @@ namespace
 const double kStBoundaryDeltaS = 0.2;        // meters
 const double kStBoundarySparseDeltaS = 1.0;  // meters
 const double kStBoundaryDeltaT = 0.05;       // seconds
+
+// s range of the part of a convex polygon in the sl plane that lies within
+// |l| <= half_width, false if the polygon misses the corridor
+bool ClipSRangeToCorridor(const std::array<common::math::Vec2d, 4>& sl_corners,
+                          const double half_width, double* const min_s,
+                          double* const max_s)
+{
+    *min_s = std::numeric_limits<double>::max();
+    *max_s = std::numeric_limits<double>::lowest();
+    for (size_t i = 0; i < sl_corners.size(); ++i)
+    {
+        const auto& p0 = sl_corners[i];
+        const auto& p1 = sl_corners[(i + 1) % sl_corners.size()];
+        if (std::fabs(p0.y()) <= half_width)
+        {
+            *min_s = std::fmin(*min_s, p0.x());
+            *max_s = std::fmax(*max_s, p0.x());
+        }
+        for (const double border_l : {-half_width, half_width})
+        {
+            if ((p0.y() - border_l) * (p1.y() - border_l) < 0.0)
+            {
+                const double ratio = (border_l - p0.y()) / (p1.y() - p0.y());
+                const double s = p0.x() + ratio * (p1.x() - p0.x());
+                *min_s = std::fmin(*min_s, s);
+                *max_s = std::fmax(*max_s, s);
+            }
+        }
+    }
+    return *min_s <= *max_s;
+}
+
+// Finds the samples the scan in BuildTrajectoryStBoundary stops at without
+// sampling the reference line. The ego box centered at s overlaps the
+// obstacle for s in [min_s - half_length, max_s + half_length] of the clipped
+// obstacle. The low and high samples start at *low_s and *high_s and step
+// towards each other by delta_s until both overlap or they meet.
+bool SweepCorridor(const std::array<common::math::Vec2d, 4>& sl_corners,
+                   const double ego_half_length, const double ego_half_width,
+                   const double delta_s, double* const low_s,
+                   double* const high_s)
+{
+    double min_s = 0.0;
+    double max_s = 0.0;
+    if (!ClipSRangeToCorridor(sl_corners, ego_half_width, &min_s, &max_s))
+    {
+        return false;
+    }
+    const double first_overlap_s = min_s - ego_half_length;
+    const double last_overlap_s = max_s + ego_half_length;
+    const double low_index =
+            std::fmax(0.0, std::ceil((first_overlap_s - *low_s) / delta_s));
+    const double high_index =
+            std::fmax(0.0, std::ceil((*high_s - last_overlap_s) / delta_s));
+    const double overlap_low_s = *low_s + low_index * delta_s;
+    const double overlap_high_s = *high_s - high_index * delta_s;
+    if (overlap_low_s > last_overlap_s || overlap_high_s < first_overlap_s)
+    {
+        return false;
+    }
+    // the scan gives up once the samples meet before both overlap
+    const double num_steps = std::fmax(low_index, high_index);
+    if (*low_s + (std::fmin(num_steps, low_index + 1.0) + 1.0) * delta_s >=
+        *high_s - std::fmin(num_steps, high_index + 1.0) * delta_s)
+    {
+        return false;
+    }
+    *low_s = overlap_low_s;
+    *high_s = overlap_high_s;
+    return true;
+}
 }  // namespace
 
 const std::unordered_map<ObjectDecisionType::ObjectTagCase, int,
@@ -502,9 +576,15 @@ bool Obstacle::BuildTrajectoryStBoundary(const ReferenceLine& reference_line,
     const double adc_length = adc_param.length();
     const double adc_half_length = adc_length / 2.0;
     const double adc_width = adc_param.width();
+    const double adc_box_width =
+            adc_width + FLAGS_nonstatic_obstacle_nudge_l_buffer;
     common::math::Box2d min_box({0, 0}, 1.0, 1.0, 1.0);
     common::math::Box2d max_box({0, 0}, 1.0, 1.0, 1.0);
-    std::vector<std::pair<STPoint, STPoint>> polygon_points;
+    // scratch of the thread, keeps its capacity across obstacles and frames
+    static thread_local std::vector<std::pair<STPoint, STPoint>>
+            polygon_points;
+    polygon_points.clear();
+    std::array<common::math::Vec2d, 4> sl_corners;
 
     SLBoundary last_sl_boundary;
     int last_index = 0;
@@ -547,8 +627,27 @@ bool Obstacle::BuildTrajectoryStBoundary(const ReferenceLine& reference_line,
                                       : std::fmin(reference_line.Length(),
                                                   mid_s + 2.0 * distance_xy);
 
-        if (!reference_line.GetApproximateSLBoundary(object_moving_box, start_s,
-                                                     end_s, &object_boundary))
+        if (FLAGS_use_analytic_st_boundary_sweep)
+        {
+            if (!reference_line.GetApproximateSLCorners(
+                        object_moving_box, start_s, end_s, &sl_corners))
+            {
+                AERROR << "failed to calculate boundary";
+                return false;
+            }
+            const auto s_range = std::minmax(
+                    {sl_corners[0].x(), sl_corners[1].x(), sl_corners[2].x(),
+                     sl_corners[3].x()});
+            const auto l_range = std::minmax(
+                    {sl_corners[0].y(), sl_corners[1].y(), sl_corners[2].y(),
+                     sl_corners[3].y()});
+            object_boundary.set_start_s(s_range.first);
+            object_boundary.set_end_s(s_range.second);
+            object_boundary.set_start_l(l_range.first);
+            object_boundary.set_end_l(l_range.second);
+        }
+        else if (!reference_line.GetApproximateSLBoundary(
+                         object_moving_box, start_s, end_s, &object_boundary))
         {
             AERROR << "failed to calculate boundary";
             return false;
@@ -600,29 +699,40 @@ bool Obstacle::BuildTrajectoryStBoundary(const ReferenceLine& reference_line,
         double high_s = std::min(object_boundary.end_s() + adc_half_length,
                                  FLAGS_st_max_s);
         bool has_high = false;
-        while (low_s + st_boundary_delta_s < high_s && !(has_low && has_high))
+        if (FLAGS_use_analytic_st_boundary_sweep)
         {
-            if (!has_low)
-            {
-                auto low_ref = reference_line.GetReferencePoint(low_s);
-                has_low = object_moving_box.HasOverlap(
-                        {low_ref, low_ref.heading(), adc_length,
-                         adc_width + FLAGS_nonstatic_obstacle_nudge_l_buffer});
-                low_s += st_boundary_delta_s;
-            }
-            if (!has_high)
+            has_low = has_high = SweepCorridor(
+                    sl_corners, adc_half_length, adc_box_width / 2.0,
+                    st_boundary_delta_s, &low_s, &high_s);
+        }
+        else
+        {
+            while (low_s + st_boundary_delta_s < high_s &&
+                   !(has_low && has_high))
             {
-                auto high_ref = reference_line.GetReferencePoint(high_s);
-                has_high = object_moving_box.HasOverlap(
-                        {high_ref, high_ref.heading(), adc_length,
-                         adc_width + FLAGS_nonstatic_obstacle_nudge_l_buffer});
-                high_s -= st_boundary_delta_s;
+                if (!has_low)
+                {
+                    auto low_ref = reference_line.GetReferencePoint(low_s);
+                    has_low = object_moving_box.HasOverlap(
+                            {low_ref, low_ref.heading(), adc_length,
+                             adc_box_width});
+                    low_s += st_boundary_delta_s;
+                }
+                if (!has_high)
+                {
+                    auto high_ref = reference_line.GetReferencePoint(high_s);
+                    has_high = object_moving_box.HasOverlap(
+                            {high_ref, high_ref.heading(), adc_length,
+                             adc_box_width});
+                    high_s -= st_boundary_delta_s;
+                }
             }
+            // the scan stepped past the overlapping samples
+            low_s -= st_boundary_delta_s;
+            high_s += st_boundary_delta_s;
         }
         if (has_low && has_high)
         {
-            low_s -= st_boundary_delta_s;
-            high_s += st_boundary_delta_s;
             double low_t = (first_traj_point.relative_time() +
                             std::fabs((low_s - object_boundary.start_s()) /
                                       object_s_diff) *
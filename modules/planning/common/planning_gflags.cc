@@ -133,6 +133,11 @@ DEFINE_double(look_forward_extend_distance, 50,
 DEFINE_double(reference_line_stitch_overlap_distance, 20,
               "The overlap distance with the existing reference line when "
               "stitching the existing reference line");
+DEFINE_bool(enable_reference_line_segment_cache, true,
+            "Reuse smoothed reference lines whose route segments cover the "
+            "requested lane segments instead of smoothing them again");
+DEFINE_int32(reference_line_segment_cache_size, 8,
+             "The max number of smoothed reference lines kept in the cache");
 
 DEFINE_bool(enable_smooth_reference_line, true,
             "enable smooth the map reference line");
@@ -207,6 +212,13 @@ DEFINE_double(kappa_bound, 0.1979, "The bound for trajectory curvature");
 // ST Boundary
 DEFINE_double(st_max_s, 100, "the maximum s of st boundary");
 DEFINE_double(st_max_t, 8, "the maximum t of st boundary");
+DEFINE_bool(use_analytic_st_boundary_sweep, false,
+            "find where the ego box meets a predicted obstacle box from the "
+            "sl corners of the obstacle instead of sampling the reference "
+            "line.");
+DEFINE_bool(enable_st_boundary_cache, false,
+            "reuse the st overlap points of obstacles whose prediction and "
+            "path did not change, within a frame and across frames.");
 
 // Decision Part
 DEFINE_bool(enable_nudge_slowdown, true,
@@ -316,8 +328,21 @@ DEFINE_double(slowdown_profile_deceleration, -0.3,
 DEFINE_bool(enable_sqp_solver, true, "True to enable SQP solver.");
 
 /// thread pool
+DEFINE_int32(planning_thread_pool_size, 0,
+             "number of worker threads of the planning thread pool, 0 for "
+             "one less than the number of hardware threads");
 DEFINE_bool(use_multi_thread_to_add_obstacles, false,
             "use multiple thread to add obstacles.");
+DEFINE_int32(add_obstacles_min_chunk_size, 16,
+             "minimal number of obstacles a thread adds at once, reference "
+             "lines with fewer obstacles add them in the calling thread.");
+DEFINE_bool(use_multi_thread_to_smooth_reference_lines, false,
+            "smooth candidate reference lines concurrently, one smoother per "
+            "candidate.");
+DEFINE_bool(use_multi_thread_to_init_reference_line_info, false,
+            "init the reference line info of each candidate concurrently.");
+DEFINE_bool(use_multi_thread_to_assess_paths, false,
+            "assess the candidate paths of a reference line concurrently.");
 DEFINE_bool(enable_multi_thread_in_dp_st_graph, false,
             "Enable multiple thread to calculation curve cost in dp_st_graph.");
 
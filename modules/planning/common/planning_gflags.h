@@ -62,6 +62,8 @@ DECLARE_double(rtk_trajectory_resolution);
 DECLARE_bool(enable_reference_line_stitching);
 DECLARE_double(look_forward_extend_distance);
 DECLARE_double(reference_line_stitch_overlap_distance);
+DECLARE_bool(enable_reference_line_segment_cache);
+DECLARE_int32(reference_line_segment_cache_size);
 
 DECLARE_bool(enable_smooth_reference_line);
 
@@ -104,6 +106,8 @@ DECLARE_double(kappa_bound);
 // STBoundary
 DECLARE_double(st_max_s);
 DECLARE_double(st_max_t);
+DECLARE_bool(use_analytic_st_boundary_sweep);
+DECLARE_bool(enable_st_boundary_cache);
 
 // Decision Part
 DECLARE_bool(enable_nudge_slowdown);
@@ -157,7 +161,12 @@ DECLARE_double(slowdown_profile_deceleration);
 DECLARE_bool(enable_sqp_solver);
 
 /// thread pool
+DECLARE_int32(planning_thread_pool_size);
 DECLARE_bool(use_multi_thread_to_add_obstacles);
+DECLARE_int32(add_obstacles_min_chunk_size);
+DECLARE_bool(use_multi_thread_to_smooth_reference_lines);
+DECLARE_bool(use_multi_thread_to_init_reference_line_info);
+DECLARE_bool(use_multi_thread_to_assess_paths);
 DECLARE_bool(enable_multi_thread_in_dp_st_graph);
 
 DECLARE_double(numerical_epsilon);
@@ -21,6 +21,8 @@
 #include "modules/planning/common/reference_line_info.h"
 
 #include <algorithm>
+#include <thread>
+#include <unordered_set>
 
 #include "absl/strings/str_cat.h"
 #include "cyber/task/task.h"
@@ -29,6 +31,7 @@
 #include "modules/common/util/util.h"
 #include "modules/map/hdmap/hdmap_common.h"
 #include "modules/map/hdmap/hdmap_util.h"
+#include "modules/planning/common/util/planning_thread_pool.h"
 #include "modules/planning/proto/planning_status.pb.h"
 #include "modules/planning/proto/sl_boundary.pb.h"
 
@@ -576,7 +579,6 @@ bool ReferenceLineInfo::AddObstacleHelper(
     return AddObstacle(obstacle.get()) != nullptr;
 }
 
-// AddObstacle is thread safe
 Obstacle* ReferenceLineInfo::AddObstacle(const Obstacle* obstacle)
 {
     if (!obstacle)
@@ -592,12 +594,20 @@ Obstacle* ReferenceLineInfo::AddObstacle(const Obstacle* obstacle)
         return nullptr;
     }
 
+    BuildObstacleBoundaries(mutable_obstacle);
+    return mutable_obstacle;
+}
+
+void ReferenceLineInfo::BuildObstacleBoundaries(
+        Obstacle* const mutable_obstacle)
+{
     SLBoundary perception_sl;
-    if (!reference_line_.GetSLBoundary(obstacle->PerceptionBoundingBox(),
-                                       &perception_sl))
+    if (!reference_line_.GetSLBoundary(
+                mutable_obstacle->PerceptionBoundingBox(), &perception_sl))
     {
-        AERROR << "Failed to get sl boundary for obstacle: " << obstacle->Id();
-        return mutable_obstacle;
+        AERROR << "Failed to get sl boundary for obstacle: "
+               << mutable_obstacle->Id();
+        return;
     }
 
     mutable_obstacle->SetPerceptionSlBoundary(perception_sl);
@@ -607,11 +617,13 @@ Obstacle* ReferenceLineInfo::AddObstacle(const Obstacle* obstacle)
 #if debug_ref_line_info
     if (mutable_obstacle->IsLaneBlocking())
     {
-        AINFO << "obstacle [" << obstacle->Id() << "] is lane blocking.";
+        AINFO << "obstacle [" << mutable_obstacle->Id()
+              << "] is lane blocking.";
     }
     else
     {
-        AINFO << "obstacle [" << obstacle->Id() << "] is NOT lane blocking.";
+        AINFO << "obstacle [" << mutable_obstacle->Id()
+              << "] is NOT lane blocking.";
     }
 #endif
 
@@ -619,13 +631,12 @@ Obstacle* ReferenceLineInfo::AddObstacle(const Obstacle* obstacle)
     {
         ObjectDecisionType ignore;
         ignore.mutable_ignore();
-        path_decision_.AddLateralDecision("reference_line_filter",
-                                          obstacle->Id(), ignore);
-
-        path_decision_.AddLongitudinalDecision("reference_line_filter",
-                                               obstacle->Id(), ignore);
+        mutable_obstacle->AddLateralDecision("reference_line_filter", ignore);
+        mutable_obstacle->AddLongitudinalDecision("reference_line_filter",
+                                                  ignore);
 #if debug_ref_line_info
-        AINFO << "NO build reference line st boundary. id:" << obstacle->Id();
+        AINFO << "NO build reference line st boundary. id:"
+              << mutable_obstacle->Id();
 #endif
     }
     else
@@ -635,7 +646,8 @@ Obstacle* ReferenceLineInfo::AddObstacle(const Obstacle* obstacle)
 
 #if debug_ref_line_info
 
-        AINFO << "build reference line st boundary. id:" << obstacle->Id();
+        AINFO << "build reference line st boundary. id:"
+              << mutable_obstacle->Id();
 
         AINFO << "reference line st boundary: t["
               << mutable_obstacle->reference_line_st_boundary().min_t() << ", "
@@ -646,42 +658,64 @@ Obstacle* ReferenceLineInfo::AddObstacle(const Obstacle* obstacle)
 
 #endif
     }
-
-    return mutable_obstacle;
 }
 
 bool ReferenceLineInfo::AddObstacles(
         const std::vector<const Obstacle*>& obstacles)
 {
-    if (FLAGS_use_multi_thread_to_add_obstacles)
-    {
-        std::vector<std::future<Obstacle*>> results;
-        for (const auto* obstacle : obstacles)
+    // The container of path_decision_ is not thread safe, and its order is
+    // the order of the input, so the obstacles are inserted here first.
+    std::vector<Obstacle*> mutable_obstacles;
+    mutable_obstacles.reserve(obstacles.size());
+    std::unordered_set<const Obstacle*> added_obstacles;
+    for (const auto* obstacle : obstacles)
+    {
+        if (!obstacle)
         {
-            results.push_back(cyber::Async(&ReferenceLineInfo::AddObstacle,
-                                           this, obstacle));
+            AERROR << "The provided obstacle is empty";
+            return false;
         }
-        for (auto& result : results)
+        auto* mutable_obstacle = path_decision_.AddObstacle(*obstacle);
+        if (!mutable_obstacle)
         {
-            if (!result.get())
-            {
-                AERROR << "Fail to add obstacles.";
-                return false;
-            }
+            AERROR << "Failed to add obstacle " << obstacle->Id();
+            return false;
+        }
+        // a repeated id overwrites the same obstacle, build it only once
+        if (added_obstacles.insert(mutable_obstacle).second)
+        {
+            mutable_obstacles.push_back(mutable_obstacle);
         }
     }
-    else
-    {
-        for (const auto* obstacle : obstacles)
+
+    // Contiguous chunks, at most one per hardware thread, so that a task
+    // amortizes its scheduling over many obstacles. Each obstacle only
+    // depends on itself and the reference line, the result is the same for
+    // any schedule.
+    const size_t num_obstacles = mutable_obstacles.size();
+    const size_t num_threads =
+            std::max(std::thread::hardware_concurrency(), 1U);
+    const size_t min_chunk_size = static_cast<size_t>(
+            std::max(FLAGS_add_obstacles_min_chunk_size, 1));
+    const size_t chunk_size = std::max(
+            min_chunk_size, (num_obstacles + num_threads - 1) / num_threads);
+    if (!FLAGS_use_multi_thread_to_add_obstacles || num_obstacles <= chunk_size)
+    {
+        for (auto* mutable_obstacle : mutable_obstacles)
         {
-            if (!AddObstacle(obstacle))
-            {
-                AERROR << "Failed to add obstacle " << obstacle->Id();
-                return false;
-            }
+            BuildObstacleBoundaries(mutable_obstacle);
         }
+        return true;
     }
 
+    // Init may run on a task of the cyber task pool or inside the parallel
+    // init of the reference lines, the planning pool runs unclaimed chunks
+    // in this thread instead of waiting for them.
+    PlanningThreadPool::Instance()->ParallelFor(
+            num_obstacles, chunk_size, [this, &mutable_obstacles](size_t i) {
+                BuildObstacleBoundaries(mutable_obstacles[i]);
+            });
+
     return true;
 }
 
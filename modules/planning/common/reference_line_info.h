@@ -480,6 +480,11 @@ private:
 
     bool is_irrelevant_obstacle(const Obstacle& obstacle);
 
+    // Set the sl boundary, lane blocking and reference line st boundary of an
+    // obstacle in path_decision_. Only writes that obstacle, so obstacles of
+    // one reference line can be processed concurrently.
+    void BuildObstacleBoundaries(Obstacle* const mutable_obstacle);
+
     void MakeDecision(DecisionResult* decision_result,
                       PlanningContext* planning_context) const;
 
@@ -0,0 +1,161 @@
+/******************************************************************************
+ * Copyright 2023 The Apollo Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *****************************************************************************/
+
+/**
+ * @file st_boundary_cache.cc
+ **/
+
+#include "modules/planning/common/speed/st_boundary_cache.h"
+
+#include <functional>
+#include <utility>
+
+#include "cyber/common/log.h"
+
+namespace apollo
+{
+namespace planning
+{
+void STBoundaryCache::StartFrame(const uint32_t sequence_num)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (has_frame_ && sequence_num == sequence_num_)
+    {
+        return;
+    }
+    if (frame_hit_count_ + frame_miss_count_ > 0)
+    {
+        ADEBUG << "ST boundary cache of frame " << sequence_num_ << ": "
+               << frame_hit_count_ << " hits, " << frame_miss_count_
+               << " misses.";
+        AINFO_EVERY(100) << "ST boundary cache hit rate: "
+                         << static_cast<double>(hit_count_) /
+                                    static_cast<double>(hit_count_ +
+                                                        miss_count_)
+                         << " (" << hit_count_ << " hits, " << miss_count_
+                         << " misses)";
+    }
+    // entries of the previous frame that were not used again are dropped
+    previous_entries_ = std::move(current_entries_);
+    current_entries_.clear();
+    previous_paths_ = std::move(current_paths_);
+    current_paths_.clear();
+    has_frame_ = true;
+    sequence_num_ = sequence_num;
+    frame_hit_count_ = 0;
+    frame_miss_count_ = 0;
+}
+
+int STBoundaryCache::PathId(const std::vector<double>& signature)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (const auto& path : current_paths_)
+    {
+        if (path.first == signature)
+        {
+            return path.second;
+        }
+    }
+    for (auto iter = previous_paths_.begin(); iter != previous_paths_.end();
+         ++iter)
+    {
+        if (iter->first == signature)
+        {
+            // keep the path for the next frame
+            current_paths_.push_back(std::move(*iter));
+            previous_paths_.erase(iter);
+            return current_paths_.back().second;
+        }
+    }
+    current_paths_.emplace_back(signature, next_path_id_++);
+    return current_paths_.back().second;
+}
+
+bool STBoundaryCache::Find(const std::string& obstacle_id,
+                           const double perception_time,
+                           const int num_trajectory_points, const int path_id,
+                           OverlapPoints* const points)
+{
+    const Key key{obstacle_id, perception_time, num_trajectory_points,
+                  path_id};
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto iter = current_entries_.find(key);
+    if (iter == current_entries_.end())
+    {
+        auto previous_iter = previous_entries_.find(key);
+        if (previous_iter == previous_entries_.end())
+        {
+            ++frame_miss_count_;
+            ++miss_count_;
+            return false;
+        }
+        // keep the entry for the next frame
+        iter = current_entries_
+                       .emplace(key, std::move(previous_iter->second))
+                       .first;
+        previous_entries_.erase(previous_iter);
+    }
+    *points = iter->second;
+    ++frame_hit_count_;
+    ++hit_count_;
+    return true;
+}
+
+void STBoundaryCache::Insert(const std::string& obstacle_id,
+                             const double perception_time,
+                             const int num_trajectory_points,
+                             const int path_id, const OverlapPoints& points)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    current_entries_[Key{obstacle_id, perception_time, num_trajectory_points,
+                         path_id}] = points;
+}
+
+void STBoundaryCache::Clear()
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    current_entries_.clear();
+    previous_entries_.clear();
+    current_paths_.clear();
+    previous_paths_.clear();
+    has_frame_ = false;
+    frame_hit_count_ = 0;
+    frame_miss_count_ = 0;
+}
+
+uint64_t STBoundaryCache::hit_count() const
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    return hit_count_;
+}
+
+uint64_t STBoundaryCache::miss_count() const
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    return miss_count_;
+}
+
+size_t STBoundaryCache::KeyHash::operator()(const Key& key) const
+{
+    // only spreads the buckets, the keys are compared with operator==
+    size_t hash = std::hash<std::string>()(key.obstacle_id);
+    hash = hash * 31 + std::hash<double>()(key.perception_time);
+    hash = hash * 31 + static_cast<size_t>(key.num_trajectory_points);
+    return hash * 31 + static_cast<size_t>(key.path_id);
+}
+
+}  // namespace planning
+}  // namespace apollo
@@ -0,0 +1,129 @@
+/******************************************************************************
+ * Copyright 2023 The Apollo Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *****************************************************************************/
+
+/**
+ * @file st_boundary_cache.h
+ **/
+
+#pragma once
+
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "modules/planning/common/speed/st_point.h"
+
+namespace apollo
+{
+namespace planning
+{
+/**
+ * @class STBoundaryCache
+ * @brief Overlap points of obstacles with the ego path on the ST-graph,
+ * keyed by obstacle id, the perception timestamp and trajectory size of the
+ * obstacle, and the id of the path. Paths get their id from an exact
+ * comparison of their signatures, so a hit always comes from the same
+ * obstacle state on the same path. The speed bounds deciders of a frame and
+ * consecutive frames with an unchanged prediction look them up instead of
+ * checking collisions again. Entries and paths not used in the current or
+ * the previous frame are dropped.
+ */
+class STBoundaryCache
+{
+public:
+    struct OverlapPoints
+    {
+        std::vector<STPoint> lower_points;
+        std::vector<STPoint> upper_points;
+        bool has_overlap = false;
+    };
+
+    STBoundaryCache() = default;
+
+    /**
+     * @brief Start a planning frame, calls with the sequence number of the
+     * current frame do nothing.
+     */
+    void StartFrame(const uint32_t sequence_num);
+
+    /**
+     * @brief Id of a path, equal for paths with equal signatures.
+     * @param signature Everything the overlap points depend on besides the
+     * obstacle, e.g. the path points and the lateral buffer
+     */
+    int PathId(const std::vector<double>& signature);
+
+    bool Find(const std::string& obstacle_id, const double perception_time,
+              const int num_trajectory_points, const int path_id,
+              OverlapPoints* const points);
+
+    void Insert(const std::string& obstacle_id, const double perception_time,
+                const int num_trajectory_points, const int path_id,
+                const OverlapPoints& points);
+
+    void Clear();
+
+    uint64_t hit_count() const;
+    uint64_t miss_count() const;
+
+private:
+    struct Key
+    {
+        std::string obstacle_id;
+        double perception_time = 0.0;
+        int num_trajectory_points = 0;
+        int path_id = 0;
+
+        bool operator==(const Key& other) const
+        {
+            return path_id == other.path_id &&
+                   perception_time == other.perception_time &&
+                   num_trajectory_points == other.num_trajectory_points &&
+                   obstacle_id == other.obstacle_id;
+        }
+    };
+
+    struct KeyHash
+    {
+        size_t operator()(const Key& key) const;
+    };
+
+    using EntryMap = std::unordered_map<Key, OverlapPoints, KeyHash>;
+    using PathList = std::vector<std::pair<std::vector<double>, int>>;
+
+private:
+    mutable std::mutex mutex_;
+    // entries and paths used in the current frame, and in the previous frame
+    // only
+    EntryMap current_entries_;
+    EntryMap previous_entries_;
+    PathList current_paths_;
+    PathList previous_paths_;
+    int next_path_id_ = 0;
+    bool has_frame_ = false;
+    uint32_t sequence_num_ = 0;
+
+    uint64_t frame_hit_count_ = 0;
+    uint64_t frame_miss_count_ = 0;
+    uint64_t hit_count_ = 0;
+    uint64_t miss_count_ = 0;
+};
+
+}  // namespace planning
+}  // namespace apollo
@@ -0,0 +1,172 @@
+/******************************************************************************
+ * Copyright 2023 The Apollo Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *****************************************************************************/
+
+/**
+ * @file st_boundary_cache_test.cc
+ **/
+
+#include "modules/planning/common/speed/st_boundary_cache.h"
+
+#include "gtest/gtest.h"
+
+namespace apollo
+{
+namespace planning
+{
+namespace
+{
+constexpr double kPerceptionTime = 1680000000.1;
+constexpr int kNumTrajectoryPoints = 80;
+
+const std::vector<double> kPathSignature = {0.0, 0.0, 0.1, 0.0,
+                                            1.0, 0.1, 0.1, 1.0};
+
+STBoundaryCache::OverlapPoints MakeOverlapPoints()
+{
+    STBoundaryCache::OverlapPoints points;
+    points.lower_points.emplace_back(1.0, 0.0);
+    points.lower_points.emplace_back(3.0, 2.0);
+    points.upper_points.emplace_back(5.0, 0.0);
+    points.upper_points.emplace_back(7.0, 2.0);
+    points.has_overlap = true;
+    return points;
+}
+
+void Insert(const int path_id, STBoundaryCache* cache)
+{
+    cache->Insert("1", kPerceptionTime, kNumTrajectoryPoints, path_id,
+                  MakeOverlapPoints());
+}
+
+bool Find(const int path_id, STBoundaryCache* cache,
+          STBoundaryCache::OverlapPoints* points)
+{
+    return cache->Find("1", kPerceptionTime, kNumTrajectoryPoints, path_id,
+                       points);
+}
+
+}  // namespace
+
+TEST(STBoundaryCacheTest, HitInSameFrame)
+{
+    STBoundaryCache cache;
+    cache.StartFrame(1);
+    const int path_id = cache.PathId(kPathSignature);
+    STBoundaryCache::OverlapPoints points;
+    EXPECT_FALSE(Find(path_id, &cache, &points));
+    Insert(path_id, &cache);
+
+    ASSERT_TRUE(Find(path_id, &cache, &points));
+    EXPECT_TRUE(points.has_overlap);
+    ASSERT_EQ(2, points.lower_points.size());
+    ASSERT_EQ(2, points.upper_points.size());
+    EXPECT_DOUBLE_EQ(3.0, points.lower_points[1].s());
+    EXPECT_DOUBLE_EQ(2.0, points.lower_points[1].t());
+    EXPECT_DOUBLE_EQ(5.0, points.upper_points[0].s());
+    EXPECT_EQ(1, cache.hit_count());
+    EXPECT_EQ(1, cache.miss_count());
+}
+
+TEST(STBoundaryCacheTest, HitCarriedIntoNextFrame)
+{
+    STBoundaryCache cache;
+    cache.StartFrame(1);
+    const int path_id = cache.PathId(kPathSignature);
+    Insert(path_id, &cache);
+
+    cache.StartFrame(2);
+    EXPECT_EQ(path_id, cache.PathId(kPathSignature));
+    STBoundaryCache::OverlapPoints points;
+    ASSERT_TRUE(Find(path_id, &cache, &points));
+    EXPECT_TRUE(points.has_overlap);
+    EXPECT_EQ(2, points.lower_points.size());
+
+    // the hit keeps the entry for one more frame
+    cache.StartFrame(3);
+    EXPECT_EQ(path_id, cache.PathId(kPathSignature));
+    EXPECT_TRUE(Find(path_id, &cache, &points));
+}
+
+TEST(STBoundaryCacheTest, DropEntryUnusedForTwoFrames)
+{
+    STBoundaryCache cache;
+    cache.StartFrame(1);
+    Insert(cache.PathId(kPathSignature), &cache);
+
+    cache.StartFrame(2);
+    cache.StartFrame(3);
+    STBoundaryCache::OverlapPoints points;
+    EXPECT_FALSE(Find(cache.PathId(kPathSignature), &cache, &points));
+}
+
+TEST(STBoundaryCacheTest, MissOnPathChange)
+{
+    STBoundaryCache cache;
+    cache.StartFrame(1);
+    const int path_id = cache.PathId(kPathSignature);
+    EXPECT_EQ(path_id, cache.PathId(kPathSignature));
+    Insert(path_id, &cache);
+
+    std::vector<double> other_signature = kPathSignature;
+    other_signature.back() += 1e-9;
+    const int other_path_id = cache.PathId(other_signature);
+    EXPECT_NE(path_id, other_path_id);
+    STBoundaryCache::OverlapPoints points;
+    EXPECT_FALSE(Find(other_path_id, &cache, &points));
+
+    cache.StartFrame(2);
+    EXPECT_EQ(other_path_id, cache.PathId(other_signature));
+    EXPECT_FALSE(Find(other_path_id, &cache, &points));
+}
+
+TEST(STBoundaryCacheTest, MissOnPredictionChange)
+{
+    STBoundaryCache cache;
+    cache.StartFrame(1);
+    const int path_id = cache.PathId(kPathSignature);
+    Insert(path_id, &cache);
+
+    STBoundaryCache::OverlapPoints points;
+    EXPECT_FALSE(cache.Find("1", kPerceptionTime + 0.1, kNumTrajectoryPoints,
+                            path_id, &points));
+    EXPECT_FALSE(cache.Find("1", kPerceptionTime, kNumTrajectoryPoints + 1,
+                            path_id, &points));
+    EXPECT_FALSE(cache.Find("2", kPerceptionTime, kNumTrajectoryPoints,
+                            path_id, &points));
+
+    cache.StartFrame(2);
+    EXPECT_FALSE(cache.Find("1", kPerceptionTime + 0.1, kNumTrajectoryPoints,
+                            cache.PathId(kPathSignature), &points));
+}
+
+TEST(STBoundaryCacheTest, RepeatedStartFrameIsNoOp)
+{
+    STBoundaryCache cache;
+    cache.StartFrame(1);
+    Insert(cache.PathId(kPathSignature), &cache);
+
+    // e.g. the second speed bounds decider of a frame, the entry must stay
+    // in the current frame and survive one more frame without use
+    cache.StartFrame(1);
+    cache.StartFrame(2);
+    cache.StartFrame(2);
+    STBoundaryCache::OverlapPoints points;
+    EXPECT_TRUE(Find(cache.PathId(kPathSignature), &cache, &points));
+    EXPECT_TRUE(points.has_overlap);
+}
+
+}  // namespace planning
+}  // namespace apollo
@@ -0,0 +1,112 @@
+/******************************************************************************
+ * Copyright 2023 The Apollo Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *****************************************************************************/
+
+/**
+ * @file planning_thread_pool.cc
+ **/
+
+#include "modules/planning/common/util/planning_thread_pool.h"
+
+#include "modules/planning/common/planning_gflags.h"
+
+namespace apollo
+{
+namespace planning
+{
+PlanningThreadPool* PlanningThreadPool::Instance()
+{
+    static PlanningThreadPool pool(
+            FLAGS_planning_thread_pool_size > 0
+                    ? FLAGS_planning_thread_pool_size
+                    : static_cast<int>(std::thread::hardware_concurrency()) -
+                              1);
+    return &pool;
+}
+
+PlanningThreadPool::PlanningThreadPool(const int thread_num)
+{
+    for (int i = 0; i < thread_num; ++i)
+    {
+        workers_.emplace_back(&PlanningThreadPool::WorkerLoop, this);
+    }
+}
+
+PlanningThreadPool::~PlanningThreadPool()
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stopped_ = true;
+    }
+    work_cv_.notify_all();
+    for (auto& worker : workers_)
+    {
+        worker.join();
+    }
+}
+
+void PlanningThreadPool::Run(Job* job)
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        jobs_.push_back(job);
+    }
+    work_cv_.notify_all();
+
+    while (job->RunNextChunk())
+    {
+    }
+
+    // every chunk is claimed, only wait for the workers still running one
+    std::unique_lock<std::mutex> lock(mutex_);
+    auto iter = std::find(jobs_.begin(), jobs_.end(), job);
+    if (iter != jobs_.end())
+    {
+        jobs_.erase(iter);
+    }
+    done_cv_.wait(lock, [job]() { return job->num_helpers == 0; });
+}
+
+void PlanningThreadPool::WorkerLoop()
+{
+    std::unique_lock<std::mutex> lock(mutex_);
+    while (true)
+    {
+        work_cv_.wait(lock, [this]() { return stopped_ || !jobs_.empty(); });
+        if (stopped_)
+        {
+            return;
+        }
+        Job* job = jobs_.front();
+        if (!job->HasChunk())
+        {
+            jobs_.pop_front();
+            continue;
+        }
+        ++job->num_helpers;
+        lock.unlock();
+        while (job->RunNextChunk())
+        {
+        }
+        lock.lock();
+        if (--job->num_helpers == 0)
+        {
+            done_cv_.notify_all();
+        }
+    }
+}
+
+}  // namespace planning
+}  // namespace apollo
@@ -0,0 +1,149 @@
+/******************************************************************************
+ * Copyright 2023 The Apollo Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *****************************************************************************/
+
+/**
+ * @file planning_thread_pool.h
+ **/
+
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace apollo
+{
+namespace planning
+{
+/**
+ * @class PlanningThreadPool
+ * @brief Fork-join pool of planning for parallel loops. It owns its threads
+ * instead of using the cyber task pool, and the calling thread of a loop
+ * runs every chunk that no worker has started. A loop therefore never waits
+ * for queued work, and loops can be nested, e.g. inside a task of the cyber
+ * task pool or inside another loop.
+ */
+class PlanningThreadPool
+{
+public:
+    /**
+     * @brief The pool with FLAGS_planning_thread_pool_size workers
+     */
+    static PlanningThreadPool* Instance();
+
+    explicit PlanningThreadPool(const int thread_num);
+
+    ~PlanningThreadPool();
+
+    /**
+     * @brief Call f(i) for every i in [0, size) and return after all calls
+     * finished.
+     * @param size Number of indices
+     * @param chunk_size Number of consecutive indices run as one task,
+     * picked from the size and the thread number if 0
+     * @param f Loop body
+     */
+    template <typename F>
+    void ParallelFor(const size_t size, size_t chunk_size, const F& f)
+    {
+        if (chunk_size == 0)
+        {
+            chunk_size = std::max<size_t>(
+                    (size + workers_.size()) / (workers_.size() + 1), 1);
+        }
+        if (workers_.empty() || size <= chunk_size)
+        {
+            for (size_t i = 0; i < size; ++i)
+            {
+                f(i);
+            }
+            return;
+        }
+        Job job(size, chunk_size, &RunChunk<F>, &f);
+        Run(&job);
+    }
+
+private:
+    struct Job
+    {
+        Job(const size_t end, const size_t chunk_size,
+            void (*run_chunk)(const void*, size_t, size_t), const void* func) :
+            run_chunk(run_chunk),
+            func(func),
+            end(end),
+            chunk_size(chunk_size)
+        {
+        }
+
+        bool HasChunk() const
+        {
+            return next.load(std::memory_order_relaxed) < end;
+        }
+
+        // claims and runs one chunk, returns false if none is left
+        bool RunNextChunk()
+        {
+            const size_t chunk_begin =
+                    next.fetch_add(chunk_size, std::memory_order_relaxed);
+            if (chunk_begin >= end)
+            {
+                return false;
+            }
+            run_chunk(func, chunk_begin,
+                      std::min(chunk_begin + chunk_size, end));
+            return true;
+        }
+
+        void (*const run_chunk)(const void*, size_t, size_t);
+        const void* const func;
+        const size_t end;
+        const size_t chunk_size;
+        std::atomic<size_t> next{0};
+        // workers running chunks of the job, guarded by the pool mutex
+        int num_helpers = 0;
+    };
+
+    template <typename F>
+    static void RunChunk(const void* func, size_t begin, size_t end)
+    {
+        const F& f = *static_cast<const F*>(func);
+        for (size_t i = begin; i < end; ++i)
+        {
+            f(i);
+        }
+    }
+
+    // publishes the job, works on it and waits for the workers that helped
+    void Run(Job* job);
+
+    void WorkerLoop();
+
+private:
+    std::vector<std::thread> workers_;
+
+    std::mutex mutex_;
+    std::condition_variable work_cv_;
+    std::condition_variable done_cv_;
+    std::deque<Job*> jobs_;
+    bool stopped_ = false;
+};
+
+}  // namespace planning
+}  // namespace apollo
@@ -56,62 +56,26 @@ bool FemPosDeviationOsqpInterface::Solve()
         return false;
     }
 
+    const int num_of_points = static_cast<int>(ref_points_.size());
+    const bool reuse_workspace = work_ != nullptr && !workspace_outdated_ &&
+                                 num_of_points == num_of_points_;
+
     // Calculate optimization states definitions
-    num_of_points_ = static_cast<int>(ref_points_.size());
+    num_of_points_ = num_of_points;
     num_of_variables_ = num_of_points_ * 2;
     num_of_constraints_ = num_of_variables_;
 
-    // Calculate kernel
-    std::vector<c_float> P_data;
-    std::vector<c_int> P_indices;
-    std::vector<c_int> P_indptr;
-    CalculateKernel(&P_data, &P_indices, &P_indptr);
-
-    // Calculate affine constraints
-    std::vector<c_float> A_data;
-    std::vector<c_int> A_indices;
-    std::vector<c_int> A_indptr;
-    std::vector<c_float> lower_bounds;
-    std::vector<c_float> upper_bounds;
-    CalculateAffineConstraint(&A_data, &A_indices, &A_indptr, &lower_bounds,
-                              &upper_bounds);
-
-    // Calculate offset
-    std::vector<c_float> q;
-    CalculateOffset(&q);
-
-    // Set primal warm start
-    std::vector<c_float> primal_warm_start;
-    SetPrimalWarmStart(&primal_warm_start);
-
-    OSQPData* data = reinterpret_cast<OSQPData*>(c_malloc(sizeof(OSQPData)));
-    OSQPSettings* settings =
-            reinterpret_cast<OSQPSettings*>(c_malloc(sizeof(OSQPSettings)));
+    // Offset, bounds and warm start change with every reference line
+    CalculateOffset(&q_);
+    CalculateBounds(&lower_bounds_, &upper_bounds_);
+    SetPrimalWarmStart(&primal_warm_start_);
 
-    // Define Solver settings
-    osqp_set_default_settings(settings);
-    settings->max_iter = max_iter_;
-    settings->time_limit = time_limit_;
-    settings->verbose = verbose_;
-    settings->scaled_termination = scaled_termination_;
-    settings->warm_start = warm_start_;
-
-    OSQPWorkspace* work = nullptr;
-
-    bool res = OptimizeWithOsqp(num_of_variables_, lower_bounds.size(), &P_data,
-                                &P_indices, &P_indptr, &A_data, &A_indices,
-                                &A_indptr, &lower_bounds, &upper_bounds, &q,
-                                &primal_warm_start, data, &work, settings);
-    if (res == false || work == nullptr || work->solution == nullptr)
+    const bool workspace_ready =
+            reuse_workspace ? UpdateWorkspace() : SetupWorkspace();
+    if (!workspace_ready || !OptimizeWithOsqp())
     {
         AERROR << "Failed to find solution.";
-        // Cleanup
-        osqp_cleanup(work);
-        c_free(data->A);
-        c_free(data->P);
-        c_free(data);
-        c_free(settings);
-
+        FreeWorkspace();
         return false;
     }
 
@@ -121,20 +85,100 @@ bool FemPosDeviationOsqpInterface::Solve()
     for (int i = 0; i < num_of_points_; ++i)
     {
         int index = i * 2;
-        x_.at(i) = work->solution->x[index];
-        y_.at(i) = work->solution->x[index + 1];
+        x_.at(i) = work_->solution->x[index];
+        y_.at(i) = work_->solution->x[index + 1];
     }
 
-    // Cleanup
-    osqp_cleanup(work);
-    c_free(data->A);
-    c_free(data->P);
-    c_free(data);
-    c_free(settings);
+    return true;
+}
+
+FemPosDeviationOsqpInterface::~FemPosDeviationOsqpInterface()
+{
+    FreeWorkspace();
+}
 
+bool FemPosDeviationOsqpInterface::SetupWorkspace()
+{
+    FreeWorkspace();
+
+    // Calculate kernel
+    P_data_.clear();
+    P_indices_.clear();
+    P_indptr_.clear();
+    CalculateKernel(&P_data_, &P_indices_, &P_indptr_);
+
+    // Calculate affine constraints
+    A_data_.clear();
+    A_indices_.clear();
+    A_indptr_.clear();
+    CalculateAffineConstraint(&A_data_, &A_indices_, &A_indptr_);
+
+    CHECK_EQ(lower_bounds_.size(), upper_bounds_.size());
+
+    data_ = reinterpret_cast<OSQPData*>(c_malloc(sizeof(OSQPData)));
+    settings_ = reinterpret_cast<OSQPSettings*>(c_malloc(sizeof(OSQPSettings)));
+
+    // Define Solver settings
+    osqp_set_default_settings(settings_);
+    settings_->max_iter = max_iter_;
+    settings_->time_limit = time_limit_;
+    settings_->verbose = verbose_;
+    settings_->scaled_termination = scaled_termination_;
+    settings_->warm_start = warm_start_;
+
+    data_->n = num_of_variables_;
+    data_->m = num_of_constraints_;
+    data_->P = csc_matrix(data_->n, data_->n, P_data_.size(), P_data_.data(),
+                          P_indices_.data(), P_indptr_.data());
+    data_->q = q_.data();
+    data_->A = csc_matrix(data_->m, data_->n, A_data_.size(), A_data_.data(),
+                          A_indices_.data(), A_indptr_.data());
+    data_->l = lower_bounds_.data();
+    data_->u = upper_bounds_.data();
+
+    work_ = osqp_setup(data_, settings_);
+    workspace_outdated_ = false;
+    return work_ != nullptr;
+}
+
+bool FemPosDeviationOsqpInterface::UpdateWorkspace()
+{
+    if (osqp_update_lin_cost(work_, q_.data()) != 0)
+    {
+        AERROR << "failed to update osqp linear cost";
+        return false;
+    }
+    if (osqp_update_bounds(work_, lower_bounds_.data(),
+                           upper_bounds_.data()) != 0)
+    {
+        AERROR << "failed to update osqp bounds";
+        return false;
+    }
     return true;
 }
 
+void FemPosDeviationOsqpInterface::FreeWorkspace()
+{
+    if (work_ != nullptr)
+    {
+        osqp_cleanup(work_);
+        work_ = nullptr;
+    }
+    if (data_ != nullptr)
+    {
+        c_free(data_->A);
+        c_free(data_->P);
+        c_free(data_);
+        data_ = nullptr;
+    }
+    if (settings_ != nullptr)
+    {
+        c_free(settings_);
+        settings_ = nullptr;
+    }
+    workspace_outdated_ = true;
+}
+
 void FemPosDeviationOsqpInterface::CalculateKernel(
         std::vector<c_float>* P_data, std::vector<c_int>* P_indices,
         std::vector<c_int>* P_indptr)
@@ -246,18 +290,18 @@ void FemPosDeviationOsqpInterface::CalculateKernel(
 
 void FemPosDeviationOsqpInterface::CalculateOffset(std::vector<c_float>* q)
 {
+    q->resize(num_of_variables_);
     for (int i = 0; i < num_of_points_; ++i)
     {
         const auto& ref_point_xy = ref_points_[i];
-        q->push_back(-2.0 * weight_ref_deviation_ * ref_point_xy.first);
-        q->push_back(-2.0 * weight_ref_deviation_ * ref_point_xy.second);
+        (*q)[2 * i] = -2.0 * weight_ref_deviation_ * ref_point_xy.first;
+        (*q)[2 * i + 1] = -2.0 * weight_ref_deviation_ * ref_point_xy.second;
     }
 }
 
 void FemPosDeviationOsqpInterface::CalculateAffineConstraint(
         std::vector<c_float>* A_data, std::vector<c_int>* A_indices,
-        std::vector<c_int>* A_indptr, std::vector<c_float>* lower_bounds,
-        std::vector<c_float>* upper_bounds)
+        std::vector<c_int>* A_indptr)
 {
     int ind_A = 0;
     for (int i = 0; i < num_of_variables_; ++i)
@@ -268,14 +312,22 @@ void FemPosDeviationOsqpInterface::CalculateAffineConstraint(
         ++ind_A;
     }
     A_indptr->push_back(ind_A);
+}
 
+void FemPosDeviationOsqpInterface::CalculateBounds(
+        std::vector<c_float>* lower_bounds, std::vector<c_float>* upper_bounds)
+{
+    lower_bounds->resize(num_of_constraints_);
+    upper_bounds->resize(num_of_constraints_);
     for (int i = 0; i < num_of_points_; ++i)
     {
         const auto& ref_point_xy = ref_points_[i];
-        upper_bounds->push_back(ref_point_xy.first + bounds_around_refs_[i]);
-        upper_bounds->push_back(ref_point_xy.second + bounds_around_refs_[i]);
-        lower_bounds->push_back(ref_point_xy.first - bounds_around_refs_[i]);
-        lower_bounds->push_back(ref_point_xy.second - bounds_around_refs_[i]);
+        (*upper_bounds)[2 * i] = ref_point_xy.first + bounds_around_refs_[i];
+        (*upper_bounds)[2 * i + 1] =
+                ref_point_xy.second + bounds_around_refs_[i];
+        (*lower_bounds)[2 * i] = ref_point_xy.first - bounds_around_refs_[i];
+        (*lower_bounds)[2 * i + 1] =
+                ref_point_xy.second - bounds_around_refs_[i];
     }
 }
 
@@ -283,57 +335,36 @@ void FemPosDeviationOsqpInterface::SetPrimalWarmStart(
         std::vector<c_float>* primal_warm_start)
 {
     CHECK_EQ(ref_points_.size(), static_cast<size_t>(num_of_points_));
-    for (const auto& ref_point_xy : ref_points_)
+    primal_warm_start->resize(num_of_variables_);
+    for (int i = 0; i < num_of_points_; ++i)
     {
-        primal_warm_start->push_back(ref_point_xy.first);
-        primal_warm_start->push_back(ref_point_xy.second);
+        (*primal_warm_start)[2 * i] = ref_points_[i].first;
+        (*primal_warm_start)[2 * i + 1] = ref_points_[i].second;
     }
 }
 
-bool FemPosDeviationOsqpInterface::OptimizeWithOsqp(
-        const size_t kernel_dim, const size_t num_affine_constraint,
-        std::vector<c_float>* P_data, std::vector<c_int>* P_indices,
-        std::vector<c_int>* P_indptr, std::vector<c_float>* A_data,
-        std::vector<c_int>* A_indices, std::vector<c_int>* A_indptr,
-        std::vector<c_float>* lower_bounds, std::vector<c_float>* upper_bounds,
-        std::vector<c_float>* q, std::vector<c_float>* primal_warm_start,
-        OSQPData* data, OSQPWorkspace** work, OSQPSettings* settings)
+bool FemPosDeviationOsqpInterface::OptimizeWithOsqp()
 {
-    CHECK_EQ(lower_bounds->size(), upper_bounds->size());
-
-    data->n = kernel_dim;
-    data->m = num_affine_constraint;
-    data->P = csc_matrix(data->n, data->n, P_data->size(), P_data->data(),
-                         P_indices->data(), P_indptr->data());
-    data->q = q->data();
-    data->A = csc_matrix(data->m, data->n, A_data->size(), A_data->data(),
-                         A_indices->data(), A_indptr->data());
-    data->l = lower_bounds->data();
-    data->u = upper_bounds->data();
-
-    *work = osqp_setup(data, settings);
-    // osqp_setup(work, data, settings);
-
-    osqp_warm_start_x(*work, primal_warm_start->data());
+    osqp_warm_start_x(work_, primal_warm_start_.data());
 
     // Solve Problem
-    osqp_solve(*work);
+    osqp_solve(work_);
 
-    auto status = (*work)->info->status_val;
+    auto status = work_->info->status_val;
 
     if (status < 0)
     {
-        AERROR << "failed optimization status:\t" << (*work)->info->status;
+        AERROR << "failed optimization status:\t" << work_->info->status;
         return false;
     }
 
     if (status != 1 && status != 2)
     {
-        AERROR << "failed optimization status:\t" << (*work)->info->status;
+        AERROR << "failed optimization status:\t" << work_->info->status;
         return false;
     }
 
-    return true;
+    return work_->solution != nullptr;
 }
 
 }  // namespace planning
@@ -29,12 +29,23 @@ namespace apollo
 {
 namespace planning
 {
+/*
+ * The kernel and the affine constraint matrix only depend on the number of
+ * points and the weights, so the osqp workspace (and its KKT factorization)
+ * is kept across Solve() calls. As long as the number of points does not
+ * change, only the offset and the bounds are updated before solving again.
+ * Changing a weight or an osqp setting triggers a new setup.
+ */
 class FemPosDeviationOsqpInterface
 {
 public:
     FemPosDeviationOsqpInterface() = default;
 
-    virtual ~FemPosDeviationOsqpInterface() = default;
+    virtual ~FemPosDeviationOsqpInterface();
+
+    FemPosDeviationOsqpInterface(const FemPosDeviationOsqpInterface&) = delete;
+    FemPosDeviationOsqpInterface& operator=(
+            const FemPosDeviationOsqpInterface&) = delete;
 
     void set_ref_points(
             const std::vector<std::pair<double, double>>& ref_points)
@@ -50,30 +61,50 @@ public:
     void set_weight_fem_pos_deviation(const double weight_fem_pos_deviation)
     {
         weight_fem_pos_deviation_ = weight_fem_pos_deviation;
+        workspace_outdated_ = true;
     }
 
     void set_weight_path_length(const double weight_path_length)
     {
         weight_path_length_ = weight_path_length;
+        workspace_outdated_ = true;
     }
 
     void set_weight_ref_deviation(const double weight_ref_deviation)
     {
         weight_ref_deviation_ = weight_ref_deviation;
+        workspace_outdated_ = true;
     }
 
-    void set_max_iter(const int max_iter) { max_iter_ = max_iter; }
+    void set_max_iter(const int max_iter)
+    {
+        max_iter_ = max_iter;
+        workspace_outdated_ = true;
+    }
 
-    void set_time_limit(const double time_limit) { time_limit_ = time_limit; }
+    void set_time_limit(const double time_limit)
+    {
+        time_limit_ = time_limit;
+        workspace_outdated_ = true;
+    }
 
-    void set_verbose(const bool verbose) { verbose_ = verbose; }
+    void set_verbose(const bool verbose)
+    {
+        verbose_ = verbose;
+        workspace_outdated_ = true;
+    }
 
     void set_scaled_termination(const bool scaled_termination)
     {
         scaled_termination_ = scaled_termination;
+        workspace_outdated_ = true;
     }
 
-    void set_warm_start(const bool warm_start) { warm_start_ = warm_start; }
+    void set_warm_start(const bool warm_start)
+    {
+        warm_start_ = warm_start;
+        workspace_outdated_ = true;
+    }
 
     bool Solve();
 
@@ -90,21 +121,20 @@ private:
 
     void CalculateAffineConstraint(std::vector<c_float>* A_data,
                                    std::vector<c_int>* A_indices,
-                                   std::vector<c_int>* A_indptr,
-                                   std::vector<c_float>* lower_bounds,
-                                   std::vector<c_float>* upper_bounds);
+                                   std::vector<c_int>* A_indptr);
+
+    void CalculateBounds(std::vector<c_float>* lower_bounds,
+                         std::vector<c_float>* upper_bounds);
 
     void SetPrimalWarmStart(std::vector<c_float>* primal_warm_start);
 
-    bool OptimizeWithOsqp(
-            const size_t kernel_dim, const size_t num_affine_constraint,
-            std::vector<c_float>* P_data, std::vector<c_int>* P_indices,
-            std::vector<c_int>* P_indptr, std::vector<c_float>* A_data,
-            std::vector<c_int>* A_indices, std::vector<c_int>* A_indptr,
-            std::vector<c_float>* lower_bounds,
-            std::vector<c_float>* upper_bounds, std::vector<c_float>* q,
-            std::vector<c_float>* primal_warm_start, OSQPData* data,
-            OSQPWorkspace** work, OSQPSettings* settings);
+    bool SetupWorkspace();
+
+    bool UpdateWorkspace();
+
+    void FreeWorkspace();
+
+    bool OptimizeWithOsqp();
 
 private:
     // Reference points and deviation bounds
@@ -128,6 +158,24 @@ private:
     int num_of_variables_ = 0;
     int num_of_constraints_ = 0;
 
+    // Optimization problem data, kept alive together with the workspace
+    std::vector<c_float> P_data_;
+    std::vector<c_int> P_indices_;
+    std::vector<c_int> P_indptr_;
+    std::vector<c_float> A_data_;
+    std::vector<c_int> A_indices_;
+    std::vector<c_int> A_indptr_;
+    std::vector<c_float> lower_bounds_;
+    std::vector<c_float> upper_bounds_;
+    std::vector<c_float> q_;
+    std::vector<c_float> primal_warm_start_;
+
+    // Osqp workspace reused across Solve() calls
+    OSQPData* data_ = nullptr;
+    OSQPSettings* settings_ = nullptr;
+    OSQPWorkspace* work_ = nullptr;
+    bool workspace_outdated_ = true;
+
     // Optimized_result
     std::vector<double> x_;
     std::vector<double> y_;
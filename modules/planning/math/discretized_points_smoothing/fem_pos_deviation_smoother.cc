@@ -38,6 +38,8 @@ FemPosDeviationSmoother::FemPosDeviationSmoother(
 {
 }
 
+FemPosDeviationSmoother::~FemPosDeviationSmoother() = default;
+
 bool FemPosDeviationSmoother::Solve(
         const std::vector<std::pair<double, double>>& raw_point2d,
         const std::vector<double>& bounds, std::vector<double>* opt_x,
@@ -72,17 +74,23 @@ bool FemPosDeviationSmoother::QpWithOsqp(
         return false;
     }
 
-    FemPosDeviationOsqpInterface solver;
-
-    solver.set_weight_fem_pos_deviation(config_.weight_fem_pos_deviation());
-    solver.set_weight_path_length(config_.weight_path_length());
-    solver.set_weight_ref_deviation(config_.weight_ref_deviation());
-
-    solver.set_max_iter(config_.max_iter());
-    solver.set_time_limit(config_.time_limit());
-    solver.set_verbose(config_.verbose());
-    solver.set_scaled_termination(config_.scaled_termination());
-    solver.set_warm_start(config_.warm_start());
+    if (qp_solver_ == nullptr)
+    {
+        qp_solver_.reset(new FemPosDeviationOsqpInterface());
+        auto& solver = *qp_solver_;
+
+        solver.set_weight_fem_pos_deviation(
+                config_.weight_fem_pos_deviation());
+        solver.set_weight_path_length(config_.weight_path_length());
+        solver.set_weight_ref_deviation(config_.weight_ref_deviation());
+
+        solver.set_max_iter(config_.max_iter());
+        solver.set_time_limit(config_.time_limit());
+        solver.set_verbose(config_.verbose());
+        solver.set_scaled_termination(config_.scaled_termination());
+        solver.set_warm_start(config_.warm_start());
+    }
+    auto& solver = *qp_solver_;
 
     solver.set_ref_points(raw_point2d);
     solver.set_bounds_around_refs(bounds);
@@ -108,26 +116,32 @@ bool FemPosDeviationSmoother::SqpWithOsqp(
         return false;
     }
 
-    FemPosDeviationSqpOsqpInterface solver;
-
-    solver.set_weight_fem_pos_deviation(config_.weight_fem_pos_deviation());
-    solver.set_weight_path_length(config_.weight_path_length());
-    solver.set_weight_ref_deviation(config_.weight_ref_deviation());
-    solver.set_weight_curvature_constraint_slack_var(
-            config_.weight_curvature_constraint_slack_var());
-
-    solver.set_curvature_constraint(config_.curvature_constraint());
-
-    solver.set_sqp_sub_max_iter(config_.sqp_sub_max_iter());
-    solver.set_sqp_ftol(config_.sqp_ftol());
-    solver.set_sqp_pen_max_iter(config_.sqp_pen_max_iter());
-    solver.set_sqp_ctol(config_.sqp_ctol());
-
-    solver.set_max_iter(config_.max_iter());
-    solver.set_time_limit(config_.time_limit());
-    solver.set_verbose(config_.verbose());
-    solver.set_scaled_termination(config_.scaled_termination());
-    solver.set_warm_start(config_.warm_start());
+    if (sqp_solver_ == nullptr)
+    {
+        sqp_solver_.reset(new FemPosDeviationSqpOsqpInterface());
+        auto& solver = *sqp_solver_;
+
+        solver.set_weight_fem_pos_deviation(
+                config_.weight_fem_pos_deviation());
+        solver.set_weight_path_length(config_.weight_path_length());
+        solver.set_weight_ref_deviation(config_.weight_ref_deviation());
+        solver.set_weight_curvature_constraint_slack_var(
+                config_.weight_curvature_constraint_slack_var());
+
+        solver.set_curvature_constraint(config_.curvature_constraint());
+
+        solver.set_sqp_sub_max_iter(config_.sqp_sub_max_iter());
+        solver.set_sqp_ftol(config_.sqp_ftol());
+        solver.set_sqp_pen_max_iter(config_.sqp_pen_max_iter());
+        solver.set_sqp_ctol(config_.sqp_ctol());
+
+        solver.set_max_iter(config_.max_iter());
+        solver.set_time_limit(config_.time_limit());
+        solver.set_verbose(config_.verbose());
+        solver.set_scaled_termination(config_.scaled_termination());
+        solver.set_warm_start(config_.warm_start());
+    }
+    auto& solver = *sqp_solver_;
 
     solver.set_ref_points(raw_point2d);
     solver.set_bounds_around_refs(bounds);
@@ -137,7 +151,7 @@ bool FemPosDeviationSmoother::SqpWithOsqp(
         return false;
     }
 
-    std::vector<std::pair<double, double>> opt_xy = solver.opt_xy();
+    const auto& opt_xy = solver.opt_xy();
 
     // TODO(Jinyun): unify output data container
     opt_x->resize(opt_xy.size());
@@ -20,6 +20,7 @@
 
 #pragma once
 
+#include <memory>
 #include <utility>
 #include <vector>
 
@@ -29,6 +30,9 @@ namespace apollo
 {
 namespace planning
 {
+class FemPosDeviationOsqpInterface;
+class FemPosDeviationSqpOsqpInterface;
+
 /*
  * @brief:
  * This class solve an optimization problem:
@@ -43,6 +47,9 @@ namespace planning
  *
  * Given an initial set of points from 0 to k-1,  The goal is to find a set of
  * points which makes the line P(start), P0, P(1) ... P(k-1) "smooth".
+ *
+ * The osqp based solvers are owned by the smoother, so keeping the smoother
+ * alive between calls lets them reuse their workspace.
  */
 
 class FemPosDeviationSmoother
@@ -51,6 +58,8 @@ public:
     explicit FemPosDeviationSmoother(
             const FemPosDeviationSmootherConfig& config);
 
+    ~FemPosDeviationSmoother();
+
     bool Solve(const std::vector<std::pair<double, double>>& raw_point2d,
                const std::vector<double>& bounds, std::vector<double>* opt_x,
                std::vector<double>* opt_y);
@@ -69,6 +78,10 @@ public:
 
 private:
     FemPosDeviationSmootherConfig config_;
+
+    std::unique_ptr<FemPosDeviationOsqpInterface> qp_solver_;
+
+    std::unique_ptr<FemPosDeviationSqpOsqpInterface> sqp_solver_;
 };
 }  // namespace planning
 }  // namespace apollo
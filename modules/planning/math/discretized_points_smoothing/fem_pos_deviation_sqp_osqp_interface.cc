@@ -57,8 +57,12 @@ bool FemPosDeviationSqpOsqpInterface::Solve()
         return false;
     }
 
+    const int num_of_points = static_cast<int>(ref_points_.size());
+    const bool reuse_workspace = work_ != nullptr && !workspace_outdated_ &&
+                                 num_of_points == num_of_points_;
+
     // Calculate optimization states definitions
-    num_of_points_ = static_cast<int>(ref_points_.size());
+    num_of_points_ = num_of_points;
     num_of_pos_variables_ = num_of_points_ * 2;
     num_of_slack_variables_ = num_of_points_ - 2;
     num_of_variables_ = num_of_pos_variables_ + num_of_slack_variables_;
@@ -68,72 +72,34 @@ bool FemPosDeviationSqpOsqpInterface::Solve()
     num_of_constraints_ =
             num_of_variable_constraints_ + num_of_curvature_constraints_;
 
-    // Set primal warm start
-    std::vector<c_float> primal_warm_start;
-    SetPrimalWarmStart(ref_points_, &primal_warm_start);
+    // Slack variables start from zero for every new reference line
+    slack_.assign(num_of_slack_variables_, 0.0);
 
-    // Calculate kernel
-    std::vector<c_float> P_data;
-    std::vector<c_int> P_indices;
-    std::vector<c_int> P_indptr;
-    CalculateKernel(&P_data, &P_indices, &P_indptr);
+    // Set primal warm start
+    SetPrimalWarmStart(ref_points_, &primal_warm_start_);
 
     // Calculate offset
-    std::vector<c_float> q;
-    CalculateOffset(&q);
+    CalculateOffset(&q_);
 
     // Calculate affine constraints
-    std::vector<c_float> A_data;
-    std::vector<c_int> A_indices;
-    std::vector<c_int> A_indptr;
-    std::vector<c_float> lower_bounds;
-    std::vector<c_float> upper_bounds;
-    CalculateAffineConstraint(ref_points_, &A_data, &A_indices, &A_indptr,
-                              &lower_bounds, &upper_bounds);
-
-    // Load matrices and vectors into OSQPData
-    OSQPData* data = reinterpret_cast<OSQPData*>(c_malloc(sizeof(OSQPData)));
-    data->n = num_of_variables_;
-    data->m = num_of_constraints_;
-    data->P = csc_matrix(data->n, data->n, P_data.size(), P_data.data(),
-                         P_indices.data(), P_indptr.data());
-    data->q = q.data();
-    data->A = csc_matrix(data->m, data->n, A_data.size(), A_data.data(),
-                         A_indices.data(), A_indptr.data());
-    data->l = lower_bounds.data();
-    data->u = upper_bounds.data();
-
-    // Define osqp solver settings
-    OSQPSettings* settings =
-            reinterpret_cast<OSQPSettings*>(c_malloc(sizeof(OSQPSettings)));
-    osqp_set_default_settings(settings);
-    settings->max_iter = max_iter_;
-    settings->time_limit = time_limit_;
-    settings->verbose = verbose_;
-    settings->scaled_termination = scaled_termination_;
-    settings->warm_start = warm_start_;
-    settings->polish = true;
-    settings->eps_abs = 1e-5;
-    settings->eps_rel = 1e-5;
-    settings->eps_prim_inf = 1e-5;
-    settings->eps_dual_inf = 1e-5;
+    if (!reuse_workspace)
+    {
+        A_data_.clear();
+        A_indices_.clear();
+        A_indptr_.clear();
+        CalculateAffineConstraintStructure(&A_data_, &A_indices_, &A_indptr_);
+    }
+    CalculateAffineConstraint(ref_points_, &A_data_, &lower_bounds_,
+                              &upper_bounds_);
 
-    // Define osqp workspace
-    OSQPWorkspace* work = nullptr;
-    // osqp_setup(&work, data, settings);
-    work = osqp_setup(data, settings);
+    const bool workspace_ready =
+            reuse_workspace ? UpdateWorkspace() : SetupWorkspace();
 
     // Initial solution
-    bool initial_solve_res = OptimizeWithOsqp(primal_warm_start, &work);
-
-    if (!initial_solve_res)
+    if (!workspace_ready || !OptimizeWithOsqp(primal_warm_start_))
     {
         AERROR << "initial iteration solving fails";
-        osqp_cleanup(work);
-        c_free(data->A);
-        c_free(data->P);
-        c_free(data);
-        c_free(settings);
+        FreeWorkspace();
         return false;
     }
 
@@ -142,7 +108,7 @@ bool FemPosDeviationSqpOsqpInterface::Solve()
     int pen_itr = 0;
     double ctol = 0.0;
     double original_slack_penalty = weight_curvature_constraint_slack_var_;
-    double last_fvalue = work->info->obj_val;
+    double last_fvalue = work_->info->obj_val;
 
     while (pen_itr < sqp_pen_max_iter_)
     {
@@ -151,31 +117,24 @@ bool FemPosDeviationSqpOsqpInterface::Solve()
 
         while (sub_itr < sqp_sub_max_iter_)
         {
-            SetPrimalWarmStart(opt_xy_, &primal_warm_start);
-            CalculateOffset(&q);
-            CalculateAffineConstraint(opt_xy_, &A_data, &A_indices, &A_indptr,
-                                      &lower_bounds, &upper_bounds);
-            osqp_update_lin_cost(work, q.data());
-            osqp_update_A(work, A_data.data(), OSQP_NULL, A_data.size());
-            osqp_update_bounds(work, lower_bounds.data(), upper_bounds.data());
-
-            bool iterative_solve_res =
-                    OptimizeWithOsqp(primal_warm_start, &work);
+            SetPrimalWarmStart(opt_xy_, &primal_warm_start_);
+            CalculateOffset(&q_);
+            CalculateAffineConstraint(opt_xy_, &A_data_, &lower_bounds_,
+                                      &upper_bounds_);
+
+            bool iterative_solve_res = UpdateWorkspace() &&
+                                       OptimizeWithOsqp(primal_warm_start_);
             if (!iterative_solve_res)
             {
                 AERROR << "iteration at " << sub_itr
                        << ", solving fails with max sub iter "
                        << sqp_sub_max_iter_;
                 weight_curvature_constraint_slack_var_ = original_slack_penalty;
-                osqp_cleanup(work);
-                c_free(data->A);
-                c_free(data->P);
-                c_free(data);
-                c_free(settings);
+                FreeWorkspace();
                 return false;
             }
 
-            double cur_fvalue = work->info->obj_val;
+            double cur_fvalue = work_->info->obj_val;
             double ftol = std::abs((last_fvalue - cur_fvalue) / last_fvalue);
 
             if (ftol < sqp_ftol_)
@@ -197,11 +156,7 @@ bool FemPosDeviationSqpOsqpInterface::Solve()
         {
             AERROR << "Max number of iteration reached";
             weight_curvature_constraint_slack_var_ = original_slack_penalty;
-            osqp_cleanup(work);
-            c_free(data->A);
-            c_free(data->P);
-            c_free(data);
-            c_free(settings);
+            FreeWorkspace();
             return false;
         }
 
@@ -215,11 +170,6 @@ bool FemPosDeviationSqpOsqpInterface::Solve()
             ADEBUG << "constraint voilation value drops to " << ctol
                    << ", under max_ctol " << sqp_ctol_;
             weight_curvature_constraint_slack_var_ = original_slack_penalty;
-            osqp_cleanup(work);
-            c_free(data->A);
-            c_free(data->P);
-            c_free(data);
-            c_free(settings);
             return true;
         }
 
@@ -231,14 +181,92 @@ bool FemPosDeviationSqpOsqpInterface::Solve()
     ADEBUG << "constraint voilation value drops to " << ctol
            << ", higher than max_ctol " << sqp_ctol_;
     weight_curvature_constraint_slack_var_ = original_slack_penalty;
-    osqp_cleanup(work);
-    c_free(data->A);
-    c_free(data->P);
-    c_free(data);
-    c_free(settings);
     return true;
 }
 
+FemPosDeviationSqpOsqpInterface::~FemPosDeviationSqpOsqpInterface()
+{
+    FreeWorkspace();
+}
+
+bool FemPosDeviationSqpOsqpInterface::SetupWorkspace()
+{
+    FreeWorkspace();
+
+    // Calculate kernel
+    P_data_.clear();
+    P_indices_.clear();
+    P_indptr_.clear();
+    CalculateKernel(&P_data_, &P_indices_, &P_indptr_);
+
+    // Load matrices and vectors into OSQPData
+    data_ = reinterpret_cast<OSQPData*>(c_malloc(sizeof(OSQPData)));
+    data_->n = num_of_variables_;
+    data_->m = num_of_constraints_;
+    data_->P = csc_matrix(data_->n, data_->n, P_data_.size(), P_data_.data(),
+                          P_indices_.data(), P_indptr_.data());
+    data_->q = q_.data();
+    data_->A = csc_matrix(data_->m, data_->n, A_data_.size(), A_data_.data(),
+                          A_indices_.data(), A_indptr_.data());
+    data_->l = lower_bounds_.data();
+    data_->u = upper_bounds_.data();
+
+    // Define osqp solver settings
+    settings_ = reinterpret_cast<OSQPSettings*>(c_malloc(sizeof(OSQPSettings)));
+    osqp_set_default_settings(settings_);
+    settings_->max_iter = max_iter_;
+    settings_->time_limit = time_limit_;
+    settings_->verbose = verbose_;
+    settings_->scaled_termination = scaled_termination_;
+    settings_->warm_start = warm_start_;
+    settings_->polish = true;
+    settings_->eps_abs = 1e-5;
+    settings_->eps_rel = 1e-5;
+    settings_->eps_prim_inf = 1e-5;
+    settings_->eps_dual_inf = 1e-5;
+
+    // Define osqp workspace
+    work_ = osqp_setup(data_, settings_);
+    workspace_outdated_ = false;
+    return work_ != nullptr;
+}
+
+bool FemPosDeviationSqpOsqpInterface::UpdateWorkspace()
+{
+    // The sparsity pattern of A never changes, only its values are updated
+    if (osqp_update_lin_cost(work_, q_.data()) != 0 ||
+        osqp_update_A(work_, A_data_.data(), OSQP_NULL, A_data_.size()) != 0 ||
+        osqp_update_bounds(work_, lower_bounds_.data(),
+                           upper_bounds_.data()) != 0)
+    {
+        AERROR << "failed to update osqp workspace";
+        return false;
+    }
+    return true;
+}
+
+void FemPosDeviationSqpOsqpInterface::FreeWorkspace()
+{
+    if (work_ != nullptr)
+    {
+        osqp_cleanup(work_);
+        work_ = nullptr;
+    }
+    if (data_ != nullptr)
+    {
+        c_free(data_->A);
+        c_free(data_->P);
+        c_free(data_);
+        data_ = nullptr;
+    }
+    if (settings_ != nullptr)
+    {
+        c_free(settings_);
+        settings_ = nullptr;
+    }
+    workspace_outdated_ = true;
+}
+
 void FemPosDeviationSqpOsqpInterface::CalculateKernel(
         std::vector<c_float>* P_data, std::vector<c_int>* P_indices,
         std::vector<c_int>* P_indptr)
@@ -368,105 +396,130 @@ void FemPosDeviationSqpOsqpInterface::CalculateOffset(std::vector<c_float>* q)
     }
 }
 
-std::vector<double>
-FemPosDeviationSqpOsqpInterface::CalculateLinearizedFemPosParams(
+void FemPosDeviationSqpOsqpInterface::CalculateLinearizedFemPosParams(
         const std::vector<std::pair<double, double>>& points,
-        const size_t index)
+        const size_t index, double* const params)
 {
-    CHECK_GT(index, 0U);
-    CHECK_LT(index, points.size() - 1);
-
-    double x_f = points[index - 1].first;
-    double x_m = points[index].first;
-    double x_l = points[index + 1].first;
-    double y_f = points[index - 1].second;
-    double y_m = points[index].second;
-    double y_l = points[index + 1].second;
-
-    double linear_term_x_f = 2.0 * x_f - 4.0 * x_m + 2.0 * x_l;
-    double linear_term_x_m = 8.0 * x_m - 4.0 * x_f - 4.0 * x_l;
-    double linear_term_x_l = 2.0 * x_l - 4.0 * x_m + 2.0 * x_f;
-    double linear_term_y_f = 2.0 * y_f - 4.0 * y_m + 2.0 * y_l;
-    double linear_term_y_m = 8.0 * y_m - 4.0 * y_f - 4.0 * y_l;
-    double linear_term_y_l = 2.0 * y_l - 4.0 * y_m + 2.0 * y_f;
-
-    double linear_approx = (-2.0 * x_m + x_f + x_l) * (-2.0 * x_m + x_f + x_l) +
-                           (-2.0 * y_m + y_f + y_l) * (-2.0 * y_m + y_f + y_l) +
-                           -x_f * linear_term_x_f + -x_m * linear_term_x_m +
-                           -x_l * linear_term_x_l + -y_f * linear_term_y_f +
-                           -y_m * linear_term_y_m + -y_l * linear_term_y_l;
-
-    return {linear_term_x_f, linear_term_y_f, linear_term_x_m, linear_term_y_m,
-            linear_term_x_l, linear_term_y_l, linear_approx};
+    DCHECK_GT(index, 0U);
+    DCHECK_LT(index, points.size() - 1);
+
+    const double x_f = points[index - 1].first;
+    const double x_m = points[index].first;
+    const double x_l = points[index + 1].first;
+    const double y_f = points[index - 1].second;
+    const double y_m = points[index].second;
+    const double y_l = points[index + 1].second;
+
+    // Gradient of the squared second order difference
+    // (x_f - 2x_m + x_l)^2 + (y_f - 2y_m + y_l)^2, which is linear in the
+    // points, so both the jacobian and the constant term are exact.
+    const double dx = x_f - 2.0 * x_m + x_l;
+    const double dy = y_f - 2.0 * y_m + y_l;
+
+    const double linear_term_x_f = 2.0 * dx;
+    const double linear_term_x_m = -4.0 * dx;
+    const double linear_term_x_l = 2.0 * dx;
+    const double linear_term_y_f = 2.0 * dy;
+    const double linear_term_y_m = -4.0 * dy;
+    const double linear_term_y_l = 2.0 * dy;
+
+    // f(p) - grad(p)' * p, with grad(p)' * p = 2 * f(p) for the quadratic form
+    const double linear_approx = -(dx * dx + dy * dy);
+
+    params[0] = linear_term_x_f;
+    params[1] = linear_term_y_f;
+    params[2] = linear_term_x_m;
+    params[3] = linear_term_y_m;
+    params[4] = linear_term_x_l;
+    params[5] = linear_term_y_l;
+    params[6] = linear_approx;
 }
 
-void FemPosDeviationSqpOsqpInterface::CalculateAffineConstraint(
-        const std::vector<std::pair<double, double>>& points,
+void FemPosDeviationSqpOsqpInterface::CalculateAffineConstraintStructure(
         std::vector<c_float>* A_data, std::vector<c_int>* A_indices,
-        std::vector<c_int>* A_indptr, std::vector<c_float>* lower_bounds,
-        std::vector<c_float>* upper_bounds)
+        std::vector<c_int>* A_indptr)
 {
-    const double scale_factor = 1;
-
-    std::vector<std::vector<double>> lin_cache;
-    for (int i = 1; i < num_of_points_ - 1; ++i)
-    {
-        lin_cache.push_back(CalculateLinearizedFemPosParams(points, i));
-    }
-
-    std::vector<std::vector<std::pair<c_int, c_float>>> columns;
-    columns.resize(num_of_variables_);
-
-    for (int i = 0; i < num_of_variables_; ++i)
+    // Per column the rows are, in this order:
+    // 1. the variable bound itself;
+    // 2. for slack variables, the curvature constraint it relaxes;
+    // 3. for position variables, the curvature constraints of the point as
+    // the last, the middle and the first point of the triple.
+    int ind_a = 0;
+    for (int i = 0; i < num_of_pos_variables_; ++i)
     {
-        columns[i].emplace_back(i, 1.0);
+        const int point_index = i / 2;
+        A_indptr->push_back(ind_a);
+        A_indices->push_back(i);
+        ++ind_a;
+        if (point_index >= 2)
+        {
+            A_indices->push_back(point_index - 2 + num_of_variables_);
+            ++ind_a;
+        }
+        if (point_index >= 1 && point_index < num_of_points_ - 1)
+        {
+            A_indices->push_back(point_index - 1 + num_of_variables_);
+            ++ind_a;
+        }
+        if (point_index < num_of_points_ - 2)
+        {
+            A_indices->push_back(point_index + num_of_variables_);
+            ++ind_a;
+        }
     }
-
     for (int i = num_of_pos_variables_; i < num_of_variables_; ++i)
     {
-        columns[i].emplace_back(i + num_of_slack_variables_,
-                                -1.0 * scale_factor);
-    }
-
-    for (int i = 2; i < num_of_points_; ++i)
-    {
-        int index = 2 * i;
-        columns[index].emplace_back(i - 2 + num_of_variables_,
-                                    lin_cache[i - 2][4] * scale_factor);
-        columns[index + 1].emplace_back(i - 2 + num_of_variables_,
-                                        lin_cache[i - 2][5] * scale_factor);
+        A_indptr->push_back(ind_a);
+        A_indices->push_back(i);
+        A_indices->push_back(i + num_of_slack_variables_);
+        ind_a += 2;
     }
+    A_indptr->push_back(ind_a);
+    A_data->resize(ind_a);
+}
 
+void FemPosDeviationSqpOsqpInterface::CalculateAffineConstraint(
+        const std::vector<std::pair<double, double>>& points,
+        std::vector<c_float>* A_data, std::vector<c_float>* lower_bounds,
+        std::vector<c_float>* upper_bounds)
+{
+    linearized_params_.resize(num_of_curvature_constraints_ *
+                              kNumLinearizedParams);
     for (int i = 1; i < num_of_points_ - 1; ++i)
     {
-        int index = 2 * i;
-        columns[index].emplace_back(i - 1 + num_of_variables_,
-                                    lin_cache[i - 1][2] * scale_factor);
-        columns[index + 1].emplace_back(i - 1 + num_of_variables_,
-                                        lin_cache[i - 1][3] * scale_factor);
-    }
-
-    for (int i = 0; i < num_of_points_ - 2; ++i)
-    {
-        int index = 2 * i;
-        columns[index].emplace_back(i + num_of_variables_,
-                                    lin_cache[i][0] * scale_factor);
-        columns[index + 1].emplace_back(i + num_of_variables_,
-                                        lin_cache[i][1] * scale_factor);
+        CalculateLinearizedFemPosParams(
+                points, i,
+                &linearized_params_[(i - 1) * kNumLinearizedParams]);
     }
 
-    int ind_a = 0;
-    for (int i = 0; i < num_of_variables_; ++i)
+    // Fill values following the fixed pattern of
+    // CalculateAffineConstraintStructure()
+    const double* lin = linearized_params_.data();
+    c_float* a = A_data->data();
+    for (int i = 0; i < num_of_pos_variables_; ++i)
     {
-        A_indptr->push_back(ind_a);
-        for (const auto& row_data_pair : columns[i])
+        const int point_index = i / 2;
+        const int coord = i % 2;
+        *a++ = 1.0;
+        if (point_index >= 2)
         {
-            A_data->push_back(row_data_pair.second);
-            A_indices->push_back(row_data_pair.first);
-            ++ind_a;
+            *a++ = lin[(point_index - 2) * kNumLinearizedParams + 4 + coord];
+        }
+        if (point_index >= 1 && point_index < num_of_points_ - 1)
+        {
+            *a++ = lin[(point_index - 1) * kNumLinearizedParams + 2 + coord];
+        }
+        if (point_index < num_of_points_ - 2)
+        {
+            *a++ = lin[point_index * kNumLinearizedParams + coord];
         }
     }
-    A_indptr->push_back(ind_a);
+    for (int i = num_of_pos_variables_; i < num_of_variables_; ++i)
+    {
+        *a++ = 1.0;
+        *a++ = -1.0;
+    }
+    CHECK_EQ(static_cast<size_t>(a - A_data->data()), A_data->size());
 
     lower_bounds->resize(num_of_constraints_);
     upper_bounds->resize(num_of_constraints_);
@@ -494,7 +547,7 @@ void FemPosDeviationSqpOsqpInterface::CalculateAffineConstraint(
     for (int i = 0; i < num_of_curvature_constraints_; ++i)
     {
         (*upper_bounds)[num_of_variable_constraints_ + i] =
-                (curvature_constraint_sqr - lin_cache[i][6]) * scale_factor;
+                curvature_constraint_sqr - lin[i * kNumLinearizedParams + 6];
         (*lower_bounds)[num_of_variable_constraints_ + i] = -1e20;
     }
 }
@@ -537,24 +590,24 @@ void FemPosDeviationSqpOsqpInterface::SetPrimalWarmStart(
 }
 
 bool FemPosDeviationSqpOsqpInterface::OptimizeWithOsqp(
-        const std::vector<c_float>& primal_warm_start, OSQPWorkspace** work)
+        const std::vector<c_float>& primal_warm_start)
 {
-    osqp_warm_start_x(*work, primal_warm_start.data());
+    osqp_warm_start_x(work_, primal_warm_start.data());
 
     // Solve Problem
-    osqp_solve(*work);
+    osqp_solve(work_);
 
-    auto status = (*work)->info->status_val;
+    auto status = work_->info->status_val;
 
     if (status < 0)
     {
-        AERROR << "failed optimization status:\t" << (*work)->info->status;
+        AERROR << "failed optimization status:\t" << work_->info->status;
         return false;
     }
 
     if (status != 1 && status != 2)
     {
-        AERROR << "failed optimization status:\t" << (*work)->info->status;
+        AERROR << "failed optimization status:\t" << work_->info->status;
         return false;
     }
 
@@ -564,13 +617,13 @@ bool FemPosDeviationSqpOsqpInterface::OptimizeWithOsqp(
     for (int i = 0; i < num_of_points_; ++i)
     {
         int index = i * 2;
-        opt_xy_.at(i) = std::make_pair((*work)->solution->x[index],
-                                       (*work)->solution->x[index + 1]);
+        opt_xy_.at(i) = std::make_pair(work_->solution->x[index],
+                                       work_->solution->x[index + 1]);
     }
 
     for (int i = 0; i < num_of_slack_variables_; ++i)
     {
-        slack_.at(i) = (*work)->solution->x[num_of_pos_variables_ + i];
+        slack_.at(i) = work_->solution->x[num_of_pos_variables_ + i];
     }
 
     return true;
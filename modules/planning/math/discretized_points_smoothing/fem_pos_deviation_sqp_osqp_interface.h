@@ -29,12 +29,24 @@ namespace apollo
 {
 namespace planning
 {
+/*
+ * The sparsity pattern of the linearized curvature constraints is fixed for a
+ * given number of points, so the constraint matrix structure is built once and
+ * every SQP iteration only rewrites its values. The osqp workspace is also
+ * kept across Solve() calls with the same number of points. Changing a
+ * weight that enters the kernel or an osqp setting triggers a new setup.
+ */
 class FemPosDeviationSqpOsqpInterface
 {
 public:
     FemPosDeviationSqpOsqpInterface() = default;
 
-    virtual ~FemPosDeviationSqpOsqpInterface() = default;
+    virtual ~FemPosDeviationSqpOsqpInterface();
+
+    FemPosDeviationSqpOsqpInterface(const FemPosDeviationSqpOsqpInterface&) =
+            delete;
+    FemPosDeviationSqpOsqpInterface& operator=(
+            const FemPosDeviationSqpOsqpInterface&) = delete;
 
     void set_ref_points(
             const std::vector<std::pair<double, double>>& ref_points)
@@ -50,16 +62,19 @@ public:
     void set_weight_fem_pos_deviation(const double weight_fem_pos_deviation)
     {
         weight_fem_pos_deviation_ = weight_fem_pos_deviation;
+        workspace_outdated_ = true;
     }
 
     void set_weight_path_length(const double weight_path_length)
     {
         weight_path_length_ = weight_path_length;
+        workspace_outdated_ = true;
     }
 
     void set_weight_ref_deviation(const double weight_ref_deviation)
     {
         weight_ref_deviation_ = weight_ref_deviation;
+        workspace_outdated_ = true;
     }
 
     void set_weight_curvature_constraint_slack_var(
@@ -74,18 +89,35 @@ public:
         curvature_constraint_ = curvature_constraint;
     }
 
-    void set_max_iter(const int max_iter) { max_iter_ = max_iter; }
+    void set_max_iter(const int max_iter)
+    {
+        max_iter_ = max_iter;
+        workspace_outdated_ = true;
+    }
 
-    void set_time_limit(const double time_limit) { time_limit_ = time_limit; }
+    void set_time_limit(const double time_limit)
+    {
+        time_limit_ = time_limit;
+        workspace_outdated_ = true;
+    }
 
-    void set_verbose(const bool verbose) { verbose_ = verbose; }
+    void set_verbose(const bool verbose)
+    {
+        verbose_ = verbose;
+        workspace_outdated_ = true;
+    }
 
     void set_scaled_termination(const bool scaled_termination)
     {
         scaled_termination_ = scaled_termination;
+        workspace_outdated_ = true;
     }
 
-    void set_warm_start(const bool warm_start) { warm_start_ = warm_start; }
+    void set_warm_start(const bool warm_start)
+    {
+        warm_start_ = warm_start;
+        workspace_outdated_ = true;
+    }
 
     void set_sqp_pen_max_iter(const int sqp_pen_max_iter)
     {
@@ -115,22 +147,30 @@ private:
 
     void CalculateOffset(std::vector<c_float>* q);
 
-    std::vector<double> CalculateLinearizedFemPosParams(
+    void CalculateLinearizedFemPosParams(
             const std::vector<std::pair<double, double>>& points,
-            const size_t index);
+            const size_t index, double* const params);
+
+    void CalculateAffineConstraintStructure(std::vector<c_float>* A_data,
+                                            std::vector<c_int>* A_indices,
+                                            std::vector<c_int>* A_indptr);
 
     void CalculateAffineConstraint(
             const std::vector<std::pair<double, double>>& points,
-            std::vector<c_float>* A_data, std::vector<c_int>* A_indices,
-            std::vector<c_int>* A_indptr, std::vector<c_float>* lower_bounds,
+            std::vector<c_float>* A_data, std::vector<c_float>* lower_bounds,
             std::vector<c_float>* upper_bounds);
 
     void SetPrimalWarmStart(
             const std::vector<std::pair<double, double>>& points,
             std::vector<c_float>* primal_warm_start);
 
-    bool OptimizeWithOsqp(const std::vector<c_float>& primal_warm_start,
-                          OSQPWorkspace** work);
+    bool SetupWorkspace();
+
+    bool UpdateWorkspace();
+
+    void FreeWorkspace();
+
+    bool OptimizeWithOsqp(const std::vector<c_float>& primal_warm_start);
 
     double CalculateConstraintViolation(
             const std::vector<std::pair<double, double>>& points);
@@ -169,6 +209,29 @@ private:
     int num_of_curvature_constraints_ = 0;
     int num_of_constraints_ = 0;
 
+    // Linearized fem pos params of every middle point, kNumLinearizedParams
+    // entries per point, see CalculateLinearizedFemPosParams()
+    static constexpr int kNumLinearizedParams = 7;
+    std::vector<double> linearized_params_;
+
+    // Optimization problem data, kept alive together with the workspace
+    std::vector<c_float> P_data_;
+    std::vector<c_int> P_indices_;
+    std::vector<c_int> P_indptr_;
+    std::vector<c_float> A_data_;
+    std::vector<c_int> A_indices_;
+    std::vector<c_int> A_indptr_;
+    std::vector<c_float> lower_bounds_;
+    std::vector<c_float> upper_bounds_;
+    std::vector<c_float> q_;
+    std::vector<c_float> primal_warm_start_;
+
+    // Osqp workspace reused across Solve() calls
+    OSQPData* data_ = nullptr;
+    OSQPSettings* settings_ = nullptr;
+    OSQPWorkspace* work_ = nullptr;
+    bool workspace_outdated_ = true;
+
     // Optimized_result
     std::vector<std::pair<double, double>> opt_xy_;
     std::vector<double> slack_;
@@ -31,13 +31,21 @@ int PlanningComponent::init(std::string config_dir)
 {
     node_ = apollo::cyber::CreateNode(apollo::cyber::binary::GetName());
 
+    // empty messages until the first ones are received
+    latest_chassis_ = std::make_shared<const apollo::canbus::Chassis>();
+    latest_traffic_light_ =
+            std::make_shared<const perception::TrafficLightDetection>();
+    perception_obstacles_ =
+            std::make_shared<const apollo::perception::PerceptionObstacles>();
+
     chassis_reader_ = node_->CreateReader<canbus::Chassis>(
             FLAGS_chassis_topic,
             [this](const std::shared_ptr<canbus::Chassis> &chassis)
             {
                 ADEBUG << "Received chassis data: run chassis callback.";
-                std::lock_guard<std::mutex> lock(mutex_);
-                chassis_.CopyFrom(*chassis);
+                std::atomic_store(
+                        &latest_chassis_,
+                        std::shared_ptr<const canbus::Chassis>(chassis));
             });
 
     localization_reader_ = node_->CreateReader<
@@ -57,8 +65,10 @@ int PlanningComponent::init(std::string config_dir)
                            &perception_obstacles)
             {
                 ADEBUG << "Received perception data: run perception callback.";
-                std::lock_guard<std::mutex> lock(mutex_);
-                perception_.CopyFrom(*perception_obstacles);
+                std::atomic_store(
+                        &latest_perception_,
+                        std::shared_ptr<const perception::PerceptionObstacles>(
+                                perception_obstacles));
             });
 
     hmi_perception_reader_ = node_->CreateReader<
@@ -68,8 +78,10 @@ int PlanningComponent::init(std::string config_dir)
                            &perception_obstacles)
             {
                 ADEBUG << "Received perception data: run perception callback.";
-                std::lock_guard<std::mutex> lock(mutex_);
-                hmi_perception_.CopyFrom(*perception_obstacles);
+                std::atomic_store(
+                        &latest_hmi_perception_,
+                        std::shared_ptr<const perception::PerceptionObstacles>(
+                                perception_obstacles));
             });
     debug_msg_reader_ = node_->CreateReader<cyber::proto::DebugMsg>(
             FLAGS_debug_planning_msg,
@@ -89,8 +101,10 @@ int PlanningComponent::init(std::string config_dir)
                 ADEBUG << "Received traffic light data: run traffic light "
                           "callback.";
 
-                std::lock_guard<std::mutex> lock(mutex_);
-                traffic_light_.CopyFrom(*traffic_light);
+                std::atomic_store(
+                        &latest_traffic_light_,
+                        std::shared_ptr<const perception::TrafficLightDetection>(
+                                traffic_light));
             });
 
     routing_request_reader_ = node_->CreateReader<
@@ -230,15 +244,9 @@ int PlanningComponent::init(std::string config_dir)
 
     adc_trajectory_ptr = std::make_shared<planning::ADCTrajectory>();
 
-    hmi_perception_.Clear();
-    perception_.Clear();
-
-    perception_obstacles_ =
-            std::make_shared<apollo::perception::PerceptionObstacles>();
-
     prediction_ = std::make_shared<apollo::prediction::PredictionObstacles>();
 
-    ptr_chassis_ = std::make_shared<apollo::canbus::Chassis>();
+    ptr_chassis_ = latest_chassis_;
 
     ptr_localization_ =
             std::make_shared<apollo::localization::LocalizationEstimate>();
@@ -320,55 +328,58 @@ int PlanningComponent::update_cyber_frame_data()
     // 需要对齐规划、预测的时间戳，因为速度规划使用到了relative time
     //----------------------------------------------------
 
-    {
-        std::lock_guard<std::mutex> lock(mutex_);
-
-        ptr_chassis_->Clear();
-        ptr_chassis_->CopyFrom(chassis_);
-
-        perception_obstacles_->Clear();
-        // 融合感知数据
-        if (hmi_perception_.has_header())
-        {
-            perception_obstacles_->CopyFrom(hmi_perception_);
+    // snapshot of the messages published by the readers, nothing is copied
+    ptr_chassis_ = std::atomic_load(&latest_chassis_);
+    local_view_.traffic_light = std::atomic_load(&latest_traffic_light_);
 
-            for (int i = 0; i < perception_.perception_obstacle_size(); i++)
-            {
-                apollo::perception::PerceptionObstacle *obs =
-                        perception_obstacles_->add_perception_obstacle();
+    // 融合感知数据
+    const auto perception = std::atomic_load(&latest_perception_);
+    const auto hmi_perception = std::atomic_load(&latest_hmi_perception_);
+    std::shared_ptr<const apollo::perception::PerceptionObstacles> base;
+    std::shared_ptr<const apollo::perception::PerceptionObstacles> extra;
+    if (hmi_perception != nullptr && hmi_perception->has_header())
+    {
+        base = hmi_perception;
+        extra = perception;
+    }
+    else if (perception != nullptr && perception->has_header())
+    {
+        base = perception;
+        extra = hmi_perception;
+    }
 
-                obs->CopyFrom(perception_.perception_obstacle().at(i));
-            }
-        }
-        else if (perception_.has_header())
+    if (base == nullptr)
+    {
+        perception_obstacles_ =
+                std::make_shared<const apollo::perception::PerceptionObstacles>();
+    }
+    else if (extra == nullptr || extra->perception_obstacle_size() == 0)
+    {
+        // only one source has obstacles, use its message as it is
+        perception_obstacles_ = base;
+    }
+    else
+    {
+        auto merged_obstacles =
+                std::make_shared<apollo::perception::PerceptionObstacles>(
+                        *base);
+        for (const auto &obs : extra->perception_obstacle())
         {
-            perception_obstacles_->CopyFrom(perception_);
-
-            for (int i = 0; i < hmi_perception_.perception_obstacle_size(); i++)
-            {
-                apollo::perception::PerceptionObstacle *obs =
-                        perception_obstacles_->add_perception_obstacle();
-
-                obs->CopyFrom(hmi_perception_.perception_obstacle().at(i));
-            }
+            merged_obstacles->add_perception_obstacle()->CopyFrom(obs);
         }
+        perception_obstacles_ = merged_obstacles;
+    }
+    AINFO << "total perception size: "
+          << perception_obstacles_->perception_obstacle_size();
+    // AINFO << "perception time: "
+    //       << perception_obstacles_->header().DebugString();
 
-        // AINFO << "hmi_perception_ size: "
-        //       << hmi_perception_.perception_obstacle_size();
-        // AINFO << "perception size: " <<
-        // perception_.perception_obstacle_size();
-        AINFO << "total perception size: "
-              << perception_obstacles_->perception_obstacle_size();
-        // AINFO << "perception time: "
-        //       << perception_obstacles_->header().DebugString();
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
 
         ptr_localization_->Clear();
         ptr_localization_->CopyFrom(localization_);
 
-        local_view_.traffic_light =
-                std::make_shared<perception::TrafficLightDetection>(
-                        traffic_light_);
-
         // update lane borrow manual
         auto *mutable_path_decider_status =
                 injector_->planning_context()
@@ -464,7 +475,7 @@ int PlanningComponent::process(
 }
 
 int PlanningComponent::update_planning(
-        std::shared_ptr<apollo::canbus::Chassis> &chassis_ptr,
+        const std::shared_ptr<const apollo::canbus::Chassis> &chassis_ptr,
         std::shared_ptr<apollo::localization::LocalizationEstimate>
                 &localization_estimate_ptr,
         std::shared_ptr<apollo::prediction::PredictionObstacles>
@@ -793,7 +804,7 @@ int PlanningComponent::debug_path_init()
     return 0;
 }
 
-const std::shared_ptr<apollo::perception::PerceptionObstacles> &
+const std::shared_ptr<const apollo::perception::PerceptionObstacles> &
 PlanningComponent::get_const_perception() const
 {
     return perception_obstacles_;
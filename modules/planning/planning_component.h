@@ -31,7 +31,8 @@ public:
     int process(std::shared_ptr<apollo::routing::RoutingResponse>
                         &routing_response_ptr);
 
-    int update_planning(std::shared_ptr<apollo::canbus::Chassis> &chassis_ptr,
+    int update_planning(
+            const std::shared_ptr<const apollo::canbus::Chassis> &chassis_ptr,
                      std::shared_ptr<apollo::localization::LocalizationEstimate>
                              &localization_estimate_ptr,
                      std::shared_ptr<apollo::prediction::PredictionObstacles>
@@ -135,7 +136,7 @@ public:
 
     int update_cyber_frame_data();
 
-    const std::shared_ptr<apollo::perception::PerceptionObstacles> &
+    const std::shared_ptr<const apollo::perception::PerceptionObstacles> &
     get_const_perception() const;
 
     const std::shared_ptr<apollo::localization::LocalizationEstimate> &
@@ -205,16 +206,20 @@ public:
     // routing::RoutingResponse *routing_;
     std::shared_ptr<apollo::prediction::PredictionObstacles> prediction_;
 
-    // input data
-    apollo::canbus::Chassis chassis_;
+    // input data, the readers publish the received chassis, perception and
+    // traffic light messages with std::atomic_store, each frame takes them
+    // with std::atomic_load without copying
+    std::shared_ptr<const apollo::canbus::Chassis> latest_chassis_;
 
-    std::shared_ptr<apollo::canbus::Chassis> ptr_chassis_;
+    std::shared_ptr<const apollo::canbus::Chassis> ptr_chassis_;
 
     // 不会每一帧都刷新，如果没有刷新，那么历史数据会记录在里面
-    apollo::perception::PerceptionObstacles perception_;
-    apollo::perception::PerceptionObstacles hmi_perception_;
+    std::shared_ptr<const apollo::perception::PerceptionObstacles>
+            latest_perception_;
+    std::shared_ptr<const apollo::perception::PerceptionObstacles>
+            latest_hmi_perception_;
 
-    std::shared_ptr<apollo::perception::PerceptionObstacles>
+    std::shared_ptr<const apollo::perception::PerceptionObstacles>
             perception_obstacles_;
 
     apollo::localization::LocalizationEstimate localization_;
@@ -222,7 +227,8 @@ public:
     std::shared_ptr<apollo::localization::LocalizationEstimate>
             ptr_localization_;
 
-    perception::TrafficLightDetection traffic_light_;
+    std::shared_ptr<const perception::TrafficLightDetection>
+            latest_traffic_light_;
 
     routing::RoutingRequest     routing_request_;
 
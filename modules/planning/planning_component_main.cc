@@ -135,7 +135,7 @@ int main(int argc, char** argv)
 
         auto end_time1 = std::chrono::system_clock::now();
 
-        const std::shared_ptr<apollo::perception::PerceptionObstacles>
+        const std::shared_ptr<const apollo::perception::PerceptionObstacles>
                 &perception = planning.get_const_perception();
 
         const std::shared_ptr<apollo::localization::LocalizationEstimate>
@@ -150,10 +150,11 @@ bool DiscretePointsReferenceLineSmoother::FemPosSmooth(
         const std::vector<double>& bounds,
         std::vector<std::pair<double, double>>* ptr_smoothed_point2d)
 {
-    const auto& fem_pos_config =
-            config_.discrete_points().fem_pos_deviation_smoothing();
-
-    FemPosDeviationSmoother smoother(fem_pos_config);
+    if (fem_pos_smoother_ == nullptr)
+    {
+        fem_pos_smoother_.reset(new FemPosDeviationSmoother(
+                config_.discrete_points().fem_pos_deviation_smoothing()));
+    }
 
     // box contraints on pos are used in fem pos smoother, thus shrink the
     // bounds by 1.0 / sqrt(2.0)
@@ -166,7 +167,8 @@ bool DiscretePointsReferenceLineSmoother::FemPosSmooth(
 
     std::vector<double> opt_x;
     std::vector<double> opt_y;
-    bool status = smoother.Solve(raw_point2d, box_bounds, &opt_x, &opt_y);
+    bool status =
+            fem_pos_smoother_->Solve(raw_point2d, box_bounds, &opt_x, &opt_y);
 
     if (!status)
     {
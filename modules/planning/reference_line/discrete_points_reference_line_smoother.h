@@ -16,9 +16,11 @@
 
 #pragma once
 
+#include <memory>
 #include <utility>
 #include <vector>
 
+#include "modules/planning/math/discretized_points_smoothing/fem_pos_deviation_smoother.h"
 #include "modules/planning/proto/reference_line_smoother_config.pb.h"
 #include "modules/planning/reference_line/reference_line.h"
 #include "modules/planning/reference_line/reference_line_smoother.h"
@@ -63,6 +65,9 @@ private:
 
     std::vector<AnchorPoint> anchor_points_;
 
+    // kept across cycles so that its osqp workspace can be reused
+    std::unique_ptr<FemPosDeviationSmoother> fem_pos_smoother_;
+
     double zero_x_ = 0.0;
 
     double zero_y_ = 0.0;
@@ -21,6 +21,7 @@
 #include "modules/planning/reference_line/reference_line.h"
 
 #include <algorithm>
+#include <cmath>
 #include <limits>
 #include <unordered_set>
 
@@ -770,6 +771,41 @@ bool ReferenceLine::GetApproximateSLBoundary(
     return true;
 }
 
+bool ReferenceLine::GetApproximateSLCorners(
+        const common::math::Box2d& box, const double start_s,
+        const double end_s,
+        std::array<common::math::Vec2d, 4>* const sl_corners) const
+{
+    double s = 0.0;
+    double l = 0.0;
+    double distance = 0.0;
+    if (!map_path_.GetProjectionWithHueristicParams(box.center(), start_s,
+                                                    end_s, &s, &l, &distance))
+    {
+        AERROR << "Cannot get projection point from path.";
+        return false;
+    }
+
+    // heading of the box relative to the reference line at the projection
+    const double heading = map_path_.GetSmoothPoint(s).heading();
+    const double cos_heading = std::cos(heading);
+    const double sin_heading = std::sin(heading);
+    const double cos_relative =
+            box.cos_heading() * cos_heading + box.sin_heading() * sin_heading;
+    const double sin_relative =
+            box.sin_heading() * cos_heading - box.cos_heading() * sin_heading;
+
+    const double dx1 = cos_relative * box.half_length();
+    const double dy1 = sin_relative * box.half_length();
+    const double dx2 = sin_relative * box.half_width();
+    const double dy2 = -cos_relative * box.half_width();
+    (*sl_corners)[0] = {s + dx1 + dx2, l + dy1 + dy2};
+    (*sl_corners)[1] = {s + dx1 - dx2, l + dy1 - dy2};
+    (*sl_corners)[2] = {s - dx1 - dx2, l - dy1 - dy2};
+    (*sl_corners)[3] = {s - dx1 + dx2, l - dy1 + dy2};
+    return true;
+}
+
 bool ReferenceLine::GetSLBoundary(const common::math::Box2d& box,
                                   SLBoundary* const sl_boundary) const
 {
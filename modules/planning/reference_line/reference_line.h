@@ -20,6 +20,7 @@
 
 #pragma once
 
+#include <array>
 #include <string>
 #include <utility>
 #include <vector>
@@ -113,6 +114,16 @@ public:
                                   const double start_s, const double end_s,
                                   SLBoundary* const sl_boundary) const;
 
+    /**
+     * @brief Same projection as GetApproximateSLBoundary, but keeps the
+     * corners of the box, in the order of Box2d::GetAllCorners.
+     * @param sl_corners x is the s and y is the l of each corner
+     */
+    bool GetApproximateSLCorners(
+            const common::math::Box2d& box, const double start_s,
+            const double end_s,
+            std::array<common::math::Vec2d, 4>* const sl_corners) const;
+
     bool GetSLBoundary(const common::math::Box2d& box,
                        SLBoundary* const sl_boundary) const;
 
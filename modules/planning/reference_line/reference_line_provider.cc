@@ -36,6 +36,7 @@
 #include "modules/map/pnc_map/path.h"
 #include "modules/planning/common/planning_context.h"
 #include "modules/planning/common/planning_gflags.h"
+#include "modules/planning/common/util/planning_thread_pool.h"
 #include "modules/routing/common/routing_gflags.h"
 
 /**
@@ -59,6 +60,44 @@ using apollo::hdmap::RouteSegments;
 
 #define debug_ref_line_priority (0)
 
+namespace
+{
+// true if the lanes of rhs continue the lanes of lhs from one of its lanes on
+bool ContinuesLaneSequence(const RouteSegments &lhs, const RouteSegments &rhs)
+{
+    size_t offset = 0;
+    while (offset < lhs.size() &&
+           lhs[offset].lane->id().id() != rhs.front().lane->id().id())
+    {
+        ++offset;
+    }
+    if (offset == lhs.size())
+    {
+        return false;
+    }
+    for (size_t i = 0; offset + i < lhs.size() && i < rhs.size(); ++i)
+    {
+        if (lhs[offset + i].lane->id().id() != rhs[i].lane->id().id())
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+// true if both segments follow the same lanes, e.g. the segments of the same
+// lane in two cycles, shifted by the vehicle movement
+bool IsSameLaneSequence(const RouteSegments &lhs, const RouteSegments &rhs)
+{
+    if (lhs.empty() || rhs.empty())
+    {
+        return false;
+    }
+    return ContinuesLaneSequence(lhs, rhs) || ContinuesLaneSequence(rhs, lhs);
+}
+
+}  // namespace
+
 ReferenceLineProvider::~ReferenceLineProvider() {}
 
 ReferenceLineProvider::ReferenceLineProvider(
@@ -83,17 +122,28 @@ ReferenceLineProvider::ReferenceLineProvider(
             << "Failed to load smoother config file "
             << FLAGS_smoother_config_filename;
 
+    smoother_ = CreateSmoother();
+    is_initialized_ = true;
+
+    // std::cout<< smoother_config_.DebugString();
+    return;
+}
+
+std::unique_ptr<ReferenceLineSmoother> ReferenceLineProvider::CreateSmoother()
+        const
+{
+    std::unique_ptr<ReferenceLineSmoother> smoother;
     if (smoother_config_.has_qp_spline())
     {
-        smoother_.reset(new QpSplineReferenceLineSmoother(smoother_config_));
+        smoother.reset(new QpSplineReferenceLineSmoother(smoother_config_));
     }
     else if (smoother_config_.has_spiral())
     {
-        smoother_.reset(new SpiralReferenceLineSmoother(smoother_config_));
+        smoother.reset(new SpiralReferenceLineSmoother(smoother_config_));
     }
     else if (smoother_config_.has_discrete_points())
     {
-        smoother_.reset(
+        smoother.reset(
                 new DiscretePointsReferenceLineSmoother(smoother_config_));
     }
     else
@@ -101,10 +151,7 @@ ReferenceLineProvider::ReferenceLineProvider(
         ACHECK(false) << "unknown smoother config "
                       << smoother_config_.DebugString();
     }
-    is_initialized_ = true;
-
-    // std::cout<< smoother_config_.DebugString();
-    return;
+    return smoother;
 }
 
 bool ReferenceLineProvider::UpdateRoutingResponse(
@@ -738,72 +785,128 @@ bool ReferenceLineProvider::CreateReferenceLine(
     }
 
     // FLAGS_enable_reference_line_stitching is 1.
-    if (is_new_routing || !FLAGS_enable_reference_line_stitching)
+    const bool smooth_from_scratch =
+            is_new_routing || !FLAGS_enable_reference_line_stitching;
+    std::vector<hdmap::RouteSegments *> candidates;
+    for (auto &segment : *segments)
+    {
+        candidates.push_back(&segment);
+    }
+    std::vector<ReferenceLine> candidate_lines(candidates.size());
+    std::vector<char> is_valid(candidates.size(), 0);
+    std::vector<SegmentCacheUpdate> cache_updates(candidates.size());
+
+    if (FLAGS_use_multi_thread_to_smooth_reference_lines &&
+        candidates.size() > 1)
     {
-        for (auto iter = segments->begin(); iter != segments->end();)
+        while (candidate_smoothers_.size() < candidates.size())
         {
-            reference_lines->emplace_back();
-            if (!SmoothRouteSegment(*iter, &reference_lines->back()))
-            {
-                AERROR << "Failed to create reference line from route segments";
-                reference_lines->pop_back();
-                iter = segments->erase(iter);
-            }
-            else
-            {
-                common::SLPoint sl;
-                if (!reference_lines->back().XYToSL(vehicle_state, &sl))
-                {
-                    AWARN << "Failed to project point: {" << vehicle_state.x()
-                          << "," << vehicle_state.y()
-                          << "} to stitched reference line";
-                }
-                Shrink(sl, &reference_lines->back(), &(*iter));
-                ++iter;
-            }
+            candidate_smoothers_.push_back(CreateSmoother());
         }
-        return true;
+        // this runs on the cyber task pool when the provider thread is
+        // enabled, the planning pool does not block on queued tasks there
+        PlanningThreadPool::Instance()->ParallelFor(
+                candidates.size(), 1, [&](const size_t i) {
+                    is_valid[i] = CreateCandidateReferenceLine(
+                            vehicle_state, smooth_from_scratch, candidates[i],
+                            &candidate_lines[i], candidate_smoothers_[i].get(),
+                            &cache_updates[i]);
+                });
     }
     else
+    {
+        for (size_t i = 0; i < candidates.size(); ++i)
+        {
+            is_valid[i] = CreateCandidateReferenceLine(
+                    vehicle_state, smooth_from_scratch, candidates[i],
+                    &candidate_lines[i], smoother_.get(), &cache_updates[i]);
+        }
+    }
+    ApplySegmentCacheUpdates(&cache_updates);
+
+    // keep the candidate order of the route segments, no matter in which
+    // order the workers finish
+    size_t index = 0;
+    for (auto iter = segments->begin(); iter != segments->end(); ++index)
+    {
+        if (!is_valid[index])
+        {
+            AERROR << "Failed to create reference line from route segments";
+            iter = segments->erase(iter);
+            continue;
+        }
+        reference_lines->emplace_back(candidate_lines[index]);
+        ++iter;
+    }
+    return true;
+}
+
+bool ReferenceLineProvider::CreateCandidateReferenceLine(
+        const common::VehicleState &vehicle_state, const bool is_new_routing,
+        hdmap::RouteSegments *segments, ReferenceLine *reference_line,
+        ReferenceLineSmoother *smoother, SegmentCacheUpdate *cache_update)
+{
+    if (!is_new_routing)
     {
         // stitching reference line
-        for (auto iter = segments->begin(); iter != segments->end();)
+        if (!ExtendReferenceLine(vehicle_state, segments, reference_line,
+                                 smoother, cache_update))
         {
-            reference_lines->emplace_back();
-            if (!ExtendReferenceLine(vehicle_state, &(*iter),
-                                     &reference_lines->back()))
-            {
-                AERROR << "Failed to extend reference line";
-                reference_lines->pop_back();
-                iter = segments->erase(iter);
-            }
-            else
-            {
-                ++iter;
-            }
+            AERROR << "Failed to extend reference line";
+            return false;
         }
+        return true;
+    }
+
+    if (!SmoothRouteSegment(*segments, reference_line, smoother,
+                            cache_update))
+    {
+        return false;
     }
+    common::SLPoint sl;
+    if (!reference_line->XYToSL(vehicle_state, &sl))
+    {
+        AWARN << "Failed to project point: {" << vehicle_state.x() << ","
+              << vehicle_state.y() << "} to stitched reference line";
+    }
+    Shrink(sl, reference_line, segments);
     return true;
 }
 
-bool ReferenceLineProvider::ExtendReferenceLine(const VehicleState &state,
-                                                RouteSegments *segments,
-                                                ReferenceLine *reference_line)
+bool ReferenceLineProvider::ExtendReferenceLine(
+        const VehicleState &state, RouteSegments *segments,
+        ReferenceLine *reference_line, ReferenceLineSmoother *smoother,
+        SegmentCacheUpdate *cache_update)
 {
     RouteSegments segment_properties;
     segment_properties.SetProperties(*segments);
-    auto prev_segment = route_segments_.begin();
-    auto prev_ref = reference_lines_.begin();
-    while (prev_segment != route_segments_.end())
+    auto prev_segment_iter = route_segments_.begin();
+    auto prev_ref_iter = reference_lines_.begin();
+    while (prev_segment_iter != route_segments_.end())
     {
-        if (prev_segment->IsConnectedSegment(*segments))
+        if (prev_segment_iter->IsConnectedSegment(*segments))
         {
             break;
         }
-        ++prev_segment;
-        ++prev_ref;
+        ++prev_segment_iter;
+        ++prev_ref_iter;
+    }
+    RouteSegments cached_segment;
+    ReferenceLine cached_ref;
+    const RouteSegments *prev_segment = nullptr;
+    const ReferenceLine *prev_ref = nullptr;
+    if (prev_segment_iter != route_segments_.end())
+    {
+        prev_segment = &(*prev_segment_iter);
+        prev_ref = &(*prev_ref_iter);
     }
-    if (prev_segment == route_segments_.end())
+    else if (GetConnectedCachedReferenceLine(*segments, &cached_segment,
+                                             &cached_ref))
+    {
+        prev_segment = &cached_segment;
+        prev_ref = &cached_ref;
+    }
+    else
     {
         if (!route_segments_.empty() && segments->IsOnSegment())
         {
@@ -811,7 +914,8 @@ bool ReferenceLineProvider::ExtendReferenceLine(const VehicleState &state,
                      "route "
                      "segment";
         }
-        return SmoothRouteSegment(*segments, reference_line);
+        return SmoothRouteSegment(*segments, reference_line, smoother,
+                                  cache_update);
     }
 
     // s是route segments开始
@@ -824,7 +928,8 @@ bool ReferenceLineProvider::ExtendReferenceLine(const VehicleState &state,
     {
         AWARN << "Vehicle current point: " << vec2d.DebugString()
               << " not on previous reference line";
-        return SmoothRouteSegment(*segments, reference_line);
+        return SmoothRouteSegment(*segments, reference_line, smoother,
+                                  cache_update);
     }
 
     const double prev_segment_length = RouteSegments::Length(*prev_segment);
@@ -856,7 +961,8 @@ bool ReferenceLineProvider::ExtendReferenceLine(const VehicleState &state,
     {
         lock.unlock();
         AERROR << "Failed to shift route segments forward";
-        return SmoothRouteSegment(*segments, reference_line);
+        return SmoothRouteSegment(*segments, reference_line, smoother,
+                                  cache_update);
     }
     lock.unlock();
 
@@ -869,24 +975,30 @@ bool ReferenceLineProvider::ExtendReferenceLine(const VehicleState &state,
         return true;
     }
 
+    // only the shifted tail is smoothed, the overlap with prev_ref is fixed
+    // as boundary condition in SmoothPrefixedReferenceLine
     hdmap::Path path(shifted_segments);
     ReferenceLine new_ref(path);
-    if (!SmoothPrefixedReferenceLine(*prev_ref, new_ref, reference_line))
+    if (!SmoothPrefixedReferenceLine(*prev_ref, new_ref, reference_line,
+                                     smoother))
     {
         AWARN << "Failed to smooth forward shifted reference line";
-        return SmoothRouteSegment(*segments, reference_line);
+        return SmoothRouteSegment(*segments, reference_line, smoother,
+                                  cache_update);
     }
 
     if (!reference_line->Stitch(*prev_ref))
     {
         AWARN << "Failed to stitch reference line";
-        return SmoothRouteSegment(*segments, reference_line);
+        return SmoothRouteSegment(*segments, reference_line, smoother,
+                                  cache_update);
     }
 
     if (!shifted_segments.Stitch(*prev_segment))
     {
         AWARN << "Failed to stitch route segments";
-        return SmoothRouteSegment(*segments, reference_line);
+        return SmoothRouteSegment(*segments, reference_line, smoother,
+                                  cache_update);
     }
 
     *segments = shifted_segments;
@@ -897,7 +1009,9 @@ bool ReferenceLineProvider::ExtendReferenceLine(const VehicleState &state,
         AWARN << "Failed to project point: " << vec2d.DebugString()
               << " to stitched reference line";
     }
-    return Shrink(sl, reference_line, segments);
+    Shrink(sl, reference_line, segments);
+    CacheReferenceLine(*segments, *reference_line, cache_update);
+    return true;
 }
 
 bool ReferenceLineProvider::Shrink(const common::SLPoint &sl,
@@ -1095,20 +1209,171 @@ void ReferenceLineProvider::GetAnchorPoints(
     anchor_points->back().enforced = true;
 }
 
-bool ReferenceLineProvider::SmoothRouteSegment(const RouteSegments &segments,
-                                               ReferenceLine *reference_line)
+bool ReferenceLineProvider::SmoothRouteSegment(
+        const RouteSegments &segments, ReferenceLine *reference_line,
+        ReferenceLineSmoother *smoother, SegmentCacheUpdate *cache_update)
 {
+    bool is_prioity_ref_line = segments.is_reference_line_priority();
+
+    if (GetCachedReferenceLine(segments, reference_line, cache_update))
+    {
+        reference_line->set_is_priority_ref_line(is_prioity_ref_line);
+        return true;
+    }
+
     hdmap::Path path(segments);
 
-    bool is_prioity_ref_line = segments.is_reference_line_priority();
     reference_line->set_is_priority_ref_line(is_prioity_ref_line);
 
-    return SmoothReferenceLine(ReferenceLine(path), reference_line);
+    if (!SmoothReferenceLine(ReferenceLine(path), reference_line, smoother))
+    {
+        return false;
+    }
+    CacheReferenceLine(segments, *reference_line, cache_update);
+    return true;
+}
+
+bool ReferenceLineProvider::GetCachedReferenceLine(
+        const RouteSegments &segments, ReferenceLine *reference_line,
+        SegmentCacheUpdate *cache_update)
+{
+    if (!FLAGS_enable_reference_line_segment_cache || segments.empty())
+    {
+        return false;
+    }
+    static constexpr double kRangeEpsilon = 0.1;
+
+    std::lock_guard<std::mutex> lock(segment_cache_mutex_);
+    for (auto iter = segment_cache_.begin(); iter != segment_cache_.end();
+         ++iter)
+    {
+        const auto &cached_segments = iter->first;
+        // find the first requested lane in the cached lanes, then all the
+        // following lanes must match one by one with covered s ranges
+        size_t offset = 0;
+        while (offset < cached_segments.size() &&
+               cached_segments[offset].lane->id().id() !=
+                       segments.front().lane->id().id())
+        {
+            ++offset;
+        }
+        if (offset + segments.size() > cached_segments.size())
+        {
+            continue;
+        }
+        bool is_covered = true;
+        for (size_t i = 0; i < segments.size() && is_covered; ++i)
+        {
+            const auto &cached = cached_segments[offset + i];
+            const auto &requested = segments[i];
+            is_covered = cached.lane->id().id() == requested.lane->id().id() &&
+                         cached.start_s <= requested.start_s + kRangeEpsilon &&
+                         cached.end_s >= requested.end_s - kRangeEpsilon;
+        }
+        if (!is_covered)
+        {
+            continue;
+        }
+
+        const auto first_waypoint = segments.FirstWaypoint();
+        const auto last_waypoint = segments.LastWaypoint();
+        const auto start_point =
+                first_waypoint.lane->GetSmoothPoint(first_waypoint.s);
+        const auto end_point =
+                last_waypoint.lane->GetSmoothPoint(last_waypoint.s);
+        common::SLPoint start_sl;
+        common::SLPoint end_sl;
+        if (!iter->second.XYToSL(start_point, &start_sl) ||
+            !iter->second.XYToSL(end_point, &end_sl) ||
+            end_sl.s() <= start_sl.s())
+        {
+            continue;
+        }
+        ReferenceLine cached_ref(iter->second);
+        if (!cached_ref.Segment(start_sl.s(), 0.0,
+                                end_sl.s() - start_sl.s()))
+        {
+            continue;
+        }
+        *reference_line = cached_ref;
+        cache_update->hits.push_back(iter);
+        ADEBUG << "Reuse cached smoothed reference line for segments "
+               << segments.Id();
+        return true;
+    }
+    return false;
+}
+
+void ReferenceLineProvider::CacheReferenceLine(
+        const RouteSegments &segments, const ReferenceLine &reference_line,
+        SegmentCacheUpdate *cache_update)
+{
+    if (!FLAGS_enable_reference_line_segment_cache || segments.empty())
+    {
+        return;
+    }
+    cache_update->entries.emplace_back(segments, reference_line);
+}
+
+void ReferenceLineProvider::ApplySegmentCacheUpdates(
+        std::vector<SegmentCacheUpdate> *updates)
+{
+    std::lock_guard<std::mutex> lock(segment_cache_mutex_);
+    // all hits first, the new entries below may erase hit entries
+    for (auto &update : *updates)
+    {
+        for (const auto &hit : update.hits)
+        {
+            segment_cache_.splice(segment_cache_.begin(), segment_cache_, hit);
+        }
+    }
+    for (auto &update : *updates)
+    {
+        while (!update.entries.empty())
+        {
+            // a new entry replaces the entries of the same lanes, otherwise
+            // the ego lane of every cycle would evict the lane change
+            // candidates from the cache
+            const auto &segments = update.entries.front().first;
+            segment_cache_.remove_if(
+                    [&segments](const SegmentCache::value_type &entry) {
+                        return IsSameLaneSequence(entry.first, segments);
+                    });
+            segment_cache_.splice(segment_cache_.begin(), update.entries,
+                                  update.entries.begin());
+        }
+    }
+    while (static_cast<int>(segment_cache_.size()) >
+           std::max(1, FLAGS_reference_line_segment_cache_size))
+    {
+        segment_cache_.pop_back();
+    }
+}
+
+bool ReferenceLineProvider::GetConnectedCachedReferenceLine(
+        const RouteSegments &segments, RouteSegments *prev_segment,
+        ReferenceLine *prev_ref)
+{
+    if (!FLAGS_enable_reference_line_segment_cache)
+    {
+        return false;
+    }
+    std::lock_guard<std::mutex> lock(segment_cache_mutex_);
+    for (const auto &entry : segment_cache_)
+    {
+        if (entry.first.IsConnectedSegment(segments))
+        {
+            *prev_segment = entry.first;
+            *prev_ref = entry.second;
+            return true;
+        }
+    }
+    return false;
 }
 
 bool ReferenceLineProvider::SmoothPrefixedReferenceLine(
         const ReferenceLine &prefix_ref, const ReferenceLine &raw_ref,
-        ReferenceLine *reference_line)
+        ReferenceLine *reference_line, ReferenceLineSmoother *smoother)
 {
     if (!FLAGS_enable_smooth_reference_line)
     {
@@ -1122,6 +1387,8 @@ bool ReferenceLineProvider::SmoothPrefixedReferenceLine(
 
     // modify anchor points based on prefix_ref
     // 将anchor point调整到历史ref line上
+    // every anchor point inside the stitched prefix is pinned to prefix_ref,
+    // so the overlap acts as boundary condition and the prefix does not jitter
     for (auto &point : anchor_points)
     {
         common::SLPoint sl_point;
@@ -1144,14 +1411,13 @@ bool ReferenceLineProvider::SmoothPrefixedReferenceLine(
         point.longitudinal_bound = 1e-6;
         point.lateral_bound = 1e-6;
         point.enforced = true;
-        break;
     }
 
-    smoother_->SetAnchorPoints(anchor_points);
+    smoother->SetAnchorPoints(anchor_points);
 
     double start_time = Clock::NowInSeconds();
 
-    if (!smoother_->Smooth(raw_ref, reference_line))
+    if (!smoother->Smooth(raw_ref, reference_line))
     {
         AERROR << "Failed to smooth prefixed reference line with anchor points";
         return false;
@@ -1172,7 +1438,8 @@ bool ReferenceLineProvider::SmoothPrefixedReferenceLine(
 }
 
 bool ReferenceLineProvider::SmoothReferenceLine(
-        const ReferenceLine &raw_reference_line, ReferenceLine *reference_line)
+        const ReferenceLine &raw_reference_line, ReferenceLine *reference_line,
+        ReferenceLineSmoother *smoother)
 {
     if (!FLAGS_enable_smooth_reference_line)
     {
@@ -1183,8 +1450,8 @@ bool ReferenceLineProvider::SmoothReferenceLine(
     std::vector<AnchorPoint> anchor_points;
     GetAnchorPoints(raw_reference_line, &anchor_points);
 
-    smoother_->SetAnchorPoints(anchor_points);
-    if (!smoother_->Smooth(raw_reference_line, reference_line))
+    smoother->SetAnchorPoints(anchor_points);
+    if (!smoother->Smooth(raw_reference_line, reference_line))
     {
         AERROR << "Failed to smooth reference line with anchor points";
         return false;
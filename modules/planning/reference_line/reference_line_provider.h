@@ -27,6 +27,7 @@
 #include <queue>
 #include <string>
 #include <unordered_set>
+#include <utility>
 #include <vector>
 
 #include "cyber/cyber.h"
@@ -130,6 +131,35 @@ private:
             const std::list<hdmap::RouteSegments>& route_segments);
 
     void GenerateThread();
+
+    std::unique_ptr<ReferenceLineSmoother> CreateSmoother() const;
+
+    using SegmentCache =
+            std::list<std::pair<hdmap::RouteSegments, ReferenceLine>>;
+
+    /**
+     * @brief Segment cache hits and new entries of one candidate. Candidates
+     * only read the cache, the updates are applied in candidate order after
+     * all candidates of a cycle are created, so the result does not depend
+     * on the order in which the candidates run.
+     */
+    struct SegmentCacheUpdate
+    {
+        std::vector<SegmentCache::iterator> hits;
+        SegmentCache entries;
+    };
+
+    /**
+     * @brief Smooth (new routing) or extend one candidate route segments.
+     * Candidates do not share any mutable state, so each one can run on its
+     * own worker with its own smoother.
+     */
+    bool CreateCandidateReferenceLine(const common::VehicleState& vehicle_state,
+                                      const bool is_new_routing,
+                                      hdmap::RouteSegments* segments,
+                                      ReferenceLine* reference_line,
+                                      ReferenceLineSmoother* smoother,
+                                      SegmentCacheUpdate* cache_update);
     void IsValidReferenceLine();
 
     void PrioritzeChangeLane(std::list<hdmap::RouteSegments>* route_segments);
@@ -141,17 +171,21 @@ private:
                                     const ReferenceLine& smoothed) const;
 
     bool SmoothReferenceLine(const ReferenceLine& raw_reference_line,
-                             ReferenceLine* reference_line);
+                             ReferenceLine* reference_line,
+                             ReferenceLineSmoother* smoother);
 
     bool SmoothPrefixedReferenceLine(const ReferenceLine& prefix_ref,
                                      const ReferenceLine& raw_ref,
-                                     ReferenceLine* reference_line);
+                                     ReferenceLine* reference_line,
+                                     ReferenceLineSmoother* smoother);
 
     void GetAnchorPoints(const ReferenceLine& reference_line,
                          std::vector<AnchorPoint>* anchor_points) const;
 
     bool SmoothRouteSegment(const hdmap::RouteSegments& segments,
-                            ReferenceLine* reference_line);
+                            ReferenceLine* reference_line,
+                            ReferenceLineSmoother* smoother,
+                            SegmentCacheUpdate* cache_update);
 
     /**
      * @brief This function creates a smoothed forward reference line
@@ -159,7 +193,9 @@ private:
      */
     bool ExtendReferenceLine(const common::VehicleState& state,
                              hdmap::RouteSegments* segments,
-                             ReferenceLine* reference_line);
+                             ReferenceLine* reference_line,
+                             ReferenceLineSmoother* smoother,
+                             SegmentCacheUpdate* cache_update);
 
     AnchorPoint GetAnchorPoint(const ReferenceLine& reference_line,
                                double s) const;
@@ -180,11 +216,43 @@ private:
     bool Shrink(const common::SLPoint& sl, ReferenceLine* ref,
                 hdmap::RouteSegments* segments);
 
+    /**
+     * @brief Cut the part covering segments out of a cached smoothed
+     * reference line. The cache is keyed by lane ids and lane s ranges.
+     * @return false if no cached reference line covers all of segments.
+     */
+    bool GetCachedReferenceLine(const hdmap::RouteSegments& segments,
+                                ReferenceLine* reference_line,
+                                SegmentCacheUpdate* cache_update);
+
+    void CacheReferenceLine(const hdmap::RouteSegments& segments,
+                            const ReferenceLine& reference_line,
+                            SegmentCacheUpdate* cache_update);
+
+    /**
+     * @brief Move the hits to the front of the segment cache and insert the
+     * new entries, in the order of updates. A new entry replaces the cached
+     * entries that follow the same lanes.
+     */
+    void ApplySegmentCacheUpdates(std::vector<SegmentCacheUpdate>* updates);
+
+    /**
+     * @brief Find a cached reference line whose route segments are connected
+     * with segments, so that it can be extended instead of smoothed again,
+     * e.g. when a lane change candidate shows up again.
+     */
+    bool GetConnectedCachedReferenceLine(const hdmap::RouteSegments& segments,
+                                         hdmap::RouteSegments* prev_segment,
+                                         ReferenceLine* prev_ref);
+
 private:
     bool is_initialized_ = false;
     std::atomic<bool> is_stop_{false};
 
     std::unique_ptr<ReferenceLineSmoother> smoother_;
+    // one smoother per candidate when smoothing candidates concurrently,
+    // smoothers keep anchor points between SetAnchorPoints and Smooth
+    std::vector<std::unique_ptr<ReferenceLineSmoother>> candidate_smoothers_;
     ReferenceLineSmootherConfig smoother_config_;
 
     std::mutex pnc_map_mutex_;
@@ -211,6 +279,10 @@ private:
 
     std::future<void> task_future_;
 
+    // most recently used first
+    std::mutex segment_cache_mutex_;
+    SegmentCache segment_cache_;
+
     std::atomic<bool> is_reference_line_updated_{true};
 
     const common::VehicleStateProvider* vehicle_state_provider_ = nullptr;
@@ -25,6 +25,8 @@
 #include "modules/common/proto/pnc_point.pb.h"
 #include "modules/map/hdmap/hdmap_util.h"
 #include "modules/planning/common/planning_context.h"
+#include "modules/planning/common/planning_gflags.h"
+#include "modules/planning/common/util/planning_thread_pool.h"
 #include "modules/planning/tasks/deciders/path_bounds_decider/path_bounds_decider.h"
 #include "modules/planning/tasks/deciders/utils/path_decider_obstacle_utils.h"
 #include "modules/common/collision_detection/gjk2d_interface.h"
@@ -96,113 +98,62 @@ Status PathAssessmentDecider::Process(
 
 #endif
 
+    // The obstacles are the same for every candidate of this frame.
+    std::vector<Polygon2D> obstacle_polygons;
+    BuildStaticObstaclePolygons(*reference_line_info, &obstacle_polygons);
+
     // 1. Remove invalid path. 根据偏移量过滤
     // check 越过路网，和static obstacle碰撞情况
-    std::vector<PathData> valid_path_data;
-    for (const auto& curr_path_data : candidate_path_data)
-    {
-#if debug_path_assessment_decider
-        AINFO << "path label " << curr_path_data.path_label();
-#endif
-
-        // RecordDebugInfo(curr_path_data, curr_path_data.path_label(),
-        //                 reference_line_info);
-
-        if (curr_path_data.path_label().find("fallback") != std::string::npos)
-        {
-            if (IsValidFallbackPath(*reference_line_info, curr_path_data))
-            {
-                valid_path_data.push_back(curr_path_data);
-            }
-        }
-        else
-        {
-            if (IsValidRegularPath(*reference_line_info, curr_path_data))
-            {
-                valid_path_data.push_back(curr_path_data);
-            }
-        }
-    }
-
-#if debug_path_assessment_decider
-
-    if (valid_path_data.size() < 1)
-    {
-        AINFO << "Candidate path data is empty.";
+    // 2. Analyze and add important info for speed decider to use
+    // check 压线情况
+    // Every candidate is assessed on its own copy, the results are kept in
+    // the order of the candidates so that the selection does not depend on
+    // the order the assessments finish in.
+    const size_t num_candidates = candidate_path_data.size();
+    std::vector<PathData> assessed_path_data(num_candidates);
+    std::vector<uint8_t> is_valid_path(num_candidates, 0);
+    if (FLAGS_use_multi_thread_to_assess_paths && num_candidates > 1)
+    {
+        PlanningThreadPool::Instance()->ParallelFor(
+                num_candidates, 1, [&](const size_t i) {
+                    is_valid_path[i] = AssessCandidatePath(
+                            *reference_line_info, obstacle_polygons,
+                            candidate_path_data[i], &assessed_path_data[i]);
+                });
     }
     else
     {
-        AINFO << "There are " << valid_path_data.size() << " candidate paths";
-    }
-
-    for (const auto& path : valid_path_data)
-    {
-        AINFO << "path bound label " << path.path_label();
+        for (size_t i = 0; i < num_candidates; ++i)
+        {
+            is_valid_path[i] = AssessCandidatePath(
+                    *reference_line_info, obstacle_polygons,
+                    candidate_path_data[i], &assessed_path_data[i]);
+        }
     }
 
-#endif
-
     const auto& end_time1 = std::chrono::system_clock::now();
     std::chrono::duration<double> diff = end_time1 - end_time0;
 
 #if debug_path_assessment_decider_time
-    AINFO << "Time for path validity checking: " << diff.count() * 1000
-          << " msec.";
+    AINFO << "Time for path validity checking and info labeling: "
+          << diff.count() * 1000 << " msec.";
 #endif
 
-    // 2. Analyze and add important info for speed decider to use
-    // check 压线情况
-    size_t valid_path_cnt = 0;
+    std::vector<PathData> valid_path_data;
+    valid_path_data.reserve(num_candidates);
     const Obstacle* blocking_obstacle_on_selflane = nullptr;
-
-    for (size_t i = 0; i != valid_path_data.size(); ++i)
+    for (size_t i = 0; i < num_candidates; ++i)
     {
-        auto& curr_path_data = valid_path_data[i];
-
-        // fallback path， valid
-        if (curr_path_data.path_label().find("fallback") != std::string::npos)
+        if (!is_valid_path[i])
         {
-            // remove empty path_data.
-            if (!curr_path_data.Empty())
-            {
-                if (valid_path_cnt != i)
-                {
-                    valid_path_data[valid_path_cnt] = curr_path_data;
-                }
-                ++valid_path_cnt;
-            }
             continue;
         }
-
-#if debug_path_assessment_decider_time
-        const auto& set_path_info_start = std::chrono::system_clock::now();
-#endif
-        // 计算path是否越过车道
-        SetPathInfo(*reference_line_info, &curr_path_data);
-
-#if debug_path_assessment_decider_time
-        const auto& set_path_info_end = std::chrono::system_clock::now();
-        std::chrono::duration<double> diff = set_path_info_end - set_path_info_start;
-        AINFO << "Time for path cross lane checking: " << diff.count() * 1000
-              << " msec.";
-#endif
-
-        // Trim all the lane-borrowing paths so that it ends with an in-lane
-        // position.
-        // 对于lane borrow path, 如果当前车道停了20辆车，可能lane borrow
-        // path 的所有点都是out lane,
-        // so经过trim后整条路径的长度变成0或很小，导致无法lane borrow。
-        // 目前认为这是合理现象。
-        // 感觉设计逻辑是：如果lane borrow不能返回车道，那么该path valid data就很短，
-        // 导致不lane borrow
-        if (curr_path_data.path_label().find("pullover") == std::string::npos)
-        {
-            TrimTailingOutLanePoints(&curr_path_data);
-        }
+        auto& curr_path_data = assessed_path_data[i];
 
         // find blocking_obstacle_on_selflane, to be used for lane selection
         // later. lane keep path
-        if (curr_path_data.path_label().find("self") != std::string::npos)
+        if (curr_path_data.path_label().find("fallback") == std::string::npos &&
+            curr_path_data.path_label().find("self") != std::string::npos)
         {
             const auto blocking_obstacle_id =
                     curr_path_data.blocking_obstacle_id();
@@ -212,25 +163,18 @@ Status PathAssessmentDecider::Process(
         }
 
         // remove empty path_data.
-        if (!curr_path_data.Empty())
+        if (curr_path_data.Empty())
         {
-            if (valid_path_cnt != i)
-            {
-                valid_path_data[valid_path_cnt] = curr_path_data;
-            }
-            ++valid_path_cnt;
+            continue;
         }
 
-        // RecordDebugInfo(curr_path_data, curr_path_data.path_label(),
-        //                 reference_line_info);
-
 #if debug_path_assessment_decider
         AINFO << "For " << curr_path_data.path_label() << ", "
               << "path length = " << curr_path_data.frenet_frame_path().size();
 #endif
-    }
 
-    valid_path_data.resize(valid_path_cnt);
+        valid_path_data.push_back(std::move(curr_path_data));
+    }
 
 #if debug_path_assessment_decider
     AINFO << "valid path size: " << valid_path_data.size();
@@ -258,7 +202,7 @@ Status PathAssessmentDecider::Process(
     diff = end_time2 - end_time1;
 
 #if debug_path_assessment_decider_time
-    AINFO << "Time for path info labeling: " << diff.count() * 1000
+    AINFO << "Time for valid path collecting: " << diff.count() * 1000
            << " msec.";
 #endif
 
@@ -605,8 +549,100 @@ bool ComparePathData(const PathData& lhs, const PathData& rhs,
     return false;
 }
 
+bool PathAssessmentDecider::AssessCandidatePath(
+        const ReferenceLineInfo& reference_line_info,
+        const std::vector<Polygon2D>& obstacle_polygons,
+        const PathData& candidate_path_data, PathData* const path_data)
+{
+#if debug_path_assessment_decider
+    AINFO << "path label " << candidate_path_data.path_label();
+#endif
+
+    // fallback path， valid
+    if (candidate_path_data.path_label().find("fallback") != std::string::npos)
+    {
+        if (!IsValidFallbackPath(reference_line_info, candidate_path_data))
+        {
+            return false;
+        }
+        *path_data = candidate_path_data;
+        return true;
+    }
+
+    if (!IsValidRegularPath(reference_line_info, obstacle_polygons,
+                            candidate_path_data))
+    {
+        return false;
+    }
+    *path_data = candidate_path_data;
+
+#if debug_path_assessment_decider_time
+    const auto& set_path_info_start = std::chrono::system_clock::now();
+#endif
+    // 计算path是否越过车道
+    SetPathInfo(reference_line_info, path_data);
+
+#if debug_path_assessment_decider_time
+    const auto& set_path_info_end = std::chrono::system_clock::now();
+    std::chrono::duration<double> diff = set_path_info_end - set_path_info_start;
+    AINFO << "Time for path cross lane checking: " << diff.count() * 1000
+          << " msec.";
+#endif
+
+    // Trim all the lane-borrowing paths so that it ends with an in-lane
+    // position.
+    // 对于lane borrow path, 如果当前车道停了20辆车，可能lane borrow
+    // path 的所有点都是out lane,
+    // so经过trim后整条路径的长度变成0或很小，导致无法lane borrow。
+    // 目前认为这是合理现象。
+    // 感觉设计逻辑是：如果lane borrow不能返回车道，那么该path valid data就很短，
+    // 导致不lane borrow
+    if (path_data->path_label().find("pullover") == std::string::npos)
+    {
+        TrimTailingOutLanePoints(path_data);
+    }
+    return true;
+}
+
+void PathAssessmentDecider::BuildStaticObstaclePolygons(
+        const ReferenceLineInfo& reference_line_info,
+        std::vector<Polygon2D>* const obstacle_polygons)
+{
+    obstacle_polygons->clear();
+    const auto& indexed_obstacles =
+            reference_line_info.path_decision().obstacles();
+
+    Polygon2D obs_polygon;
+    for (const auto* obstacle : indexed_obstacles.Items())
+    {
+        // Filter out unrelated obstacles.
+        if (!IsWithinPathDeciderScopeObstacle(*obstacle))
+        {
+            continue;
+        }
+
+        // Ignore too small obstacles.
+        const auto& obstacle_sl = obstacle->PerceptionSLBoundary();
+        if ((obstacle_sl.end_s() - obstacle_sl.start_s()) *
+                    (obstacle_sl.end_l() - obstacle_sl.start_l()) <
+            kMinObstacleArea)
+        {
+            continue;
+        }
+
+        const common::math::Box2d& obs_box = obstacle->PerceptionBoundingBox();
+
+        cvt_box2d_to_polygon(&obs_polygon, obs_box);
+
+        // Convert into polygon and save it.
+        obstacle_polygons->emplace_back(obs_polygon);
+    }
+}
+
 bool PathAssessmentDecider::IsValidRegularPath(
-        const ReferenceLineInfo& reference_line_info, const PathData& path_data)
+        const ReferenceLineInfo& reference_line_info,
+        const std::vector<Polygon2D>& obstacle_polygons,
+        const PathData& path_data)
 {
     // Basic sanity checks.
     if (path_data.Empty())
@@ -634,7 +670,7 @@ bool PathAssessmentDecider::IsValidRegularPath(
 
     // Check if there is any collision.
     // if (IsCollidingWithStaticObstacles(reference_line_info, path_data))
-    if (is_colliding_with_static_obstacles(reference_line_info, path_data))
+    if (is_colliding_with_static_obstacles(obstacle_polygons, path_data))
     {
 #if debug_path_assessment_decider
         AINFO << path_data.path_label() << ": ADC has collision.";
@@ -934,40 +970,9 @@ bool PathAssessmentDecider::IsCollidingWithStaticObstacles(
 }
 
 bool PathAssessmentDecider::is_colliding_with_static_obstacles(
-        const ReferenceLineInfo& reference_line_info, const PathData& path_data)
+        const std::vector<Polygon2D>& obstacle_polygons,
+        const PathData& path_data)
 {
-    // Get all obstacles and convert them into frenet-frame polygons.
-    std::vector<Polygon2D> obstacle_polygons;
-    const auto& indexed_obstacles =
-            reference_line_info.path_decision().obstacles();
-
-    Polygon2D obs_polygon;
-    for (const auto* obstacle : indexed_obstacles.Items())
-    {
-        // Filter out unrelated obstacles.
-        if (!IsWithinPathDeciderScopeObstacle(*obstacle))
-        {
-            continue;
-        }
-
-        // Ignore too small obstacles.
-        const auto& obstacle_sl = obstacle->PerceptionSLBoundary();
-        if ((obstacle_sl.end_s() - obstacle_sl.start_s()) *
-                    (obstacle_sl.end_l() - obstacle_sl.start_l()) <
-            kMinObstacleArea)
-        {
-            continue;
-        }
-
-        const common::math::Box2d& obs_box = obstacle->PerceptionBoundingBox();
-
-
-        cvt_box2d_to_polygon(&obs_polygon, obs_box);
-
-        // Convert into polygon and save it.
-        obstacle_polygons.emplace_back(obs_polygon);
-    }
-
     if (obstacle_polygons.size() < 1)
     {
         return false;
@@ -21,6 +21,7 @@
 #include <tuple>
 #include <vector>
 
+#include "modules/common/math/polygon_base.h"
 #include "modules/planning/proto/planning_config.pb.h"
 #include "modules/planning/tasks/deciders/decider.h"
 
@@ -61,7 +62,24 @@ private:
     /////////////////////////////////////////////////////////////////////////////
     // Below are functions called when executing PathAssessmentDecider.
 
+    /** @brief Check the validity of a candidate path and, for regular paths,
+     *   label and trim a copy of it. The candidates are independent, so this
+     *   only reads the reference line info and may run concurrently.
+     *  @return If the path is valid, it may still be empty after trimming.
+     */
+    bool AssessCandidatePath(const ReferenceLineInfo& reference_line_info,
+                             const std::vector<Polygon2D>& obstacle_polygons,
+                             const PathData& candidate_path_data,
+                             PathData* const path_data);
+
+    // Polygons of the obstacles the collision check considers, computed once
+    // per frame and shared by all candidates.
+    void BuildStaticObstaclePolygons(
+            const ReferenceLineInfo& reference_line_info,
+            std::vector<Polygon2D>* const obstacle_polygons);
+
     bool IsValidRegularPath(const ReferenceLineInfo& reference_line_info,
+                            const std::vector<Polygon2D>& obstacle_polygons,
                             const PathData& path_data);
 
     bool IsValidFallbackPath(const ReferenceLineInfo& reference_line_info,
@@ -86,7 +104,7 @@ private:
 
     // gjk collision check
     bool is_colliding_with_static_obstacles(
-            const ReferenceLineInfo& reference_line_info,
+            const std::vector<Polygon2D>& obstacle_polygons,
             const PathData& path_data);
 
     bool IsStopOnReverseNeighborLane(
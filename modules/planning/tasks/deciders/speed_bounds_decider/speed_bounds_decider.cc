@@ -77,6 +77,9 @@ Status SpeedBoundsDecider::Process(Frame *const frame,
 
     // 1. Map obstacles into st graph
     auto time1 = std::chrono::system_clock::now();
+    // overlap points cached by earlier passes stay valid while the path and
+    // the predictions do not change
+    injector_->st_boundary_cache()->StartFrame(frame->SequenceNum());
     STBoundaryMapper boundary_mapper(
             speed_bounds_config_, reference_line, path_data,
             path_data.discretized_path().Length(),
@@ -91,6 +91,11 @@ Status STBoundaryMapper::ComputeSTBoundary(PathDecision* path_decision)
     // generate path
     generate_adc_polygon_path(FLAGS_nonstatic_obstacle_nudge_l_buffer,
                           path_data_.discretized_path(), adc_polygon_path_);
+    if (FLAGS_enable_st_boundary_cache)
+    {
+        path_id_ = injector_->st_boundary_cache()->PathId(
+                ComputePathSignature());
+    }
 
     for (const auto* ptr_obstacle_item : path_decision->obstacles().Items())
     {
@@ -244,8 +249,8 @@ void STBoundaryMapper::ComputeSTBoundary(Obstacle* obstacle) const
     std::vector<STPoint> lower_points;
     std::vector<STPoint> upper_points;
 
-    if (!GetOverlapBoundaryPoints(path_data_.discretized_path(), *obstacle,
-                                  &upper_points, &lower_points))
+    if (!GetCachedOverlapBoundaryPoints(*obstacle, &upper_points,
+                                        &lower_points))
     {
         return;
     }
@@ -283,6 +288,67 @@ void STBoundaryMapper::ComputeSTBoundary(Obstacle* obstacle) const
     return;
 }
 
+bool STBoundaryMapper::GetCachedOverlapBoundaryPoints(
+        const Obstacle& obstacle, std::vector<STPoint>* upper_points,
+        std::vector<STPoint>* lower_points) const
+{
+    // virtual obstacles are built by planning and can move without a new
+    // perception timestamp
+    const double perception_time = obstacle.Perception().timestamp();
+    if (!FLAGS_enable_st_boundary_cache || obstacle.IsVirtual() ||
+        perception_time <= 0.0)
+    {
+        return GetOverlapBoundaryPoints(path_data_.discretized_path(),
+                                        obstacle, upper_points, lower_points);
+    }
+
+    const int num_trajectory_points =
+            obstacle.Trajectory().trajectory_point_size();
+    auto* cache = injector_->st_boundary_cache();
+    STBoundaryCache::OverlapPoints points;
+    if (cache->Find(obstacle.Id(), perception_time, num_trajectory_points,
+                    path_id_, &points))
+    {
+        *upper_points = std::move(points.upper_points);
+        *lower_points = std::move(points.lower_points);
+        return points.has_overlap;
+    }
+
+    points.has_overlap = GetOverlapBoundaryPoints(
+            path_data_.discretized_path(), obstacle, upper_points,
+            lower_points);
+    points.upper_points = *upper_points;
+    points.lower_points = *lower_points;
+    cache->Insert(obstacle.Id(), perception_time, num_trajectory_points,
+                  path_id_, points);
+    return points.has_overlap;
+}
+
+std::vector<double> STBoundaryMapper::ComputePathSignature() const
+{
+    const bool in_change_lane = injector_->planning_context()
+                                        ->planning_status()
+                                        .change_lane()
+                                        .status() ==
+                                ChangeLaneStatus::IN_CHANGE_LANE;
+    const auto& path_points = path_data_.discretized_path();
+    std::vector<double> signature;
+    signature.reserve(5 + 4 * path_points.size());
+    signature.push_back(planning_max_distance_);
+    signature.push_back(planning_max_time_);
+    signature.push_back(FLAGS_nonstatic_obstacle_nudge_l_buffer);
+    signature.push_back(FLAGS_lane_change_obstacle_nudge_l_buffer);
+    signature.push_back(in_change_lane ? 1.0 : 0.0);
+    for (const auto& path_point : path_points)
+    {
+        signature.push_back(path_point.x());
+        signature.push_back(path_point.y());
+        signature.push_back(path_point.theta());
+        signature.push_back(path_point.s());
+    }
+    return signature;
+}
+
 bool STBoundaryMapper::GetOverlapBoundaryPoints(
         const std::vector<PathPoint>& path_points, const Obstacle& obstacle,
         std::vector<STPoint>* upper_points,
@@ -502,8 +568,8 @@ void STBoundaryMapper::ComputeSTBoundaryWithDecision(
     else
     {
         // 只是计算st bound，并不会额外拓展
-        if (!GetOverlapBoundaryPoints(path_data_.discretized_path(), *obstacle,
-                                      &upper_points, &lower_points))
+        if (!GetCachedOverlapBoundaryPoints(*obstacle, &upper_points,
+                                            &lower_points))
         {
             return;
         }
@@ -31,6 +31,7 @@
 #include "modules/planning/common/path/path_data.h"
 #include "modules/planning/common/path_decision.h"
 #include "modules/planning/common/speed/st_boundary.h"
+#include "modules/planning/common/speed/st_boundary_cache.h"
 #include "modules/planning/common/speed_limit.h"
 #include "modules/planning/proto/task_config.pb.h"
 #include "modules/planning/reference_line/reference_line.h"
@@ -74,6 +75,19 @@ private:
             const Obstacle& obstacle, std::vector<STPoint>* upper_points,
             std::vector<STPoint>* lower_points) const;
 
+    /** @brief Looks the overlap points of the obstacle up in the st
+     * boundary cache of the injector, and calls GetOverlapBoundaryPoints
+     * on a miss.
+     */
+    bool GetCachedOverlapBoundaryPoints(
+            const Obstacle& obstacle, std::vector<STPoint>* upper_points,
+            std::vector<STPoint>* lower_points) const;
+
+    /** @brief Everything the overlap points depend on besides the obstacle,
+     * computed once per ComputeSTBoundary.
+     */
+    std::vector<double> ComputePathSignature() const;
+
     /** @brief Given a path-point and an obstacle bounding box, check if the
      *        ADC, when at that path-point, will collide with the obstacle.
      * @param The path-point of the center of rear-axis for ADC.
@@ -158,6 +172,7 @@ private:
     std::shared_ptr<DependencyInjector> injector_;
 
     std::vector<Polygon2D> adc_polygon_path_;
+    int path_id_ = 0;
 };
 
 }  // namespace planning
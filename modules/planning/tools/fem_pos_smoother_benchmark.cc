@@ -0,0 +1,328 @@
+/******************************************************************************
+ * Copyright 2023 The Apollo Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *****************************************************************************/
+
+/**
+ * @file
+ * @brief Times FemPosDeviationSmoother created per reference line against
+ * one kept across calls (workspace reuse) on the same recorded anchor points.
+ * Usage:
+ *   fem_pos_smoother_benchmark --anchor_points_file=points.txt
+ *       [--smoother_config_file=fem_pos_config.pb.txt] [--repeat=10]
+ *       [--output_file=out.txt] [--compare_file=other_out.txt]
+ * The anchor point file holds one "x y [lateral_bound]" per line, reference
+ * lines of consecutive planning cycles are separated by an empty line.
+ * To compare with an older revision of the smoother, build this tool against
+ * that revision (e.g. in a git worktree), run it with --output_file, then run
+ * the current build with --compare_file on the same anchor points.
+ */
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <fstream>
+#include <iomanip>
+#include <sstream>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "gflags/gflags.h"
+
+#include "cyber/common/file.h"
+#include "cyber/common/log.h"
+#include "modules/planning/math/discretized_points_smoothing/fem_pos_deviation_smoother.h"
+
+DEFINE_string(anchor_points_file, "", "recorded reference line anchor points");
+DEFINE_string(smoother_config_file, "",
+              "FemPosDeviationSmootherConfig in text format, the default "
+              "config is used if empty");
+DEFINE_double(default_lateral_bound, 0.25,
+              "lateral bound of anchor points without a recorded bound");
+DEFINE_int32(repeat, 10, "number of passes over all reference lines");
+DEFINE_string(output_file, "",
+              "file to write the smoothed points of the reused workspace "
+              "run to, in the format of the anchor point file");
+DEFINE_string(compare_file, "",
+              "output_file of another run, e.g. of a build at an older "
+              "revision, to report the max point deviation against");
+
+namespace apollo
+{
+namespace planning
+{
+namespace
+{
+struct SmoothingProblem
+{
+    std::vector<std::pair<double, double>> points;
+    std::vector<double> bounds;
+};
+
+bool LoadProblems(const std::string& file_name,
+                  std::vector<SmoothingProblem>* problems)
+{
+    std::ifstream fin(file_name);
+    if (!fin.is_open())
+    {
+        AERROR << "Failed to open " << file_name;
+        return false;
+    }
+
+    SmoothingProblem problem;
+    std::string line;
+    auto flush = [&problems, &problem]() {
+        if (problem.points.size() > 2)
+        {
+            // same treatment as DiscretePointsReferenceLineSmoother
+            const double zero_x = problem.points.front().first;
+            const double zero_y = problem.points.front().second;
+            for (auto& point : problem.points)
+            {
+                point.first -= zero_x;
+                point.second -= zero_y;
+            }
+            problem.bounds.front() = 0.0;
+            problem.bounds.back() = 0.0;
+            for (auto& bound : problem.bounds)
+            {
+                bound *= 1.0 / std::sqrt(2.0);
+            }
+            problems->push_back(problem);
+        }
+        problem.points.clear();
+        problem.bounds.clear();
+    };
+
+    while (std::getline(fin, line))
+    {
+        std::istringstream iss(line);
+        double x = 0.0;
+        double y = 0.0;
+        if (!(iss >> x >> y))
+        {
+            flush();
+            continue;
+        }
+        double bound = FLAGS_default_lateral_bound;
+        iss >> bound;
+        problem.points.emplace_back(x, y);
+        problem.bounds.push_back(bound);
+    }
+    flush();
+    return !problems->empty();
+}
+
+struct BenchmarkResult
+{
+    double total_ms = 0.0;
+    double max_ms = 0.0;
+    int num_solved = 0;
+    int num_failed = 0;
+    std::vector<std::vector<double>> opt_x;
+    std::vector<std::vector<double>> opt_y;
+};
+
+template <typename SolveFunc>
+BenchmarkResult RunBenchmark(const std::vector<SmoothingProblem>& problems,
+                             const SolveFunc& solve)
+{
+    BenchmarkResult result;
+    result.opt_x.resize(problems.size());
+    result.opt_y.resize(problems.size());
+    for (int pass = 0; pass < FLAGS_repeat; ++pass)
+    {
+        for (size_t i = 0; i < problems.size(); ++i)
+        {
+            const auto start = std::chrono::steady_clock::now();
+            const bool ok = solve(problems[i], &result.opt_x[i],
+                                  &result.opt_y[i]);
+            const double ms = std::chrono::duration<double, std::milli>(
+                                      std::chrono::steady_clock::now() - start)
+                                      .count();
+            result.total_ms += ms;
+            result.max_ms = std::max(result.max_ms, ms);
+            if (ok)
+            {
+                ++result.num_solved;
+            }
+            else
+            {
+                ++result.num_failed;
+            }
+        }
+    }
+    return result;
+}
+
+// largest distance between the points of two runs on the same problems
+double MaxDeviation(const BenchmarkResult& lhs, const BenchmarkResult& rhs)
+{
+    double max_deviation = 0.0;
+    for (size_t i = 0; i < lhs.opt_x.size(); ++i)
+    {
+        const size_t size =
+                std::min(lhs.opt_x[i].size(), rhs.opt_x[i].size());
+        for (size_t j = 0; j < size; ++j)
+        {
+            max_deviation = std::max(
+                    max_deviation,
+                    std::hypot(lhs.opt_x[i][j] - rhs.opt_x[i][j],
+                               lhs.opt_y[i][j] - rhs.opt_y[i][j]));
+        }
+    }
+    return max_deviation;
+}
+
+bool WriteResult(const std::string& file_name, const BenchmarkResult& result)
+{
+    std::ofstream fout(file_name);
+    if (!fout.is_open())
+    {
+        AERROR << "Failed to open " << file_name;
+        return false;
+    }
+    fout << std::setprecision(17);
+    for (size_t i = 0; i < result.opt_x.size(); ++i)
+    {
+        for (size_t j = 0; j < result.opt_x[i].size(); ++j)
+        {
+            fout << result.opt_x[i][j] << " " << result.opt_y[i][j] << "\n";
+        }
+        fout << "\n";
+    }
+    return true;
+}
+
+// reads the points written by WriteResult, one reference line per block
+bool LoadResult(const std::string& file_name, BenchmarkResult* result)
+{
+    std::ifstream fin(file_name);
+    if (!fin.is_open())
+    {
+        AERROR << "Failed to open " << file_name;
+        return false;
+    }
+    result->opt_x.assign(1, {});
+    result->opt_y.assign(1, {});
+    std::string line;
+    while (std::getline(fin, line))
+    {
+        std::istringstream iss(line);
+        double x = 0.0;
+        double y = 0.0;
+        if (!(iss >> x >> y))
+        {
+            result->opt_x.emplace_back();
+            result->opt_y.emplace_back();
+            continue;
+        }
+        result->opt_x.back().push_back(x);
+        result->opt_y.back().push_back(y);
+    }
+    // drops the block opened by the last separator
+    result->opt_x.pop_back();
+    result->opt_y.pop_back();
+    return true;
+}
+
+void Report(const std::string& name, const BenchmarkResult& result)
+{
+    const int num_runs = result.num_solved + result.num_failed;
+    AINFO << name << ": runs " << num_runs << ", failed " << result.num_failed
+          << ", mean " << result.total_ms / std::max(num_runs, 1)
+          << " ms, max " << result.max_ms << " ms";
+}
+
+}  // namespace
+}  // namespace planning
+}  // namespace apollo
+
+int main(int argc, char* argv[])
+{
+    google::ParseCommandLineFlags(&argc, &argv, true);
+
+    using apollo::planning::FemPosDeviationSmoother;
+    using apollo::planning::FemPosDeviationSmootherConfig;
+    using apollo::planning::SmoothingProblem;
+
+    FemPosDeviationSmootherConfig config;
+    if (!FLAGS_smoother_config_file.empty() &&
+        !apollo::cyber::common::GetProtoFromFile(FLAGS_smoother_config_file,
+                                                 &config))
+    {
+        AERROR << "Failed to load config " << FLAGS_smoother_config_file;
+        return -1;
+    }
+
+    std::vector<SmoothingProblem> problems;
+    if (!apollo::planning::LoadProblems(FLAGS_anchor_points_file, &problems))
+    {
+        AERROR << "No reference line loaded from "
+               << FLAGS_anchor_points_file;
+        return -1;
+    }
+
+    const auto per_call = apollo::planning::RunBenchmark(
+            problems, [&config](const SmoothingProblem& problem,
+                                std::vector<double>* opt_x,
+                                std::vector<double>* opt_y) {
+                FemPosDeviationSmoother smoother(config);
+                return smoother.Solve(problem.points, problem.bounds, opt_x,
+                                      opt_y);
+            });
+
+    FemPosDeviationSmoother reused_smoother(config);
+    const auto reused = apollo::planning::RunBenchmark(
+            problems, [&reused_smoother](const SmoothingProblem& problem,
+                                         std::vector<double>* opt_x,
+                                         std::vector<double>* opt_y) {
+                return reused_smoother.Solve(problem.points, problem.bounds,
+                                             opt_x, opt_y);
+            });
+
+    // both variants solve the same problems, the results should only differ
+    // within the solver tolerance
+    AINFO << "Loaded " << problems.size() << " reference lines";
+    apollo::planning::Report("setup per call", per_call);
+    apollo::planning::Report("reused workspace", reused);
+    AINFO << "speed up of reused workspace: "
+          << per_call.total_ms / std::max(reused.total_ms, 1e-9);
+    AINFO << "max point deviation of reused workspace: "
+          << apollo::planning::MaxDeviation(per_call, reused) << " m";
+
+    if (!FLAGS_output_file.empty() &&
+        !apollo::planning::WriteResult(FLAGS_output_file, reused))
+    {
+        return -1;
+    }
+    if (!FLAGS_compare_file.empty())
+    {
+        apollo::planning::BenchmarkResult other;
+        if (!apollo::planning::LoadResult(FLAGS_compare_file, &other))
+        {
+            return -1;
+        }
+        if (other.opt_x.size() != reused.opt_x.size())
+        {
+            AERROR << FLAGS_compare_file << " holds " << other.opt_x.size()
+                   << " reference lines, expected " << reused.opt_x.size();
+            return -1;
+        }
+        AINFO << "max point deviation from " << FLAGS_compare_file << ": "
+              << apollo::planning::MaxDeviation(other, reused) << " m";
+    }
+    return 0;
+}
@@ -23,14 +23,14 @@ namespace planning
 void AutotuningMLPModel::Run(const std::vector<Eigen::MatrixXf>& inputs,
                              Eigen::MatrixXf* const output) const
 {
-    Eigen::MatrixXf inp = inputs[0];
-    Eigen::MatrixXf temp;
+    // every row of the input is one sample, all samples run as one batch
+    const Eigen::MatrixXf* inp = &inputs[0];
     for (size_t i = 0; i < layers_.size(); ++i)
     {
-        layers_[i]->Run({inp}, &temp);
-        inp = temp;
+        layers_[i]->Run(*inp, &layer_outputs_[i]);
+        inp = &layer_outputs_[i];
     }
-    *output = temp;
+    *output = *inp;
 }
 
 }  // namespace planning
@@ -30,33 +30,74 @@ namespace prediction
 using apollo::common::PointENU;
 using apollo::hdmap::JunctionInfo;
 using apollo::hdmap::LaneInfo;
+using apollo::hdmap::HDMap;
+using apollo::hdmap::HDMapUtil;
 using ConstLaneInfoPtr = std::shared_ptr<const LaneInfo>;
 
+// Junction topology only depends on the base map, so it is cached for the
+// whole process and dropped when the base map object changes.
+std::mutex JunctionAnalyzer::topology_cache_mutex_;
+const HDMap* JunctionAnalyzer::topology_cache_map_ = nullptr;
+std::unordered_map<std::string,
+                   std::shared_ptr<JunctionAnalyzer::JunctionTopology>>
+        JunctionAnalyzer::topology_cache_;
+
 void JunctionAnalyzer::Init(const std::string& junction_id)
 {
-    if (junction_info_ptr_ != nullptr &&
-        junction_info_ptr_->id().id() == junction_id)
-    {
-        return;
-    }
-    Clear();
-    junction_info_ptr_ = PredictionMap::JunctionById(junction_id);
-    SetAllJunctionExits();
+    // Looked up every time so that a reloaded map is picked up even if the
+    // junction stays the same.
+    topology_ = GetJunctionTopology(junction_id);
 }
 
 void JunctionAnalyzer::Clear()
 {
     // Clear all data
-    junction_info_ptr_ = nullptr;
-    junction_exits_.clear();
-    junction_features_.clear();
+    topology_ = nullptr;
+}
+
+void JunctionAnalyzer::ClearJunctionTopologyCache()
+{
+    std::lock_guard<std::mutex> lock(topology_cache_mutex_);
+    topology_cache_.clear();
+    topology_cache_map_ = nullptr;
 }
 
-void JunctionAnalyzer::SetAllJunctionExits()
+std::shared_ptr<JunctionAnalyzer::JunctionTopology>
+JunctionAnalyzer::GetJunctionTopology(const std::string& junction_id)
 {
-    CHECK_NOTNULL(junction_info_ptr_);
+    std::lock_guard<std::mutex> lock(topology_cache_mutex_);
+    const HDMap* base_map = HDMapUtil::BaseMapPtr();
+    if (base_map != topology_cache_map_)
+    {
+        topology_cache_.clear();
+        topology_cache_map_ = base_map;
+    }
+    auto iter = topology_cache_.find(junction_id);
+    if (iter != topology_cache_.end())
+    {
+        return iter->second;
+    }
+
+    auto junction_info_ptr = PredictionMap::JunctionById(junction_id);
+    if (junction_info_ptr == nullptr)
+    {
+        AERROR << "Junction [" << junction_id << "] is not in the map";
+        return nullptr;
+    }
+    auto topology = std::make_shared<JunctionTopology>();
+    topology->junction_info_ptr = junction_info_ptr;
+    topology->junction_range = ComputeJunctionRange(*junction_info_ptr);
+    SetAllJunctionExits(topology.get());
+    topology_cache_.emplace(junction_id, topology);
+    return topology;
+}
+
+void JunctionAnalyzer::SetAllJunctionExits(JunctionTopology* topology)
+{
+    CHECK_NOTNULL(topology->junction_info_ptr);
     // Go through everything that the junction overlaps with.
-    for (const auto& overlap_id : junction_info_ptr_->junction().overlap_id())
+    for (const auto& overlap_id :
+         topology->junction_info_ptr->junction().overlap_id())
     {
         auto overlap_info_ptr = PredictionMap::OverlapById(overlap_id.id());
         if (overlap_info_ptr == nullptr)
@@ -83,7 +124,7 @@ void JunctionAnalyzer::SetAllJunctionExits()
                     junction_exit.set_exit_heading(lane_info_ptr->Heading(s));
                     junction_exit.set_exit_width(lane_info_ptr->GetWidth(s));
                     // add junction_exit to hashtable
-                    junction_exits_[lane_id] = junction_exit;
+                    topology->junction_exits[lane_id] = junction_exit;
                 }
             }
         }
@@ -112,7 +153,8 @@ std::vector<JunctionExit> JunctionAnalyzer::GetJunctionExits(
         if (IsExitLane(curr_lane_id) &&
             visited_exit_lanes.find(curr_lane_id) == visited_exit_lanes.end())
         {
-            junction_exits.push_back(junction_exits_[curr_lane_id]);
+            junction_exits.push_back(
+                    topology_->junction_exits.at(curr_lane_id));
             visited_exit_lanes.insert(curr_lane_id);
             continue;
         }
@@ -134,9 +176,14 @@ std::vector<JunctionExit> JunctionAnalyzer::GetJunctionExits(
 const JunctionFeature& JunctionAnalyzer::GetJunctionFeature(
         const std::string& start_lane_id)
 {
-    if (junction_features_.find(start_lane_id) != junction_features_.end())
+    CHECK_NOTNULL(topology_);
+    // The topology is shared with the analyzers of other containers, which
+    // may run on other threads.
+    std::lock_guard<std::mutex> lock(topology_->mutex);
+    auto iter = topology_->junction_features.find(start_lane_id);
+    if (iter != topology_->junction_features.end())
     {
-        return junction_features_[start_lane_id];
+        return iter->second;
     }
     JunctionFeature junction_feature;
     junction_feature.set_junction_id(GetJunctionId());
@@ -150,8 +197,10 @@ const JunctionFeature& JunctionAnalyzer::GetJunctionFeature(
     }
     junction_feature.mutable_enter_lane()->set_lane_id(start_lane_id);
     junction_feature.add_start_lane_id(start_lane_id);
-    junction_features_[start_lane_id] = junction_feature;
-    return junction_features_[start_lane_id];
+    // references to unordered_map elements stay valid on insertion
+    return topology_->junction_features
+            .emplace(start_lane_id, std::move(junction_feature))
+            .first->second;
 }
 
 JunctionFeature JunctionAnalyzer::GetJunctionFeature(
@@ -162,7 +211,8 @@ JunctionFeature JunctionAnalyzer::GetJunctionFeature(
     std::unordered_map<std::string, JunctionExit> junction_exits_map;
     for (const std::string& start_lane_id : start_lane_ids)
     {
-        JunctionFeature junction_feature = GetJunctionFeature(start_lane_id);
+        const JunctionFeature& junction_feature =
+                GetJunctionFeature(start_lane_id);
         if (!initialized)
         {
             merged_junction_feature.set_junction_id(
@@ -192,22 +242,28 @@ JunctionFeature JunctionAnalyzer::GetJunctionFeature(
 
 bool JunctionAnalyzer::IsExitLane(const std::string& lane_id)
 {
-    return junction_exits_.find(lane_id) != junction_exits_.end();
+    return topology_->junction_exits.find(lane_id) !=
+           topology_->junction_exits.end();
 }
 
 const std::string& JunctionAnalyzer::GetJunctionId()
 {
-    CHECK_NOTNULL(junction_info_ptr_);
-    return junction_info_ptr_->id().id();
+    CHECK_NOTNULL(topology_);
+    return topology_->junction_info_ptr->id().id();
 }
 
 double JunctionAnalyzer::ComputeJunctionRange()
 {
-    CHECK_NOTNULL(junction_info_ptr_);
-    if (!junction_info_ptr_->junction().has_polygon() ||
-        junction_info_ptr_->junction().polygon().point_size() < 3)
+    CHECK_NOTNULL(topology_);
+    return topology_->junction_range;
+}
+
+double JunctionAnalyzer::ComputeJunctionRange(const JunctionInfo& info)
+{
+    if (!info.junction().has_polygon() ||
+        info.junction().polygon().point_size() < 3)
     {
-        AERROR << "Junction [" << GetJunctionId()
+        AERROR << "Junction [" << info.id().id()
                << "] has not enough polygon points to compute range";
         return FLAGS_defualt_junction_range;
     }
@@ -215,7 +271,7 @@ double JunctionAnalyzer::ComputeJunctionRange()
     double x_max = -std::numeric_limits<double>::infinity();
     double y_min = std::numeric_limits<double>::infinity();
     double y_max = -std::numeric_limits<double>::infinity();
-    for (const auto& point : junction_info_ptr_->junction().polygon().point())
+    for (const auto& point : info.junction().polygon().point())
     {
         x_min = std::min(x_min, point.x());
         x_max = std::max(x_max, point.x());
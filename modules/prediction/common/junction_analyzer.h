@@ -17,6 +17,7 @@
 #pragma once
 
 #include <memory>
+#include <mutex>
 #include <string>
 #include <unordered_map>
 #include <vector>
@@ -32,7 +33,9 @@ class JunctionAnalyzer
 {
 public:
     /**
-     * @brief Initialize by junction ID, if junction id differs from prev cycle
+     * @brief Initialize by junction ID. The junction topology is taken from a
+     *        process wide cache shared by all analyzers and is only built on
+     *        the first use of a junction.
      * @param junction ID
      */
     void Init(const std::string& junction_id);
@@ -42,6 +45,12 @@ public:
      */
     void Clear();
 
+    /**
+     * @brief Drop the cached topology of all junctions. The cache is also
+     *        dropped automatically once the base map is reloaded.
+     */
+    static void ClearJunctionTopologyCache();
+
     /**
      * @brief Get junction ID
      * @return Junction ID
@@ -71,9 +80,42 @@ public:
 
 private:
     /**
-     * @brief Set all junction exits in the hashtable junction_exits_
+     * @brief Static structure of one junction which is shared by all the
+     *        analyzers initialized with this junction.
+     */
+    struct JunctionTopology
+    {
+        // junction_info pointer associated to the junction_id
+        std::shared_ptr<const apollo::hdmap::JunctionInfo> junction_info_ptr;
+        double junction_range = 0.0;
+        // Hashtable: exit_lane_id -> junction_exit
+        std::unordered_map<std::string, JunctionExit> junction_exits;
+        // Guards junction_features, which is filled lazily
+        std::mutex mutex;
+        // Hashtable: start_lane_id -> junction_feature
+        std::unordered_map<std::string, JunctionFeature> junction_features;
+    };
+
+    /**
+     * @brief Get the cached topology of a junction, build it on first use
+     * @param junction ID
+     * @return Junction topology, nullptr if the junction is not in the map
      */
-    void SetAllJunctionExits();
+    static std::shared_ptr<JunctionTopology> GetJunctionTopology(
+            const std::string& junction_id);
+
+    /**
+     * @brief Set all junction exits of a junction
+     * @param Junction topology with junction_info_ptr set
+     */
+    static void SetAllJunctionExits(JunctionTopology* topology);
+
+    /**
+     * @brief Compute junction range from the junction polygon
+     * @param Junction info
+     * @return Junction range
+     */
+    static double ComputeJunctionRange(const apollo::hdmap::JunctionInfo& info);
 
     /**
      * @brief Get all filtered junction exits associated to start lane ID
@@ -91,12 +133,16 @@ private:
     bool IsExitLane(const std::string& lane_id);
 
 private:
-    // junction_info pointer associated to the input junction_id
-    std::shared_ptr<const apollo::hdmap::JunctionInfo> junction_info_ptr_;
-    // Hashtable: exit_lane_id -> junction_exit
-    std::unordered_map<std::string, JunctionExit> junction_exits_;
-    // Hashtable: start_lane_id -> junction_feature
-    std::unordered_map<std::string, JunctionFeature> junction_features_;
+    // topology of the current junction, owned together with the cache so it
+    // stays valid if the cache is dropped while this analyzer still uses it
+    std::shared_ptr<JunctionTopology> topology_;
+
+    // Process wide cache: junction_id -> junction topology, built for the
+    // base map topology_cache_map_
+    static std::mutex topology_cache_mutex_;
+    static const apollo::hdmap::HDMap* topology_cache_map_;
+    static std::unordered_map<std::string, std::shared_ptr<JunctionTopology>>
+            topology_cache_;
 };
 
 }  // namespace prediction
@@ -61,6 +61,9 @@ DEFINE_double(base_image_half_range, 100.0, "The half range of base image.");
 DEFINE_bool(enable_draw_adc_trajectory, true,
             "If draw adc trajectory in semantic map");
 DEFINE_bool(img_show_semantic_map, false, "If show the image of semantic map.");
+DEFINE_bool(enable_incremental_semantic_map, true,
+            "If scroll the base image with the ego vehicle and only draw the "
+            "newly exposed map area, instead of redrawing the whole image.");
 
 // Scenario
 DEFINE_double(junction_distance_threshold, 10.0,
@@ -145,6 +148,11 @@ DEFINE_double(still_unknown_position_std, 0.5,
 DEFINE_double(slow_obstacle_speed_threshold, 2.0,
               "Speed threshold for slow obstacles");
 DEFINE_double(max_history_time, 7.0, "Obstacles' maximal historical time.");
+DEFINE_int32(max_num_obstacle_history_frames, 128,
+             "Capacity of the numeric state history of one obstacle");
+DEFINE_bool(enable_compact_obstacle_history, true,
+            "If lane graphs and trajectories are only kept in the latest "
+            "feature of obstacle history");
 DEFINE_double(target_lane_gap, 2.0, "Gap between two lane points.");
 DEFINE_double(dense_lane_gap, 0.2,
               "Gap between two adjacent lane points"
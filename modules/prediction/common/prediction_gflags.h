@@ -47,6 +47,7 @@ DECLARE_double(surrounding_lane_search_radius);
 DECLARE_double(base_image_half_range);
 DECLARE_bool(enable_draw_adc_trajectory);
 DECLARE_bool(img_show_semantic_map);
+DECLARE_bool(enable_incremental_semantic_map);
 
 // Scenario
 DECLARE_double(junction_distance_threshold);
@@ -92,6 +93,8 @@ DECLARE_double(still_pedestrian_position_std);
 DECLARE_double(still_unknown_position_std);
 DECLARE_double(slow_obstacle_speed_threshold);
 DECLARE_double(max_history_time);
+DECLARE_int32(max_num_obstacle_history_frames);
+DECLARE_bool(enable_compact_obstacle_history);
 DECLARE_double(target_lane_gap);
 DECLARE_double(dense_lane_gap);
 DECLARE_int32(max_num_current_lane);
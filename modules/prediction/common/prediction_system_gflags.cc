@@ -55,10 +55,28 @@ DEFINE_int32(prediction_offline_mode, 0,
              "3: dump predicted trajectory to predict_result.*.bin"
              "4: dump frame environment info to frame_env.*.bin"
              "5: dump data for tuning to datatuning.*.bin");
+DEFINE_double(offline_shard_duration_sec, 60.0,
+              "Time window of the records processed by one task of the "
+              "offline feature pipeline.");
+DEFINE_double(offline_shard_warm_up_sec, 8.0,
+              "Time before a shard whose messages only fill the container "
+              "history, should cover FLAGS_max_history_time.");
 DEFINE_bool(enable_multi_thread, true, "If enable multi-thread.");
 DEFINE_int32(max_thread_num, 8, "Maximal number of threads.");
-DEFINE_int32(max_caution_thread_num, 2,
-             "Maximal number of threads for caution obstacles.");
+DEFINE_bool(enable_batched_model_inference, false,
+            "If defer torch model inference of evaluators to the end of the "
+            "evaluation stage and run it batched across obstacles.");
+DEFINE_int32(max_model_inference_batch_size, 32,
+             "Maximal number of obstacles in one batched model inference.");
+DEFINE_double(model_inference_batch_deadline_ms, 5.0,
+              "Maximal time in ms a queued obstacle waits for its batch.");
+DEFINE_bool(enable_prediction_deadline, false,
+            "If replace the evaluator of a normal priority obstacle by a "
+            "cheaper one, or skip it, when its estimated cost exceeds the "
+            "remaining evaluation budget of the frame. Ignored with "
+            "enable_batched_model_inference.");
+DEFINE_double(prediction_evaluation_budget_ms, 60.0,
+              "Time budget in ms of the evaluation stage of one frame.");
 DEFINE_bool(enable_async_draw_base_image, true,
             "If enable async to draw base image");
 DEFINE_bool(use_cuda, true, "If use cuda for torch.");
@@ -99,3 +117,6 @@ DEFINE_double(obstacle_phi, 0.0, "obstacle heading phi");
 DEFINE_double(road_distance, 100.0,
               "road distance within which the points are got");
 DEFINE_double(point_distance, 5.0, "sampling distance of two points");
+DEFINE_int32(max_num_cached_vectornet_polylines, 20000,
+             "Maximal number of sampled map polylines VectorNet keeps, the "
+             "cache is emptied once it grows larger");
@@ -32,9 +32,15 @@ DECLARE_double(prediction_test_duration);
 
 DECLARE_string(prediction_offline_bags);
 DECLARE_int32(prediction_offline_mode);
+DECLARE_double(offline_shard_duration_sec);
+DECLARE_double(offline_shard_warm_up_sec);
 DECLARE_bool(enable_multi_thread);
 DECLARE_int32(max_thread_num);
-DECLARE_int32(max_caution_thread_num);
+DECLARE_bool(enable_batched_model_inference);
+DECLARE_int32(max_model_inference_batch_size);
+DECLARE_double(model_inference_batch_deadline_ms);
+DECLARE_bool(enable_prediction_deadline);
+DECLARE_double(prediction_evaluation_budget_ms);
 DECLARE_bool(enable_async_draw_base_image);
 DECLARE_bool(use_cuda);
 
@@ -61,3 +67,4 @@ DECLARE_double(obstacle_y);
 DECLARE_double(obstacle_phi);
 DECLARE_double(road_distance);
 DECLARE_double(point_distance);
+DECLARE_int32(max_num_cached_vectornet_polylines);
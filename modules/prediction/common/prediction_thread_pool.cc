@@ -16,10 +16,20 @@
 
 #include "modules/prediction/common/prediction_thread_pool.h"
 
+#include "modules/prediction/common/prediction_system_gflags.h"
+
 namespace apollo
 {
 namespace prediction
 {
+namespace
+{
+// pool and queue of the current worker thread
+thread_local const WorkStealingThreadPool* s_worker_pool = nullptr;
+thread_local size_t s_worker_queue_index = 0;
+
+}  // namespace
+
 thread_local int PredictionThreadPool::s_thread_pool_level = 0;
 std::vector<int> BaseThreadPool::THREAD_POOL_CAPACITY = {20, 20, 20};
 
@@ -96,5 +106,146 @@ BaseThreadPool* PredictionThreadPool::Instance()
     return LevelThreadPool<0>::Instance();
 }
 
+WorkStealingThreadPool* PredictionThreadPool::WorkStealingInstance()
+{
+    static WorkStealingThreadPool pool(std::max(FLAGS_max_thread_num - 1, 0));
+    return &pool;
+}
+
+WorkStealingThreadPool::WorkStealingThreadPool(int thread_num)
+{
+    thread_num = std::max(thread_num, 0);
+    for (int i = 0; i <= thread_num; ++i)
+    {
+        queues_.emplace_back(new JobQueue());
+    }
+    for (int i = 0; i < thread_num; ++i)
+    {
+        workers_.emplace_back([this, i] { WorkerLoop(i); });
+    }
+}
+
+WorkStealingThreadPool::~WorkStealingThreadPool()
+{
+    {
+        std::lock_guard<std::mutex> lock(wake_mutex_);
+        stopped_ = true;
+    }
+    wake_cv_.notify_all();
+    for (std::thread& worker : workers_)
+    {
+        worker.join();
+    }
+}
+
+size_t WorkStealingThreadPool::DefaultChunkSize(size_t size) const
+{
+    // a few chunks per thread leave room for stealing when the cost of the
+    // iterations differs
+    const size_t num_chunks = 4 * (workers_.size() + 1);
+    return std::max<size_t>(size / num_chunks, 1);
+}
+
+size_t WorkStealingThreadPool::CurrentQueueIndex() const
+{
+    return s_worker_pool == this ? s_worker_queue_index : workers_.size();
+}
+
+void WorkStealingThreadPool::Run(Job* job)
+{
+    JobQueue* queue = queues_[CurrentQueueIndex()].get();
+    {
+        std::lock_guard<std::mutex> lock(queue->mutex);
+        queue->jobs.push_back(job);
+    }
+    {
+        std::lock_guard<std::mutex> lock(wake_mutex_);
+        wake_epoch_.fetch_add(1, std::memory_order_release);
+    }
+    wake_cv_.notify_all();
+
+    while (job->RunNextChunk())
+    {
+    }
+
+    // no thread can pick up the job after it left the queue, the remaining
+    // chunks are run by the thieves that already have it
+    {
+        std::lock_guard<std::mutex> lock(queue->mutex);
+        queue->jobs.erase(
+                std::find(queue->jobs.begin(), queue->jobs.end(), job));
+    }
+    while (job->num_thieves.load(std::memory_order_acquire) > 0)
+    {
+        if (!TryRunOtherJob(CurrentQueueIndex()))
+        {
+            std::this_thread::yield();
+        }
+    }
+}
+
+bool WorkStealingThreadPool::TryRunOtherJob(size_t queue_index)
+{
+    for (size_t i = 1; i <= queues_.size(); ++i)
+    {
+        JobQueue* queue = queues_[(queue_index + i) % queues_.size()].get();
+        Job* stolen_job = nullptr;
+        {
+            std::lock_guard<std::mutex> lock(queue->mutex);
+            // the oldest job of a thread is the outermost loop, it usually
+            // has the most work left
+            for (Job* job : queue->jobs)
+            {
+                if (job->HasChunk())
+                {
+                    stolen_job = job;
+                    stolen_job->num_thieves.fetch_add(
+                            1, std::memory_order_relaxed);
+                    break;
+                }
+            }
+        }
+        if (stolen_job == nullptr)
+        {
+            continue;
+        }
+        bool ran_chunk = false;
+        while (stolen_job->RunNextChunk())
+        {
+            ran_chunk = true;
+        }
+        // the owner may return as soon as this reaches zero
+        stolen_job->num_thieves.fetch_sub(1, std::memory_order_release);
+        if (ran_chunk)
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+void WorkStealingThreadPool::WorkerLoop(size_t queue_index)
+{
+    s_worker_pool = this;
+    s_worker_queue_index = queue_index;
+    while (true)
+    {
+        const uint64_t epoch = wake_epoch_.load(std::memory_order_acquire);
+        if (TryRunOtherJob(queue_index))
+        {
+            continue;
+        }
+        std::unique_lock<std::mutex> lock(wake_mutex_);
+        wake_cv_.wait(lock, [this, epoch] {
+            return stopped_ ||
+                   wake_epoch_.load(std::memory_order_relaxed) != epoch;
+        });
+        if (stopped_)
+        {
+            return;
+        }
+    }
+}
+
 }  // namespace prediction
 }  // namespace apollo
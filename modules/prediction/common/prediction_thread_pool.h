@@ -20,8 +20,14 @@
 
 #pragma once
 
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <deque>
 #include <future>
 #include <memory>
+#include <mutex>
+#include <thread>
 #include <utility>
 #include <vector>
 
@@ -110,17 +116,172 @@ private:
     }
 };
 
+/**
+ * @class WorkStealingThreadPool
+ * @brief Fork-join pool for parallel loops.
+ *
+ * A ParallelFor call is one job living on the stack of the calling thread.
+ * The job is published in the queue of the calling thread, and the caller
+ * and idle workers take chunks of iterations from it through an atomic
+ * counter. Idle workers steal jobs from the queues of other threads. No
+ * memory is allocated per iteration. A thread waiting for its job helps with
+ * the jobs of other threads, so ParallelFor can be nested without a pool per
+ * nesting level.
+ */
+class WorkStealingThreadPool
+{
+public:
+    explicit WorkStealingThreadPool(int thread_num);
+
+    ~WorkStealingThreadPool();
+
+    int thread_num() const { return static_cast<int>(workers_.size()); }
+
+    /**
+     * @brief Call f(i) for every i in [begin, end) and return after all calls
+     *        finished. The calling thread takes part in the loop.
+     * @param First index
+     * @param One past the last index
+     * @param Number of consecutive indices run as one task, picked from the
+     *        loop size and the thread number if 0
+     * @param Loop body
+     */
+    template <typename F>
+    void ParallelFor(size_t begin, size_t end, size_t chunk_size, const F& f)
+    {
+        if (begin >= end)
+        {
+            return;
+        }
+        if (chunk_size == 0)
+        {
+            chunk_size = DefaultChunkSize(end - begin);
+        }
+        if (workers_.empty() || end - begin <= chunk_size)
+        {
+            for (size_t i = begin; i < end; ++i)
+            {
+                f(i);
+            }
+            return;
+        }
+        Job job(begin, end, chunk_size, &RunChunk<F>, &f);
+        Run(&job);
+    }
+
+private:
+    struct Job
+    {
+        Job(size_t begin, size_t end, size_t chunk_size,
+            void (*run_chunk)(const void*, size_t, size_t), const void* func) :
+            run_chunk(run_chunk),
+            func(func),
+            end(end),
+            chunk_size(chunk_size),
+            next(begin)
+        {
+        }
+
+        bool HasChunk() const
+        {
+            return next.load(std::memory_order_relaxed) < end;
+        }
+
+        // claims and runs one chunk, returns false if none is left
+        bool RunNextChunk()
+        {
+            const size_t chunk_begin =
+                    next.fetch_add(chunk_size, std::memory_order_relaxed);
+            if (chunk_begin >= end)
+            {
+                return false;
+            }
+            run_chunk(func, chunk_begin,
+                      std::min(chunk_begin + chunk_size, end));
+            return true;
+        }
+
+        void (*const run_chunk)(const void*, size_t, size_t);
+        const void* const func;
+        const size_t end;
+        const size_t chunk_size;
+        std::atomic<size_t> next;
+        // threads other than the owner that may still access the job
+        std::atomic<int> num_thieves{0};
+    };
+
+    struct JobQueue
+    {
+        std::mutex mutex;
+        std::deque<Job*> jobs;
+    };
+
+    template <typename F>
+    static void RunChunk(const void* func, size_t begin, size_t end)
+    {
+        const F& f = *static_cast<const F*>(func);
+        for (size_t i = begin; i < end; ++i)
+        {
+            f(i);
+        }
+    }
+
+    size_t DefaultChunkSize(size_t size) const;
+
+    // publishes the job, works on it and waits until it is done
+    void Run(Job* job);
+
+    // runs chunks of a job from any queue, starting with the one after
+    // queue_index, returns false if no chunk was found
+    bool TryRunOtherJob(size_t queue_index);
+
+    void WorkerLoop(size_t queue_index);
+
+    size_t CurrentQueueIndex() const;
+
+private:
+    std::vector<std::thread> workers_;
+    // one queue per worker, the last one is shared by all other threads
+    std::vector<std::unique_ptr<JobQueue>> queues_;
+
+    std::mutex wake_mutex_;
+    std::condition_variable wake_cv_;
+    std::atomic<uint64_t> wake_epoch_{0};
+    bool stopped_ = false;
+};
+
 class PredictionThreadPool
 {
 public:
     static BaseThreadPool* Instance();
 
+    /**
+     * @brief The pool of ParallelFor and ForEach, it has
+     *        FLAGS_max_thread_num - 1 workers besides the calling thread.
+     */
+    static WorkStealingThreadPool* WorkStealingInstance();
+
     static thread_local int s_thread_pool_level;
 
+    /**
+     * @brief Call f(i) for every i in [0, size) in parallel
+     */
+    template <typename F>
+    static void ParallelFor(size_t size, const F& f, size_t chunk_size = 0)
+    {
+        WorkStealingInstance()->ParallelFor(0, size, chunk_size, f);
+    }
+
     template <typename InputIter, typename F>
     static void ForEach(InputIter begin, InputIter end, F f)
     {
-        Instance()->ForEach(begin, end, f);
+        std::vector<InputIter> iters;
+        for (auto iter = begin; iter != end; ++iter)
+        {
+            iters.push_back(iter);
+        }
+        ParallelFor(
+                iters.size(), [&iters, &f](size_t i) { f(*iters[i]); }, 1);
     }
 };
 
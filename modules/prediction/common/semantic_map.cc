@@ -16,6 +16,8 @@
 
 #include "modules/prediction/common/semantic_map.h"
 
+#include <algorithm>
+#include <cmath>
 #include <utility>
 #include <vector>
 
@@ -37,6 +39,28 @@ namespace prediction
 {
 namespace
 {
+// size of the base image in pixels and of one pixel in meters, the same as
+// in GetTransPoint()
+constexpr int kBaseImageSize = 2000;
+constexpr double kPixelSize = 0.1;
+// map elements are searched a bit beyond an area for the lane line width
+constexpr double kSearchRadiusMargin = 1.0;
+// the feature map is a 400 x 400 pixel window in front of the obstacle,
+// rotated to the obstacle heading and resized to 224 x 224
+constexpr int kCropSize = 400;
+constexpr int kCropCenterCol = 200;
+constexpr int kCropCenterRow = 300;
+constexpr int kFeatureMapSize = 224;
+// every pixel of the rotated window is within this distance of the obstacle
+const int kCropRadius = static_cast<int>(std::ceil(std::hypot(
+                                kCropCenterCol, kCropCenterRow))) +
+                        1;
+
+double SnapToPixel(const double value)
+{
+    return std::floor(value / kPixelSize) * kPixelSize;
+}
+
 bool ValidFeatureHistory(const ObstacleHistory& obstacle_history,
                          const double curr_base_x, const double curr_base_y)
 {
@@ -75,21 +99,29 @@ void SemanticMap::RunCurrFrame(
     }
 
     ego_feature_ = obstacle_id_history_map.at(FLAGS_ego_vehicle_id).feature(0);
+    // keep the origin on the pixel grid so that the base image can be
+    // scrolled by whole pixels
+    const double base_x = SnapToPixel(ego_feature_.position().x() -
+                                      FLAGS_base_image_half_range);
+    const double base_y = SnapToPixel(ego_feature_.position().y() -
+                                      FLAGS_base_image_half_range);
     if (!FLAGS_enable_async_draw_base_image)
     {
-        double x = ego_feature_.position().x();
-        double y = ego_feature_.position().y();
-        curr_base_x_ = x - FLAGS_base_image_half_range;
-        curr_base_y_ = y - FLAGS_base_image_half_range;
-        DrawBaseMap(x, y, curr_base_x_, curr_base_y_);
+        UpdateBaseMap(base_x, base_y);
         base_img_.copyTo(curr_img_);
+        curr_base_x_ = base_x_;
+        curr_base_y_ = base_y_;
     }
     else
     {
-        base_img_.copyTo(curr_img_);
-        curr_base_x_ = base_x_;
-        curr_base_y_ = base_y_;
-        task_future_ = cyber::Async(&SemanticMap::DrawBaseMapThread, this);
+        {
+            std::lock_guard<std::mutex> lock(draw_base_map_thread_mutex_);
+            base_img_.copyTo(curr_img_);
+            curr_base_x_ = base_x_;
+            curr_base_y_ = base_y_;
+        }
+        task_future_ = cyber::Async(&SemanticMap::DrawBaseMapThread, this,
+                                    base_x, base_y);
         // This is only for the first frame without base image yet
         if (!started_drawing_)
         {
@@ -127,34 +159,99 @@ void SemanticMap::RunCurrFrame(
     }
 }
 
-void SemanticMap::DrawBaseMap(const double x, const double y,
-                              const double base_x, const double base_y)
+void SemanticMap::UpdateBaseMap(const double base_x, const double base_y)
 {
-    base_img_ = cv::Mat(2000, 2000, CV_8UC3, cv::Scalar(0, 0, 0));
-    common::PointENU center_point =
-            common::util::PointFactory::ToPointENU(x, y);
-    DrawRoads(center_point, base_x, base_y);
-    DrawJunctions(center_point, base_x, base_y);
-    DrawCrosswalks(center_point, base_x, base_y);
-    DrawLanes(center_point, base_x, base_y);
+    const cv::Rect image_area(0, 0, kBaseImageSize, kBaseImageSize);
+    // pixel (col, row) of the new image is pixel (col + shift_col,
+    // row + shift_row) of the old one, rows grow southwards
+    const int shift_col =
+            static_cast<int>(std::lround((base_x - base_x_) / kPixelSize));
+    const int shift_row =
+            static_cast<int>(std::lround((base_y_ - base_y) / kPixelSize));
+    if (!FLAGS_enable_incremental_semantic_map || !has_base_img_ ||
+        std::abs(shift_col) >= kBaseImageSize ||
+        std::abs(shift_row) >= kBaseImageSize)
+    {
+        base_img_.create(kBaseImageSize, kBaseImageSize, CV_8UC3);
+        DrawBaseMapArea(image_area, base_x, base_y);
+    }
+    else if (shift_col != 0 || shift_row != 0)
+    {
+        const cv::Rect kept_area =
+                cv::Rect(-shift_col, -shift_row, kBaseImageSize,
+                         kBaseImageSize) &
+                image_area;
+        scrolled_img_.create(kBaseImageSize, kBaseImageSize, CV_8UC3);
+        base_img_(kept_area + cv::Point(shift_col, shift_row))
+                .copyTo(scrolled_img_(kept_area));
+        cv::swap(base_img_, scrolled_img_);
+
+        // exposed columns over the full height
+        if (shift_col > 0)
+        {
+            DrawBaseMapArea(cv::Rect(kept_area.br().x, 0, shift_col,
+                                     kBaseImageSize),
+                            base_x, base_y);
+        }
+        else if (shift_col < 0)
+        {
+            DrawBaseMapArea(cv::Rect(0, 0, -shift_col, kBaseImageSize),
+                            base_x, base_y);
+        }
+        // exposed rows of the kept columns
+        if (shift_row > 0)
+        {
+            DrawBaseMapArea(cv::Rect(kept_area.x, kept_area.br().y,
+                                     kept_area.width, shift_row),
+                            base_x, base_y);
+        }
+        else if (shift_row < 0)
+        {
+            DrawBaseMapArea(
+                    cv::Rect(kept_area.x, 0, kept_area.width, -shift_row),
+                    base_x, base_y);
+        }
+    }
+    base_x_ = base_x;
+    base_y_ = base_y;
+    has_base_img_ = true;
 }
 
-void SemanticMap::DrawBaseMapThread()
+void SemanticMap::DrawBaseMapThread(const double base_x, const double base_y)
 {
     std::lock_guard<std::mutex> lock(draw_base_map_thread_mutex_);
-    double x = ego_feature_.position().x();
-    double y = ego_feature_.position().y();
-    base_x_ = x - FLAGS_base_image_half_range;
-    base_y_ = y - FLAGS_base_image_half_range;
-    DrawBaseMap(x, y, base_x_, base_y_);
+    UpdateBaseMap(base_x, base_y);
+}
+
+void SemanticMap::DrawBaseMapArea(const cv::Rect& area, const double base_x,
+                                  const double base_y)
+{
+    cv::Mat area_img = base_img_(area);
+    area_img.setTo(cv::Scalar(0, 0, 0));
+    // origin of the area, GetTransPoint() then returns pixels of area_img
+    const double area_base_x = base_x + area.x * kPixelSize;
+    const double area_base_y = base_y - area.y * kPixelSize;
+
+    const double half_width = 0.5 * area.width * kPixelSize;
+    const double half_height = 0.5 * area.height * kPixelSize;
+    common::PointENU center_point = common::util::PointFactory::ToPointENU(
+            area_base_x + half_width,
+            base_y + (kBaseImageSize - area.y) * kPixelSize - half_height);
+    const double radius =
+            std::hypot(half_width, half_height) + kSearchRadiusMargin;
+    DrawRoads(center_point, radius, area_base_x, area_base_y, &area_img);
+    DrawJunctions(center_point, radius, area_base_x, area_base_y, &area_img);
+    DrawCrosswalks(center_point, radius, area_base_x, area_base_y, &area_img);
+    DrawLanes(center_point, radius, area_base_x, area_base_y, &area_img);
 }
 
 void SemanticMap::DrawRoads(const common::PointENU& center_point,
-                            const double base_x, const double base_y,
+                            const double radius, const double base_x,
+                            const double base_y, cv::Mat* img,
                             const cv::Scalar& color)
 {
     std::vector<apollo::hdmap::RoadInfoConstPtr> roads;
-    apollo::hdmap::HDMapUtil::BaseMap().GetRoads(center_point, 141.4, &roads);
+    apollo::hdmap::HDMapUtil::BaseMap().GetRoads(center_point, radius, &roads);
     for (const auto& road : roads)
     {
         for (const auto& section : road->road().section())
@@ -188,7 +285,7 @@ void SemanticMap::DrawRoads(const common::PointENU& center_point,
                 }
             }
             cv::fillPoly(
-                    base_img_,
+                    *img,
                     std::vector<std::vector<cv::Point>>({std::move(polygon)}),
                     color);
         }
@@ -196,11 +293,12 @@ void SemanticMap::DrawRoads(const common::PointENU& center_point,
 }
 
 void SemanticMap::DrawJunctions(const common::PointENU& center_point,
-                                const double base_x, const double base_y,
+                                const double radius, const double base_x,
+                                const double base_y, cv::Mat* img,
                                 const cv::Scalar& color)
 {
     std::vector<apollo::hdmap::JunctionInfoConstPtr> junctions;
-    apollo::hdmap::HDMapUtil::BaseMap().GetJunctions(center_point, 141.4,
+    apollo::hdmap::HDMapUtil::BaseMap().GetJunctions(center_point, radius,
                                                      &junctions);
     for (const auto& junction : junctions)
     {
@@ -210,18 +308,19 @@ void SemanticMap::DrawJunctions(const common::PointENU& center_point,
             polygon.push_back(std::move(
                     GetTransPoint(point.x(), point.y(), base_x, base_y)));
         }
-        cv::fillPoly(base_img_,
+        cv::fillPoly(*img,
                      std::vector<std::vector<cv::Point>>({std::move(polygon)}),
                      color);
     }
 }
 
 void SemanticMap::DrawCrosswalks(const common::PointENU& center_point,
-                                 const double base_x, const double base_y,
+                                 const double radius, const double base_x,
+                                 const double base_y, cv::Mat* img,
                                  const cv::Scalar& color)
 {
     std::vector<apollo::hdmap::CrosswalkInfoConstPtr> crosswalks;
-    apollo::hdmap::HDMapUtil::BaseMap().GetCrosswalks(center_point, 141.4,
+    apollo::hdmap::HDMapUtil::BaseMap().GetCrosswalks(center_point, radius,
                                                       &crosswalks);
     for (const auto& crosswalk : crosswalks)
     {
@@ -231,18 +330,19 @@ void SemanticMap::DrawCrosswalks(const common::PointENU& center_point,
             polygon.push_back(std::move(
                     GetTransPoint(point.x(), point.y(), base_x, base_y)));
         }
-        cv::fillPoly(base_img_,
+        cv::fillPoly(*img,
                      std::vector<std::vector<cv::Point>>({std::move(polygon)}),
                      color);
     }
 }
 
 void SemanticMap::DrawLanes(const common::PointENU& center_point,
-                            const double base_x, const double base_y,
+                            const double radius, const double base_x,
+                            const double base_y, cv::Mat* img,
                             const cv::Scalar& color)
 {
     std::vector<apollo::hdmap::LaneInfoConstPtr> lanes;
-    apollo::hdmap::HDMapUtil::BaseMap().GetLanes(center_point, 141.4, &lanes);
+    apollo::hdmap::HDMapUtil::BaseMap().GetLanes(center_point, radius, &lanes);
     for (const auto& lane : lanes)
     {
         // Draw lane_central first
@@ -273,7 +373,7 @@ void SemanticMap::DrawLanes(const common::PointENU& center_point,
                 //     * 255,
                 //                rgb.at<float>(0, 2) * 255);
 
-                cv::line(base_img_, p0, p1, HSVtoRGB(H), 4);
+                cv::line(*img, p0, p1, HSVtoRGB(H), 4);
             }
         }
         // Not drawing boundary for virtual city_driving lane
@@ -296,7 +396,7 @@ void SemanticMap::DrawLanes(const common::PointENU& center_point,
                         GetTransPoint(segment.line_segment().point(i + 1).x(),
                                       segment.line_segment().point(i + 1).y(),
                                       base_x, base_y);
-                cv::line(base_img_, p0, p1, color, 2);
+                cv::line(*img, p0, p1, color, 2);
             }
         }
         // Draw lane's right_boundary
@@ -312,7 +412,7 @@ void SemanticMap::DrawLanes(const common::PointENU& center_point,
                         GetTransPoint(segment.line_segment().point(i + 1).x(),
                                       segment.line_segment().point(i + 1).y(),
                                       base_x, base_y);
-                cv::line(base_img_, p0, p1, color, 2);
+                cv::line(*img, p0, p1, color, 2);
             }
         }
     }
@@ -437,13 +537,17 @@ cv::Mat SemanticMap::CropArea(const cv::Mat& input_img,
                               const cv::Point2i& center_point,
                               const double heading)
 {
-    cv::Mat rotation_mat = cv::getRotationMatrix2D(
+    // Rotation, crop and resize are folded into one affine transform, so
+    // only the pixels of the output image are sampled instead of rotating
+    // the whole input image.
+    cv::Mat transform = cv::getRotationMatrix2D(
             center_point, 90.0 - heading * 180.0 / M_PI, 1.0);
-    cv::Mat rotated_mat;
-    cv::warpAffine(input_img, rotated_mat, rotation_mat, input_img.size());
-    cv::Rect rect(center_point.x - 200, center_point.y - 300, 400, 400);
+    transform.at<double>(0, 2) -= center_point.x - kCropCenterCol;
+    transform.at<double>(1, 2) -= center_point.y - kCropCenterRow;
+    transform *= static_cast<double>(kFeatureMapSize) / kCropSize;
     cv::Mat output_img;
-    cv::resize(rotated_mat(rect), output_img, cv::Size(224, 224));
+    cv::warpAffine(input_img, output_img, transform,
+                   cv::Size(kFeatureMapSize, kFeatureMapSize));
     return output_img;
 }
 
@@ -451,13 +555,27 @@ cv::Mat SemanticMap::CropByHistory(const ObstacleHistory& history,
                                    const cv::Scalar& color, const double base_x,
                                    const double base_y)
 {
-    cv::Mat feature_map = curr_img_.clone();
-    DrawHistory(history, color, base_x, base_y, &feature_map);
     const Feature& curr_feature = history.feature(0);
     const cv::Point2i& center_point =
             GetTransPoint(curr_feature.position().x(),
                           curr_feature.position().y(), base_x, base_y);
-    return CropArea(feature_map, center_point, curr_feature.theta());
+    // Only copy the part of the shared frame image the rotated window can
+    // cover, and draw the history of this obstacle on top of it. Pixels
+    // outside of the frame image stay black.
+    const cv::Rect window(center_point.x - kCropRadius,
+                          center_point.y - kCropRadius, 2 * kCropRadius,
+                          2 * kCropRadius);
+    const cv::Rect area =
+            window & cv::Rect(0, 0, curr_img_.cols, curr_img_.rows);
+    cv::Mat feature_map(window.size(), CV_8UC3, cv::Scalar(0, 0, 0));
+    if (area.area() > 0)
+    {
+        curr_img_(area).copyTo(feature_map(area - window.tl()));
+    }
+    DrawHistory(history, color, base_x + window.x * kPixelSize,
+                base_y - window.y * kPixelSize, &feature_map);
+    return CropArea(feature_map, center_point - window.tl(),
+                    curr_feature.theta());
 }
 
 bool SemanticMap::GetMapById(const int obstacle_id, cv::Mat* feature_map)
@@ -50,25 +50,35 @@ private:
                            static_cast<int>(2000 - (y - base_y) / 0.1));
     }
 
-    void DrawBaseMap(const double x, const double y, const double base_x,
-                     const double base_y);
+    /**
+     * @brief Move base_img_ to the new origin. The part still covered by the
+     *        old image is scrolled, only the newly exposed area is drawn.
+     * @param New origin, on the pixel grid
+     */
+    void UpdateBaseMap(const double base_x, const double base_y);
 
-    void DrawBaseMapThread();
+    void DrawBaseMapThread(const double base_x, const double base_y);
 
-    void DrawRoads(const common::PointENU& center_point, const double base_x,
-                   const double base_y,
+    // Draw the static map elements of one area of base_img_
+    void DrawBaseMapArea(const cv::Rect& area, const double base_x,
+                         const double base_y);
+
+    void DrawRoads(const common::PointENU& center_point, const double radius,
+                   const double base_x, const double base_y, cv::Mat* img,
                    const cv::Scalar& color = cv::Scalar(64, 64, 64));
 
     void DrawJunctions(const common::PointENU& center_point,
-                       const double base_x, const double base_y,
+                       const double radius, const double base_x,
+                       const double base_y, cv::Mat* img,
                        const cv::Scalar& color = cv::Scalar(128, 128, 128));
 
     void DrawCrosswalks(const common::PointENU& center_point,
-                        const double base_x, const double base_y,
+                        const double radius, const double base_x,
+                        const double base_y, cv::Mat* img,
                         const cv::Scalar& color = cv::Scalar(192, 192, 192));
 
-    void DrawLanes(const common::PointENU& center_point, const double base_x,
-                   const double base_y,
+    void DrawLanes(const common::PointENU& center_point, const double radius,
+                   const double base_x, const double base_y, cv::Mat* img,
                    const cv::Scalar& color = cv::Scalar(255, 255, 255));
 
     cv::Scalar HSVtoRGB(double H = 1.0, double S = 1.0, double V = 1.0);
@@ -98,6 +108,9 @@ private:
     cv::Mat base_img_;
     double base_x_ = 0.0;
     double base_y_ = 0.0;
+    bool has_base_img_ = false;
+    // the previous base image, reused as buffer when scrolling
+    cv::Mat scrolled_img_;
 
     std::mutex draw_base_map_thread_mutex_;
 
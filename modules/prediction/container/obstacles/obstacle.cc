@@ -103,6 +103,11 @@ Feature* Obstacle::mutable_latest_feature()
 
 size_t Obstacle::history_size() const { return feature_history_.size(); }
 
+const ObstacleStateHistory& Obstacle::state_history() const
+{
+    return state_history_;
+}
+
 bool Obstacle::IsStill()
 {
     if (feature_history_.size() > 0)
@@ -240,12 +245,7 @@ void Obstacle::ClearOldInformation()
     {
         return;
     }
-    feature_history_[1].clear_predicted_trajectory();
-    Lane* lane = feature_history_[1].mutable_lane();
-    lane->clear_current_lane_feature();
-    lane->clear_nearby_lane_feature();
-    lane->clear_lane_graph();
-    lane->clear_lane_graph_ordered();
+    ClearHistoricalFeature(&feature_history_[1]);
 }
 
 void Obstacle::TrimHistory(const size_t remain_size)
@@ -253,6 +253,7 @@ void Obstacle::TrimHistory(const size_t remain_size)
     if (feature_history_.size() > remain_size)
     {
         feature_history_.resize(remain_size);
+        state_history_.Trim(remain_size);
     }
 }
 
@@ -1657,10 +1658,38 @@ void Obstacle::SetMotionStatusBySpeed()
 
 void Obstacle::InsertFeatureToHistory(const Feature& feature)
 {
+    evaluation_path_ = EvaluationPath::CONFIGURED;
     feature_history_.emplace_front(feature);
+    state_history_.Push(feature);
+    // the state history drops its earliest frame when full, keep both in sync
+    if (feature_history_.size() > state_history_.size())
+    {
+        feature_history_.pop_back();
+    }
+    // only the latest frame needs lane graphs and trajectories, the history
+    // is read through the numeric fields
+    if (FLAGS_enable_compact_obstacle_history && feature_history_.size() > 1)
+    {
+        ClearHistoricalFeature(&feature_history_[1]);
+    }
     ADEBUG << "Obstacle [" << id_ << "] inserted a frame into the history.";
 }
 
+void Obstacle::ClearHistoricalFeature(Feature* const feature)
+{
+    feature->clear_predicted_trajectory();
+    feature->clear_short_term_predicted_trajectory_points();
+    feature->clear_adc_trajectory_point();
+    feature->clear_adc_localization();
+    feature->clear_surrounding_lane_id();
+    feature->clear_within_lane_id();
+    Lane* lane = feature->mutable_lane();
+    lane->clear_current_lane_feature();
+    lane->clear_nearby_lane_feature();
+    lane->clear_lane_graph();
+    lane->clear_lane_graph_ordered();
+}
+
 std::unique_ptr<Obstacle> Obstacle::Create(
         const PerceptionObstacle& perception_obstacle, const double timestamp,
         const int prediction_id, ObstacleClusters* clusters_ptr)
@@ -1701,6 +1730,7 @@ void Obstacle::DiscardOutdatedHistory()
            FLAGS_max_history_time)
     {
         feature_history_.pop_back();
+        state_history_.PopBack();
     }
     auto num_of_discarded_frames = num_of_frames - feature_history_.size();
     if (num_of_discarded_frames > 0)
@@ -1766,6 +1796,11 @@ void Obstacle::SetPredictorType(
     obstacle_conf_.set_predictor_type(predictor_type);
 }
 
+void Obstacle::SetEvaluationPath(const EvaluationPath evaluation_path)
+{
+    evaluation_path_ = evaluation_path;
+}
+
 PredictionObstacle Obstacle::GeneratePredictionObstacle()
 {
     PredictionObstacle prediction_obstacle;
@@ -34,6 +34,7 @@
 #include "modules/prediction/common/junction_analyzer.h"
 #include "modules/prediction/common/prediction_gflags.h"
 #include "modules/prediction/container/obstacles/obstacle_clusters.h"
+#include "modules/prediction/container/obstacles/obstacle_state_history.h"
 #include "modules/prediction/proto/feature.pb.h"
 #include "modules/prediction/proto/prediction_conf.pb.h"
 #include "modules/prediction/proto/prediction_obstacle.pb.h"
@@ -53,6 +54,18 @@ namespace prediction
 class Obstacle
 {
 public:
+    /**
+     * @brief How the obstacle was evaluated in the current frame. The
+     *        configured evaluator is replaced by a cheaper one or skipped if
+     *        it does not fit into the remaining evaluation budget.
+     */
+    enum class EvaluationPath
+    {
+        CONFIGURED = 0,
+        CHEAP_EVALUATOR = 1,
+        PREDICTOR_ONLY = 2,
+    };
+
     /**
      * @brief Constructor
      */
@@ -159,6 +172,13 @@ public:
      */
     size_t history_size() const;
 
+    /**
+     * @brief Get the numeric fields of the historical features, it has the
+     *        same size and order as the feature history.
+     * @return The numeric state history.
+     */
+    const ObstacleStateHistory& state_history() const;
+
     /**
      * @brief Check if the obstacle is still.
      * @return If the obstacle is still.
@@ -248,6 +268,10 @@ public:
 
     const ObstacleConf& obstacle_conf() { return obstacle_conf_; }
 
+    void SetEvaluationPath(const EvaluationPath evaluation_path);
+
+    EvaluationPath evaluation_path() const { return evaluation_path_; }
+
     PredictionObstacle GeneratePredictionObstacle();
 
 private:
@@ -320,6 +344,8 @@ private:
 
     void InsertFeatureToHistory(const Feature& feature);
 
+    static void ClearHistoricalFeature(Feature* const feature);
+
     void SetJunctionFeatureWithEnterLane(const std::string& enter_lane_id,
                                          Feature* const feature_ptr);
 
@@ -347,10 +373,14 @@ private:
 
     std::deque<Feature> feature_history_;
 
+    ObstacleStateHistory state_history_{FLAGS_max_num_obstacle_history_frames};
+
     std::vector<std::shared_ptr<const hdmap::LaneInfo>> current_lanes_;
 
     ObstacleConf obstacle_conf_;
 
+    EvaluationPath evaluation_path_ = EvaluationPath::CONFIGURED;
+
     ObstacleClusters* clusters_ptr_ = nullptr;
     JunctionAnalyzer* junction_analyzer_ = nullptr;
 };
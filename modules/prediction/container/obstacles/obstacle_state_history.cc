@@ -0,0 +1,119 @@
+/******************************************************************************
+ * Copyright 2023 The Apollo Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *****************************************************************************/
+
+#include "modules/prediction/container/obstacles/obstacle_state_history.h"
+
+#include <algorithm>
+
+#include "cyber/common/log.h"
+
+namespace apollo
+{
+namespace prediction
+{
+ObstacleStateHistory::ObstacleStateHistory(const int capacity)
+{
+    const size_t num_slots = static_cast<size_t>(std::max(capacity, 1));
+    timestamp_.resize(num_slots, 0.0);
+    has_position_.resize(num_slots, 0);
+    x_.resize(num_slots, 0.0);
+    y_.resize(num_slots, 0.0);
+    has_velocity_.resize(num_slots, 0);
+    velocity_x_.resize(num_slots, 0.0);
+    velocity_y_.resize(num_slots, 0.0);
+    speed_.resize(num_slots, 0.0);
+    has_velocity_heading_.resize(num_slots, 0);
+    velocity_heading_.resize(num_slots, 0.0);
+    theta_.resize(num_slots, 0.0);
+    acc_.resize(num_slots, 0.0);
+    has_acceleration_.resize(num_slots, 0);
+    acceleration_x_.resize(num_slots, 0.0);
+    acceleration_y_.resize(num_slots, 0.0);
+    has_lane_feature_.resize(num_slots, 0);
+    lane_s_.resize(num_slots, 0.0);
+    lane_l_.resize(num_slots, 0.0);
+    angle_diff_.resize(num_slots, 0.0);
+    dist_to_left_boundary_.resize(num_slots, 0.0);
+    dist_to_right_boundary_.resize(num_slots, 0.0);
+    lane_turn_type_.resize(num_slots, 0);
+}
+
+void ObstacleStateHistory::Push(const Feature& feature)
+{
+    const size_t num_slots = capacity();
+    head_ = (head_ + num_slots - 1) % num_slots;
+    size_ = std::min(size_ + 1, num_slots);
+
+    timestamp_[head_] = feature.timestamp();
+    has_position_[head_] = feature.has_position();
+    x_[head_] = feature.position().x();
+    y_[head_] = feature.position().y();
+    has_velocity_[head_] = feature.has_velocity();
+    velocity_x_[head_] = feature.velocity().x();
+    velocity_y_[head_] = feature.velocity().y();
+    speed_[head_] = feature.speed();
+    has_velocity_heading_[head_] = feature.has_velocity_heading();
+    velocity_heading_[head_] = feature.velocity_heading();
+    theta_[head_] = feature.theta();
+    acc_[head_] = feature.acc();
+    has_acceleration_[head_] = feature.has_acceleration();
+    acceleration_x_[head_] = feature.acceleration().x();
+    acceleration_y_[head_] = feature.acceleration().y();
+
+    const bool has_lane_feature =
+            feature.has_lane() && feature.lane().has_lane_feature();
+    const LaneFeature& lane_feature = feature.lane().lane_feature();
+    has_lane_feature_[head_] = has_lane_feature;
+    lane_s_[head_] = has_lane_feature ? lane_feature.lane_s() : 0.0;
+    lane_l_[head_] = has_lane_feature ? lane_feature.lane_l() : 0.0;
+    angle_diff_[head_] = has_lane_feature ? lane_feature.angle_diff() : 0.0;
+    dist_to_left_boundary_[head_] =
+            has_lane_feature ? lane_feature.dist_to_left_boundary() : 0.0;
+    dist_to_right_boundary_[head_] =
+            has_lane_feature ? lane_feature.dist_to_right_boundary() : 0.0;
+    lane_turn_type_[head_] =
+            has_lane_feature ? lane_feature.lane_turn_type() : 0;
+}
+
+void ObstacleStateHistory::PopBack()
+{
+    if (size_ > 0)
+    {
+        --size_;
+    }
+}
+
+void ObstacleStateHistory::Trim(const size_t remain_size)
+{
+    size_ = std::min(size_, remain_size);
+}
+
+void ObstacleStateHistory::Clear()
+{
+    head_ = 0;
+    size_ = 0;
+}
+
+size_t ObstacleStateHistory::Index(const size_t i) const
+{
+    DCHECK_LT(i, size_);
+    const size_t index = head_ + i;
+    const size_t num_slots = capacity();
+    return index < num_slots ? index : index - num_slots;
+}
+
+}  // namespace prediction
+}  // namespace apollo
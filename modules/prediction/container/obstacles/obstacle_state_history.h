@@ -0,0 +1,171 @@
+/******************************************************************************
+ * Copyright 2023 The Apollo Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *****************************************************************************/
+
+/**
+ * @file
+ * @brief Numeric state history of an obstacle
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include "modules/prediction/proto/feature.pb.h"
+
+namespace apollo
+{
+namespace prediction
+{
+/**
+ * @class ObstacleStateHistory
+ * @brief Fixed capacity ring buffer of the numeric fields of the historical
+ *        features of one obstacle, stored as one array per field. Index 0 is
+ *        the latest frame, same as Obstacle::feature(i).
+ */
+class ObstacleStateHistory
+{
+public:
+    /**
+     * @brief Constructor
+     * @param Maximal number of frames, the earliest frame is dropped when a
+     *        frame is pushed into a full history
+     */
+    explicit ObstacleStateHistory(const int capacity);
+
+    /**
+     * @brief Insert the numeric fields of a feature as the latest frame
+     * @param Feature
+     */
+    void Push(const Feature& feature);
+
+    /**
+     * @brief Remove the earliest frame
+     */
+    void PopBack();
+
+    /**
+     * @brief Keep the latest frames only
+     * @param Number of frames to keep
+     */
+    void Trim(const size_t remain_size);
+
+    void Clear();
+
+    size_t size() const { return size_; }
+
+    bool empty() const { return size_ == 0; }
+
+    size_t capacity() const { return timestamp_.size(); }
+
+    double timestamp(const size_t i) const { return timestamp_[Index(i)]; }
+
+    bool has_position(const size_t i) const
+    {
+        return has_position_[Index(i)] != 0;
+    }
+    double x(const size_t i) const { return x_[Index(i)]; }
+    double y(const size_t i) const { return y_[Index(i)]; }
+
+    bool has_velocity(const size_t i) const
+    {
+        return has_velocity_[Index(i)] != 0;
+    }
+    double velocity_x(const size_t i) const { return velocity_x_[Index(i)]; }
+    double velocity_y(const size_t i) const { return velocity_y_[Index(i)]; }
+    double speed(const size_t i) const { return speed_[Index(i)]; }
+    bool has_velocity_heading(const size_t i) const
+    {
+        return has_velocity_heading_[Index(i)] != 0;
+    }
+    double velocity_heading(const size_t i) const
+    {
+        return velocity_heading_[Index(i)];
+    }
+    double theta(const size_t i) const { return theta_[Index(i)]; }
+    double acc(const size_t i) const { return acc_[Index(i)]; }
+
+    bool has_acceleration(const size_t i) const
+    {
+        return has_acceleration_[Index(i)] != 0;
+    }
+    double acceleration_x(const size_t i) const
+    {
+        return acceleration_x_[Index(i)];
+    }
+    double acceleration_y(const size_t i) const
+    {
+        return acceleration_y_[Index(i)];
+    }
+
+    /**
+     * @brief If the frame has a lane feature, the lane fields below are zero
+     *        otherwise.
+     */
+    bool has_lane_feature(const size_t i) const
+    {
+        return has_lane_feature_[Index(i)] != 0;
+    }
+    double lane_s(const size_t i) const { return lane_s_[Index(i)]; }
+    double lane_l(const size_t i) const { return lane_l_[Index(i)]; }
+    double angle_diff(const size_t i) const { return angle_diff_[Index(i)]; }
+    double dist_to_left_boundary(const size_t i) const
+    {
+        return dist_to_left_boundary_[Index(i)];
+    }
+    double dist_to_right_boundary(const size_t i) const
+    {
+        return dist_to_right_boundary_[Index(i)];
+    }
+    uint32_t lane_turn_type(const size_t i) const
+    {
+        return lane_turn_type_[Index(i)];
+    }
+
+private:
+    size_t Index(const size_t i) const;
+
+private:
+    // slot of the latest frame, frame i is stored at (head_ + i) % capacity
+    size_t head_ = 0;
+    size_t size_ = 0;
+
+    std::vector<double> timestamp_;
+    std::vector<uint8_t> has_position_;
+    std::vector<double> x_;
+    std::vector<double> y_;
+    std::vector<uint8_t> has_velocity_;
+    std::vector<double> velocity_x_;
+    std::vector<double> velocity_y_;
+    std::vector<double> speed_;
+    std::vector<uint8_t> has_velocity_heading_;
+    std::vector<double> velocity_heading_;
+    std::vector<double> theta_;
+    std::vector<double> acc_;
+    std::vector<uint8_t> has_acceleration_;
+    std::vector<double> acceleration_x_;
+    std::vector<double> acceleration_y_;
+    std::vector<uint8_t> has_lane_feature_;
+    std::vector<double> lane_s_;
+    std::vector<double> lane_l_;
+    std::vector<double> angle_diff_;
+    std::vector<double> dist_to_left_boundary_;
+    std::vector<double> dist_to_right_boundary_;
+    std::vector<uint32_t> lane_turn_type_;
+};
+
+}  // namespace prediction
+}  // namespace apollo
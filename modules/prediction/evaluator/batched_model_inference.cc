@@ -0,0 +1,201 @@
+/******************************************************************************
+ * Copyright 2023 The Apollo Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *****************************************************************************/
+
+#include "modules/prediction/evaluator/batched_model_inference.h"
+
+#include <utility>
+
+#include "cyber/common/log.h"
+#include "modules/prediction/common/prediction_system_gflags.h"
+
+namespace apollo
+{
+namespace prediction
+{
+namespace
+{
+bool HasSameShape(const std::vector<torch::Tensor>& lhs,
+                  const std::vector<torch::Tensor>& rhs)
+{
+    if (lhs.size() != rhs.size())
+    {
+        return false;
+    }
+    for (size_t i = 0; i < lhs.size(); ++i)
+    {
+        if (lhs[i].sizes() != rhs[i].sizes())
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+}  // namespace
+
+BatchedModelInference::BatchedModelInference(
+        torch::jit::script::Module* model, bool tuple_input) :
+    model_(model),
+    tuple_input_(tuple_input)
+{
+    CHECK_NOTNULL(model_);
+}
+
+void BatchedModelInference::Push(Obstacle* obstacle,
+                                 std::vector<torch::Tensor> inputs,
+                                 OutputCallback callback)
+{
+    CHECK_NOTNULL(obstacle);
+    std::vector<Sample> ready_samples;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        const auto now = std::chrono::steady_clock::now();
+        if (pending_samples_.empty())
+        {
+            oldest_pending_time_ = now;
+        }
+        pending_samples_.push_back(
+                {obstacle, std::move(inputs), std::move(callback)});
+
+        const double waited_ms = std::chrono::duration<double, std::milli>(
+                                         now - oldest_pending_time_)
+                                         .count();
+        if (static_cast<int>(pending_samples_.size()) >=
+                    FLAGS_max_model_inference_batch_size ||
+            waited_ms >= FLAGS_model_inference_batch_deadline_ms)
+        {
+            ready_samples.swap(pending_samples_);
+        }
+    }
+    // run outside of the lock so that other threads keep queueing
+    if (!ready_samples.empty())
+    {
+        Run(&ready_samples);
+    }
+}
+
+void BatchedModelInference::Flush()
+{
+    std::vector<Sample> ready_samples;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        ready_samples.swap(pending_samples_);
+    }
+    if (!ready_samples.empty())
+    {
+        Run(&ready_samples);
+    }
+}
+
+void BatchedModelInference::Run(std::vector<Sample>* samples)
+{
+    // Samples can only be stacked if all their inputs have the same shape,
+    // e.g. lane features padded to different lengths go to separate batches.
+    std::vector<std::vector<Sample*>> groups;
+    for (auto& sample : *samples)
+    {
+        bool grouped = false;
+        for (auto& group : groups)
+        {
+            if (HasSameShape(group.front()->inputs, sample.inputs))
+            {
+                group.push_back(&sample);
+                grouped = true;
+                break;
+            }
+        }
+        if (!grouped)
+        {
+            groups.push_back({&sample});
+        }
+    }
+    for (auto& group : groups)
+    {
+        RunSameShape(&group);
+    }
+}
+
+void BatchedModelInference::RunSameShape(std::vector<Sample*>* samples)
+{
+    const size_t num_inputs = samples->front()->inputs.size();
+    std::vector<torch::jit::IValue> batched_inputs;
+    batched_inputs.reserve(num_inputs);
+    for (size_t i = 0; i < num_inputs; ++i)
+    {
+        std::vector<torch::Tensor> tensors;
+        tensors.reserve(samples->size());
+        for (const Sample* sample : *samples)
+        {
+            tensors.push_back(sample->inputs[i]);
+        }
+        batched_inputs.emplace_back(torch::cat(tensors, 0));
+    }
+
+    std::vector<torch::jit::IValue> torch_inputs;
+    if (tuple_input_)
+    {
+        torch_inputs.push_back(
+                c10::ivalue::Tuple::create(std::move(batched_inputs)));
+    }
+    else
+    {
+        torch_inputs = std::move(batched_inputs);
+    }
+
+    torch::jit::IValue output;
+    try
+    {
+        output = model_->forward(torch_inputs);
+    }
+    catch (const c10::Error& e)
+    {
+        AERROR << "Batched model inference of " << samples->size()
+               << " samples failed: " << e.what();
+        // the predictors must not rely on the missing evaluator output
+        for (Sample* sample : *samples)
+        {
+            sample->obstacle->SetEvaluationPath(
+                    Obstacle::EvaluationPath::PREDICTOR_ONLY);
+        }
+        return;
+    }
+
+    // copy the output back once for all samples instead of once per row
+    if (output.isTensor())
+    {
+        output = output.toTensor().to(torch::kCPU);
+    }
+    else if (output.isTuple())
+    {
+        std::vector<torch::jit::IValue> elements;
+        for (const auto& element : output.toTuple()->elements())
+        {
+            elements.emplace_back(element.isTensor()
+                                          ? element.toTensor().to(torch::kCPU)
+                                          : element);
+        }
+        output = c10::ivalue::Tuple::create(std::move(elements));
+    }
+
+    ADEBUG << "Batched model inference of " << samples->size() << " samples.";
+    for (size_t row = 0; row < samples->size(); ++row)
+    {
+        (*samples)[row]->callback(output, static_cast<int64_t>(row));
+    }
+}
+
+}  // namespace prediction
+}  // namespace apollo
@@ -0,0 +1,99 @@
+/******************************************************************************
+ * Copyright 2023 The Apollo Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *****************************************************************************/
+
+/**
+ * @file
+ * @brief Collect torch model inputs of many obstacles and run them batched
+ */
+
+#pragma once
+
+#include <chrono>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "torch/script.h"
+#include "torch/torch.h"
+
+#include "modules/prediction/container/obstacles/obstacle.h"
+
+namespace apollo
+{
+namespace prediction
+{
+class BatchedModelInference
+{
+public:
+    /**
+     * @brief Called with the output of the batched forward pass and the row
+     * of the sample that was pushed together with it.
+     */
+    using OutputCallback =
+            std::function<void(const torch::jit::IValue& output, int64_t row)>;
+
+    /**
+     * @brief Constructor
+     * @param The model, must outlive this object
+     * @param If the inputs are passed to forward() as one tuple instead of
+     *        positional arguments
+     */
+    BatchedModelInference(torch::jit::script::Module* model, bool tuple_input);
+
+    /**
+     * @brief Queue one sample. Every input tensor has a leading batch dimension
+     *        of 1. Queued samples are run right away once there are
+     *        FLAGS_max_model_inference_batch_size of them or the oldest one
+     *        waited longer than FLAGS_model_inference_batch_deadline_ms.
+     *        If the forward pass fails, the callback is not called and the
+     *        obstacle is left to the predictor like an obstacle whose
+     *        evaluation was skipped.
+     * @param Obstacle the sample belongs to
+     * @param Input tensors
+     * @param Callback to scatter the output back to the obstacle
+     */
+    void Push(Obstacle* obstacle, std::vector<torch::Tensor> inputs,
+              OutputCallback callback);
+
+    /**
+     * @brief Run all queued samples
+     */
+    void Flush();
+
+private:
+    struct Sample
+    {
+        Obstacle* obstacle = nullptr;
+        std::vector<torch::Tensor> inputs;
+        OutputCallback callback;
+    };
+
+    void Run(std::vector<Sample>* samples);
+
+    void RunSameShape(std::vector<Sample*>* samples);
+
+private:
+    torch::jit::script::Module* model_ = nullptr;
+    bool tuple_input_ = false;
+
+    std::mutex mutex_;
+    std::vector<Sample> pending_samples_;
+    std::chrono::steady_clock::time_point oldest_pending_time_;
+};
+
+}  // namespace prediction
+}  // namespace apollo
@@ -87,6 +87,20 @@ public:
     {
         return Evaluate(obstacle, obstacles_container);
     }
+
+    /**
+     * @brief Defer model inference of the following Evaluate() calls, so that
+     *        the obstacles of a frame sharing a model run in batches.
+     *        Evaluators without batch support ignore it.
+     */
+    virtual void BeginBatch() {}
+
+    /**
+     * @brief Run all deferred model inference and write the results back to
+     *        the obstacles, then stop deferring.
+     */
+    virtual void FlushBatch() {}
+
     /**
      * @brief Get the name of evaluator
      */
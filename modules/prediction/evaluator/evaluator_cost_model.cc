@@ -0,0 +1,70 @@
+/******************************************************************************
+ * Copyright 2023 The Apollo Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *****************************************************************************/
+
+#include "modules/prediction/evaluator/evaluator_cost_model.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace apollo
+{
+namespace prediction
+{
+namespace
+{
+// weight of the latest sample, reaches the steady state in a few dozen calls
+constexpr double kSmoothingFactor = 0.05;
+// for a roughly normal cost, mean + 3 * mean absolute deviation is above
+// the 99th percentile
+constexpr double kDeviationFactor = 3.0;
+// use the plain average until there are enough samples for the filter
+constexpr int kMinNumSamples = 20;
+
+}  // namespace
+
+void EvaluatorCostModel::Update(const std::string& evaluator_name,
+                                const double cost_ms)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    Cost& cost = costs_[evaluator_name];
+    ++cost.num_samples;
+    if (cost.num_samples == 1)
+    {
+        cost.mean_ms = cost_ms;
+        cost.deviation_ms = 0.0;
+        return;
+    }
+    const double alpha = std::max(kSmoothingFactor,
+                                  1.0 / std::min(cost.num_samples,
+                                                 kMinNumSamples));
+    const double error = cost_ms - cost.mean_ms;
+    cost.mean_ms += alpha * error;
+    cost.deviation_ms += alpha * (std::fabs(error) - cost.deviation_ms);
+}
+
+double EvaluatorCostModel::Estimate(const std::string& evaluator_name) const
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = costs_.find(evaluator_name);
+    if (it == costs_.end())
+    {
+        return 0.0;
+    }
+    return it->second.mean_ms + kDeviationFactor * it->second.deviation_ms;
+}
+
+}  // namespace prediction
+}  // namespace apollo
@@ -0,0 +1,68 @@
+/******************************************************************************
+ * Copyright 2023 The Apollo Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *****************************************************************************/
+
+/**
+ * @file
+ * @brief Running estimate of the cost of one evaluator call
+ */
+
+#pragma once
+
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+namespace apollo
+{
+namespace prediction
+{
+/**
+ * @class EvaluatorCostModel
+ * @brief Exponential moving average of the mean and the mean absolute
+ *        deviation of the wall time of one evaluator call, per evaluator.
+ *        Thread safe.
+ */
+class EvaluatorCostModel
+{
+public:
+    /**
+     * @brief Add a measured cost
+     * @param Evaluator name
+     * @param Wall time of the call in ms
+     */
+    void Update(const std::string& evaluator_name, const double cost_ms);
+
+    /**
+     * @brief Get a pessimistic cost, mean plus a multiple of the deviation
+     * @param Evaluator name
+     * @return Cost in ms, 0 if the evaluator was never measured
+     */
+    double Estimate(const std::string& evaluator_name) const;
+
+private:
+    struct Cost
+    {
+        double mean_ms = 0.0;
+        double deviation_ms = 0.0;
+        int num_samples = 0;
+    };
+
+    mutable std::mutex mutex_;
+    std::unordered_map<std::string, Cost> costs_;
+};
+
+}  // namespace prediction
+}  // namespace apollo
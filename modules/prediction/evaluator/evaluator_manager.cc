@@ -43,7 +43,6 @@ namespace apollo
 namespace prediction
 {
 using apollo::perception::PerceptionObstacle;
-using IdObstacleListMap = std::unordered_map<int, std::list<Obstacle*>>;
 
 namespace
 {
@@ -61,10 +60,11 @@ bool IsTrainable(const Feature& feature)
     return true;
 }
 
-void GroupObstaclesByObstacleIds(ObstaclesContainer* const obstacles_container,
-                                 IdObstacleListMap* const id_obstacle_map)
+void CollectObstaclesToEvaluate(ObstaclesContainer* const obstacles_container,
+                                const bool enable_deadline,
+                                std::vector<Obstacle*>* const obstacles)
 {
-    int caution_thread_idx = 0;
+    std::vector<Obstacle*> normal_obstacles;
     for (int obstacle_id :
          obstacles_container->curr_frame_considered_obstacle_ids())
     {
@@ -87,24 +87,40 @@ void GroupObstaclesByObstacleIds(ObstaclesContainer* const obstacles_container,
         }
         else if (feature.priority().priority() == ObstaclePriority::CAUTION)
         {
-            caution_thread_idx =
-                    caution_thread_idx % FLAGS_max_caution_thread_num;
-            (*id_obstacle_map)[caution_thread_idx].push_back(obstacle_ptr);
-            ADEBUG << "Cautioned obstacle [" << obstacle_id << "] for thread"
-                   << caution_thread_idx;
-            ++caution_thread_idx;
+            // caution obstacles run the expensive evaluators, start them
+            // first so that they do not end up in the tail of the loop
+            obstacles->push_back(obstacle_ptr);
         }
         else
         {
-            int normal_thread_num =
-                    FLAGS_max_thread_num - FLAGS_max_caution_thread_num;
-            int id_mod = obstacle_id % normal_thread_num +
-                         FLAGS_max_caution_thread_num;
-            (*id_obstacle_map)[id_mod].push_back(obstacle_ptr);
-            ADEBUG << "Normal obstacle [" << obstacle_id << "] for thread"
-                   << id_mod;
+            normal_obstacles.push_back(obstacle_ptr);
         }
     }
+    if (enable_deadline)
+    {
+        // normal obstacles close to the ego vehicle matter more, evaluate
+        // them before the budget runs low
+        const Obstacle* ego_vehicle =
+                obstacles_container->GetObstacle(FLAGS_ego_vehicle_id);
+        if (ego_vehicle != nullptr && ego_vehicle->history_size() > 0)
+        {
+            const auto& ego_position = ego_vehicle->latest_feature().position();
+            auto squared_distance = [&ego_position](const Obstacle* obstacle) {
+                const auto& position = obstacle->latest_feature().position();
+                const double dx = position.x() - ego_position.x();
+                const double dy = position.y() - ego_position.y();
+                return dx * dx + dy * dy;
+            };
+            std::stable_sort(normal_obstacles.begin(), normal_obstacles.end(),
+                             [&squared_distance](const Obstacle* lhs,
+                                                 const Obstacle* rhs) {
+                                 return squared_distance(lhs) <
+                                        squared_distance(rhs);
+                             });
+        }
+    }
+    obstacles->insert(obstacles->end(), normal_obstacles.begin(),
+                      normal_obstacles.end());
 }
 
 }  // namespace
@@ -138,6 +154,17 @@ void EvaluatorManager::Init(const PredictionConf& config)
 
     RegisterEvaluators();
 
+    // The batched model evaluators only queue their inputs, the inference
+    // runs after all obstacles are evaluated, so neither the cost model nor
+    // the remaining budget would see the inference time.
+    enable_deadline_ = FLAGS_enable_prediction_deadline;
+    if (enable_deadline_ && FLAGS_enable_batched_model_inference)
+    {
+        AWARN << "The prediction deadline is disabled, it does not support "
+                 "enable_batched_model_inference.";
+        enable_deadline_ = false;
+    }
+
     for (const auto& obstacle_conf : config.obstacle_conf())
     {
         if (!obstacle_conf.has_obstacle_type())
@@ -273,19 +300,42 @@ void EvaluatorManager::Run(
 
     std::vector<Obstacle*> dynamic_env;
 
-    if (FLAGS_enable_multi_thread)
+    frame_start_time_ = std::chrono::steady_clock::now();
+    num_cheap_evaluated_ = 0;
+    num_predictor_only_ = 0;
+
+    // Model evaluators only queue their inputs while batching, the outputs
+    // are written back to the obstacles by FlushBatch() below.
+    if (FLAGS_enable_batched_model_inference)
     {
-        IdObstacleListMap id_obstacle_map;
-        GroupObstaclesByObstacleIds(obstacles_container, &id_obstacle_map);
-        PredictionThreadPool::ForEach(
-                id_obstacle_map.begin(), id_obstacle_map.end(),
-                [&](IdObstacleListMap::iterator::value_type& obstacles_iter) {
-                    for (auto obstacle_ptr : obstacles_iter.second)
-                    {
-                        EvaluateObstacle(adc_trajectory_container, obstacle_ptr,
-                                         obstacles_container, dynamic_env);
-                    }
-                });
+        for (auto& evaluator : evaluators_)
+        {
+            evaluator.second->BeginBatch();
+        }
+    }
+
+    if (FLAGS_enable_multi_thread || enable_deadline_)
+    {
+        std::vector<Obstacle*> obstacles;
+        CollectObstaclesToEvaluate(obstacles_container, enable_deadline_,
+                                   &obstacles);
+        // one obstacle per task, evaluation time differs a lot between
+        // obstacles
+        auto evaluate = [&](size_t i) {
+            EvaluateObstacle(adc_trajectory_container, obstacles[i],
+                             obstacles_container, dynamic_env);
+        };
+        if (FLAGS_enable_multi_thread)
+        {
+            PredictionThreadPool::ParallelFor(obstacles.size(), evaluate, 1);
+        }
+        else
+        {
+            for (size_t i = 0; i < obstacles.size(); ++i)
+            {
+                evaluate(i);
+            }
+        }
     }
     else
     {
@@ -308,6 +358,33 @@ void EvaluatorManager::Run(
                              obstacles_container, dynamic_env);
         }
     }
+
+    if (FLAGS_enable_batched_model_inference)
+    {
+        for (auto& evaluator : evaluators_)
+        {
+            evaluator.second->FlushBatch();
+        }
+    }
+
+    if (enable_deadline_)
+    {
+        const double elapsed_ms =
+                FLAGS_prediction_evaluation_budget_ms - RemainingBudgetMs();
+        if (num_cheap_evaluated_ > 0 || num_predictor_only_ > 0)
+        {
+            AINFO << "Evaluation took " << elapsed_ms << " ms of "
+                  << FLAGS_prediction_evaluation_budget_ms << " ms budget, "
+                  << num_cheap_evaluated_ << " obstacles downgraded to the "
+                  << "cost evaluator, " << num_predictor_only_
+                  << " obstacles left to the predictor.";
+        }
+        else
+        {
+            ADEBUG << "Evaluation took " << elapsed_ms << " ms of "
+                   << FLAGS_prediction_evaluation_budget_ms << " ms budget.";
+        }
+    }
 }
 
 void EvaluatorManager::EvaluateObstacle(
@@ -347,8 +424,10 @@ void EvaluatorManager::EvaluateObstacle(
                 if (evaluator->GetName() ==
                     "JOINTLY_PREDICTION_PLANNING_EVALUATOR")
                 {
-                    if (evaluator->Evaluate(adc_trajectory_container, obstacle,
-                                            obstacles_container))
+                    if (TimedEvaluate(evaluator, [&](Evaluator* e) {
+                            return e->Evaluate(adc_trajectory_container,
+                                               obstacle, obstacles_container);
+                        }))
                     {
                         break;
                     }
@@ -361,7 +440,9 @@ void EvaluatorManager::EvaluateObstacle(
                 }
                 else
                 {
-                    if (evaluator->Evaluate(obstacle, obstacles_container))
+                    if (TimedEvaluate(evaluator, [&](Evaluator* e) {
+                            return e->Evaluate(obstacle, obstacles_container);
+                        }))
                     {
                         break;
                     }
@@ -375,6 +456,9 @@ void EvaluatorManager::EvaluateObstacle(
             }
 
             // if obstacle is not caution or caution_evaluator run failed
+            // junction predictor needs the exit probabilities of the junction
+            // evaluator, the cost evaluator cannot replace it
+            bool allow_cheap_evaluator = false;
             if (obstacle->HasJunctionFeatureWithExits() &&
                 !obstacle->IsCloseToJunctionExit())
             {
@@ -383,6 +467,7 @@ void EvaluatorManager::EvaluateObstacle(
             else if (obstacle->IsOnLane())
             {
                 evaluator = GetEvaluator(vehicle_on_lane_evaluator_);
+                allow_cheap_evaluator = true;
             }
             else
             {
@@ -392,14 +477,16 @@ void EvaluatorManager::EvaluateObstacle(
                 break;
             }
             CHECK_NOTNULL(evaluator);
-            if (evaluator->GetName() == "LANE_SCANNING_EVALUATOR")
-            {
-                evaluator->Evaluate(obstacle, obstacles_container, dynamic_env);
-            }
-            else
-            {
-                evaluator->Evaluate(obstacle, obstacles_container);
-            }
+            EvaluateWithinBudget(
+                    obstacle, evaluator, allow_cheap_evaluator,
+                    [&](Evaluator* e) {
+                        if (e->GetName() == "LANE_SCANNING_EVALUATOR")
+                        {
+                            return e->Evaluate(obstacle, obstacles_container,
+                                               dynamic_env);
+                        }
+                        return e->Evaluate(obstacle, obstacles_container);
+                    });
             break;
         }
         case PerceptionObstacle::BICYCLE:
@@ -408,7 +495,11 @@ void EvaluatorManager::EvaluateObstacle(
             {
                 evaluator = GetEvaluator(cyclist_on_lane_evaluator_);
                 CHECK_NOTNULL(evaluator);
-                evaluator->Evaluate(obstacle, obstacles_container);
+                EvaluateWithinBudget(obstacle, evaluator, true,
+                                     [&](Evaluator* e) {
+                                         return e->Evaluate(
+                                                 obstacle, obstacles_container);
+                                     });
             }
             break;
         }
@@ -421,7 +512,9 @@ void EvaluatorManager::EvaluateObstacle(
             {
                 evaluator = GetEvaluator(pedestrian_evaluator_);
                 CHECK_NOTNULL(evaluator);
-                evaluator->Evaluate(obstacle, obstacles_container);
+                TimedEvaluate(evaluator, [&](Evaluator* e) {
+                    return e->Evaluate(obstacle, obstacles_container);
+                });
                 break;
             }
         }
@@ -431,7 +524,11 @@ void EvaluatorManager::EvaluateObstacle(
             {
                 evaluator = GetEvaluator(default_on_lane_evaluator_);
                 CHECK_NOTNULL(evaluator);
-                evaluator->Evaluate(obstacle, obstacles_container);
+                EvaluateWithinBudget(obstacle, evaluator, true,
+                                     [&](Evaluator* e) {
+                                         return e->Evaluate(
+                                                 obstacle, obstacles_container);
+                                     });
             }
             break;
         }
@@ -447,6 +544,71 @@ void EvaluatorManager::EvaluateObstacle(Obstacle* obstacle,
                      dummy_dynamic_env);
 }
 
+bool EvaluatorManager::TimedEvaluate(
+        Evaluator* evaluator, const std::function<bool(Evaluator*)>& evaluate)
+{
+    if (!enable_deadline_)
+    {
+        return evaluate(evaluator);
+    }
+    const auto start_time = std::chrono::steady_clock::now();
+    const bool evaluated = evaluate(evaluator);
+    const double cost_ms = std::chrono::duration<double, std::milli>(
+                                   std::chrono::steady_clock::now() -
+                                   start_time)
+                                   .count();
+    cost_model_.Update(evaluator->GetName(), cost_ms);
+    return evaluated;
+}
+
+bool EvaluatorManager::EvaluateWithinBudget(
+        Obstacle* obstacle, Evaluator* evaluator,
+        const bool allow_cheap_evaluator,
+        const std::function<bool(Evaluator*)>& evaluate)
+{
+    if (!enable_deadline_ || obstacle->IsCaution())
+    {
+        return TimedEvaluate(evaluator, evaluate);
+    }
+    const double remaining_ms = RemainingBudgetMs();
+    const double estimated_ms = cost_model_.Estimate(evaluator->GetName());
+    if (estimated_ms <= remaining_ms)
+    {
+        return TimedEvaluate(evaluator, evaluate);
+    }
+
+    Evaluator* cheap_evaluator = GetEvaluator(ObstacleConf::COST_EVALUATOR);
+    if (allow_cheap_evaluator && cheap_evaluator != nullptr &&
+        cheap_evaluator != evaluator &&
+        cost_model_.Estimate(cheap_evaluator->GetName()) <= remaining_ms &&
+        TimedEvaluate(cheap_evaluator, evaluate))
+    {
+        obstacle->SetEvaluationPath(Obstacle::EvaluationPath::CHEAP_EVALUATOR);
+        ++num_cheap_evaluated_;
+        ADEBUG << "Obstacle [" << obstacle->id() << "] evaluated by "
+               << cheap_evaluator->GetName() << " instead of "
+               << evaluator->GetName() << ", estimated " << estimated_ms
+               << " ms, remaining " << remaining_ms << " ms.";
+        return true;
+    }
+
+    obstacle->SetEvaluationPath(Obstacle::EvaluationPath::PREDICTOR_ONLY);
+    ++num_predictor_only_;
+    ADEBUG << "Obstacle [" << obstacle->id() << "] skipped "
+           << evaluator->GetName() << ", estimated " << estimated_ms
+           << " ms, remaining " << remaining_ms << " ms.";
+    return false;
+}
+
+double EvaluatorManager::RemainingBudgetMs() const
+{
+    const double elapsed_ms = std::chrono::duration<double, std::milli>(
+                                      std::chrono::steady_clock::now() -
+                                      frame_start_time_)
+                                      .count();
+    return FLAGS_prediction_evaluation_budget_ms - elapsed_ms;
+}
+
 void EvaluatorManager::BuildObstacleIdHistoryMap(
         ObstaclesContainer* obstacles_container, size_t max_num_frame)
 {
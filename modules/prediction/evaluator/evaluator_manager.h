@@ -21,6 +21,9 @@
 
 #pragma once
 
+#include <atomic>
+#include <chrono>
+#include <functional>
 #include <list>
 #include <map>
 #include <memory>
@@ -30,6 +33,7 @@
 #include "cyber/common/macros.h"
 #include "modules/prediction/common/semantic_map.h"
 #include "modules/prediction/evaluator/evaluator.h"
+#include "modules/prediction/evaluator/evaluator_cost_model.h"
 #include "modules/prediction/pipeline/vector_net.h"
 #include "modules/prediction/proto/prediction_conf.pb.h"
 
@@ -86,6 +90,34 @@ private:
 
     void DumpCurrentFrameEnv(ObstaclesContainer* obstacles_container);
 
+    /**
+     * @brief Run one evaluator call, measure it for the cost model if the
+     *        prediction deadline is enabled
+     * @param Evaluator
+     * @param Function running the evaluator
+     * @return If the evaluation succeeded
+     */
+    bool TimedEvaluate(Evaluator* evaluator,
+                       const std::function<bool(Evaluator*)>& evaluate);
+
+    /**
+     * @brief Run the configured evaluator of an obstacle if its estimated
+     *        cost fits into the remaining budget of the frame. Otherwise run
+     *        the cost evaluator, or leave the obstacle to the predictor, and
+     *        record the path taken on the obstacle. Caution obstacles are
+     *        never downgraded.
+     * @param Obstacle
+     * @param Configured evaluator
+     * @param If the cost evaluator can replace the configured evaluator
+     * @param Function running an evaluator on the obstacle
+     * @return If the evaluation succeeded
+     */
+    bool EvaluateWithinBudget(Obstacle* obstacle, Evaluator* evaluator,
+                              const bool allow_cheap_evaluator,
+                              const std::function<bool(Evaluator*)>& evaluate);
+
+    double RemainingBudgetMs() const;
+
     /**
      * @brief Register an evaluator by type
      * @param Evaluator type
@@ -142,6 +174,18 @@ private:
     std::unordered_map<int, ObstacleHistory> obstacle_id_history_map_;
 
     std::unique_ptr<SemanticMap> semantic_map_;
+
+    // FLAGS_enable_prediction_deadline unless it is not supported by the
+    // other flags
+    bool enable_deadline_ = false;
+
+    EvaluatorCostModel cost_model_;
+
+    std::chrono::steady_clock::time_point frame_start_time_;
+
+    std::atomic<int> num_cheap_evaluated_{0};
+
+    std::atomic<int> num_predictor_only_{0};
 };
 
 }  // namespace prediction
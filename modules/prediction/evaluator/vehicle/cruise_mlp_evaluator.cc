@@ -50,10 +50,23 @@ CruiseMLPEvaluator::CruiseMLPEvaluator() : device_(torch::kCPU)
 {
     evaluator_type_ = ObstacleConf::CRUISE_MLP_EVALUATOR;
     LoadModels();
+    go_batch_inference_.reset(
+            new BatchedModelInference(&torch_go_model_, false));
+    cutin_batch_inference_.reset(
+            new BatchedModelInference(&torch_cutin_model_, false));
 }
 
 void CruiseMLPEvaluator::Clear() {}
 
+void CruiseMLPEvaluator::BeginBatch() { batching_ = true; }
+
+void CruiseMLPEvaluator::FlushBatch()
+{
+    go_batch_inference_->Flush();
+    cutin_batch_inference_->Flush();
+    batching_ = false;
+}
+
 bool CruiseMLPEvaluator::Evaluate(Obstacle* obstacle_ptr,
                                   ObstaclesContainer* obstacles_container)
 {
@@ -143,6 +156,19 @@ bool CruiseMLPEvaluator::Evaluate(Obstacle* obstacle_ptr,
         {
             torch_input[0][i] = static_cast<float>(feature_values[i]);
         }
+        if (batching_)
+        {
+            auto& batch_inference = lane_sequence_ptr->vehicle_on_lane()
+                                            ? go_batch_inference_
+                                            : cutin_batch_inference_;
+            batch_inference->Push(
+                    obstacle_ptr, {torch_input.to(device_)},
+                    [lane_sequence_ptr](const torch::jit::IValue& output,
+                                        int64_t row) {
+                        SetModelOutput(output, row, lane_sequence_ptr);
+                    });
+            continue;
+        }
         torch_inputs.push_back(std::move(torch_input.to(device_)));
         if (lane_sequence_ptr->vehicle_on_lane())
         {
@@ -235,42 +261,29 @@ void CruiseMLPEvaluator::SetObstacleFeatureValues(
     double prev_timestamp = obs_curr_feature.timestamp();
 
     // Starting from the most recent timestamp and going backward.
-    ADEBUG << "Obstacle has " << obstacle_ptr->history_size()
-           << " history timestamps.";
-    for (std::size_t i = 0; i < obstacle_ptr->history_size(); ++i)
+    const ObstacleStateHistory& history = obstacle_ptr->state_history();
+    ADEBUG << "Obstacle has " << history.size() << " history timestamps.";
+    for (std::size_t i = 0; i < history.size(); ++i)
     {
-        const Feature& feature = obstacle_ptr->feature(i);
-        if (!feature.IsInitialized())
-        {
-            continue;
-        }
-        if (feature.timestamp() < obs_feature_history_start_time)
+        if (history.timestamp(i) < obs_feature_history_start_time)
         {
             break;
         }
-        if (!feature.has_lane())
-        {
-            ADEBUG << "Feature has no lane. Quit.";
-        }
         // These are for the old 23 features.
-        if (feature.has_lane() && feature.lane().has_lane_feature())
+        if (history.has_lane_feature(i))
         {
-            thetas.push_back(feature.lane().lane_feature().angle_diff());
-            lane_ls.push_back(feature.lane().lane_feature().lane_l());
-            dist_lbs.push_back(
-                    feature.lane().lane_feature().dist_to_left_boundary());
-            dist_rbs.push_back(
-                    feature.lane().lane_feature().dist_to_right_boundary());
-            lane_types.push_back(
-                    feature.lane().lane_feature().lane_turn_type());
-            timestamps.push_back(feature.timestamp());
-            speeds.push_back(feature.speed());
+            thetas.push_back(history.angle_diff(i));
+            lane_ls.push_back(history.lane_l(i));
+            dist_lbs.push_back(history.dist_to_left_boundary(i));
+            dist_rbs.push_back(history.dist_to_right_boundary(i));
+            lane_types.push_back(history.lane_turn_type(i));
+            timestamps.push_back(history.timestamp(i));
+            speeds.push_back(history.speed(i));
             ++count;
         }
         else
         {
             ADEBUG << "Feature has no lane_feature!!!";
-            ADEBUG << feature.lane().current_lane_feature_size();
         }
 
         // These are for the new features based on the relative coord. system.
@@ -283,23 +296,22 @@ void CruiseMLPEvaluator::SetObstacleFeatureValues(
             has_history[i] = 0.0;
             continue;
         }
-        if (feature.has_position())
+        if (history.has_position(i))
         {
-            pos_history[i] =
-                    WorldCoordToObjCoord(std::make_pair(feature.position().x(),
-                                                        feature.position().y()),
-                                         obs_curr_pos, obs_curr_heading);
+            pos_history[i] = WorldCoordToObjCoord(
+                    std::make_pair(history.x(i), history.y(i)), obs_curr_pos,
+                    obs_curr_heading);
         }
         else
         {
             has_history[i] = 0.0;
         }
-        if (feature.has_velocity())
+        if (history.has_velocity(i))
         {
-            auto vel_end =
-                    WorldCoordToObjCoord(std::make_pair(feature.velocity().x(),
-                                                        feature.velocity().y()),
-                                         obs_curr_pos, obs_curr_heading);
+            auto vel_end = WorldCoordToObjCoord(
+                    std::make_pair(history.velocity_x(i),
+                                   history.velocity_y(i)),
+                    obs_curr_pos, obs_curr_heading);
             auto vel_begin = WorldCoordToObjCoord(
                     std::make_pair(0.0, 0.0), obs_curr_pos, obs_curr_heading);
             vel_history[i] = std::make_pair(vel_end.first - vel_begin.first,
@@ -309,11 +321,11 @@ void CruiseMLPEvaluator::SetObstacleFeatureValues(
         {
             has_history[i] = 0.0;
         }
-        if (feature.has_acceleration())
+        if (history.has_acceleration(i))
         {
             auto acc_end = WorldCoordToObjCoord(
-                    std::make_pair(feature.acceleration().x(),
-                                   feature.acceleration().y()),
+                    std::make_pair(history.acceleration_x(i),
+                                   history.acceleration_y(i)),
                     obs_curr_pos, obs_curr_heading);
             auto acc_begin = WorldCoordToObjCoord(
                     std::make_pair(0.0, 0.0), obs_curr_pos, obs_curr_heading);
@@ -324,17 +336,17 @@ void CruiseMLPEvaluator::SetObstacleFeatureValues(
         {
             has_history[i] = 0.0;
         }
-        if (feature.has_velocity_heading())
+        if (history.has_velocity_heading(i))
         {
             vel_heading_history[i] = WorldAngleToObjAngle(
-                    feature.velocity_heading(), obs_curr_heading);
+                    history.velocity_heading(i), obs_curr_heading);
             if (i != 0)
             {
                 vel_heading_changing_rate_history[i] =
                         (vel_heading_history[i - 1] - vel_heading_history[i]) /
-                        (FLAGS_double_precision + feature.timestamp() -
+                        (FLAGS_double_precision + history.timestamp(i) -
                          prev_timestamp);
-                prev_timestamp = feature.timestamp();
+                prev_timestamp = history.timestamp(i);
             }
         }
         else
@@ -647,16 +659,23 @@ void CruiseMLPEvaluator::ModelInference(
         torch::jit::script::Module torch_model_ptr,
         LaneSequence* lane_sequence_ptr)
 {
-    auto torch_output_tuple = torch_model_ptr.forward(torch_inputs).toTuple();
+    SetModelOutput(torch_model_ptr.forward(torch_inputs), 0, lane_sequence_ptr);
+}
+
+void CruiseMLPEvaluator::SetModelOutput(const torch::jit::IValue& torch_output,
+                                        int64_t row,
+                                        LaneSequence* lane_sequence_ptr)
+{
+    auto torch_output_tuple = torch_output.toTuple();
     auto probability_tensor =
             torch_output_tuple->elements()[0].toTensor().to(torch::kCPU);
     auto finish_time_tensor =
             torch_output_tuple->elements()[1].toTensor().to(torch::kCPU);
     lane_sequence_ptr->set_probability(
             apollo::common::math::Sigmoid(static_cast<double>(
-                    probability_tensor.accessor<float, 2>()[0][0])));
-    lane_sequence_ptr->set_time_to_lane_center(
-            static_cast<double>(finish_time_tensor.accessor<float, 2>()[0][0]));
+                    probability_tensor.accessor<float, 2>()[row][0])));
+    lane_sequence_ptr->set_time_to_lane_center(static_cast<double>(
+            finish_time_tensor.accessor<float, 2>()[row][0]));
 }
 
 }  // namespace prediction
@@ -16,12 +16,14 @@
 
 #pragma once
 
+#include <memory>
 #include <string>
 #include <vector>
 
 #include "torch/script.h"
 #include "torch/torch.h"
 
+#include "modules/prediction/evaluator/batched_model_inference.h"
 #include "modules/prediction/evaluator/evaluator.h"
 
 #include "modules/prediction/container/obstacles/obstacles_container.h"
@@ -65,6 +67,10 @@ public:
      */
     std::string GetName() override { return "CRUISE_MLP_EVALUATOR"; }
 
+    void BeginBatch() override;
+
+    void FlushBatch() override;
+
     void Clear();
 
 private:
@@ -107,6 +113,9 @@ private:
                         torch::jit::script::Module torch_model_ptr,
                         LaneSequence* lane_sequence_ptr);
 
+    static void SetModelOutput(const torch::jit::IValue& torch_output,
+                               int64_t row, LaneSequence* lane_sequence_ptr);
+
 private:
     static const size_t OBSTACLE_FEATURE_SIZE = 23 + 5 * 9;
     static const size_t INTERACTION_FEATURE_SIZE = 8;
@@ -116,6 +125,10 @@ private:
     torch::jit::script::Module torch_go_model_;
     torch::jit::script::Module torch_cutin_model_;
     torch::Device device_;
+
+    bool batching_ = false;
+    std::unique_ptr<BatchedModelInference> go_batch_inference_;
+    std::unique_ptr<BatchedModelInference> cutin_batch_inference_;
 };
 
 }  // namespace prediction
@@ -70,14 +70,14 @@ public:
 
     /**
      * @brief Process map data to vector
-     * @param FeatureVector: map feature vector
+     * @param PackedPolylines: map polylines, the map data tensors share
+     *        their buffers and must not outlive them
      * @param int: obstacle number
-     * @param PidVector: map p_id vector
      * @param Tensor: map data
      * @param Tensor: map data p_id
      */
-    bool VectornetProcessMapData(FeatureVector* map_feature,
-                                 PidVector* map_p_id, const int obs_num,
+    bool VectornetProcessMapData(const PackedPolylines& map_polylines,
+                                 const int obs_num,
                                  torch::Tensor* ptr_map_data,
                                  torch::Tensor* ptr_all_map_p_id,
                                  torch::Tensor* ptr_vector_mask);
@@ -61,10 +61,19 @@ JunctionMLPEvaluator::JunctionMLPEvaluator() : device_(torch::kCPU)
 {
     evaluator_type_ = ObstacleConf::JUNCTION_MLP_EVALUATOR;
     LoadModel();
+    batch_inference_.reset(new BatchedModelInference(&torch_model_, false));
 }
 
 void JunctionMLPEvaluator::Clear() {}
 
+void JunctionMLPEvaluator::BeginBatch() { batching_ = true; }
+
+void JunctionMLPEvaluator::FlushBatch()
+{
+    batch_inference_->Flush();
+    batching_ = false;
+}
+
 bool JunctionMLPEvaluator::Evaluate(Obstacle* obstacle_ptr,
                                     ObstaclesContainer* obstacles_container)
 {
@@ -113,10 +122,33 @@ bool JunctionMLPEvaluator::Evaluate(Obstacle* obstacle_ptr,
     {
         torch_input[0][i] = static_cast<float>(feature_values[i]);
     }
-    torch_inputs.push_back(std::move(torch_input.to(device_)));
     std::vector<double> probability;
     if (latest_feature_ptr->junction_feature().junction_exit_size() > 1)
     {
+        if (batching_)
+        {
+            batch_inference_->Push(
+                    obstacle_ptr, {torch_input.to(device_)},
+                    [this, latest_feature_ptr](const torch::jit::IValue& output,
+                                               int64_t row) {
+                        auto torch_output =
+                                output.toTensor().accessor<float, 2>();
+                        std::vector<double> probability;
+                        for (int i = 0; i < torch_output.size(1); ++i)
+                        {
+                            probability.push_back(
+                                    static_cast<double>(torch_output[row][i]));
+                        }
+                        SetJunctionProbability(probability, latest_feature_ptr);
+                    });
+            if (latest_feature_ptr->lane().lane_graph().lane_sequence().empty())
+            {
+                AERROR << "Obstacle [" << id << "] has no lane sequences.";
+                return false;
+            }
+            return true;
+        }
+        torch_inputs.push_back(std::move(torch_input.to(device_)));
         at::Tensor torch_output_tensor =
                 torch_model_.forward(torch_inputs).toTensor().to(torch::kCPU);
         auto torch_output = torch_output_tensor.accessor<float, 2>();
@@ -134,6 +166,17 @@ bool JunctionMLPEvaluator::Evaluate(Obstacle* obstacle_ptr,
                                    EGO_VEHICLE_FEATURE_SIZE + 8 * i]);
         }
     }
+    if (!SetJunctionProbability(probability, latest_feature_ptr))
+    {
+        AERROR << "Obstacle [" << id << "] has no lane sequences.";
+        return false;
+    }
+    return true;
+}
+
+bool JunctionMLPEvaluator::SetJunctionProbability(
+        const std::vector<double>& probability, Feature* latest_feature_ptr)
+{
     for (double prob : probability)
     {
         latest_feature_ptr->mutable_junction_feature()
@@ -145,7 +188,6 @@ bool JunctionMLPEvaluator::Evaluate(Obstacle* obstacle_ptr,
     CHECK_NOTNULL(lane_graph_ptr);
     if (lane_graph_ptr->lane_sequence().empty())
     {
-        AERROR << "Obstacle [" << id << "] has no lane sequences.";
         return false;
     }
 
@@ -255,19 +297,13 @@ void JunctionMLPEvaluator::SetObstacleFeatureValues(
     if (obstacle_ptr->history_size() > FLAGS_junction_historical_frame_length)
     {
         has_history = true;
+        const ObstacleStateHistory& history = obstacle_ptr->state_history();
         for (std::size_t i = 0; i < FLAGS_junction_historical_frame_length; ++i)
         {
-            const Feature& feature = obstacle_ptr->feature(i + 1);
-            if (!feature.IsInitialized())
-            {
-                has_history = false;
-                break;
-            }
-            if (feature.has_position())
+            if (history.has_position(i + 1))
             {
                 pos_history[i] = WorldCoordToObjCoord(
-                        std::make_pair(feature.position().x(),
-                                       feature.position().y()),
+                        std::make_pair(history.x(i + 1), history.y(i + 1)),
                         obs_curr_pos, obs_curr_heading);
             }
         }
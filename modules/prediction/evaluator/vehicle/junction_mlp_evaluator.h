@@ -16,6 +16,7 @@
 
 #pragma once
 
+#include <memory>
 #include <string>
 #include <vector>
 
@@ -23,6 +24,7 @@
 #include "torch/torch.h"
 
 #include "modules/prediction/container/obstacles/obstacles_container.h"
+#include "modules/prediction/evaluator/batched_model_inference.h"
 #include "modules/prediction/evaluator/evaluator.h"
 
 namespace apollo
@@ -70,7 +72,21 @@ public:
      */
     std::string GetName() override { return "JUNCTION_MLP_EVALUATOR"; }
 
+    void BeginBatch() override;
+
+    void FlushBatch() override;
+
 private:
+    /**
+     * @brief Set junction exit probabilities and assign them to the lane
+     *        sequences leading to the exits
+     * @param Probabilities of the 12 fan areas
+     * @param Latest feature of the obstacle
+     * @return False if the obstacle has no lane sequences
+     */
+    bool SetJunctionProbability(const std::vector<double>& probability,
+                                Feature* latest_feature_ptr);
+
     /**
      * @brief Set obstacle feature vector
      * @param Obstacle pointer
@@ -112,6 +128,9 @@ private:
 
     torch::jit::script::Module torch_model_;
     torch::Device device_;
+
+    bool batching_ = false;
+    std::unique_ptr<BatchedModelInference> batch_inference_;
 };
 
 }  // namespace prediction
@@ -41,6 +41,16 @@ LaneScanningEvaluator::LaneScanningEvaluator() : device_(torch::kCPU)
 {
     evaluator_type_ = ObstacleConf::LANE_SCANNING_EVALUATOR;
     LoadModel();
+    batch_inference_.reset(
+            new BatchedModelInference(&torch_lane_scanning_model_, false));
+}
+
+void LaneScanningEvaluator::BeginBatch() { batching_ = true; }
+
+void LaneScanningEvaluator::FlushBatch()
+{
+    batch_inference_->Flush();
+    batching_ = false;
 }
 
 bool LaneScanningEvaluator::Evaluate(Obstacle* obstacle_ptr,
@@ -119,6 +129,17 @@ bool LaneScanningEvaluator::Evaluate(Obstacle* obstacle_ptr,
     {
         torch_input[0][i] = static_cast<float>(feature_values[i]);
     }
+    if (batching_)
+    {
+        batch_inference_->Push(
+                obstacle_ptr, {torch_input.to(device_)},
+                [latest_feature_ptr](const torch::jit::IValue& output,
+                                     int64_t row) {
+                    SetShortTermTrajectory(output.toTensor(), row,
+                                           latest_feature_ptr);
+                });
+        return true;
+    }
     torch_inputs.push_back(std::move(torch_input));
     ModelInference(torch_inputs, torch_lane_scanning_model_,
                    latest_feature_ptr);
@@ -522,13 +543,20 @@ void LaneScanningEvaluator::ModelInference(
         torch::jit::script::Module torch_model, Feature* feature_ptr)
 {
     auto torch_output_tensor = torch_model.forward(torch_inputs).toTensor();
+    SetShortTermTrajectory(torch_output_tensor, 0, feature_ptr);
+}
+
+void LaneScanningEvaluator::SetShortTermTrajectory(
+        const at::Tensor& torch_output_tensor, int64_t row,
+        Feature* feature_ptr)
+{
     auto torch_output = torch_output_tensor.accessor<float, 3>();
     for (size_t i = 0; i < SHORT_TERM_TRAJECTORY_SIZE; ++i)
     {
         TrajectoryPoint point;
-        double dx = static_cast<double>(torch_output[0][0][i]);
+        double dx = static_cast<double>(torch_output[row][0][i]);
         double dy = static_cast<double>(
-                torch_output[0][0][i + SHORT_TERM_TRAJECTORY_SIZE]);
+                torch_output[row][0][i + SHORT_TERM_TRAJECTORY_SIZE]);
         Vec2d offset(dx, dy);
         Vec2d rotated_offset = offset.rotate(feature_ptr->velocity_heading());
         double point_x = feature_ptr->position().x() + rotated_offset.x();
@@ -16,6 +16,7 @@
 
 #pragma once
 
+#include <memory>
 #include <string>
 #include <vector>
 
@@ -23,6 +24,7 @@
 #include "torch/torch.h"
 
 #include "modules/prediction/container/obstacles/obstacles_container.h"
+#include "modules/prediction/evaluator/batched_model_inference.h"
 #include "modules/prediction/evaluator/evaluator.h"
 
 namespace apollo
@@ -79,6 +81,10 @@ public:
      */
     std::string GetName() override { return "LANE_SCANNING_EVALUATOR"; }
 
+    void BeginBatch() override;
+
+    void FlushBatch() override;
+
 private:
     /**
      * @brief Load model from file
@@ -107,6 +113,16 @@ private:
                         torch::jit::script::Module torch_model,
                         Feature* feature_ptr);
 
+    /**
+     * @brief Append the short term trajectory of one obstacle from the model
+     *        output
+     * @param Model output
+     * @param Row of the obstacle in the model output
+     * @param Latest feature of the obstacle
+     */
+    static void SetShortTermTrajectory(const at::Tensor& torch_output_tensor,
+                                       int64_t row, Feature* feature_ptr);
+
 private:
     static const size_t OBSTACLE_FEATURE_SIZE = 20 * (9 + 40);
     static const size_t INTERACTION_FEATURE_SIZE = 8;
@@ -118,6 +134,9 @@ private:
 
     torch::jit::script::Module torch_lane_scanning_model_;
     torch::Device device_;
+
+    bool batching_ = false;
+    std::unique_ptr<BatchedModelInference> batch_inference_;
 };
 
 }  // namespace prediction
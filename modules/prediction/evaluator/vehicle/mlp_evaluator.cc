@@ -207,29 +207,22 @@ void MLPEvaluator::SetObstacleFeatureValues(Obstacle* obstacle_ptr,
     double duration =
             obstacle_ptr->timestamp() - FLAGS_prediction_trajectory_time_length;
     int count = 0;
-    for (std::size_t i = 0; i < obstacle_ptr->history_size(); ++i)
+    const ObstacleStateHistory& history = obstacle_ptr->state_history();
+    for (std::size_t i = 0; i < history.size(); ++i)
     {
-        const Feature& feature = obstacle_ptr->feature(i);
-        if (!feature.IsInitialized())
-        {
-            continue;
-        }
-        if (feature.timestamp() < duration)
+        if (history.timestamp(i) < duration)
         {
             break;
         }
-        if (feature.has_lane() && feature.lane().has_lane_feature())
+        if (history.has_lane_feature(i))
         {
-            thetas.push_back(feature.lane().lane_feature().angle_diff());
-            lane_ls.push_back(feature.lane().lane_feature().lane_l());
-            dist_lbs.push_back(
-                    feature.lane().lane_feature().dist_to_left_boundary());
-            dist_rbs.push_back(
-                    feature.lane().lane_feature().dist_to_right_boundary());
-            lane_types.push_back(
-                    feature.lane().lane_feature().lane_turn_type());
-            timestamps.push_back(feature.timestamp());
-            speeds.push_back(feature.speed());
+            thetas.push_back(history.angle_diff(i));
+            lane_ls.push_back(history.lane_l(i));
+            dist_lbs.push_back(history.dist_to_left_boundary(i));
+            dist_rbs.push_back(history.dist_to_right_boundary(i));
+            lane_types.push_back(history.lane_turn_type(i));
+            timestamps.push_back(history.timestamp(i));
+            speeds.push_back(history.speed(i));
             ++count;
         }
     }
@@ -37,10 +37,23 @@ SemanticLSTMEvaluator::SemanticLSTMEvaluator(SemanticMap* semantic_map) :
 {
     evaluator_type_ = ObstacleConf::SEMANTIC_LSTM_EVALUATOR;
     LoadModel();
+    vehicle_batch_inference_.reset(
+            new BatchedModelInference(&torch_vehicle_model_, true));
+    pedestrian_batch_inference_.reset(
+            new BatchedModelInference(&torch_pedestrian_model_, true));
 }
 
 void SemanticLSTMEvaluator::Clear() {}
 
+void SemanticLSTMEvaluator::BeginBatch() { batching_ = true; }
+
+void SemanticLSTMEvaluator::FlushBatch()
+{
+    vehicle_batch_inference_->Flush();
+    pedestrian_batch_inference_->Flush();
+    batching_ = false;
+}
+
 bool SemanticLSTMEvaluator::Evaluate(Obstacle* obstacle_ptr,
                                      ObstaclesContainer* obstacles_container)
 {
@@ -105,6 +118,25 @@ bool SemanticLSTMEvaluator::Evaluate(Obstacle* obstacle_ptr,
                 pos_history[i].second - pos_history[i + 1].second;
     }
 
+    if (batching_)
+    {
+        auto& batch_inference = obstacle_ptr->IsPedestrian()
+                                        ? pedestrian_batch_inference_
+                                        : vehicle_batch_inference_;
+        // img_tensor shares its memory with img_float, copy it before the
+        // inference is deferred
+        batch_inference->Push(
+                obstacle_ptr,
+                {img_tensor.clone().to(device_), obstacle_pos.to(device_),
+                 obstacle_pos_step.to(device_)},
+                [this, latest_feature_ptr](const torch::jit::IValue& output,
+                                           int64_t row) {
+                    SetPredictedTrajectory(output.toTensor(), row,
+                                           latest_feature_ptr);
+                });
+        return true;
+    }
+
     // Build input features for torch
     std::vector<torch::jit::IValue> torch_inputs;
 
@@ -135,6 +167,14 @@ bool SemanticLSTMEvaluator::Evaluate(Obstacle* obstacle_ptr,
     std::chrono::duration<double> diff = end_time - start_time;
     ADEBUG << "Semantic_LSTM_evaluator used time: " << diff.count() * 1000
            << " ms.";
+    SetPredictedTrajectory(torch_output_tensor, 0, latest_feature_ptr);
+    return true;
+}
+
+void SemanticLSTMEvaluator::SetPredictedTrajectory(
+        const at::Tensor& torch_output_tensor, int64_t row,
+        Feature* latest_feature_ptr)
+{
     auto torch_output = torch_output_tensor.accessor<float, 3>();
 
     // Get the trajectory
@@ -155,8 +195,8 @@ bool SemanticLSTMEvaluator::Evaluate(Obstacle* obstacle_ptr,
             prev_y = last_point.y();
         }
         TrajectoryPoint* point = trajectory->add_trajectory_point();
-        double dx = static_cast<double>(torch_output[0][i][0]);
-        double dy = static_cast<double>(torch_output[0][i][1]);
+        double dx = static_cast<double>(torch_output[row][i][0]);
+        double dy = static_cast<double>(torch_output[row][i][1]);
 
         double heading = latest_feature_ptr->velocity_heading();
         Vec2d offset(dx, dy);
@@ -169,10 +209,10 @@ bool SemanticLSTMEvaluator::Evaluate(Obstacle* obstacle_ptr,
         if (torch_output_tensor.sizes()[2] == 5)
         {
             double sigma_xr =
-                    std::abs(static_cast<double>(torch_output[0][i][2]));
+                    std::abs(static_cast<double>(torch_output[row][i][2]));
             double sigma_yr =
-                    std::abs(static_cast<double>(torch_output[0][i][3]));
-            double corr_r = static_cast<double>(torch_output[0][i][4]);
+                    std::abs(static_cast<double>(torch_output[row][i][3]));
+            double corr_r = static_cast<double>(torch_output[row][i][4]);
             Eigen::Matrix2d cov_matrix_r;
             cov_matrix_r(0, 0) = sigma_xr * sigma_xr;
             cov_matrix_r(0, 1) = corr_r * sigma_xr * sigma_yr;
@@ -245,8 +285,6 @@ bool SemanticLSTMEvaluator::Evaluate(Obstacle* obstacle_ptr,
                          FLAGS_prediction_trajectory_time_resolution);
         }
     }
-
-    return true;
 }
 
 bool SemanticLSTMEvaluator::ExtractObstacleHistory(
@@ -258,16 +296,12 @@ bool SemanticLSTMEvaluator::ExtractObstacleHistory(
     double obs_curr_heading = obs_curr_feature.velocity_heading();
     std::pair<double, double> obs_curr_pos = std::make_pair(
             obs_curr_feature.position().x(), obs_curr_feature.position().y());
-    for (std::size_t i = 0; i < obstacle_ptr->history_size() && i < 20; ++i)
+    const ObstacleStateHistory& history = obstacle_ptr->state_history();
+    for (std::size_t i = 0; i < history.size() && i < 20; ++i)
     {
-        const Feature& feature = obstacle_ptr->feature(i);
-        if (!feature.IsInitialized())
-        {
-            break;
-        }
         pos_history->at(i) = WorldCoordToObjCoord(
-                std::make_pair(feature.position().x(), feature.position().y()),
-                obs_curr_pos, obs_curr_heading);
+                std::make_pair(history.x(i), history.y(i)), obs_curr_pos,
+                obs_curr_heading);
     }
     return true;
 }
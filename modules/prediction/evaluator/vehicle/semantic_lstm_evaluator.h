@@ -16,11 +16,13 @@
 
 #pragma once
 
+#include <memory>
 #include <string>
 #include <utility>
 #include <vector>
 
 #include "modules/prediction/common/semantic_map.h"
+#include "modules/prediction/evaluator/batched_model_inference.h"
 #include "modules/prediction/evaluator/evaluator.h"
 #include "torch/extension.h"
 #include "torch/script.h"
@@ -70,7 +72,21 @@ public:
      */
     std::string GetName() override { return "SEMANTIC_LSTM_EVALUATOR"; }
 
+    void BeginBatch() override;
+
+    void FlushBatch() override;
+
 private:
+    /**
+     * @brief Convert the model output of one obstacle to its predicted
+     *        trajectory
+     * @param Model output
+     * @param Row of the obstacle in the model output
+     * @param Latest feature of the obstacle
+     */
+    void SetPredictedTrajectory(const at::Tensor& torch_output_tensor,
+                                int64_t row, Feature* latest_feature_ptr);
+
     /**
      * @brief Load model file
      */
@@ -82,6 +98,10 @@ private:
     at::Tensor torch_default_output_tensor_;
     torch::Device device_;
     SemanticMap* semantic_map_;
+
+    bool batching_ = false;
+    std::unique_ptr<BatchedModelInference> vehicle_batch_inference_;
+    std::unique_ptr<BatchedModelInference> pedestrian_batch_inference_;
 };
 
 }  // namespace prediction
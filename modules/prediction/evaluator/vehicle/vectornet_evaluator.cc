@@ -160,15 +160,15 @@ bool VectornetEvaluator::VectornetProcessObstaclePosition(
 }
 
 bool VectornetEvaluator::VectornetProcessMapData(
-        FeatureVector* map_feature, PidVector* map_p_id, const int obs_num,
+        const PackedPolylines& map_polylines, const int obs_num,
         torch::Tensor* ptr_map_data, torch::Tensor* ptr_all_map_p_id,
         torch::Tensor* ptr_vector_mask)
 {
-    int map_polyline_num = map_feature->size();
+    int map_polyline_num = map_polylines.num_polylines;
 
     for (int i = 0; i < map_polyline_num && obs_num + i < 450; ++i)
     {
-        size_t one_polyline_vector_size = map_feature->at(i).size();
+        size_t one_polyline_vector_size = map_polylines.num_vectors[i];
         if (one_polyline_vector_size < 50)
         {
             ptr_vector_mask->index_put_(
@@ -179,23 +179,24 @@ bool VectornetEvaluator::VectornetProcessMapData(
         }
     }
 
-    auto opts = torch::TensorOptions().dtype(torch::kDouble);
-
-    for (int i = 0; i < map_polyline_num && i + obs_num < 450; ++i)
+    if (map_polyline_num == 0)
     {
-        ptr_all_map_p_id->index_put_(
-                {i}, torch::from_blob(map_p_id->at(i).data(), {2}, opts));
-
-        int one_polyline_vector_size = map_feature->at(i).size();
-        for (int j = 0; j < one_polyline_vector_size && j < 50; ++j)
-        {
-            ptr_map_data->index_put_(
-                    {i, j},
-                    torch::from_blob(map_feature->at(i)[j].data(), {9}, opts));
-        }
+        *ptr_map_data = torch::zeros({0, 50, PackedPolylines::kVectorSize});
+        *ptr_all_map_p_id = torch::zeros({0, 2});
+        return true;
     }
-    *ptr_map_data = ptr_map_data->toType(at::kFloat);
-    *ptr_all_map_p_id = ptr_all_map_p_id->toType(at::kFloat);
+
+    // The polylines are already padded to the tensor layout, wrap them
+    // instead of copying every vector.
+    auto opts = torch::TensorOptions().dtype(torch::kFloat);
+    *ptr_map_data = torch::from_blob(
+            const_cast<float*>(map_polylines.vectors.data()),
+            {map_polyline_num, map_polylines.max_num_vectors,
+             PackedPolylines::kVectorSize},
+            opts);
+    *ptr_all_map_p_id = torch::from_blob(
+            const_cast<float*>(map_polylines.p_ids.data()),
+            {map_polyline_num, 2}, opts);
 
     return true;
 }
@@ -246,8 +247,7 @@ bool VectornetEvaluator::Evaluate(Obstacle* obstacle_ptr,
     CHECK_NOTNULL(latest_feature_ptr);
 
     // Query the map data
-    FeatureVector map_feature;
-    PidVector map_p_id;
+    PackedPolylines map_polylines;
     const double pos_x = latest_feature_ptr->position().x();
     const double pos_y = latest_feature_ptr->position().y();
     common::PointENU center_point =
@@ -257,7 +257,8 @@ bool VectornetEvaluator::Evaluate(Obstacle* obstacle_ptr,
 
     auto start_time_query = std::chrono::system_clock::now();
 
-    if (!vector_net_.query(center_point, heading, &map_feature, &map_p_id))
+    if (!vector_net_.query(center_point, heading, 450 - obs_num, 50,
+                           &map_polylines))
     {
         return false;
     }
@@ -268,17 +269,17 @@ bool VectornetEvaluator::Evaluate(Obstacle* obstacle_ptr,
     AINFO << "vectors query used time: " << diff_query.count() * 1000 << " ms.";
 
     // process map data & map p id & v_mask for map polyline
-    int map_polyline_num = map_feature.size();
+    int map_polyline_num = map_polylines.num_polylines;
     int data_length = ((obs_num + map_polyline_num) < 450)
                               ? (obs_num + map_polyline_num)
                               : 450;
 
     // Process input tensor
     auto start_time_data_prep = std::chrono::system_clock::now();
-    torch::Tensor map_data = torch::zeros({map_polyline_num, 50, 9});
-    torch::Tensor all_map_p_id = torch::zeros({map_polyline_num, 2});
+    torch::Tensor map_data;
+    torch::Tensor all_map_p_id;
 
-    if (!VectornetProcessMapData(&map_feature, &map_p_id, obs_num, &map_data,
+    if (!VectornetProcessMapData(map_polylines, obs_num, &map_data,
                                  &all_map_p_id, &vector_mask))
     {
         AERROR << "Obstacle [" << id << "] processing map data fails.";
@@ -431,16 +432,11 @@ bool VectornetEvaluator::ExtractObstaclesHistory(
     std::pair<double, double> obs_curr_pos = std::make_pair(
             obs_curr_feature.position().x(), obs_curr_feature.position().y());
     // Extract target obstacle history
-    for (std::size_t i = 0; i < obstacle_ptr->history_size() && i < 20; ++i)
+    const ObstacleStateHistory& target_history = obstacle_ptr->state_history();
+    for (std::size_t i = 0; i < target_history.size() && i < 20; ++i)
     {
-        const Feature& target_feature = obstacle_ptr->feature(i);
-        if (!target_feature.IsInitialized())
-        {
-            break;
-        }
         target_pos_history->at(i) = WorldCoordToObjCoordNorth(
-                std::make_pair(target_feature.position().x(),
-                               target_feature.position().y()),
+                std::make_pair(target_history.x(i), target_history.y(i)),
                 obs_curr_pos, obs_curr_heading);
     }
     all_obs_length->emplace_back(std::make_pair(obs_curr_feature.length(),
@@ -481,17 +477,12 @@ bool VectornetEvaluator::ExtractObstaclesHistory(
                     1);
         }
 
+        const ObstacleStateHistory& history = obstacle->state_history();
         for (size_t i = 0; i < obs_his_size; ++i)
         {
-            const Feature& feature = obstacle->feature(i);
-            if (!feature.IsInitialized())
-            {
-                break;
-            }
             pos_history[i] = WorldCoordToObjCoordNorth(
-                    std::make_pair(feature.position().x(),
-                                   feature.position().y()),
-                    obs_curr_pos, obs_curr_heading);
+                    std::make_pair(history.x(i), history.y(i)), obs_curr_pos,
+                    obs_curr_heading);
         }
         all_obs_pos_history->emplace_back(pos_history);
     }
@@ -89,11 +89,11 @@ bool Dense::Load(const DenseParameter& dense_pb)
     if (!dense_pb.has_activation())
     {
         ADEBUG << "Set activation as linear function";
-        kactivation_ = serialize_to_function("linear");
+        activation_ = ActivationType::LINEAR;
     }
     else
     {
-        kactivation_ = serialize_to_function(dense_pb.activation());
+        activation_ = serialize_to_activation_type(dense_pb.activation());
     }
     units_ = dense_pb.units();
     return true;
@@ -103,13 +103,18 @@ void Dense::Run(const std::vector<Eigen::MatrixXf>& inputs,
                 Eigen::MatrixXf* output)
 {
     CHECK_EQ(inputs.size(), 1U);
-    Eigen::MatrixXf prod = static_cast<Eigen::MatrixXf>(inputs[0] * weights_);
+    Run(inputs[0], output);
+}
+
+void Dense::Run(const Eigen::MatrixXf& input, Eigen::MatrixXf* output)
+{
+    DCHECK_NE(&input, output);
+    output->noalias() = input * weights_;
     if (use_bias_)
     {
-        Eigen::MatrixXf sum = prod.rowwise() + bias_.transpose();
-        prod = sum;
+        output->rowwise() += bias_.transpose();
     }
-    *output = prod.unaryExpr(kactivation_);
+    ApplyActivation(activation_, *output);
     CHECK_EQ(output->cols(), units_);
 }
 
@@ -157,6 +162,18 @@ bool Conv1d::Load(const Conv1dParameter& conv1d_pb)
     {
         stride_ = 1;
     }
+    const int num_kernels = static_cast<int>(kernel_.size());
+    const int kernel_rows = num_kernels > 0 ? kernel_[0].rows() : 0;
+    const int kernel_size = num_kernels > 0 ? kernel_[0].cols() : 0;
+    kernel_matrix_.resize(num_kernels, kernel_rows * kernel_size);
+    for (int i = 0; i < num_kernels; ++i)
+    {
+        for (int p = 0; p < kernel_rows; ++p)
+        {
+            kernel_matrix_.block(i, p * kernel_size, 1, kernel_size) =
+                    kernel_[i].row(p);
+        }
+    }
     return true;
 }
 
@@ -164,30 +181,29 @@ void Conv1d::Run(const std::vector<Eigen::MatrixXf>& inputs,
                  Eigen::MatrixXf* output)
 {
     CHECK_EQ(inputs.size(), 1U);
+    Run(inputs[0], output);
+}
+
+void Conv1d::Run(const Eigen::MatrixXf& input, Eigen::MatrixXf* output)
+{
     CHECK_GT(kernel_.size(), 0U);
-    CHECK_EQ(kernel_[0].rows(), inputs[0].rows());
-    int kernel_size = static_cast<int>(kernel_[0].cols());
-    int output_num_col =
-            static_cast<int>((inputs[0].cols() - kernel_size) / stride_) + 1;
-    int output_num_row = static_cast<int>(kernel_.size());
-    output->resize(output_num_row, output_num_col);
-    for (int i = 0; i < output_num_row; ++i)
+    CHECK_EQ(kernel_[0].rows(), input.rows());
+    const int kernel_size = static_cast<int>(kernel_[0].cols());
+    const int num_input_rows = static_cast<int>(input.rows());
+    const int output_num_col =
+            static_cast<int>((input.cols() - kernel_size) / stride_) + 1;
+    // column j holds the input window of output column j, row by row
+    windows_.resize(num_input_rows * kernel_size, output_num_col);
+    for (int j = 0; j < output_num_col; ++j)
     {
-        for (int j = 0; j < output_num_col; ++j)
+        for (int p = 0; p < num_input_rows; ++p)
         {
-            float output_i_j_unbiased = 0.0f;
-            for (int p = 0; p < inputs[0].rows(); ++p)
-            {
-                for (int q = j * stride_; q < j * stride_ + kernel_size; ++q)
-                {
-                    output_i_j_unbiased +=
-                            inputs[0](p, q) * kernel_[i](p, q - j * stride_);
-                }
-            }
-
-            (*output)(i, j) = output_i_j_unbiased + bias_(i);
+            windows_.block(p * kernel_size, j, kernel_size, 1) =
+                    input.block(p, j * stride_, 1, kernel_size).transpose();
         }
     }
+    output->noalias() = kernel_matrix_ * windows_;
+    output->colwise() += bias_;
 }
 
 bool MaxPool1d::Load(const LayerParameter& layer_pb)
@@ -222,20 +238,25 @@ void MaxPool1d::Run(const std::vector<Eigen::MatrixXf>& inputs,
                     Eigen::MatrixXf* output)
 {
     CHECK_EQ(inputs.size(), 1U);
+    Run(inputs[0], output);
+}
+
+void MaxPool1d::Run(const Eigen::MatrixXf& input, Eigen::MatrixXf* output)
+{
     int output_num_col =
-            static_cast<int>((inputs[0].cols() - kernel_size_) / stride_) + 1;
-    int output_num_row = static_cast<int>(inputs[0].rows());
+            static_cast<int>((input.cols() - kernel_size_) / stride_) + 1;
+    int output_num_row = static_cast<int>(input.rows());
     output->resize(output_num_row, output_num_col);
     int input_index = 0;
     for (int j = 0; j < output_num_col; ++j)
     {
-        CHECK_LE(input_index + kernel_size_, inputs[0].cols());
+        CHECK_LE(input_index + kernel_size_, input.cols());
         for (int i = 0; i < output_num_row; ++i)
         {
             float output_i_j = -std::numeric_limits<float>::infinity();
             for (int k = input_index; k < input_index + kernel_size_; ++k)
             {
-                output_i_j = std::max(output_i_j, inputs[0](i, k));
+                output_i_j = std::max(output_i_j, input(i, k));
             }
             (*output)(i, j) = output_i_j;
         }
@@ -275,20 +296,25 @@ void AvgPool1d::Run(const std::vector<Eigen::MatrixXf>& inputs,
                     Eigen::MatrixXf* output)
 {
     CHECK_EQ(inputs.size(), 1U);
+    Run(inputs[0], output);
+}
+
+void AvgPool1d::Run(const Eigen::MatrixXf& input, Eigen::MatrixXf* output)
+{
     int output_num_col =
-            static_cast<int>((inputs[0].cols() - kernel_size_) / stride_) + 1;
-    int output_num_row = static_cast<int>(inputs[0].rows());
+            static_cast<int>((input.cols() - kernel_size_) / stride_) + 1;
+    int output_num_row = static_cast<int>(input.rows());
     output->resize(output_num_row, output_num_col);
     int input_index = 0;
     for (int j = 0; j < output_num_col; ++j)
     {
-        CHECK_LE(input_index + kernel_size_, inputs[0].cols());
+        CHECK_LE(input_index + kernel_size_, input.cols());
         for (int i = 0; i < output_num_row; ++i)
         {
             float output_i_j_sum = 0.0f;
             for (int k = input_index; k < input_index + kernel_size_; ++k)
             {
-                output_i_j_sum += inputs[0](i, k);
+                output_i_j_sum += input(i, k);
             }
             (*output)(i, j) = output_i_j_sum / static_cast<float>(kernel_size_);
         }
@@ -305,12 +331,12 @@ bool Activation::Load(const LayerParameter& layer_pb)
     }
     if (!layer_pb.has_activation())
     {
-        kactivation_ = serialize_to_function("linear");
+        activation_ = ActivationType::LINEAR;
     }
     else
     {
         ActivationParameter activation_pb = layer_pb.activation();
-        kactivation_ = serialize_to_function(activation_pb.activation());
+        activation_ = serialize_to_activation_type(activation_pb.activation());
     }
     return true;
 }
@@ -319,11 +345,11 @@ bool Activation::Load(const ActivationParameter& activation_pb)
 {
     if (!activation_pb.has_activation())
     {
-        kactivation_ = serialize_to_function("linear");
+        activation_ = ActivationType::LINEAR;
     }
     else
     {
-        kactivation_ = serialize_to_function(activation_pb.activation());
+        activation_ = serialize_to_activation_type(activation_pb.activation());
     }
     return true;
 }
@@ -332,7 +358,13 @@ void Activation::Run(const std::vector<Eigen::MatrixXf>& inputs,
                      Eigen::MatrixXf* output)
 {
     CHECK_EQ(inputs.size(), 1U);
-    *output = inputs[0].unaryExpr(kactivation_);
+    Run(inputs[0], output);
+}
+
+void Activation::Run(const Eigen::MatrixXf& input, Eigen::MatrixXf* output)
+{
+    *output = input;
+    ApplyActivation(activation_, *output);
 }
 
 bool BatchNormalization::Load(const LayerParameter& layer_pb)
@@ -375,25 +407,33 @@ bool BatchNormalization::Load(const LayerParameter& layer_pb)
             return false;
         }
     }
-    return true;
-}
 
-void BatchNormalization::Run(const std::vector<Eigen::MatrixXf>& inputs,
-                             Eigen::MatrixXf* output)
-{
-    CHECK_EQ(inputs.size(), 1U);
-    Eigen::MatrixXf temp = (inputs[0].rowwise() - mu_.transpose());
-    Eigen::MatrixXf norm = temp.array().rowwise() /
-                           (sigma_.array().sqrt() + epsilon_).transpose();
+    // (x - mu) / (sqrt(sigma) + epsilon) * gamma + beta
+    norm_scale_ = (sigma_.array().sqrt() + epsilon_).inverse().transpose();
     if (scale_)
     {
-        norm = norm.array().rowwise() * gamma_.transpose().array();
+        norm_scale_ = norm_scale_.cwiseProduct(gamma_.transpose());
     }
+    norm_shift_ = -mu_.transpose().cwiseProduct(norm_scale_);
     if (center_)
     {
-        norm = norm.rowwise() + beta_.transpose();
+        norm_shift_ += beta_.transpose();
     }
-    *output = norm;
+    return true;
+}
+
+void BatchNormalization::Run(const std::vector<Eigen::MatrixXf>& inputs,
+                             Eigen::MatrixXf* output)
+{
+    CHECK_EQ(inputs.size(), 1U);
+    Run(inputs[0], output);
+}
+
+void BatchNormalization::Run(const Eigen::MatrixXf& input,
+                             Eigen::MatrixXf* output)
+{
+    *output = (input.array().rowwise() * norm_scale_.array()).matrix();
+    output->rowwise() += norm_shift_;
 }
 
 bool LSTM::Load(const LayerParameter& layer_pb)
@@ -434,21 +474,21 @@ bool LSTM::Load(const LayerParameter& layer_pb)
     if (!lstm_pb.has_activation())
     {
         ADEBUG << "Set activation function as tanh.";
-        kactivation_ = serialize_to_function("tanh");
+        activation_ = ActivationType::TANH;
     }
     else
     {
-        kactivation_ = serialize_to_function(lstm_pb.activation());
+        activation_ = serialize_to_activation_type(lstm_pb.activation());
     }
     if (!lstm_pb.has_recurrent_activation())
     {
-        ADEBUG << "Set recurrent_activation function as hard_tanh.";
-        krecurrent_activation_ = serialize_to_function("hard_tanh");
+        ADEBUG << "Set recurrent_activation function as hard_sigmoid.";
+        recurrent_activation_ = ActivationType::HARD_SIGMOID;
     }
     else
     {
-        krecurrent_activation_ =
-                serialize_to_function(lstm_pb.recurrent_activation());
+        recurrent_activation_ =
+                serialize_to_activation_type(lstm_pb.recurrent_activation());
     }
     if (!lstm_pb.has_use_bias())
     {
@@ -536,53 +576,62 @@ bool LSTM::Load(const LayerParameter& layer_pb)
         AERROR << "Fail to Load recurrent output weights!";
         return false;
     }
+
+    w_.resize(wi_.rows(), 4 * units_);
+    w_ << wi_, wf_, wc_, wo_;
+    r_w_.resize(r_wi_.rows(), 4 * units_);
+    r_w_ << r_wi_, r_wf_, r_wc_, r_wo_;
+    b_.resize(4 * units_);
+    b_ << bi_.transpose(), bf_.transpose(), bc_.transpose(), bo_.transpose();
     ResetState();
     return true;
 }
 
-void LSTM::Step(const Eigen::MatrixXf& input, Eigen::MatrixXf* output,
-                Eigen::MatrixXf* ht_1, Eigen::MatrixXf* ct_1)
+void LSTM::Step(const int t)
 {
-    Eigen::MatrixXf x_i = input * wi_ + bi_.transpose();
-    Eigen::MatrixXf x_f = input * wf_ + bf_.transpose();
-    Eigen::MatrixXf x_c = input * wc_ + bc_.transpose();
-    Eigen::MatrixXf x_o = input * wo_ + bo_.transpose();
+    gates_ = input_projection_.row(t);
+    gates_.noalias() += ht_1_ * r_w_;
 
-    Eigen::MatrixXf i =
-            (x_i + (*ht_1) * r_wi_).unaryExpr(krecurrent_activation_);
-    Eigen::MatrixXf f =
-            (x_f + (*ht_1) * r_wf_).unaryExpr(krecurrent_activation_);
-    Eigen::MatrixXf c =
-            f.array() * ct_1->array() +
-            i.array() *
-                    ((x_c + (*ht_1) * r_wc_).unaryExpr(kactivation_)).array();
-    Eigen::MatrixXf o =
-            (x_o + (*ht_1) * r_wo_).unaryExpr(krecurrent_activation_);
-    Eigen::MatrixXf h = o.array() * (c.unaryExpr(kactivation_)).array();
+    // gates_ holds the input, forget, cell and output gates in this order
+    ApplyActivation(recurrent_activation_, gates_.leftCols(2 * units_));
+    ApplyActivation(activation_, gates_.middleCols(2 * units_, units_));
+    ApplyActivation(recurrent_activation_, gates_.rightCols(units_));
 
-    *ht_1 = h;
-    *ct_1 = c;
-    *output = h;
+    ct_1_ = gates_.middleCols(units_, units_).cwiseProduct(ct_1_) +
+            gates_.leftCols(units_).cwiseProduct(
+                    gates_.middleCols(2 * units_, units_));
+    ht_1_ = ct_1_;
+    ApplyActivation(activation_, ht_1_);
+    ht_1_.array() *= gates_.rightCols(units_).array();
 }
 
 void LSTM::Run(const std::vector<Eigen::MatrixXf>& inputs,
                Eigen::MatrixXf* output)
 {
     CHECK_EQ(inputs.size(), 1U);
-    Eigen::MatrixXf sequences(inputs[0].rows(), units_);
-    Eigen::MatrixXf temp;
-    for (int i = 0; i < inputs[0].rows(); ++i)
+    Run(inputs[0], output);
+}
+
+void LSTM::Run(const Eigen::MatrixXf& input, Eigen::MatrixXf* output)
+{
+    CHECK_GT(input.rows(), 0);
+    input_projection_.noalias() = input * w_;
+    input_projection_.rowwise() += b_;
+    if (return_sequences_)
     {
-        Step(inputs[0].row(i), &temp, &ht_1_, &ct_1_);
-        sequences.row(i) = temp.row(0);
+        output->resize(input.rows(), units_);
     }
-    if (return_sequences_)
+    for (int i = 0; i < input.rows(); ++i)
     {
-        *output = sequences;
+        Step(i);
+        if (return_sequences_)
+        {
+            output->row(i) = ht_1_.row(0);
+        }
     }
-    else
+    if (!return_sequences_)
     {
-        *output = temp.row(0);
+        *output = ht_1_;
     }
 }
 
@@ -626,8 +675,13 @@ void Flatten::Run(const std::vector<Eigen::MatrixXf>& inputs,
                   Eigen::MatrixXf* output)
 {
     CHECK_EQ(inputs.size(), 1U);
+    Run(inputs[0], output);
+}
+
+void Flatten::Run(const Eigen::MatrixXf& input, Eigen::MatrixXf* output)
+{
     Eigen::Matrix<float, Eigen::Dynamic, Eigen::Dynamic, Eigen::RowMajor> inp(
-            inputs[0]);
+            input);
     inp.resize(1, inp.size());
     *output = inp;
 }
@@ -678,8 +732,13 @@ void Input::Run(const std::vector<Eigen::MatrixXf>& inputs,
                 Eigen::MatrixXf* output)
 {
     CHECK_EQ(inputs.size(), 1U);
-    CHECK_EQ(inputs[0].cols(), input_shape_.back());
-    *output = inputs[0];
+    Run(inputs[0], output);
+}
+
+void Input::Run(const Eigen::MatrixXf& input, Eigen::MatrixXf* output)
+{
+    CHECK_EQ(input.cols(), input_shape_.back());
+    *output = input;
 }
 
 bool Concatenate::Load(const LayerParameter& layer_pb)
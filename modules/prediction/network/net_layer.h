@@ -82,6 +82,18 @@ public:
     virtual void Run(const std::vector<Eigen::MatrixXf>& inputs,
                      Eigen::MatrixXf* output) = 0;
 
+    /**
+     * @brief Compute the layer output from a single input, without copying
+     *        it into a vector of inputs. Layers with one input implement
+     *        this, the output buffer is reused if it has the right size.
+     * @param Input to a network layer, must not be the output
+     * @param Output of a network layer will be returned
+     */
+    virtual void Run(const Eigen::MatrixXf& input, Eigen::MatrixXf* output)
+    {
+        Run(std::vector<Eigen::MatrixXf>{input}, output);
+    }
+
     /**
      * @brief Name of a layer
      * @return Name of a layer
@@ -107,6 +119,8 @@ private:
  *
  *        Parameter w and b can be loaded from pb message. if bias is
  *        not used, b = 0. f is linear function at default.
+ *        Every row of x is one sample, a batch of samples is evaluated by
+ *        one matrix product, the bias and f are applied to it in place.
  */
 class Dense : public Layer
 {
@@ -133,12 +147,19 @@ public:
     void Run(const std::vector<Eigen::MatrixXf>& inputs,
              Eigen::MatrixXf* output) override;
 
+    /**
+     * @brief Compute the layer output from its single input
+     * @param Input to a network layer
+     * @param Output of a network layer will be returned
+     */
+    void Run(const Eigen::MatrixXf& input, Eigen::MatrixXf* output) override;
+
 private:
     int units_;
     bool use_bias_;
     Eigen::MatrixXf weights_;
     Eigen::VectorXf bias_;
-    std::function<float(float)> kactivation_;
+    ActivationType activation_ = ActivationType::LINEAR;
 };
 
 /**
@@ -175,12 +196,24 @@ public:
     void Run(const std::vector<Eigen::MatrixXf>& inputs,
              Eigen::MatrixXf* output) override;
 
+    /**
+     * @brief Compute the layer output from its single input
+     * @param Input to a network layer
+     * @param Output of a network layer will be returned
+     */
+    void Run(const Eigen::MatrixXf& input, Eigen::MatrixXf* output) override;
+
 private:
     std::vector<int> shape_;
     bool use_bias_;
     std::vector<Eigen::MatrixXf> kernel_;
     Eigen::VectorXf bias_;
     int stride_;
+
+    // kernels flattened to one row each, the convolution is one product of
+    // it with the input windows (im2col) kept in windows_ between runs
+    Eigen::MatrixXf kernel_matrix_;
+    Eigen::MatrixXf windows_;
 };
 
 /**
@@ -212,6 +245,13 @@ public:
     void Run(const std::vector<Eigen::MatrixXf>& inputs,
              Eigen::MatrixXf* output) override;
 
+    /**
+     * @brief Compute the layer output from its single input
+     * @param Input to a network layer
+     * @param Output of a network layer will be returned
+     */
+    void Run(const Eigen::MatrixXf& input, Eigen::MatrixXf* output) override;
+
 private:
     int kernel_size_;
     int stride_;
@@ -246,6 +286,13 @@ public:
     void Run(const std::vector<Eigen::MatrixXf>& inputs,
              Eigen::MatrixXf* output) override;
 
+    /**
+     * @brief Compute the layer output from its single input
+     * @param Input to a network layer
+     * @param Output of a network layer will be returned
+     */
+    void Run(const Eigen::MatrixXf& input, Eigen::MatrixXf* output) override;
+
 private:
     int kernel_size_;
     int stride_;
@@ -284,8 +331,15 @@ public:
     void Run(const std::vector<Eigen::MatrixXf>& inputs,
              Eigen::MatrixXf* output) override;
 
+    /**
+     * @brief Compute the layer output from its single input
+     * @param Input to a network layer
+     * @param Output of a network layer will be returned
+     */
+    void Run(const Eigen::MatrixXf& input, Eigen::MatrixXf* output) override;
+
 private:
-    std::function<float(float)> kactivation_;
+    ActivationType activation_ = ActivationType::LINEAR;
 };
 
 /**
@@ -311,6 +365,13 @@ public:
     void Run(const std::vector<Eigen::MatrixXf>& inputs,
              Eigen::MatrixXf* output) override;
 
+    /**
+     * @brief Compute the layer output from its single input
+     * @param Input to a network layer
+     * @param Output of a network layer will be returned
+     */
+    void Run(const Eigen::MatrixXf& input, Eigen::MatrixXf* output) override;
+
 private:
     Eigen::VectorXf mu_;
     Eigen::VectorXf sigma_;
@@ -321,6 +382,10 @@ private:
     int axis_ = 0;
     bool center_ = false;
     bool scale_ = false;
+
+    // the normalization folded into y = x * norm_scale_ + norm_shift_
+    Eigen::RowVectorXf norm_scale_;
+    Eigen::RowVectorXf norm_shift_;
 };
 
 /**
@@ -346,6 +411,13 @@ public:
     void Run(const std::vector<Eigen::MatrixXf>& inputs,
              Eigen::MatrixXf* output) override;
 
+    /**
+     * @brief Compute the layer output from its single input
+     * @param Input to a network layer
+     * @param Output of a network layer will be returned
+     */
+    void Run(const Eigen::MatrixXf& input, Eigen::MatrixXf* output) override;
+
     /**
      * @brief Reset the internal state and memory cell state as zero-matrix
      */
@@ -365,14 +437,11 @@ public:
 
 private:
     /**
-     * @brief Compute the output of LSTM step by step
-     * @param Input of current step
-     * @param Output of current step
-     * @param Hidden state of previous step and return current hidden state
-     * @param Cell state of previous step and return current cell state
+     * @brief Compute one step of LSTM, updates ht_1_ and ct_1_ from the
+     *        previous step to the current step
+     * @param Index of the step in input_projection_
      */
-    void Step(const Eigen::MatrixXf& input, Eigen::MatrixXf* output,
-              Eigen::MatrixXf* ht_1, Eigen::MatrixXf* ct_1);
+    void Step(const int t);
 
     Eigen::MatrixXf wi_;
     Eigen::MatrixXf wf_;
@@ -388,10 +457,19 @@ private:
     Eigen::MatrixXf r_wc_;
     Eigen::MatrixXf r_wo_;
 
+    // weights of the input, forget, cell and output gates side by side, so
+    // that one product computes all gates
+    Eigen::MatrixXf w_;
+    Eigen::MatrixXf r_w_;
+    Eigen::RowVectorXf b_;
+    // inputs of all steps times w_ plus b_, computed once per run
+    Eigen::MatrixXf input_projection_;
+    Eigen::MatrixXf gates_;
+
     Eigen::MatrixXf ht_1_;
     Eigen::MatrixXf ct_1_;
-    std::function<float(float)> kactivation_;
-    std::function<float(float)> krecurrent_activation_;
+    ActivationType activation_ = ActivationType::TANH;
+    ActivationType recurrent_activation_ = ActivationType::HARD_SIGMOID;
     int units_ = 0;
     bool return_sequences_ = false;
     bool stateful_ = false;
@@ -419,6 +497,13 @@ public:
      */
     void Run(const std::vector<Eigen::MatrixXf>& inputs,
              Eigen::MatrixXf* output) override;
+
+    /**
+     * @brief Compute the layer output from its single input
+     * @param Input to a network layer
+     * @param Output of a network layer will be returned
+     */
+    void Run(const Eigen::MatrixXf& input, Eigen::MatrixXf* output) override;
 };
 
 /**
@@ -443,6 +528,13 @@ public:
     void Run(const std::vector<Eigen::MatrixXf>& inputs,
              Eigen::MatrixXf* output) override;
 
+    /**
+     * @brief Compute the layer output from its single input
+     * @param Input to a network layer
+     * @param Output of a network layer will be returned
+     */
+    void Run(const Eigen::MatrixXf& input, Eigen::MatrixXf* output) override;
+
 private:
     std::vector<int> input_shape_;
     std::string dtype_;
@@ -71,6 +71,7 @@ bool NetModel::LoadModel(const NetParameter& net_parameter)
         }
         layers_.push_back(std::move(layer));
     }
+    layer_outputs_.resize(layers_.size());
     ok_ = true;
     AINFO << "Success in loading the model!";
     ADEBUG << "Its Performance:" << PerformanceString().c_str();
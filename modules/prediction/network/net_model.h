@@ -111,6 +111,9 @@ public:
 
 protected:
     std::vector<std::unique_ptr<Layer>> layers_;
+    // output of every layer, kept across runs so that a run with the same
+    // input shapes does not allocate
+    mutable std::vector<Eigen::MatrixXf> layer_outputs_;
     NetParameter net_parameter_;
     bool ok_ = false;
 };
@@ -70,6 +70,40 @@ std::function<float(float)> serialize_to_function(const std::string& str)
     return func_map.at(str);
 }
 
+ActivationType serialize_to_activation_type(const std::string& str)
+{
+    static const std::unordered_map<std::string, ActivationType> type_map(
+            {{"linear", ActivationType::LINEAR},
+             {"tanh", ActivationType::TANH},
+             {"sigmoid", ActivationType::SIGMOID},
+             {"hard_sigmoid", ActivationType::HARD_SIGMOID},
+             {"relu", ActivationType::RELU}});
+    return type_map.at(str);
+}
+
+void ApplyActivation(const ActivationType type,
+                     Eigen::Ref<Eigen::MatrixXf> matrix)
+{
+    auto values = matrix.array();
+    switch (type)
+    {
+        case ActivationType::LINEAR:
+            break;
+        case ActivationType::TANH:
+            values = values.tanh();
+            break;
+        case ActivationType::SIGMOID:
+            values = (1.0f + (-values).exp()).inverse();
+            break;
+        case ActivationType::HARD_SIGMOID:
+            values = (0.2f * values + 0.5f).max(0.0f).min(1.0f);
+            break;
+        case ActivationType::RELU:
+            values = values.max(0.0f);
+            break;
+    }
+}
+
 bool LoadTensor(const TensorParameter& tensor_pb, Eigen::MatrixXf* matrix)
 {
     if (tensor_pb.data().empty() || tensor_pb.shape().empty())
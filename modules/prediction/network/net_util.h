@@ -86,6 +86,35 @@ Eigen::MatrixXf FlattenMatrix(const Eigen::MatrixXf& matrix);
  */
 std::function<float(float)> serialize_to_function(const std::string& str);
 
+/**
+ * @brief Activation functions that can be applied to a whole matrix
+ */
+enum class ActivationType
+{
+    LINEAR,
+    TANH,
+    SIGMOID,
+    HARD_SIGMOID,
+    RELU,
+};
+
+/**
+ * @brief translate a string into a network activation type
+ * @param string, same names as serialize_to_function
+ * @return activation type map to the string
+ */
+ActivationType serialize_to_activation_type(const std::string& str);
+
+/**
+ * @brief apply an activation function to every element of a matrix in place,
+ *        with vectorized Eigen array operations instead of one call of
+ *        serialize_to_function(str) per element
+ * @param activation type
+ * @param matrix or block of a matrix
+ */
+void ApplyActivation(const ActivationType type,
+                     Eigen::Ref<Eigen::MatrixXf> matrix);
+
 /**
  * @brief load matrix value from a protobuf message
  * @param protobuf message in the form of TensorParameter
@@ -27,42 +27,31 @@ RnnModel::RnnModel() {}
 void RnnModel::Run(const std::vector<Eigen::MatrixXf>& inputs,
                    Eigen::MatrixXf* output) const
 {
-    Eigen::MatrixXf inp1;
-    Eigen::MatrixXf inp2;
-    layers_[0]->Run({inputs[0]}, &inp1);
-    layers_[1]->Run({inputs[1]}, &inp2);
+    auto& out = layer_outputs_;
+    layers_[0]->Run(inputs[0], &out[0]);
+    layers_[1]->Run(inputs[1], &out[1]);
 
-    Eigen::MatrixXf bn1;
-    Eigen::MatrixXf bn2;
-    layers_[2]->Run({inp1}, &bn1);
-    layers_[3]->Run({inp2}, &bn2);
+    layers_[2]->Run(out[0], &out[2]);
+    layers_[3]->Run(out[1], &out[3]);
 
-    Eigen::MatrixXf lstm1;
-    Eigen::MatrixXf lstm2;
-    layers_[4]->Run({bn1}, &lstm1);
-    layers_[5]->Run({bn2}, &lstm2);
+    layers_[4]->Run(out[2], &out[4]);
+    layers_[5]->Run(out[3], &out[5]);
 
-    Eigen::MatrixXf merge;
-    Eigen::MatrixXf dense1;
-    Eigen::MatrixXf act1;
-    layers_[6]->Run({lstm1, lstm2}, &merge);
-    layers_[7]->Run({merge}, &dense1);
-    layers_[8]->Run({dense1}, &bn1);
-    layers_[9]->Run({bn1}, &act1);
+    layers_[6]->Run(std::vector<Eigen::MatrixXf>{out[4], out[5]}, &out[6]);
+    layers_[7]->Run(out[6], &out[7]);
+    layers_[8]->Run(out[7], &out[8]);
+    layers_[9]->Run(out[8], &out[9]);
 
-    Eigen::MatrixXf dense2;
-    Eigen::MatrixXf prob;
-    layers_[10]->Run({act1}, &dense2);
-    layers_[12]->Run({dense2}, &bn1);
-    layers_[14]->Run({bn1}, &prob);
+    layers_[10]->Run(out[9], &out[10]);
+    layers_[12]->Run(out[10], &out[12]);
+    layers_[14]->Run(out[12], &out[14]);
 
-    Eigen::MatrixXf acc;
-    layers_[11]->Run({act1}, &dense2);
-    layers_[13]->Run({dense2}, &bn1);
-    layers_[15]->Run({bn1}, &acc);
+    layers_[11]->Run(out[9], &out[11]);
+    layers_[13]->Run(out[11], &out[13]);
+    layers_[15]->Run(out[13], &out[15]);
 
     output->resize(1, 2);
-    *output << prob, acc;
+    *output << out[14], out[15];
 }
 
 void RnnModel::SetState(const std::vector<Eigen::MatrixXf>& states)
@@ -0,0 +1,223 @@
+/******************************************************************************
+ * Copyright 2023 The Apollo Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *****************************************************************************/
+
+#include "modules/prediction/pipeline/obstacle_feature_table.h"
+
+#include <fstream>
+#include <utility>
+
+#include "cyber/common/log.h"
+
+namespace apollo
+{
+namespace prediction
+{
+namespace
+{
+// must follow the order of the AddColumn calls in the constructor
+enum ColumnIndex : size_t
+{
+    SHARD_ID = 0,
+    TIMESTAMP,
+    OBSTACLE_ID,
+    OBSTACLE_TYPE,
+    PRIORITY,
+    IS_STILL,
+    X,
+    Y,
+    THETA,
+    VELOCITY_X,
+    VELOCITY_Y,
+    SPEED,
+    ACC,
+    LENGTH,
+    WIDTH,
+    HAS_LANE_FEATURE,
+    LANE_S,
+    LANE_L,
+    ANGLE_DIFF,
+    DIST_TO_LEFT_BOUNDARY,
+    DIST_TO_RIGHT_BOUNDARY,
+    LANE_TURN_TYPE,
+    HAS_EGO,
+    EGO_X,
+    EGO_Y,
+    EGO_THETA,
+    EGO_SPEED,
+    NUM_COLUMNS,
+};
+
+constexpr char kMagic[4] = {'P', 'F', 'T', 'B'};
+
+template <typename T>
+void WriteValue(const T& value, std::ofstream* fout)
+{
+    fout->write(reinterpret_cast<const char*>(&value), sizeof(T));
+}
+
+}  // namespace
+
+ObstacleFeatureTable::ObstacleFeatureTable()
+{
+    AddColumn("shard_id", INT32);
+    AddColumn("timestamp", FLOAT64);
+    AddColumn("obstacle_id", INT32);
+    AddColumn("obstacle_type", INT32);
+    AddColumn("priority", INT32);
+    AddColumn("is_still", INT32);
+    AddColumn("x", FLOAT64);
+    AddColumn("y", FLOAT64);
+    AddColumn("theta", FLOAT64);
+    AddColumn("velocity_x", FLOAT64);
+    AddColumn("velocity_y", FLOAT64);
+    AddColumn("speed", FLOAT64);
+    AddColumn("acc", FLOAT64);
+    AddColumn("length", FLOAT64);
+    AddColumn("width", FLOAT64);
+    AddColumn("has_lane_feature", INT32);
+    AddColumn("lane_s", FLOAT64);
+    AddColumn("lane_l", FLOAT64);
+    AddColumn("angle_diff", FLOAT64);
+    AddColumn("dist_to_left_boundary", FLOAT64);
+    AddColumn("dist_to_right_boundary", FLOAT64);
+    AddColumn("lane_turn_type", INT32);
+    AddColumn("has_ego", INT32);
+    AddColumn("ego_x", FLOAT64);
+    AddColumn("ego_y", FLOAT64);
+    AddColumn("ego_theta", FLOAT64);
+    AddColumn("ego_speed", FLOAT64);
+    CHECK_EQ(columns_.size(), static_cast<size_t>(NUM_COLUMNS));
+}
+
+void ObstacleFeatureTable::AddColumn(const std::string& name,
+                                     const ColumnType type)
+{
+    Column column;
+    column.name = name;
+    column.type = type;
+    columns_.push_back(std::move(column));
+}
+
+void ObstacleFeatureTable::Set(const size_t column, const double value)
+{
+    DCHECK_EQ(columns_[column].type, FLOAT64);
+    columns_[column].float64_values.push_back(value);
+}
+
+void ObstacleFeatureTable::Set(const size_t column, const int32_t value)
+{
+    DCHECK_EQ(columns_[column].type, INT32);
+    columns_[column].int32_values.push_back(value);
+}
+
+void ObstacleFeatureTable::Append(const int shard_id, const Obstacle& obstacle,
+                                  const Obstacle* ego_vehicle)
+{
+    const Feature& feature = obstacle.latest_feature();
+    const ObstacleStateHistory& history = obstacle.state_history();
+    CHECK(!history.empty());
+
+    Set(SHARD_ID, static_cast<int32_t>(shard_id));
+    Set(TIMESTAMP, history.timestamp(0));
+    Set(OBSTACLE_ID, static_cast<int32_t>(obstacle.id()));
+    Set(OBSTACLE_TYPE, static_cast<int32_t>(obstacle.type()));
+    Set(PRIORITY, static_cast<int32_t>(feature.priority().priority()));
+    Set(IS_STILL, static_cast<int32_t>(feature.is_still()));
+    Set(X, history.x(0));
+    Set(Y, history.y(0));
+    Set(THETA, history.theta(0));
+    Set(VELOCITY_X, history.velocity_x(0));
+    Set(VELOCITY_Y, history.velocity_y(0));
+    Set(SPEED, history.speed(0));
+    Set(ACC, history.acc(0));
+    Set(LENGTH, feature.length());
+    Set(WIDTH, feature.width());
+    Set(HAS_LANE_FEATURE, static_cast<int32_t>(history.has_lane_feature(0)));
+    Set(LANE_S, history.lane_s(0));
+    Set(LANE_L, history.lane_l(0));
+    Set(ANGLE_DIFF, history.angle_diff(0));
+    Set(DIST_TO_LEFT_BOUNDARY, history.dist_to_left_boundary(0));
+    Set(DIST_TO_RIGHT_BOUNDARY, history.dist_to_right_boundary(0));
+    Set(LANE_TURN_TYPE, static_cast<int32_t>(history.lane_turn_type(0)));
+
+    const bool has_ego =
+            ego_vehicle != nullptr && !ego_vehicle->state_history().empty();
+    Set(HAS_EGO, static_cast<int32_t>(has_ego));
+    const ObstacleStateHistory* ego_history =
+            has_ego ? &ego_vehicle->state_history() : nullptr;
+    Set(EGO_X, has_ego ? ego_history->x(0) : 0.0);
+    Set(EGO_Y, has_ego ? ego_history->y(0) : 0.0);
+    Set(EGO_THETA, has_ego ? ego_history->theta(0) : 0.0);
+    Set(EGO_SPEED, has_ego ? ego_history->speed(0) : 0.0);
+
+    ++num_rows_;
+}
+
+void ObstacleFeatureTable::Clear()
+{
+    for (auto& column : columns_)
+    {
+        column.float64_values.clear();
+        column.int32_values.clear();
+    }
+    num_rows_ = 0;
+}
+
+bool ObstacleFeatureTable::WriteToFile(const std::string& file_name) const
+{
+    std::ofstream fout(file_name, std::ios::out | std::ios::binary |
+                                          std::ios::trunc);
+    if (!fout.is_open())
+    {
+        AERROR << "Failed to open " << file_name;
+        return false;
+    }
+
+    fout.write(kMagic, sizeof(kMagic));
+    WriteValue(kSchemaVersion, &fout);
+    WriteValue(static_cast<uint32_t>(columns_.size()), &fout);
+    WriteValue(static_cast<uint64_t>(num_rows_), &fout);
+    for (const auto& column : columns_)
+    {
+        WriteValue(static_cast<uint32_t>(column.name.size()), &fout);
+        fout.write(column.name.data(), column.name.size());
+        WriteValue(static_cast<uint8_t>(column.type), &fout);
+    }
+    for (const auto& column : columns_)
+    {
+        if (column.type == FLOAT64)
+        {
+            fout.write(reinterpret_cast<const char*>(
+                               column.float64_values.data()),
+                       column.float64_values.size() * sizeof(double));
+        }
+        else
+        {
+            fout.write(
+                    reinterpret_cast<const char*>(column.int32_values.data()),
+                    column.int32_values.size() * sizeof(int32_t));
+        }
+    }
+    if (!fout.good())
+    {
+        AERROR << "Failed to write " << file_name;
+        return false;
+    }
+    return true;
+}
+
+}  // namespace prediction
+}  // namespace apollo
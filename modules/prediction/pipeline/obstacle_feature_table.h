@@ -0,0 +1,103 @@
+/******************************************************************************
+ * Copyright 2023 The Apollo Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *****************************************************************************/
+
+/**
+ * @file
+ * @brief Columnar table of obstacle features for offline training data
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "modules/prediction/container/obstacles/obstacle.h"
+
+namespace apollo
+{
+namespace prediction
+{
+/**
+ * @class ObstacleFeatureTable
+ * @brief One row per obstacle and frame, one array per column. The columns
+ *        are fixed by kSchemaVersion, a column is only ever appended to the
+ *        end of the schema together with a version bump.
+ *
+ * File layout, numbers in host byte order (little endian on all supported
+ * platforms):
+ *   char[4]  magic "PFTB"
+ *   uint32   schema version
+ *   uint32   number of columns
+ *   uint64   number of rows
+ *   per column: uint32 name length, name, uint8 type (0: float64, 1: int32)
+ *   per column: number of rows values of the column type
+ */
+class ObstacleFeatureTable
+{
+public:
+    static constexpr uint32_t kSchemaVersion = 1;
+
+    enum ColumnType : uint8_t
+    {
+        FLOAT64 = 0,
+        INT32 = 1,
+    };
+
+    ObstacleFeatureTable();
+
+    /**
+     * @brief Append the latest frame of an obstacle
+     * @param Shard the frame belongs to
+     * @param Obstacle with at least one frame
+     * @param Ego vehicle, nullptr if not known in this frame
+     */
+    void Append(const int shard_id, const Obstacle& obstacle,
+                const Obstacle* ego_vehicle);
+
+    size_t num_rows() const { return num_rows_; }
+
+    void Clear();
+
+    /**
+     * @brief Write the table to a file, replacing it if it exists
+     * @param File name
+     * @return If the file was written completely
+     */
+    bool WriteToFile(const std::string& file_name) const;
+
+private:
+    struct Column
+    {
+        std::string name;
+        ColumnType type = FLOAT64;
+        std::vector<double> float64_values;
+        std::vector<int32_t> int32_values;
+    };
+
+    void AddColumn(const std::string& name, const ColumnType type);
+
+    void Set(const size_t column, const double value);
+
+    void Set(const size_t column, const int32_t value);
+
+private:
+    std::vector<Column> columns_;
+    size_t num_rows_ = 0;
+};
+
+}  // namespace prediction
+}  // namespace apollo
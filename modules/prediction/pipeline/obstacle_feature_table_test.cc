@@ -0,0 +1,172 @@
+/******************************************************************************
+ * Copyright 2023 The Apollo Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *****************************************************************************/
+
+#include "modules/prediction/pipeline/obstacle_feature_table.h"
+
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+namespace apollo
+{
+namespace prediction
+{
+namespace
+{
+constexpr char kTestFile[] = "obstacle_feature_table_test.bin";
+constexpr uint32_t kNumColumns = 27;
+
+Feature MakeFeature(const int id, const double x)
+{
+    Feature feature;
+    feature.set_id(id);
+    feature.set_type(perception::PerceptionObstacle::VEHICLE);
+    feature.set_timestamp(10.0);
+    feature.mutable_position()->set_x(x);
+    feature.mutable_position()->set_y(2.0);
+    feature.mutable_velocity()->set_x(3.0);
+    feature.mutable_velocity()->set_y(4.0);
+    feature.set_speed(5.0);
+    feature.set_theta(0.5);
+    feature.set_length(4.5);
+    feature.set_width(2.0);
+    LaneFeature* lane_feature =
+            feature.mutable_lane()->mutable_lane_feature();
+    lane_feature->set_lane_s(7.0);
+    lane_feature->set_lane_l(0.2);
+    return feature;
+}
+
+template <typename T>
+T ReadValue(std::ifstream* fin)
+{
+    T value{};
+    fin->read(reinterpret_cast<char*>(&value), sizeof(T));
+    return value;
+}
+
+struct ColumnInfo
+{
+    std::string name;
+    uint8_t type = 0;
+};
+
+}  // namespace
+
+TEST(ObstacleFeatureTableTest, FileFormat)
+{
+    Obstacle obstacle;
+    obstacle.InsertFeature(MakeFeature(3, 1.0));
+    Obstacle other_obstacle;
+    other_obstacle.InsertFeature(MakeFeature(4, 11.0));
+    Obstacle ego_vehicle;
+    ego_vehicle.InsertFeature(MakeFeature(-1, 100.0));
+
+    ObstacleFeatureTable table;
+    table.Append(5, obstacle, nullptr);
+    table.Append(5, other_obstacle, &ego_vehicle);
+    ASSERT_EQ(2, table.num_rows());
+    ASSERT_TRUE(table.WriteToFile(kTestFile));
+
+    std::ifstream fin(kTestFile, std::ios::in | std::ios::binary);
+    ASSERT_TRUE(fin.is_open());
+    char magic[4];
+    fin.read(magic, sizeof(magic));
+    EXPECT_EQ("PFTB", std::string(magic, sizeof(magic)));
+    EXPECT_EQ(ObstacleFeatureTable::kSchemaVersion, ReadValue<uint32_t>(&fin));
+    ASSERT_EQ(kNumColumns, ReadValue<uint32_t>(&fin));
+    const uint64_t num_rows = ReadValue<uint64_t>(&fin);
+    ASSERT_EQ(2, num_rows);
+
+    std::vector<ColumnInfo> columns(kNumColumns);
+    for (auto& column : columns)
+    {
+        column.name.resize(ReadValue<uint32_t>(&fin));
+        fin.read(&column.name[0], column.name.size());
+        column.type = ReadValue<uint8_t>(&fin);
+    }
+    EXPECT_EQ("shard_id", columns[0].name);
+    EXPECT_EQ(ObstacleFeatureTable::INT32, columns[0].type);
+    EXPECT_EQ("timestamp", columns[1].name);
+    EXPECT_EQ(ObstacleFeatureTable::FLOAT64, columns[1].type);
+    EXPECT_EQ("ego_speed", columns.back().name);
+    EXPECT_EQ(ObstacleFeatureTable::FLOAT64, columns.back().type);
+
+    // the values follow column by column
+    std::vector<std::vector<double>> values(kNumColumns);
+    for (size_t i = 0; i < columns.size(); ++i)
+    {
+        for (uint64_t row = 0; row < num_rows; ++row)
+        {
+            values[i].push_back(
+                    columns[i].type == ObstacleFeatureTable::INT32
+                            ? static_cast<double>(ReadValue<int32_t>(&fin))
+                            : ReadValue<double>(&fin));
+        }
+    }
+    ASSERT_TRUE(fin.good());
+    fin.get();
+    EXPECT_TRUE(fin.eof());
+
+    auto column_values = [&](const std::string& name) {
+        for (size_t i = 0; i < columns.size(); ++i)
+        {
+            if (columns[i].name == name)
+            {
+                return values[i];
+            }
+        }
+        ADD_FAILURE() << "Missing column " << name;
+        return std::vector<double>();
+    };
+    EXPECT_EQ(std::vector<double>({5.0, 5.0}), column_values("shard_id"));
+    EXPECT_EQ(std::vector<double>({3.0, 4.0}), column_values("obstacle_id"));
+    EXPECT_EQ(std::vector<double>({1.0, 11.0}), column_values("x"));
+    EXPECT_EQ(std::vector<double>({7.0, 7.0}), column_values("lane_s"));
+    EXPECT_EQ(std::vector<double>({1.0, 1.0}),
+              column_values("has_lane_feature"));
+    EXPECT_EQ(std::vector<double>({0.0, 1.0}), column_values("has_ego"));
+    EXPECT_EQ(std::vector<double>({0.0, 100.0}), column_values("ego_x"));
+}
+
+TEST(ObstacleFeatureTableTest, Clear)
+{
+    Obstacle obstacle;
+    obstacle.InsertFeature(MakeFeature(3, 1.0));
+    ObstacleFeatureTable table;
+    table.Append(0, obstacle, nullptr);
+    table.Clear();
+    EXPECT_EQ(0, table.num_rows());
+    ASSERT_TRUE(table.WriteToFile(kTestFile));
+
+    // same file as a table that never had a row
+    const std::string empty_file = std::string(kTestFile) + ".empty";
+    ASSERT_TRUE(ObstacleFeatureTable().WriteToFile(empty_file));
+    std::ifstream fin(kTestFile, std::ios::in | std::ios::binary);
+    std::ifstream empty_fin(empty_file, std::ios::in | std::ios::binary);
+    ASSERT_TRUE(fin.is_open());
+    ASSERT_TRUE(empty_fin.is_open());
+    EXPECT_EQ(std::string(std::istreambuf_iterator<char>(empty_fin),
+                          std::istreambuf_iterator<char>()),
+              std::string(std::istreambuf_iterator<char>(fin),
+                          std::istreambuf_iterator<char>()));
+}
+
+}  // namespace prediction
+}  // namespace apollo
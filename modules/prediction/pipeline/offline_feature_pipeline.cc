@@ -0,0 +1,352 @@
+/******************************************************************************
+ * Copyright 2023 The Apollo Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *****************************************************************************/
+
+#include "modules/prediction/pipeline/offline_feature_pipeline.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <memory>
+#include <mutex>
+
+#include "cyber/common/log.h"
+#include "cyber/record/record_reader.h"
+#include "cyber/record/record_writer.h"
+#include "modules/common/adapters/adapter_gflags.h"
+#include "modules/prediction/common/message_process.h"
+#include "modules/prediction/common/prediction_constants.h"
+#include "modules/prediction/common/prediction_gflags.h"
+#include "modules/prediction/common/prediction_map.h"
+#include "modules/prediction/common/prediction_system_gflags.h"
+#include "modules/prediction/common/prediction_thread_pool.h"
+#include "modules/prediction/pipeline/obstacle_feature_table.h"
+
+namespace apollo
+{
+namespace prediction
+{
+using apollo::common::adapter::AdapterConfig;
+using apollo::cyber::record::RecordMessage;
+using apollo::cyber::record::RecordReader;
+using apollo::cyber::record::RecordWriter;
+using apollo::localization::LocalizationEstimate;
+using apollo::perception::PerceptionObstacles;
+using apollo::planning::ADCTrajectory;
+
+namespace
+{
+// evaluators and predictors of a worker, handed from one shard to the next
+struct ShardModels
+{
+    EvaluatorManager evaluator_manager;
+    PredictorManager predictor_manager;
+};
+
+struct RecordTimeRange
+{
+    std::string file;
+    uint64_t begin_time = 0;
+    uint64_t end_time = 0;
+};
+
+uint64_t SecondsToNanoseconds(const double seconds)
+{
+    return static_cast<uint64_t>(std::max(seconds, 0.0) * 1e9);
+}
+
+void AppendFrame(const int shard_id, ContainerManager* container_manager,
+                 ObstacleFeatureTable* table)
+{
+    auto ptr_obstacles_container =
+            container_manager->GetContainer<ObstaclesContainer>(
+                    AdapterConfig::PERCEPTION_OBSTACLES);
+    CHECK_NOTNULL(ptr_obstacles_container);
+    const Obstacle* ego_vehicle =
+            ptr_obstacles_container->GetObstacle(FLAGS_ego_vehicle_id);
+    for (const int id :
+         ptr_obstacles_container->curr_frame_movable_obstacle_ids())
+    {
+        if (id == FLAGS_ego_vehicle_id)
+        {
+            continue;
+        }
+        const Obstacle* obstacle = ptr_obstacles_container->GetObstacle(id);
+        if (obstacle == nullptr || obstacle->history_size() == 0)
+        {
+            continue;
+        }
+        table->Append(shard_id, *obstacle, ego_vehicle);
+    }
+}
+
+}  // namespace
+
+OfflineFeaturePipeline::OfflineFeaturePipeline(
+        const PredictionConf& prediction_conf) :
+    prediction_conf_(prediction_conf)
+{
+}
+
+std::vector<RecordShard> OfflineFeaturePipeline::ShardRecords(
+        const std::vector<std::string>& record_files,
+        const double shard_duration, const double warm_up_time)
+{
+    std::vector<RecordShard> shards;
+    std::vector<RecordTimeRange> records;
+    for (const auto& file : record_files)
+    {
+        RecordReader reader(file);
+        if (!reader.IsValid())
+        {
+            AERROR << "Skip invalid record " << file;
+            continue;
+        }
+        RecordTimeRange record;
+        record.file = file;
+        record.begin_time = reader.GetHeader().begin_time();
+        record.end_time = reader.GetHeader().end_time();
+        records.push_back(record);
+    }
+    if (records.empty())
+    {
+        return shards;
+    }
+    std::sort(records.begin(), records.end(),
+              [](const RecordTimeRange& lhs, const RecordTimeRange& rhs) {
+                  return lhs.begin_time < rhs.begin_time;
+              });
+
+    uint64_t begin_time = records.front().begin_time;
+    uint64_t end_time = begin_time;
+    for (const auto& record : records)
+    {
+        end_time = std::max(end_time, record.end_time);
+    }
+    const uint64_t duration =
+            std::max(SecondsToNanoseconds(shard_duration), uint64_t{1});
+    const uint64_t warm_up = SecondsToNanoseconds(warm_up_time);
+
+    for (uint64_t shard_begin = begin_time; shard_begin <= end_time;
+         shard_begin += duration)
+    {
+        RecordShard shard;
+        shard.id = static_cast<int>(shards.size());
+        shard.begin_time = shard_begin;
+        shard.end_time = shard_begin + duration;
+        shard.warm_up_begin_time = shard_begin - std::min(warm_up,
+                                                          shard_begin -
+                                                                  begin_time);
+        for (const auto& record : records)
+        {
+            if (record.end_time >= shard.warm_up_begin_time &&
+                record.begin_time < shard.end_time)
+            {
+                shard.record_files.push_back(record.file);
+            }
+        }
+        // a gap between drives, or only the warm-up of the shard has records
+        const bool has_messages = std::any_of(
+                records.begin(), records.end(),
+                [&shard](const RecordTimeRange& record) {
+                    return record.end_time >= shard.begin_time &&
+                           record.begin_time < shard.end_time;
+                });
+        if (has_messages)
+        {
+            shards.push_back(std::move(shard));
+        }
+    }
+    return shards;
+}
+
+int OfflineFeaturePipeline::Run(const std::vector<std::string>& record_files,
+                                const std::string& output_dir,
+                                int* const next_shard_id) const
+{
+    std::vector<RecordShard> shards =
+            ShardRecords(record_files, FLAGS_offline_shard_duration_sec,
+                         FLAGS_offline_shard_warm_up_sec);
+    AINFO << "Split " << record_files.size() << " records into "
+          << shards.size() << " shards.";
+    for (auto& shard : shards)
+    {
+        shard.id += *next_shard_id;
+    }
+    *next_shard_id += static_cast<int>(shards.size());
+
+    // the evaluators load their models on init, so a set is only built when
+    // all existing ones are in use, i.e. at most once per worker
+    std::mutex models_mutex;
+    std::vector<std::unique_ptr<ShardModels>> idle_models;
+    std::atomic<int> num_processed{0};
+    std::atomic<int> num_succeeded{0};
+    // one shard per task, a shard runs for minutes
+    PredictionThreadPool::ParallelFor(
+            shards.size(),
+            [&](size_t i) {
+                std::unique_ptr<ShardModels> models;
+                {
+                    std::lock_guard<std::mutex> lock(models_mutex);
+                    if (!idle_models.empty())
+                    {
+                        models = std::move(idle_models.back());
+                        idle_models.pop_back();
+                    }
+                }
+                if (models == nullptr)
+                {
+                    models.reset(new ShardModels());
+                    MessageProcess::InitEvaluators(&models->evaluator_manager,
+                                                   prediction_conf_);
+                    MessageProcess::InitPredictors(&models->predictor_manager,
+                                                   prediction_conf_);
+                }
+
+                const RecordShard& shard = shards[i];
+                const std::string output_file =
+                        output_dir + "/obstacle_features." +
+                        std::to_string(shard.id) + ".bin";
+                const std::string record_file =
+                        output_dir + "/shard." + std::to_string(shard.id) +
+                        ".record.new_prediction";
+                if (ProcessShard(shard, output_file, record_file,
+                                 &models->evaluator_manager,
+                                 &models->predictor_manager))
+                {
+                    ++num_succeeded;
+                }
+                {
+                    std::lock_guard<std::mutex> lock(models_mutex);
+                    idle_models.push_back(std::move(models));
+                }
+                AINFO << "Processed shard [ " << ++num_processed << " / "
+                      << shards.size() << " ]: " << output_file;
+            },
+            1);
+    return num_succeeded;
+}
+
+bool OfflineFeaturePipeline::ProcessShard(
+        const RecordShard& shard, const std::string& output_file,
+        const std::string& record_file, EvaluatorManager* evaluator_manager,
+        PredictorManager* predictor_manager) const
+{
+    // containers are not shared between shards, every shard replays its
+    // records from its own warm-up state
+    auto container_manager = std::make_shared<ContainerManager>();
+    ScenarioManager scenario_manager;
+    if (!MessageProcess::InitContainers(container_manager.get()) ||
+        (!FLAGS_use_navigation_mode && !PredictionMap::Ready()))
+    {
+        AERROR << "Failed to init shard " << shard.id;
+        return false;
+    }
+
+    // every offline mode dumps its data from OnPerception, the feature
+    // table alone only needs the containers
+    const bool run_on_perception =
+            FLAGS_prediction_offline_mode != PredictionConstants::kOnlineMode;
+    const bool dump_record =
+            FLAGS_prediction_offline_mode == PredictionConstants::kDumpRecord;
+    const auto& topic_conf = prediction_conf_.topic_conf();
+    RecordWriter writer;
+    if (dump_record && !writer.Open(record_file))
+    {
+        AERROR << "Failed to open " << record_file;
+        return false;
+    }
+    ObstacleFeatureTable table;
+    for (const auto& record_file : shard.record_files)
+    {
+        RecordReader reader(record_file);
+        RecordMessage message;
+        while (reader.ReadMessage(&message, shard.warm_up_begin_time,
+                                  shard.end_time - 1))
+        {
+            if (message.channel_name ==
+                topic_conf.perception_obstacle_topic())
+            {
+                PerceptionObstacles perception_obstacles;
+                if (!perception_obstacles.ParseFromString(message.content))
+                {
+                    continue;
+                }
+                if (message.time < shard.begin_time || !run_on_perception)
+                {
+                    MessageProcess::ContainerProcess(container_manager,
+                                                     perception_obstacles,
+                                                     &scenario_manager);
+                }
+                else
+                {
+                    PredictionObstacles prediction_obstacles;
+                    MessageProcess::OnPerception(
+                            perception_obstacles, container_manager,
+                            evaluator_manager, predictor_manager,
+                            &scenario_manager, &prediction_obstacles);
+                    if (dump_record)
+                    {
+                        writer.WriteMessage<PerceptionObstacles>(
+                                message.channel_name, perception_obstacles,
+                                message.time);
+                        writer.WriteMessage<PredictionObstacles>(
+                                topic_conf.prediction_topic(),
+                                prediction_obstacles, message.time);
+                    }
+                }
+                if (message.time >= shard.begin_time)
+                {
+                    AppendFrame(shard.id, container_manager.get(), &table);
+                }
+            }
+            else if (message.channel_name == topic_conf.localization_topic())
+            {
+                LocalizationEstimate localization;
+                if (localization.ParseFromString(message.content))
+                {
+                    if (dump_record && message.time >= shard.begin_time)
+                    {
+                        writer.WriteMessage<LocalizationEstimate>(
+                                message.channel_name, localization,
+                                message.time);
+                    }
+                    MessageProcess::OnLocalization(container_manager.get(),
+                                                   localization);
+                }
+            }
+            else if (message.channel_name ==
+                     topic_conf.planning_trajectory_topic())
+            {
+                ADCTrajectory adc_trajectory;
+                if (adc_trajectory.ParseFromString(message.content))
+                {
+                    MessageProcess::OnPlanning(container_manager.get(),
+                                               adc_trajectory);
+                }
+            }
+        }
+    }
+    if (dump_record)
+    {
+        writer.Close();
+    }
+    AINFO << "Shard " << shard.id << " has " << table.num_rows()
+          << " obstacle frames.";
+    return table.WriteToFile(output_file);
+}
+
+}  // namespace prediction
+}  // namespace apollo
@@ -0,0 +1,99 @@
+/******************************************************************************
+ * Copyright 2023 The Apollo Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *****************************************************************************/
+
+/**
+ * @file
+ * @brief Extract offline training features from records in parallel
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "modules/prediction/evaluator/evaluator_manager.h"
+#include "modules/prediction/predictor/predictor_manager.h"
+#include "modules/prediction/proto/prediction_conf.pb.h"
+
+namespace apollo
+{
+namespace prediction
+{
+/**
+ * @brief A time window of records processed by one task
+ */
+struct RecordShard
+{
+    int id = 0;
+    std::vector<std::string> record_files;
+    // message times in ns, messages in [warm_up_begin_time, begin_time) only
+    // fill the container history, features are extracted in
+    // [begin_time, end_time)
+    uint64_t warm_up_begin_time = 0;
+    uint64_t begin_time = 0;
+    uint64_t end_time = 0;
+};
+
+/**
+ * @class OfflineFeaturePipeline
+ * @brief Runs the online container, evaluator and predictor code on records
+ *        like MessageProcess::ProcessOfflineData, but splits the records into
+ *        time windows processed in parallel, each with its own containers
+ *        and a warm-up period. The obstacle features of every shard are
+ *        written as an ObstacleFeatureTable. The dumps of the offline modes
+ *        still go through FeatureOutput, kDumpRecord writes one record with
+ *        the new prediction messages per shard.
+ */
+class OfflineFeaturePipeline
+{
+public:
+    explicit OfflineFeaturePipeline(const PredictionConf& prediction_conf);
+
+    /**
+     * @brief Process records, the shards run on PredictionThreadPool
+     * @param Record files, in any order
+     * @param Directory of the feature tables
+     * @param Id of the first shard, advanced by the number of shards so that
+     *        runs into the same directory do not overwrite each other
+     * @return Number of shards processed successfully
+     */
+    int Run(const std::vector<std::string>& record_files,
+            const std::string& output_dir, int* const next_shard_id) const;
+
+    /**
+     * @brief Split records into time windows
+     * @param Record files
+     * @param Duration of one shard in seconds
+     * @param Warm-up time before a shard in seconds
+     * @return Shards, windows without any record are skipped
+     */
+    static std::vector<RecordShard> ShardRecords(
+            const std::vector<std::string>& record_files,
+            const double shard_duration, const double warm_up_time);
+
+private:
+    bool ProcessShard(const RecordShard& shard, const std::string& output_file,
+                      const std::string& record_file,
+                      EvaluatorManager* evaluator_manager,
+                      PredictorManager* predictor_manager) const;
+
+private:
+    PredictionConf prediction_conf_;
+};
+
+}  // namespace prediction
+}  // namespace apollo
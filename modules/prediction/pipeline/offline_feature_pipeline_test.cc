@@ -0,0 +1,125 @@
+/******************************************************************************
+ * Copyright 2023 The Apollo Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *****************************************************************************/
+
+#include "modules/prediction/pipeline/offline_feature_pipeline.h"
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+#include "cyber/record/record_writer.h"
+
+namespace apollo
+{
+namespace prediction
+{
+using apollo::cyber::message::RawMessage;
+using apollo::cyber::record::RecordWriter;
+
+namespace
+{
+constexpr char kChannelName[] = "/test/channel";
+constexpr char kMessageType[] = "apollo.cyber.proto.Test";
+constexpr char kProtoDesc[] = "1234567890";
+constexpr char kFirstRecord[] = "offline_feature_pipeline_test_1.record";
+constexpr char kSecondRecord[] = "offline_feature_pipeline_test_2.record";
+constexpr uint64_t kBeginTime = 1000000000000;
+constexpr uint64_t kSecond = 1000000000;
+
+// one message per second in [begin_sec, end_sec]
+void WriteRecord(const std::string& file, const uint64_t begin_sec,
+                 const uint64_t end_sec)
+{
+    RecordWriter writer;
+    writer.SetSizeOfFileSegmentation(0);
+    writer.SetIntervalOfFileSegmentation(0);
+    ASSERT_TRUE(writer.Open(file));
+    writer.WriteChannel(kChannelName, kMessageType, kProtoDesc);
+    for (uint64_t sec = begin_sec; sec <= end_sec; ++sec)
+    {
+        auto message = std::make_shared<RawMessage>(std::to_string(sec));
+        writer.WriteMessage(kChannelName, message, kBeginTime + sec * kSecond);
+    }
+    writer.Close();
+}
+
+}  // namespace
+
+TEST(OfflineFeaturePipelineTest, ShardRecords)
+{
+    // two drives with a gap from 10 s to 30 s
+    WriteRecord(kFirstRecord, 0, 9);
+    WriteRecord(kSecondRecord, 30, 34);
+
+    const std::vector<RecordShard> shards =
+            OfflineFeaturePipeline::ShardRecords(
+                    {kSecondRecord, kFirstRecord, "not_a_record"}, 5.0, 2.0);
+    ASSERT_EQ(3, shards.size());
+
+    // the first shard has no warm-up, nothing is before it
+    EXPECT_EQ(0, shards[0].id);
+    EXPECT_EQ(kBeginTime, shards[0].warm_up_begin_time);
+    EXPECT_EQ(kBeginTime, shards[0].begin_time);
+    EXPECT_EQ(kBeginTime + 5 * kSecond, shards[0].end_time);
+    EXPECT_EQ(std::vector<std::string>({kFirstRecord}),
+              shards[0].record_files);
+
+    EXPECT_EQ(1, shards[1].id);
+    EXPECT_EQ(kBeginTime + 3 * kSecond, shards[1].warm_up_begin_time);
+    EXPECT_EQ(shards[0].end_time, shards[1].begin_time);
+    EXPECT_EQ(kBeginTime + 10 * kSecond, shards[1].end_time);
+    EXPECT_EQ(std::vector<std::string>({kFirstRecord}),
+              shards[1].record_files);
+
+    // the windows in the gap are skipped, the shard ids stay contiguous, the
+    // last message time starts a shard of its own
+    EXPECT_EQ(2, shards[2].id);
+    EXPECT_EQ(kBeginTime + 28 * kSecond, shards[2].warm_up_begin_time);
+    EXPECT_EQ(kBeginTime + 30 * kSecond, shards[2].begin_time);
+    EXPECT_EQ(kBeginTime + 35 * kSecond, shards[2].end_time);
+    EXPECT_EQ(std::vector<std::string>({kSecondRecord}),
+              shards[2].record_files);
+}
+
+TEST(OfflineFeaturePipelineTest, ShardRecordsWarmUpInPreviousRecord)
+{
+    WriteRecord(kFirstRecord, 0, 9);
+    WriteRecord(kSecondRecord, 10, 14);
+
+    const std::vector<RecordShard> shards =
+            OfflineFeaturePipeline::ShardRecords(
+                    {kFirstRecord, kSecondRecord}, 10.0, 3.0);
+    ASSERT_EQ(2, shards.size());
+    EXPECT_EQ(std::vector<std::string>({kFirstRecord}),
+              shards[0].record_files);
+    // the warm-up of the second shard reads the end of the first record
+    EXPECT_EQ(kBeginTime + 7 * kSecond, shards[1].warm_up_begin_time);
+    EXPECT_EQ(std::vector<std::string>({kFirstRecord, kSecondRecord}),
+              shards[1].record_files);
+}
+
+TEST(OfflineFeaturePipelineTest, ShardRecordsWithoutRecords)
+{
+    EXPECT_TRUE(OfflineFeaturePipeline::ShardRecords({}, 5.0, 2.0).empty());
+    EXPECT_TRUE(OfflineFeaturePipeline::ShardRecords({"not_a_record"}, 5.0,
+                                                     2.0)
+                        .empty());
+}
+
+}  // namespace prediction
+}  // namespace apollo
@@ -15,6 +15,9 @@
  *****************************************************************************/
 
 #if 0
+#include <algorithm>
+#include <thread>
+
 #include "cyber/common/file.h"
 
 #include "absl/strings/str_split.h"
@@ -22,6 +25,7 @@
 #include "modules/prediction/common/message_process.h"
 #include "modules/prediction/common/prediction_map.h"
 #include "modules/prediction/common/prediction_system_gflags.h"
+#include "modules/prediction/pipeline/offline_feature_pipeline.h"
 #include "modules/prediction/proto/prediction_conf.pb.h"
 #include "modules/prediction/util/data_extraction.h"
 
@@ -48,15 +52,16 @@ void GenerateDataForLearning() {
   ADEBUG << "Adapter config file is loaded into: "
          << prediction_conf.ShortDebugString();
 
-  auto container_manager = std::make_shared<ContainerManager>();
-  EvaluatorManager evaluator_manager;
-  PredictorManager predictor_manager;
-  ScenarioManager scenario_manager;
-
-  if (!MessageProcess::Init(container_manager.get(), &evaluator_manager,
-                            &predictor_manager, prediction_conf)) {
-    return;
+  // the shards already keep all cores busy
+  FLAGS_enable_multi_thread = false;
+  if (gflags::GetCommandLineFlagInfoOrDie("max_thread_num").is_default) {
+    FLAGS_max_thread_num =
+        std::max(1, static_cast<int>(std::thread::hardware_concurrency()));
   }
+
+  const OfflineFeaturePipeline pipeline(prediction_conf);
+  // shard ids continue over the inputs, they all write into the same dir
+  int next_shard_id = 0;
   const std::vector<std::string> inputs =
       absl::StrSplit(FLAGS_prediction_offline_bags, ':');
   for (const auto& input : inputs) {
@@ -65,13 +70,10 @@ void GenerateDataForLearning() {
     std::sort(offline_bags.begin(), offline_bags.end());
     AINFO << "For input " << input << ", found " << offline_bags.size()
           << "  rosbags to process";
-    for (std::size_t i = 0; i < offline_bags.size(); ++i) {
-      AINFO << "\tProcessing: [ " << i << " / " << offline_bags.size()
-            << " ]: " << offline_bags[i];
-      MessageProcess::ProcessOfflineData(prediction_conf, container_manager,
-                                         &evaluator_manager, &predictor_manager,
-                                         &scenario_manager, offline_bags[i]);
-    }
+    const int num_shards =
+        pipeline.Run(offline_bags, FLAGS_prediction_data_dir, &next_shard_id);
+    AINFO << "For input " << input << ", processed " << num_shards
+          << " shards";
   }
   FeatureOutput::Close();
 }
@@ -15,6 +15,7 @@
  *****************************************************************************/
 #include "modules/prediction/pipeline/vector_net.h"
 
+#include <algorithm>
 #include <cmath>
 #include <limits>
 #include <unordered_set>
@@ -26,13 +27,44 @@ namespace apollo
 {
 namespace prediction
 {
+namespace
+{
+// Rotates a point around the center so that the obstacle heads to +y, same
+// as common::math::RotateVector2d with M_PI_2 - obstacle_phi.
+struct PolylineTransform
+{
+    PolylineTransform(const common::PointENU& center_point,
+                      const double obstacle_phi) :
+        center_x(center_point.x()),
+        center_y(center_point.y()),
+        cos_theta(std::cos(M_PI_2 - obstacle_phi)),
+        sin_theta(std::sin(M_PI_2 - obstacle_phi))
+    {
+    }
+
+    double X(const double x, const double y) const
+    {
+        return cos_theta * (x - center_x) - sin_theta * (y - center_y);
+    }
+
+    double Y(const double x, const double y) const
+    {
+        return sin_theta * (x - center_x) + cos_theta * (y - center_y);
+    }
+
+    double center_x;
+    double center_y;
+    double cos_theta;
+    double sin_theta;
+};
+
+}  // namespace
+
 template <typename Points>
-void VectorNet::GetOnePolyline(
-        const Points& points, double* start_length,
-        const common::PointENU& center_point, const double obstacle_phi,
-        ATTRIBUTE_TYPE attr_type, BOUNDARY_TYPE bound_type, const int count,
-        std::vector<std::vector<double>>* const one_polyline,
-        std::vector<double>* const one_p_id)
+void VectorNet::GetOnePolyline(const Points& points, double* start_length,
+                               ATTRIBUTE_TYPE attr_type,
+                               BOUNDARY_TYPE bound_type,
+                               WorldPolyline* const one_polyline) const
 {
     size_t size = points.size();
     std::vector<double> s(size, 0);
@@ -75,40 +107,12 @@ void VectorNet::GetOnePolyline(
     if (point_size == 0) return;
     const double attr = attribute_map.at(attr_type);
     const double bound = boundary_map.at(bound_type);
-    auto last_point_after_rotate = common::math::RotateVector2d(
-            {x[0] - center_point.x(), y[0] - center_point.y()},
-            M_PI_2 - obstacle_phi);
-
     for (size_t i = 1; i < point_size; ++i)
     {
-        if (one_p_id->at(0) > last_point_after_rotate.x())
-        {
-            one_p_id->at(0) = last_point_after_rotate.x();
-        }
-        if (one_p_id->at(1) > last_point_after_rotate.y())
-        {
-            one_p_id->at(1) = last_point_after_rotate.y();
-        }
-
-        std::vector<double> one_vector;
-
-        // d_s, d_e
-        one_vector.push_back(last_point_after_rotate.x());
-        one_vector.push_back(last_point_after_rotate.y());
-
-        Eigen::Vector2d point_after_rotate = common::math::RotateVector2d(
-                {x[i] - center_point.x(), y[i] - center_point.y()},
-                M_PI_2 - obstacle_phi);
-
-        one_vector.push_back(point_after_rotate.x());
-        one_vector.push_back(point_after_rotate.y());
-        last_point_after_rotate = std::move(point_after_rotate);
-
-        // attribute
-        one_vector.insert(one_vector.end(), {0.0, 0.0, attr, bound});
-
-        one_vector.push_back(count);
-        one_polyline->push_back(std::move(one_vector));
+        one_polyline->points.insert(one_polyline->points.end(),
+                                    {x[i - 1], y[i - 1], x[i], y[i]});
+        one_polyline->attributes.insert(one_polyline->attributes.end(),
+                                        {attr, bound});
     }
 }
 
@@ -118,11 +122,95 @@ bool VectorNet::query(const common::PointENU& center_point,
                       PidVector* const p_id_ptr)
 {
     CHECK_NOTNULL(feature_ptr);
-    count_ = 0;
-    GetRoads(center_point, obstacle_phi, feature_ptr, p_id_ptr);
-    GetLanes(center_point, obstacle_phi, feature_ptr, p_id_ptr);
-    GetJunctions(center_point, obstacle_phi, feature_ptr, p_id_ptr);
-    GetCrosswalks(center_point, obstacle_phi, feature_ptr, p_id_ptr);
+    std::vector<WorldPolylinePtr> polylines;
+    GetPolylines(center_point, &polylines);
+
+    const PolylineTransform transform(center_point, obstacle_phi);
+    for (size_t count = 0; count < polylines.size(); ++count)
+    {
+        const WorldPolyline& polyline = *polylines[count];
+        std::vector<std::vector<double>> one_polyline;
+        std::vector<double> one_p_id{std::numeric_limits<float>::max(),
+                                     std::numeric_limits<float>::max()};
+        for (int i = 0; i < polyline.num_vectors(); ++i)
+        {
+            const double* points = &polyline.points[4 * i];
+            const double start_x = transform.X(points[0], points[1]);
+            const double start_y = transform.Y(points[0], points[1]);
+            one_p_id[0] = std::min(one_p_id[0], start_x);
+            one_p_id[1] = std::min(one_p_id[1], start_y);
+            // d_s, d_e, attribute
+            one_polyline.push_back({start_x, start_y,
+                                    transform.X(points[2], points[3]),
+                                    transform.Y(points[2], points[3]), 0.0,
+                                    0.0, polyline.attributes[2 * i],
+                                    polyline.attributes[2 * i + 1],
+                                    static_cast<double>(count)});
+        }
+        feature_ptr->push_back(std::move(one_polyline));
+        p_id_ptr->push_back(std::move(one_p_id));
+    }
+    return true;
+}
+
+bool VectorNet::query(const common::PointENU& center_point,
+                      const double obstacle_phi, const int max_num_polylines,
+                      const int max_num_vectors,
+                      PackedPolylines* const polylines_ptr)
+{
+    CHECK_NOTNULL(polylines_ptr);
+    std::vector<WorldPolylinePtr> polylines;
+    GetPolylines(center_point, &polylines);
+
+    const int num_polylines = std::max(
+            std::min(static_cast<int>(polylines.size()), max_num_polylines),
+            0);
+    constexpr int kVectorSize = PackedPolylines::kVectorSize;
+    polylines_ptr->num_polylines = num_polylines;
+    polylines_ptr->max_num_vectors = max_num_vectors;
+    polylines_ptr->vectors.assign(
+            static_cast<size_t>(num_polylines) * max_num_vectors * kVectorSize,
+            0.0f);
+    polylines_ptr->num_vectors.resize(num_polylines);
+    polylines_ptr->p_ids.resize(2 * num_polylines);
+
+    const PolylineTransform transform(center_point, obstacle_phi);
+    for (int count = 0; count < num_polylines; ++count)
+    {
+        const WorldPolyline& polyline = *polylines[count];
+        const int num_vectors = polyline.num_vectors();
+        const double* points = polyline.points.data();
+        const double* attributes = polyline.attributes.data();
+        float* vectors = &polylines_ptr->vectors[static_cast<size_t>(count) *
+                                                 max_num_vectors * kVectorSize];
+        // the min reduction runs over all vectors, same as query() above,
+        // only the vectors which fit the padded size are written
+        double p_id_x = std::numeric_limits<float>::max();
+        double p_id_y = std::numeric_limits<float>::max();
+        for (int i = 0; i < num_vectors; ++i)
+        {
+            const double* point = points + 4 * i;
+            const double start_x = transform.X(point[0], point[1]);
+            const double start_y = transform.Y(point[0], point[1]);
+            p_id_x = std::min(p_id_x, start_x);
+            p_id_y = std::min(p_id_y, start_y);
+            if (i >= max_num_vectors)
+            {
+                continue;
+            }
+            float* vector = vectors + i * kVectorSize;
+            vector[0] = static_cast<float>(start_x);
+            vector[1] = static_cast<float>(start_y);
+            vector[2] = static_cast<float>(transform.X(point[2], point[3]));
+            vector[3] = static_cast<float>(transform.Y(point[2], point[3]));
+            vector[6] = static_cast<float>(attributes[2 * i]);
+            vector[7] = static_cast<float>(attributes[2 * i + 1]);
+            vector[8] = static_cast<float>(count);
+        }
+        polylines_ptr->num_vectors[count] = num_vectors;
+        polylines_ptr->p_ids[2 * count] = static_cast<float>(p_id_x);
+        polylines_ptr->p_ids[2 * count + 1] = static_cast<float>(p_id_y);
+    }
     return true;
 }
 
@@ -169,10 +257,40 @@ bool VectorNet::offline_query(const double obstacle_x, const double obstacle_y,
     return true;
 }
 
+void VectorNet::GetPolylines(const common::PointENU& center_point,
+                             std::vector<WorldPolylinePtr>* const polylines_ptr)
+{
+    {
+        std::lock_guard<std::mutex> lock(polyline_cache_mutex_);
+        if (static_cast<int>(polyline_cache_.size()) >
+            FLAGS_max_num_cached_vectornet_polylines)
+        {
+            polyline_cache_.clear();
+        }
+    }
+    GetRoads(center_point, polylines_ptr);
+    GetLanes(center_point, polylines_ptr);
+    GetJunctions(center_point, polylines_ptr);
+    GetCrosswalks(center_point, polylines_ptr);
+}
+
+VectorNet::WorldPolylinePtr VectorNet::FindPolyline(const std::string& key)
+{
+    std::lock_guard<std::mutex> lock(polyline_cache_mutex_);
+    auto iter = polyline_cache_.find(key);
+    return iter == polyline_cache_.end() ? nullptr : iter->second;
+}
+
+VectorNet::WorldPolylinePtr VectorNet::CachePolyline(
+        const std::string& key, WorldPolylinePtr polyline)
+{
+    std::lock_guard<std::mutex> lock(polyline_cache_mutex_);
+    // another thread may have sampled the same element in the meantime
+    return polyline_cache_.emplace(key, std::move(polyline)).first->second;
+}
+
 void VectorNet::GetRoads(const common::PointENU& center_point,
-                         const double obstacle_phi,
-                         FeatureVector* const feature_ptr,
-                         PidVector* const p_id_ptr)
+                         std::vector<WorldPolylinePtr>* const polylines_ptr)
 {
     std::vector<apollo::hdmap::RoadInfoConstPtr> roads;
     apollo::hdmap::HDMapUtil::BaseMap().GetRoads(center_point,
@@ -180,44 +298,50 @@ void VectorNet::GetRoads(const common::PointENU& center_point,
 
     for (const auto& road : roads)
     {
-        for (const auto& section : road->road().section())
+        for (int i = 0; i < road->road().section_size(); ++i)
         {
-            for (const auto& edge : section.boundary().outer_polygon().edge())
+            const auto& edges =
+                    road->road().section(i).boundary().outer_polygon();
+            for (int j = 0; j < edges.edge_size(); ++j)
             {
-                std::vector<std::vector<double>> one_polyline;
-                std::vector<double> one_p_id{std::numeric_limits<float>::max(),
-                                             std::numeric_limits<float>::max()};
-                double start_length = 0;
-                BOUNDARY_TYPE bound_type = UNKNOW;
-                if (edge.type() == hdmap::BoundaryEdge::LEFT_BOUNDARY)
-                {
-                    bound_type = LEFT_BOUNDARY;
-                }
-                else if (edge.type() == hdmap::BoundaryEdge::RIGHT_BOUNDARY)
-                {
-                    bound_type = RIGHT_BOUNDARY;
-                }
-                else if (edge.type() == hdmap::BoundaryEdge::NORMAL)
-                {
-                    bound_type = NORMAL;
-                }
-                else
-                {
-                    bound_type = UNKNOW;
-                }
-
-                for (const auto& segment : edge.curve().segment())
+                const std::string key = "road_" + road->id().id() + "_" +
+                                        std::to_string(i) + "_" +
+                                        std::to_string(j);
+                WorldPolylinePtr cached = FindPolyline(key);
+                if (cached == nullptr)
                 {
-                    GetOnePolyline(segment.line_segment().point(),
-                                   &start_length, center_point, obstacle_phi,
-                                   ROAD, bound_type, count_, &one_polyline,
-                                   &one_p_id);
+                    const auto& edge = edges.edge(j);
+                    auto one_polyline = std::make_shared<WorldPolyline>();
+                    double start_length = 0;
+                    BOUNDARY_TYPE bound_type = UNKNOW;
+                    if (edge.type() == hdmap::BoundaryEdge::LEFT_BOUNDARY)
+                    {
+                        bound_type = LEFT_BOUNDARY;
+                    }
+                    else if (edge.type() == hdmap::BoundaryEdge::RIGHT_BOUNDARY)
+                    {
+                        bound_type = RIGHT_BOUNDARY;
+                    }
+                    else if (edge.type() == hdmap::BoundaryEdge::NORMAL)
+                    {
+                        bound_type = NORMAL;
+                    }
+                    else
+                    {
+                        bound_type = UNKNOW;
+                    }
+
+                    for (const auto& segment : edge.curve().segment())
+                    {
+                        GetOnePolyline(segment.line_segment().point(),
+                                       &start_length, ROAD, bound_type,
+                                       one_polyline.get());
+                    }
+                    cached = CachePolyline(key, std::move(one_polyline));
                 }
-                if (one_polyline.size() == 0) continue;
+                if (cached->num_vectors() == 0) continue;
 
-                feature_ptr->push_back(std::move(one_polyline));
-                p_id_ptr->push_back(std::move(one_p_id));
-                ++count_;
+                polylines_ptr->push_back(std::move(cached));
             }
         }
     }
@@ -272,9 +396,7 @@ void VectorNet::GetLaneQueue(
 }
 
 void VectorNet::GetLanes(const common::PointENU& center_point,
-                         const double obstacle_phi,
-                         FeatureVector* const feature_ptr,
-                         PidVector* const p_id_ptr)
+                         std::vector<WorldPolylinePtr>* const polylines_ptr)
 {
     std::vector<apollo::hdmap::LaneInfoConstPtr> lanes;
     apollo::hdmap::HDMapUtil::BaseMap().GetLanes(center_point,
@@ -285,104 +407,115 @@ void VectorNet::GetLanes(const common::PointENU& center_point,
 
     for (const auto& lane_deque : lane_deque_vector)
     {
-        // Draw lane's left_boundary
-        std::vector<std::vector<double>> left_polyline;
-        std::vector<double> left_p_id{std::numeric_limits<float>::max(),
-                                      std::numeric_limits<float>::max()};
-        double start_length = 0;
+        // the boundaries are sampled along the whole chain of lanes, so the
+        // chain is the cache key
+        std::string key;
         for (const auto& lane : lane_deque)
         {
-            std::cout << lane->lane().id().id() << " ";
-            // if (lane->lane().left_boundary().virtual_()) continue;
-            for (const auto& segment :
-                 lane->lane().left_boundary().curve().segment())
+            key += lane->lane().id().id() + " ";
+        }
+
+        // Draw lane's left_boundary
+        WorldPolylinePtr left_polyline = FindPolyline("lane_left_" + key);
+        if (left_polyline == nullptr)
+        {
+            auto one_polyline = std::make_shared<WorldPolyline>();
+            double start_length = 0;
+            for (const auto& lane : lane_deque)
             {
-                auto bound_type =
-                        lane->lane().left_boundary().boundary_type(0).types(0);
-                GetOnePolyline(segment.line_segment().point(), &start_length,
-                               center_point, obstacle_phi,
-                               lane_attr_map.at(bound_type), LEFT_BOUNDARY,
-                               count_, &left_polyline, &left_p_id);
+                // if (lane->lane().left_boundary().virtual_()) continue;
+                for (const auto& segment :
+                     lane->lane().left_boundary().curve().segment())
+                {
+                    auto bound_type = lane->lane()
+                                              .left_boundary()
+                                              .boundary_type(0)
+                                              .types(0);
+                    GetOnePolyline(segment.line_segment().point(),
+                                   &start_length, lane_attr_map.at(bound_type),
+                                   LEFT_BOUNDARY, one_polyline.get());
+                }
             }
+            left_polyline =
+                    CachePolyline("lane_left_" + key, std::move(one_polyline));
         }
 
-        if (left_polyline.size() < 2) continue;
-        feature_ptr->push_back(std::move(left_polyline));
-        p_id_ptr->push_back(std::move(left_p_id));
-        ++count_;
+        if (left_polyline->num_vectors() < 2) continue;
+        polylines_ptr->push_back(std::move(left_polyline));
 
-        std::vector<std::vector<double>> right_polyline;
-        std::vector<double> right_p_id{std::numeric_limits<float>::max(),
-                                       std::numeric_limits<float>::max()};
-        start_length = 0;
         // Draw lane's right_boundary
-        for (const auto& lane : lane_deque)
+        WorldPolylinePtr right_polyline = FindPolyline("lane_right_" + key);
+        if (right_polyline == nullptr)
         {
-            // if (lane->lane().right_boundary().virtual_()) continue;
-            for (const auto& segment :
-                 lane->lane().right_boundary().curve().segment())
+            auto one_polyline = std::make_shared<WorldPolyline>();
+            double start_length = 0;
+            for (const auto& lane : lane_deque)
             {
-                auto bound_type =
-                        lane->lane().left_boundary().boundary_type(0).types(0);
-                GetOnePolyline(segment.line_segment().point(), &start_length,
-                               center_point, obstacle_phi,
-                               lane_attr_map.at(bound_type), RIGHT_BOUNDARY,
-                               count_, &right_polyline, &right_p_id);
+                // if (lane->lane().right_boundary().virtual_()) continue;
+                for (const auto& segment :
+                     lane->lane().right_boundary().curve().segment())
+                {
+                    auto bound_type = lane->lane()
+                                              .left_boundary()
+                                              .boundary_type(0)
+                                              .types(0);
+                    GetOnePolyline(segment.line_segment().point(),
+                                   &start_length, lane_attr_map.at(bound_type),
+                                   RIGHT_BOUNDARY, one_polyline.get());
+                }
             }
+            right_polyline =
+                    CachePolyline("lane_right_" + key, std::move(one_polyline));
         }
 
-        if (right_polyline.size() < 2) continue;
-        feature_ptr->push_back(std::move(right_polyline));
-        p_id_ptr->push_back(std::move(right_p_id));
-        ++count_;
+        if (right_polyline->num_vectors() < 2) continue;
+        polylines_ptr->push_back(std::move(right_polyline));
     }
 }
 
 void VectorNet::GetJunctions(const common::PointENU& center_point,
-                             const double obstacle_phi,
-                             FeatureVector* const feature_ptr,
-                             PidVector* const p_id_ptr)
+                             std::vector<WorldPolylinePtr>* const polylines_ptr)
 {
     std::vector<apollo::hdmap::JunctionInfoConstPtr> junctions;
     apollo::hdmap::HDMapUtil::BaseMap().GetJunctions(
             center_point, FLAGS_road_distance, &junctions);
     for (const auto& junction : junctions)
     {
-        std::vector<std::vector<double>> one_polyline;
-        std::vector<double> one_p_id{std::numeric_limits<float>::max(),
-                                     std::numeric_limits<float>::max()};
-        double start_length = 0;
-        GetOnePolyline(junction->junction().polygon().point(), &start_length,
-                       center_point, obstacle_phi, JUNCTION, UNKNOW, count_,
-                       &one_polyline, &one_p_id);
-
-        feature_ptr->push_back(std::move(one_polyline));
-        p_id_ptr->push_back(std::move(one_p_id));
-        ++count_;
+        const std::string key = "junction_" + junction->id().id();
+        WorldPolylinePtr cached = FindPolyline(key);
+        if (cached == nullptr)
+        {
+            auto one_polyline = std::make_shared<WorldPolyline>();
+            double start_length = 0;
+            GetOnePolyline(junction->junction().polygon().point(),
+                           &start_length, JUNCTION, UNKNOW, one_polyline.get());
+            cached = CachePolyline(key, std::move(one_polyline));
+        }
+        polylines_ptr->push_back(std::move(cached));
     }
 }
 
-void VectorNet::GetCrosswalks(const common::PointENU& center_point,
-                              const double obstacle_phi,
-                              FeatureVector* const feature_ptr,
-                              PidVector* const p_id_ptr)
+void VectorNet::GetCrosswalks(
+        const common::PointENU& center_point,
+        std::vector<WorldPolylinePtr>* const polylines_ptr)
 {
     std::vector<apollo::hdmap::CrosswalkInfoConstPtr> crosswalks;
     apollo::hdmap::HDMapUtil::BaseMap().GetCrosswalks(
             center_point, FLAGS_road_distance, &crosswalks);
     for (const auto& crosswalk : crosswalks)
     {
-        std::vector<std::vector<double>> one_polyline;
-        std::vector<double> one_p_id{std::numeric_limits<float>::max(),
-                                     std::numeric_limits<float>::max()};
-        double start_length = 0;
-        GetOnePolyline(crosswalk->crosswalk().polygon().point(), &start_length,
-                       center_point, obstacle_phi, CROSSWALK, UNKNOW, count_,
-                       &one_polyline, &one_p_id);
-
-        feature_ptr->push_back(std::move(one_polyline));
-        p_id_ptr->push_back(std::move(one_p_id));
-        ++count_;
+        const std::string key = "crosswalk_" + crosswalk->id().id();
+        WorldPolylinePtr cached = FindPolyline(key);
+        if (cached == nullptr)
+        {
+            auto one_polyline = std::make_shared<WorldPolyline>();
+            double start_length = 0;
+            GetOnePolyline(crosswalk->crosswalk().polygon().point(),
+                           &start_length, CROSSWALK, UNKNOW,
+                           one_polyline.get());
+            cached = CachePolyline(key, std::move(one_polyline));
+        }
+        polylines_ptr->push_back(std::move(cached));
     }
 }
 }  // namespace prediction
@@ -18,7 +18,10 @@
 
 #include <deque>
 #include <map>
+#include <memory>
+#include <mutex>
 #include <string>
+#include <unordered_map>
 #include <vector>
 
 #include "modules/common/math/linear_interpolation.h"
@@ -56,6 +59,24 @@ enum BOUNDARY_TYPE
     RIGHT_BOUNDARY,
 };
 
+/**
+ * @brief Map polylines around an obstacle in one zero padded float buffer of
+ *        shape [num_polylines, max_num_vectors, kVectorSize], which can be
+ *        wrapped by a tensor without copying.
+ */
+struct PackedPolylines
+{
+    static constexpr int kVectorSize = 9;
+
+    int num_polylines = 0;
+    int max_num_vectors = 0;
+    std::vector<float> vectors;
+    // number of vectors of every polyline before padding or truncation
+    std::vector<int> num_vectors;
+    // 2 per polyline, the minimal x and y of the vectors' start points
+    std::vector<float> p_ids;
+};
+
 class VectorNet
 {
 public:
@@ -66,6 +87,18 @@ public:
     bool query(const common::PointENU& center_point, const double obstacle_phi,
                FeatureVector* const feature_ptr, PidVector* const p_id_ptr);
 
+    /**
+     * @brief Same polylines as query(), without the nested vectors
+     * @param Center point
+     * @param Heading of the obstacle
+     * @param Maximal number of polylines, the rest is dropped
+     * @param Number of vectors every polyline is padded or truncated to
+     * @param Output polylines
+     */
+    bool query(const common::PointENU& center_point, const double obstacle_phi,
+               const int max_num_polylines, const int max_num_vectors,
+               PackedPolylines* const polylines_ptr);
+
     bool offline_query(const double obstacle_x, const double obstacle_y,
                        const double obstacle_phi);
 
@@ -104,34 +137,54 @@ private:
             {hdmap::LaneBoundaryType::CURB, LANE_CURB},
     };
 
+    /**
+     * @brief Sampled polyline of one map element in world coordinates. The
+     *        sampling only depends on the map, so it is done once per element
+     *        and shared by all obstacles.
+     */
+    struct WorldPolyline
+    {
+        // 4 per vector: start x, start y, end x, end y
+        std::vector<double> points;
+        // 2 per vector: attribute, boundary type
+        std::vector<double> attributes;
+
+        int num_vectors() const
+        {
+            return static_cast<int>(attributes.size() / 2);
+        }
+    };
+    using WorldPolylinePtr = std::shared_ptr<const WorldPolyline>;
+
     template <typename Points>
     void GetOnePolyline(const Points& points, double* start_length,
-                        const common::PointENU& center_point,
-                        const double obstacle_phi, ATTRIBUTE_TYPE attr_type,
-                        BOUNDARY_TYPE bound_type, const int count,
-                        std::vector<std::vector<double>>* const one_polyline,
-                        std::vector<double>* const one_p_id);
+                        ATTRIBUTE_TYPE attr_type, BOUNDARY_TYPE bound_type,
+                        WorldPolyline* const one_polyline) const;
+
+    void GetPolylines(const common::PointENU& center_point,
+                      std::vector<WorldPolylinePtr>* const polylines_ptr);
 
     void GetRoads(const common::PointENU& center_point,
-                  const double obstacle_phi, FeatureVector* const feature_ptr,
-                  PidVector* const p_id_ptr);
+                  std::vector<WorldPolylinePtr>* const polylines_ptr);
 
     void GetLaneQueue(const std::vector<hdmap::LaneInfoConstPtr>& lanes,
                       std::vector<std::deque<hdmap::LaneInfoConstPtr>>* const
                               lane_deque_ptr);
 
     void GetLanes(const common::PointENU& center_point,
-                  const double obstacle_phi, FeatureVector* const feature_ptr,
-                  PidVector* const p_id_ptr);
+                  std::vector<WorldPolylinePtr>* const polylines_ptr);
     void GetJunctions(const common::PointENU& center_point,
-                      const double obstacle_phi,
-                      FeatureVector* const feature_ptr,
-                      PidVector* const p_id_ptr);
+                      std::vector<WorldPolylinePtr>* const polylines_ptr);
     void GetCrosswalks(const common::PointENU& center_point,
-                       const double obstacle_phi,
-                       FeatureVector* const feature_ptr,
-                       PidVector* const p_id_ptr);
-    int count_ = 0;
+                       std::vector<WorldPolylinePtr>* const polylines_ptr);
+
+    WorldPolylinePtr FindPolyline(const std::string& key);
+
+    WorldPolylinePtr CachePolyline(const std::string& key,
+                                   WorldPolylinePtr polyline);
+
+    std::mutex polyline_cache_mutex_;
+    std::unordered_map<std::string, WorldPolylinePtr> polyline_cache_;
 };
 
 }  // namespace prediction
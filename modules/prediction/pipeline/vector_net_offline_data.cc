@@ -16,6 +16,7 @@
 
 #if 0
 #include <fstream>
+#include "modules/prediction/common/prediction_thread_pool.h"
 #include "modules/prediction/pipeline/vector_net.h"
 
 using apollo::prediction::VectorNet;
@@ -32,14 +33,17 @@ int main(int argc, char* argv[]) {
     AERROR << "Failed to parse file: " << FLAGS_world_coordinate_file;
     return -1;
   }
-  for (auto pose : world_coords.pose()) {
-    double x = pose.x();
-    double y = pose.y();
-    double phi = pose.phi();
-    std::string _file_name = \
-        FLAGS_prediction_target_dir + "/" + pose.id() + ".pb.txt";
-    vector_net.offline_query(x, y, phi, _file_name);
-  }
+  // every pose is written to its own file, the map polylines are cached
+  // by vector_net across threads
+  apollo::prediction::PredictionThreadPool::ParallelFor(
+      world_coords.pose_size(),
+      [&](size_t i) {
+        const auto& pose = world_coords.pose(static_cast<int>(i));
+        std::string _file_name = \
+            FLAGS_prediction_target_dir + "/" + pose.id() + ".pb.txt";
+        vector_net.offline_query(pose.x(), pose.y(), pose.phi(), _file_name);
+      },
+      1);
 
   return 0;
 }
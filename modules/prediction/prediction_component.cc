@@ -266,7 +266,7 @@ bool PredictionComponent::ContainerSubmoduleProcess(
 #endif
 
 bool PredictionComponent::PredictionEndToEndProc(
-        const std::shared_ptr<perception::PerceptionObstacles>&
+        const std::shared_ptr<const perception::PerceptionObstacles>&
                 perception_obstacles,
         const std::shared_ptr<localization::LocalizationEstimate>&
                 ptr_localization_msg,
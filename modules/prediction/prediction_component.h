@@ -67,7 +67,7 @@ public:
     // override;
 
     bool PredictionEndToEndProc(
-            const std::shared_ptr<perception::PerceptionObstacles>
+            const std::shared_ptr<const perception::PerceptionObstacles>
                     &perception_obstacles,
             const std::shared_ptr<localization::LocalizationEstimate>
                     &ptr_localization_msg,
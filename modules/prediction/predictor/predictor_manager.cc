@@ -16,8 +16,9 @@
 
 #include "modules/prediction/predictor/predictor_manager.h"
 
-#include <list>
 #include <unordered_map>
+#include <utility>
+#include <vector>
 
 #include "modules/prediction/common/feature_output.h"
 #include "modules/prediction/common/prediction_constants.h"
@@ -45,21 +46,6 @@ namespace
 {
 using apollo::perception::PerceptionObstacle;
 using apollo::perception::PerceptionObstacles;
-using IdObstacleListMap = std::unordered_map<int, std::list<Obstacle*>>;
-
-void GroupObstaclesByObstacleId(const int obstacle_id,
-                                ObstaclesContainer* const obstacles_container,
-                                IdObstacleListMap* const id_obstacle_map)
-{
-    Obstacle* obstacle_ptr = obstacles_container->GetObstacle(obstacle_id);
-    if (obstacle_ptr == nullptr)
-    {
-        AERROR << "Null obstacle [" << obstacle_id << "] found";
-        return;
-    }
-    int id_mod = obstacle_id % FLAGS_max_thread_num;
-    (*id_obstacle_map)[id_mod].push_back(obstacle_ptr);
-}
 
 }  // namespace
 
@@ -221,7 +207,7 @@ void PredictorManager::PredictObstaclesInParallel(
         int id = perception_obstacle.id();
         id_prediction_obstacle_map[id] = std::make_shared<PredictionObstacle>();
     }
-    IdObstacleListMap id_obstacle_map;
+    std::vector<std::pair<Obstacle*, PredictionObstacle*>> obstacles;
     for (const auto& perception_obstacle :
          perception_obstacles.perception_obstacle())
     {
@@ -237,21 +223,18 @@ void PredictorManager::PredictObstaclesInParallel(
         }
         else
         {
-            GroupObstaclesByObstacleId(id, obstacles_container,
-                                       &id_obstacle_map);
-        }
-    }
-    PredictionThreadPool::ForEach(
-            id_obstacle_map.begin(), id_obstacle_map.end(),
-            [&](IdObstacleListMap::iterator::value_type& obstacles_iter) {
-                for (auto obstacle_ptr : obstacles_iter.second)
-                {
-                    int id = obstacle_ptr->id();
-                    PredictObstacle(adc_trajectory_container, obstacle_ptr,
-                                    obstacles_container,
-                                    id_prediction_obstacle_map[id].get());
-                }
-            });
+            obstacles.emplace_back(obstacle,
+                                   id_prediction_obstacle_map[id].get());
+        }
+    }
+    // one obstacle per task, prediction time differs a lot between obstacles
+    PredictionThreadPool::ParallelFor(
+            obstacles.size(),
+            [&](size_t i) {
+                PredictObstacle(adc_trajectory_container, obstacles[i].first,
+                                obstacles_container, obstacles[i].second);
+            },
+            1);
     for (const PerceptionObstacle& perception_obstacle :
          perception_obstacles.perception_obstacle())
     {
@@ -293,6 +276,15 @@ void PredictorManager::PredictObstacle(
         RunEmptyPredictor(adc_trajectory_container, obstacle,
                           obstacles_container);
     }
+    else if (obstacle->evaluation_path() ==
+             Obstacle::EvaluationPath::PREDICTOR_ONLY)
+    {
+        // the evaluator was skipped to meet the evaluation deadline, the
+        // configured predictor may rely on its output
+        ADEBUG << "Unevaluated obstacle [" << obstacle->id() << "]";
+        RunFreeMovePredictor(adc_trajectory_container, obstacle,
+                             obstacles_container);
+    }
     else
     {
         switch (obstacle->type())
@@ -661,6 +653,19 @@ void PredictorManager::RunDefaultPredictor(
     predictor->Predict(adc_trajectory_container, obstacle, obstacles_container);
 }
 
+void PredictorManager::RunFreeMovePredictor(
+        const ADCTrajectoryContainer* adc_trajectory_container,
+        Obstacle* obstacle, ObstaclesContainer* obstacles_container)
+{
+    Predictor* predictor = GetPredictor(ObstacleConf::FREE_MOVE_PREDICTOR);
+    if (predictor == nullptr)
+    {
+        AERROR << "Nullptr found for obstacle [" << obstacle->id() << "]";
+        return;
+    }
+    predictor->Predict(adc_trajectory_container, obstacle, obstacles_container);
+}
+
 void PredictorManager::RunEmptyPredictor(
         const ADCTrajectoryContainer* adc_trajectory_container,
         Obstacle* obstacle, ObstaclesContainer* obstacles_container)
@@ -145,6 +145,10 @@ private:
             const ADCTrajectoryContainer* adc_trajectory_container,
             Obstacle* obstacle, ObstaclesContainer* obstacles_container);
 
+    void RunFreeMovePredictor(
+            const ADCTrajectoryContainer* adc_trajectory_container,
+            Obstacle* obstacle, ObstaclesContainer* obstacles_container);
+
     bool is_same_trajectory(const prediction::Trajectory& left,
                             const prediction::Trajectory& right);
 
@@ -32,3 +32,20 @@ DEFINE_bool(enable_change_lane_in_result, true,
 
 DEFINE_uint32(routing_response_history_interval_ms, 1000,
               "ms, emit routing resposne for this time interval");
+
+DEFINE_bool(enable_routing_landmark_heuristic, true,
+            "use the precomputed landmark (ALT) lower bound as the A* "
+            "heuristic when the index matches the topo graph");
+
+DEFINE_int32(routing_landmark_num, 16,
+             "number of landmarks used to build the routing landmark index");
+
+DEFINE_bool(routing_build_landmark_index_on_start, true,
+            "build and save the landmark index when loading the topo graph "
+            "if no valid index file is found next to it");
+
+DEFINE_int32(routing_batch_thread_num, 0,
+             "worker threads for batch routing, 0 means hardware concurrency");
+
+DEFINE_string(routing_batch_service_name, "/apollo/routing/batch",
+              "cyber service name of the batch routing server");
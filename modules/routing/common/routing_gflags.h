@@ -24,3 +24,10 @@ DECLARE_string(routing_node_name);
 DECLARE_double(min_length_for_lane_change);
 DECLARE_bool(enable_change_lane_in_result);
 DECLARE_uint32(routing_response_history_interval_ms);
+
+DECLARE_bool(enable_routing_landmark_heuristic);
+DECLARE_int32(routing_landmark_num);
+DECLARE_bool(routing_build_landmark_index_on_start);
+
+DECLARE_int32(routing_batch_thread_num);
+DECLARE_string(routing_batch_service_name);
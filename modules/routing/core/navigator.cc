@@ -16,6 +16,8 @@
 
 #include "modules/routing/core/navigator.h"
 
+#include <utility>
+
 #include "cyber/common/file.h"
 #include "modules/routing/common/routing_gflags.h"
 #include "modules/routing/graph/sub_topo_graph.h"
@@ -124,8 +126,8 @@ Navigator::Navigator(const std::string& topo_file_path)
               << topo_file_path;
         return;
     }
+    InitLandmarkIndex(topo_file_path);
     black_list_generator_.reset(new BlackListRangeGenerator);
-    result_generator_.reset(new ResultGenerator);
     is_ready_ = true;
     AINFO << "The navigator is ready.";
 }
@@ -134,20 +136,46 @@ Navigator::~Navigator() {}
 
 bool Navigator::IsReady() const { return is_ready_; }
 
-void Navigator::Clear() { topo_range_manager_.Clear(); }
+void Navigator::InitLandmarkIndex(const std::string& topo_file_path)
+{
+    if (!FLAGS_enable_routing_landmark_heuristic)
+    {
+        return;
+    }
+    const std::string index_file_path =
+            TopoLandmarkIndex::IndexFilePath(topo_file_path);
+    std::unique_ptr<TopoLandmarkIndex> landmark_index(new TopoLandmarkIndex());
+    if (!landmark_index->Load(index_file_path, *graph_))
+    {
+        if (!FLAGS_routing_build_landmark_index_on_start ||
+            !landmark_index->Build(*graph_, FLAGS_routing_landmark_num))
+        {
+            AWARN << "Routing landmark index is not available, use anchor "
+                     "point distance as heuristic.";
+            return;
+        }
+        if (!landmark_index->Save(index_file_path))
+        {
+            AWARN << "Failed to save routing landmark index to "
+                  << index_file_path;
+        }
+    }
+    landmark_index_ = std::move(landmark_index);
+}
 
 bool Navigator::Init(const RoutingRequest& request, const TopoGraph* graph,
                      std::vector<const TopoNode*>* const way_nodes,
-                     std::vector<double>* const way_s)
+                     std::vector<double>* const way_s,
+                     TopoRangeManager* const topo_range_manager) const
 {
-    Clear();
+    topo_range_manager->Clear();
     if (!GetWayNodes(request, graph_.get(), way_nodes, way_s))
     {
         AERROR << "Failed to find search terminal point in graph!";
         return false;
     }
     black_list_generator_->GenerateBlackMapFromRequest(request, graph_.get(),
-                                                       &topo_range_manager_);
+                                                       topo_range_manager);
     return true;
 }
 
@@ -178,10 +206,12 @@ bool Navigator::MergeRoute(
 bool Navigator::SearchRouteByStrategy(
         const TopoGraph* graph, const std::vector<const TopoNode*>& way_nodes,
         const std::vector<double>& way_s,
+        const TopoRangeManager& topo_range_manager,
         std::vector<NodeWithRange>* const result_nodes) const
 {
     std::unique_ptr<Strategy> strategy_ptr;
-    strategy_ptr.reset(new AStarStrategy(FLAGS_enable_change_lane_in_result));
+    strategy_ptr.reset(new AStarStrategy(FLAGS_enable_change_lane_in_result,
+                                         landmark_index_.get()));
 
     result_nodes->clear();
     std::vector<NodeWithRange> node_vec;
@@ -192,7 +222,7 @@ bool Navigator::SearchRouteByStrategy(
         double way_start_s = way_s[i - 1];
         double way_end_s = way_s[i];
 
-        TopoRangeManager full_range_manager = topo_range_manager_;
+        TopoRangeManager full_range_manager = topo_range_manager;
         black_list_generator_->AddBlackMapFromTerminal(way_start, way_end,
                                                        way_start_s, way_end_s,
                                                        &full_range_manager);
@@ -236,6 +266,19 @@ bool Navigator::SearchRouteByStrategy(
 
 bool Navigator::SearchRoute(const RoutingRequest& request,
                             RoutingResponse* const response)
+{
+    std::vector<NodeWithRange> result_nodes;
+    if (!SearchRoute(request, response, &result_nodes))
+    {
+        return false;
+    }
+    _result_nodes = std::move(result_nodes);
+    return true;
+}
+
+bool Navigator::SearchRoute(
+        const RoutingRequest& request, RoutingResponse* const response,
+        std::vector<NodeWithRange>* const result_nodes) const
 {
     if (!ShowRequestInfo(request, graph_.get()))
     {
@@ -253,7 +296,8 @@ bool Navigator::SearchRoute(const RoutingRequest& request,
     }
     std::vector<const TopoNode*> way_nodes;
     std::vector<double> way_s;
-    if (!Init(request, graph_.get(), &way_nodes, &way_s))
+    TopoRangeManager topo_range_manager;
+    if (!Init(request, graph_.get(), &way_nodes, &way_s, &topo_range_manager))
     {
         SetErrorCode(ErrorCode::ROUTING_ERROR_NOT_READY,
                      "Failed to initialize navigator!",
@@ -261,26 +305,28 @@ bool Navigator::SearchRoute(const RoutingRequest& request,
         return false;
     }
 
-    std::vector<NodeWithRange> result_nodes;
-    if (!SearchRouteByStrategy(graph_.get(), way_nodes, way_s, &result_nodes))
+    if (!SearchRouteByStrategy(graph_.get(), way_nodes, way_s,
+                               topo_range_manager, result_nodes))
     {
         SetErrorCode(ErrorCode::ROUTING_ERROR_RESPONSE,
                      "Failed to find route with request!",
                      response->mutable_status());
         return false;
     }
-    if (result_nodes.empty())
+    if (result_nodes->empty())
     {
         SetErrorCode(ErrorCode::ROUTING_ERROR_RESPONSE,
                      "Failed to result nodes!", response->mutable_status());
         return false;
     }
-    result_nodes.front().SetStartS(request.waypoint().begin()->s());
-    result_nodes.back().SetEndS(request.waypoint().rbegin()->s());
+    result_nodes->front().SetStartS(request.waypoint().begin()->s());
+    result_nodes->back().SetEndS(request.waypoint().rbegin()->s());
 
-    if (!result_generator_->GeneratePassageRegion(
-                graph_->MapVersion(), request, result_nodes,
-                topo_range_manager_, response))
+    // ResultGenerator keeps no state, a local one keeps this method reentrant
+    ResultGenerator result_generator;
+    if (!result_generator.GeneratePassageRegion(
+                graph_->MapVersion(), request, *result_nodes,
+                topo_range_manager, response))
     {
         SetErrorCode(ErrorCode::ROUTING_ERROR_RESPONSE,
                      "Failed to generate passage regions based on result lanes",
@@ -289,9 +335,7 @@ bool Navigator::SearchRoute(const RoutingRequest& request,
     }
     SetErrorCode(ErrorCode::OK, "Success!", response->mutable_status());
 
-    // PrintDebugData(result_nodes);
-
-    _result_nodes = result_nodes;
+    // PrintDebugData(*result_nodes);
     return true;
 }
 
@@ -22,6 +22,7 @@
 
 #include "modules/routing/core/black_list_range_generator.h"
 #include "modules/routing/core/result_generator.h"
+#include "modules/routing/graph/topo_landmark_index.h"
 
 namespace apollo
 {
@@ -38,30 +39,38 @@ public:
     bool SearchRoute(const RoutingRequest& request,
                      RoutingResponse* const response);
 
+    /**
+     * @brief search route without touching any member state, so that several
+     * requests can be solved concurrently against the same topo graph.
+     */
+    bool SearchRoute(const RoutingRequest& request,
+                     RoutingResponse* const response,
+                     std::vector<NodeWithRange>* const result_nodes) const;
+
 private:
     bool Init(const RoutingRequest& request, const TopoGraph* graph,
               std::vector<const TopoNode*>* const way_nodes,
-              std::vector<double>* const way_s);
-
-    void Clear();
+              std::vector<double>* const way_s,
+              TopoRangeManager* const topo_range_manager) const;
 
     bool SearchRouteByStrategy(
             const TopoGraph* graph,
             const std::vector<const TopoNode*>& way_nodes,
             const std::vector<double>& way_s,
+            const TopoRangeManager& topo_range_manager,
             std::vector<NodeWithRange>* const result_nodes) const;
 
+    void InitLandmarkIndex(const std::string& topo_file_path);
+
     bool MergeRoute(const std::vector<NodeWithRange>& node_vec,
                     std::vector<NodeWithRange>* const result_node_vec) const;
 
 private:
     bool is_ready_ = false;
     std::unique_ptr<TopoGraph> graph_;
-
-    TopoRangeManager topo_range_manager_;
+    std::unique_ptr<TopoLandmarkIndex> landmark_index_;
 
     std::unique_ptr<BlackListRangeGenerator> black_list_generator_;
-    std::unique_ptr<ResultGenerator> result_generator_;
 
 public:
     //
@@ -121,5 +121,10 @@ void TopoGraph::GetNodesByRoadId(
     }
 }
 
+const std::vector<std::shared_ptr<TopoNode> >& TopoGraph::TopoNodes() const
+{
+    return topo_nodes_;
+}
+
 }  // namespace routing
 }  // namespace apollo
@@ -43,6 +43,7 @@ public:
     void GetNodesByRoadId(
             const std::string& road_id,
             std::unordered_set<const TopoNode*>* const node_in_road) const;
+    const std::vector<std::shared_ptr<TopoNode> >& TopoNodes() const;
 
 private:
     void Clear();
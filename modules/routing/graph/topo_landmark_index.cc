@@ -0,0 +1,401 @@
+/******************************************************************************
+ * Copyright 2023 The Apollo Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *****************************************************************************/
+
+#include "modules/routing/graph/topo_landmark_index.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <fstream>
+#include <functional>
+#include <limits>
+#include <queue>
+#include <utility>
+
+namespace apollo
+{
+namespace routing
+{
+namespace
+{
+constexpr uint32_t kIndexMagic = 0x4c4d4b32;  // "LMK2"
+constexpr float kInfinity = std::numeric_limits<float>::infinity();
+
+void WriteString(const std::string& str, std::ofstream* const out)
+{
+    const uint32_t size = static_cast<uint32_t>(str.size());
+    out->write(reinterpret_cast<const char*>(&size), sizeof(size));
+    out->write(str.data(), size);
+}
+
+bool ReadString(std::ifstream* const in, std::string* const str)
+{
+    uint32_t size = 0;
+    if (!in->read(reinterpret_cast<char*>(&size), sizeof(size)))
+    {
+        return false;
+    }
+    str->resize(size);
+    return static_cast<bool>(in->read(&(*str)[0], size));
+}
+
+}  // namespace
+
+double TopoLandmarkIndex::EdgeCost(const TopoEdge* edge)
+{
+    double cost = edge->Cost() + edge->ToNode()->Cost();
+    if (edge->Type() != TopoEdgeType::TET_FORWARD)
+    {
+        cost -= (edge->FromNode()->Cost() + edge->ToNode()->Cost()) / 2;
+    }
+    return cost;
+}
+
+std::string TopoLandmarkIndex::IndexFilePath(const std::string& topo_file_path)
+{
+    const auto pos = topo_file_path.find_last_of('.');
+    const auto slash_pos = topo_file_path.find_last_of('/');
+    if (pos == std::string::npos ||
+        (slash_pos != std::string::npos && pos < slash_pos))
+    {
+        return topo_file_path + "_landmark.bin";
+    }
+    return topo_file_path.substr(0, pos) + "_landmark.bin";
+}
+
+void TopoLandmarkIndex::Clear()
+{
+    map_version_.clear();
+    lane_ids_.clear();
+    landmark_lane_ids_.clear();
+    node_index_map_.clear();
+    from_landmark_.clear();
+    to_landmark_.clear();
+}
+
+void TopoLandmarkIndex::BindNodes(const TopoGraph& graph)
+{
+    node_index_map_.clear();
+    node_index_map_.reserve(lane_ids_.size());
+    for (size_t i = 0; i < lane_ids_.size(); ++i)
+    {
+        const auto* node = graph.GetNode(lane_ids_[i]);
+        if (node != nullptr)
+        {
+            node_index_map_[node] = static_cast<int>(i);
+        }
+    }
+}
+
+int TopoLandmarkIndex::NodeIndex(const TopoNode* node) const
+{
+    const auto iter = node_index_map_.find(node->OriginNode());
+    if (iter == node_index_map_.end())
+    {
+        return -1;
+    }
+    return iter->second;
+}
+
+void TopoLandmarkIndex::RunDijkstra(const TopoGraph& graph, int landmark,
+                                    bool forward,
+                                    std::vector<float>* const dist) const
+{
+    const auto& nodes = graph.TopoNodes();
+    dist->assign(nodes.size(), kInfinity);
+
+    using QueueItem = std::pair<double, int>;
+    std::priority_queue<QueueItem, std::vector<QueueItem>,
+                        std::greater<QueueItem>>
+            open_queue;
+    (*dist)[landmark] = 0.0f;
+    open_queue.emplace(0.0, landmark);
+    while (!open_queue.empty())
+    {
+        const auto top = open_queue.top();
+        open_queue.pop();
+        const int index = top.second;
+        if (top.first > (*dist)[index])
+        {
+            continue;
+        }
+        const auto* node = nodes[index].get();
+        const auto& edges =
+                forward ? node->OutToAllEdge() : node->InFromAllEdge();
+        for (const auto* edge : edges)
+        {
+            const auto* next = forward ? edge->ToNode() : edge->FromNode();
+            const int next_index = NodeIndex(next);
+            if (next_index < 0)
+            {
+                continue;
+            }
+            const double next_dist = top.first + EdgeCost(edge);
+            if (next_dist < (*dist)[next_index])
+            {
+                (*dist)[next_index] = static_cast<float>(next_dist);
+                open_queue.emplace(next_dist, next_index);
+            }
+        }
+    }
+}
+
+bool TopoLandmarkIndex::Build(const TopoGraph& graph, int num_landmarks)
+{
+    Clear();
+    const auto& nodes = graph.TopoNodes();
+    if (nodes.empty() || num_landmarks <= 0)
+    {
+        AERROR << "Empty topo graph or invalid landmark number: "
+               << num_landmarks;
+        return false;
+    }
+    for (const auto& node : nodes)
+    {
+        for (const auto* edge : node->OutToAllEdge())
+        {
+            if (EdgeCost(edge) < 0.0)
+            {
+                AWARN << "Negative routing cost on edge "
+                      << edge->FromLaneId() << " -> " << edge->ToLaneId()
+                      << ", the landmark bound would not hold.";
+                return false;
+            }
+        }
+    }
+    map_version_ = graph.MapVersion();
+    lane_ids_.reserve(nodes.size());
+    for (const auto& node : nodes)
+    {
+        lane_ids_.push_back(node->LaneId());
+    }
+    BindNodes(graph);
+
+    const size_t node_num = nodes.size();
+    const size_t landmark_num =
+            std::min(node_num, static_cast<size_t>(num_landmarks));
+
+    // farthest-point sampling: start from the node farthest from the anchor
+    // centroid, then repeatedly take the node with the largest cost to the
+    // landmarks selected so far. Unreachable nodes are preferred so that
+    // every strongly connected region gets covered.
+    double center_x = 0.0;
+    double center_y = 0.0;
+    for (const auto& node : nodes)
+    {
+        center_x += node->AnchorPoint().x();
+        center_y += node->AnchorPoint().y();
+    }
+    center_x /= static_cast<double>(node_num);
+    center_y /= static_cast<double>(node_num);
+    int next_landmark = 0;
+    double max_dist = -1.0;
+    for (size_t i = 0; i < node_num; ++i)
+    {
+        const double dist =
+                std::hypot(nodes[i]->AnchorPoint().x() - center_x,
+                           nodes[i]->AnchorPoint().y() - center_y);
+        if (dist > max_dist)
+        {
+            max_dist = dist;
+            next_landmark = static_cast<int>(i);
+        }
+    }
+
+    std::vector<std::vector<float>> from_dist(landmark_num);
+    std::vector<std::vector<float>> to_dist(landmark_num);
+    std::vector<float> min_dist(node_num, kInfinity);
+    std::vector<bool> is_landmark(node_num, false);
+    for (size_t k = 0; k < landmark_num; ++k)
+    {
+        is_landmark[next_landmark] = true;
+        landmark_lane_ids_.push_back(lane_ids_[next_landmark]);
+        RunDijkstra(graph, next_landmark, true, &from_dist[k]);
+        RunDijkstra(graph, next_landmark, false, &to_dist[k]);
+
+        float best = -1.0f;
+        for (size_t i = 0; i < node_num; ++i)
+        {
+            min_dist[i] = std::min(min_dist[i], from_dist[k][i]);
+            if (!is_landmark[i] && min_dist[i] > best)
+            {
+                best = min_dist[i];
+                next_landmark = static_cast<int>(i);
+            }
+        }
+        if (best < 0.0f)
+        {
+            break;
+        }
+    }
+
+    const size_t stride = landmark_lane_ids_.size();
+    from_landmark_.assign(node_num * stride, kInfinity);
+    to_landmark_.assign(node_num * stride, kInfinity);
+    for (size_t i = 0; i < node_num; ++i)
+    {
+        for (size_t k = 0; k < stride; ++k)
+        {
+            from_landmark_[i * stride + k] = from_dist[k][i];
+            to_landmark_[i * stride + k] = to_dist[k][i];
+        }
+    }
+    AINFO << "Built routing landmark index with " << stride
+          << " landmarks over " << node_num << " nodes.";
+    return true;
+}
+
+bool TopoLandmarkIndex::Save(const std::string& file_path) const
+{
+    if (!IsReady())
+    {
+        AERROR << "Landmark index is empty, nothing to save.";
+        return false;
+    }
+    std::ofstream out(file_path, std::ios::binary);
+    if (!out.is_open())
+    {
+        AERROR << "Failed to open landmark index file: " << file_path;
+        return false;
+    }
+    const uint32_t node_num = static_cast<uint32_t>(lane_ids_.size());
+    const uint32_t landmark_num =
+            static_cast<uint32_t>(landmark_lane_ids_.size());
+    out.write(reinterpret_cast<const char*>(&kIndexMagic),
+              sizeof(kIndexMagic));
+    WriteString(map_version_, &out);
+    out.write(reinterpret_cast<const char*>(&node_num), sizeof(node_num));
+    out.write(reinterpret_cast<const char*>(&landmark_num),
+              sizeof(landmark_num));
+    for (const auto& lane_id : lane_ids_)
+    {
+        WriteString(lane_id, &out);
+    }
+    for (const auto& lane_id : landmark_lane_ids_)
+    {
+        WriteString(lane_id, &out);
+    }
+    out.write(reinterpret_cast<const char*>(from_landmark_.data()),
+              from_landmark_.size() * sizeof(float));
+    out.write(reinterpret_cast<const char*>(to_landmark_.data()),
+              to_landmark_.size() * sizeof(float));
+    return static_cast<bool>(out);
+}
+
+bool TopoLandmarkIndex::Load(const std::string& file_path,
+                             const TopoGraph& graph)
+{
+    Clear();
+    std::ifstream in(file_path, std::ios::binary);
+    if (!in.is_open())
+    {
+        AINFO << "No routing landmark index found at " << file_path;
+        return false;
+    }
+    uint32_t magic = 0;
+    uint32_t node_num = 0;
+    uint32_t landmark_num = 0;
+    if (!in.read(reinterpret_cast<char*>(&magic), sizeof(magic)) ||
+        magic != kIndexMagic || !ReadString(&in, &map_version_) ||
+        !in.read(reinterpret_cast<char*>(&node_num), sizeof(node_num)) ||
+        !in.read(reinterpret_cast<char*>(&landmark_num),
+                 sizeof(landmark_num)))
+    {
+        AERROR << "Invalid landmark index header: " << file_path;
+        Clear();
+        return false;
+    }
+    if (map_version_ != graph.MapVersion() ||
+        node_num != graph.TopoNodes().size() || landmark_num == 0)
+    {
+        AWARN << "Landmark index " << file_path
+              << " does not match the topo graph, ignore it.";
+        Clear();
+        return false;
+    }
+    lane_ids_.resize(node_num);
+    landmark_lane_ids_.resize(landmark_num);
+    for (auto& lane_id : lane_ids_)
+    {
+        if (!ReadString(&in, &lane_id) || graph.GetNode(lane_id) == nullptr)
+        {
+            AWARN << "Landmark index lane " << lane_id
+                  << " is not in the topo graph, ignore the index.";
+            Clear();
+            return false;
+        }
+    }
+    for (auto& lane_id : landmark_lane_ids_)
+    {
+        if (!ReadString(&in, &lane_id))
+        {
+            Clear();
+            return false;
+        }
+    }
+    const size_t size = static_cast<size_t>(node_num) * landmark_num;
+    from_landmark_.resize(size);
+    to_landmark_.resize(size);
+    if (!in.read(reinterpret_cast<char*>(from_landmark_.data()),
+                 size * sizeof(float)) ||
+        !in.read(reinterpret_cast<char*>(to_landmark_.data()),
+                 size * sizeof(float)))
+    {
+        AERROR << "Truncated landmark index file: " << file_path;
+        Clear();
+        return false;
+    }
+    BindNodes(graph);
+    AINFO << "Loaded routing landmark index with " << landmark_num
+          << " landmarks from " << file_path;
+    return true;
+}
+
+double TopoLandmarkIndex::LowerBound(const TopoNode* src_node,
+                                     const TopoNode* dest_node) const
+{
+    const int src = NodeIndex(src_node);
+    const int dest = NodeIndex(dest_node);
+    if (src < 0 || dest < 0)
+    {
+        return -1.0;
+    }
+    const size_t stride = landmark_lane_ids_.size();
+    const float* src_from = &from_landmark_[src * stride];
+    const float* dest_from = &from_landmark_[dest * stride];
+    const float* src_to = &to_landmark_[src * stride];
+    const float* dest_to = &to_landmark_[dest * stride];
+    float bound = 0.0f;
+    for (size_t k = 0; k < stride; ++k)
+    {
+        // inf - inf is nan and inf - x is inf; both mean the landmark can not
+        // bound this pair, only use finite differences
+        const float forward = dest_from[k] - src_from[k];
+        const float backward = src_to[k] - dest_to[k];
+        if (std::isfinite(forward))
+        {
+            bound = std::max(bound, forward);
+        }
+        if (std::isfinite(backward))
+        {
+            bound = std::max(bound, backward);
+        }
+    }
+    return bound;
+}
+
+}  // namespace routing
+}  // namespace apollo
@@ -0,0 +1,110 @@
+/******************************************************************************
+ * Copyright 2023 The Apollo Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *****************************************************************************/
+
+/**
+ * @file
+ * @brief ALT (A*, landmarks, triangle inequality) index over a TopoGraph.
+ **/
+
+#pragma once
+
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "modules/routing/graph/topo_graph.h"
+
+namespace apollo
+{
+namespace routing
+{
+/**
+ * @class TopoLandmarkIndex
+ * @brief Precomputed shortest cost from/to a small set of landmark nodes.
+ *
+ * For any landmark L the triangle inequality gives
+ *   d(v, t) >= d(L, t) - d(L, v)  and  d(v, t) >= d(v, L) - d(t, L),
+ * which is a much tighter lower bound than the anchor point distance. Edge
+ * weights are the costs accumulated by the A* strategy, see EdgeCost(). The
+ * bound needs non-negative weights, so no index is built for a graph with a
+ * negative edge cost.
+ *
+ * Removing nodes or edges (black list ranges, sub graphs) can only increase
+ * the true cost, so the bound stays valid for every SubTopoGraph built on top
+ * of the same TopoGraph. Sub nodes are looked up through their origin node.
+ */
+class TopoLandmarkIndex
+{
+public:
+    TopoLandmarkIndex() = default;
+    ~TopoLandmarkIndex() = default;
+
+    /**
+     * @brief select landmarks by farthest-point sampling and run one forward
+     * and one backward Dijkstra per landmark.
+     */
+    bool Build(const TopoGraph& graph, int num_landmarks);
+
+    /**
+     * @brief load an index created by Save(). The index is rejected if the
+     * map version or the node set does not match the graph.
+     */
+    bool Load(const std::string& file_path, const TopoGraph& graph);
+
+    bool Save(const std::string& file_path) const;
+
+    bool IsReady() const { return !landmark_lane_ids_.empty(); }
+
+    int NumLandmarks() const
+    {
+        return static_cast<int>(landmark_lane_ids_.size());
+    }
+
+    /**
+     * @brief lower bound of the routing cost from src_node to dest_node, both
+     * of them can be sub nodes. Returns a negative value when either node is
+     * unknown to the index, so the caller can fall back to another heuristic.
+     */
+    double LowerBound(const TopoNode* src_node,
+                      const TopoNode* dest_node) const;
+
+    static std::string IndexFilePath(const std::string& topo_file_path);
+
+    /**
+     * @brief routing cost of moving along an edge: edge cost plus cost of the
+     * target node, lane change edges only pay half of both node costs.
+     */
+    static double EdgeCost(const TopoEdge* edge);
+
+private:
+    void Clear();
+    void BindNodes(const TopoGraph& graph);
+    int NodeIndex(const TopoNode* node) const;
+    void RunDijkstra(const TopoGraph& graph, int landmark, bool forward,
+                     std::vector<float>* const dist) const;
+
+private:
+    std::string map_version_;
+    std::vector<std::string> lane_ids_;
+    std::vector<std::string> landmark_lane_ids_;
+    std::unordered_map<const TopoNode*, int> node_index_map_;
+    // row-major [node][landmark], unreachable pairs are stored as +inf
+    std::vector<float> from_landmark_;
+    std::vector<float> to_landmark_;
+};
+
+}  // namespace routing
+}  // namespace apollo
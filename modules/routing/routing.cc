@@ -14,8 +14,13 @@
  * limitations under the License.
  *****************************************************************************/
 
+#include <algorithm>
+#include <atomic>
+#include <chrono>
 #include <limits>
+#include <thread>
 #include <unordered_map>
+#include <utility>
 
 #include "modules/routing/routing.h"
 
@@ -64,7 +69,7 @@ apollo::common::Status Routing::Start()
 }
 
 std::vector<RoutingRequest> Routing::FillLaneInfoIfMissing(
-        const RoutingRequest& routing_request)
+        const RoutingRequest& routing_request) const
 {
     std::vector<RoutingRequest> fixed_requests;
     std::unordered_map<int, std::vector<LaneWaypoint>>
@@ -148,7 +153,7 @@ std::vector<RoutingRequest> Routing::FillLaneInfoIfMissing(
 }
 
 bool Routing::GetParkingID(const PointENU& parking_point,
-                           std::string* parking_space_id)
+                           std::string* parking_space_id) const
 {
     // search current parking space id associated with parking point.
     constexpr double kDistance = 0.01;  // meter
@@ -162,7 +167,7 @@ bool Routing::GetParkingID(const PointENU& parking_point,
     return false;
 }
 
-bool Routing::FillParkingID(RoutingResponse* routing_response)
+bool Routing::FillParkingID(RoutingResponse* routing_response) const
 {
     const auto& routing_request = routing_response->routing_request();
     const bool has_parking_info = routing_request.has_parking_info();
@@ -200,13 +205,38 @@ bool Routing::Process(const std::shared_ptr<RoutingRequest>& routing_request,
     CHECK_NOTNULL(routing_response);
     // AINFO << "Get new routing request:" << routing_request->DebugString();
 
-    const auto& fixed_requests = FillLaneInfoIfMissing(*routing_request);
+    std::vector<NodeWithRange> result_nodes;
+    if (ProcessRequest(*routing_request, routing_response, &result_nodes))
+    {
+        navigator_ptr_->_result_nodes = std::move(result_nodes);
+        monitor_logger_buffer_.INFO("Routing success!");
+        return true;
+    }
+
+    AERROR << "Failed to search route with navigator.";
+    monitor_logger_buffer_.WARN("Routing failed! " +
+                                routing_response->status().msg());
+    return false;
+}
+
+bool Routing::ProcessRequest(
+        const RoutingRequest& routing_request,
+        RoutingResponse* const routing_response,
+        std::vector<NodeWithRange>* const result_nodes) const
+{
+    const auto& fixed_requests = FillLaneInfoIfMissing(routing_request);
     double min_routing_length = std::numeric_limits<double>::max();
     for (const auto& fixed_request : fixed_requests)
     {
         RoutingResponse routing_response_temp;
-        if (navigator_ptr_->SearchRoute(fixed_request, &routing_response_temp))
+        std::vector<NodeWithRange> nodes;
+        if (navigator_ptr_->SearchRoute(fixed_request, &routing_response_temp,
+                                        &nodes))
         {
+            if (result_nodes != nullptr)
+            {
+                *result_nodes = std::move(nodes);
+            }
             const double routing_length =
                     routing_response_temp.measurement().distance();
             if (routing_length < min_routing_length)
@@ -215,18 +245,107 @@ bool Routing::Process(const std::shared_ptr<RoutingRequest>& routing_request,
                 min_routing_length = routing_length;
             }
         }
+        else if (min_routing_length == std::numeric_limits<double>::max())
+        {
+            routing_response->mutable_status()->CopyFrom(
+                    routing_response_temp.status());
+        }
         FillParkingID(routing_response);
     }
-    if (min_routing_length < std::numeric_limits<double>::max())
+    return min_routing_length < std::numeric_limits<double>::max();
+}
+
+bool Routing::ProcessBatch(const RoutingBatchRequest& batch_request,
+                           RoutingBatchResponse* const batch_response) const
+{
+    CHECK_NOTNULL(batch_response);
+    batch_response->Clear();
+
+    const int request_num = batch_request.request_size();
+    int thread_num = batch_request.thread_num() > 0
+                             ? static_cast<int>(batch_request.thread_num())
+                             : FLAGS_routing_batch_thread_num;
+    if (thread_num <= 0)
     {
-        monitor_logger_buffer_.INFO("Routing success!");
-        return true;
+        thread_num = static_cast<int>(std::thread::hardware_concurrency());
     }
+    thread_num = std::max(1, std::min(thread_num, request_num));
 
-    AERROR << "Failed to search route with navigator.";
-    monitor_logger_buffer_.WARN("Routing failed! " +
-                                routing_response->status().msg());
-    return false;
+    std::vector<RoutingResponse> responses(request_num);
+    std::vector<double> latency_ms(request_num, 0.0);
+    std::vector<char> success(request_num, 0);
+
+    const auto batch_start = std::chrono::steady_clock::now();
+    if (navigator_ptr_ == nullptr || !navigator_ptr_->IsReady())
+    {
+        AERROR << "Navigator is not ready!";
+        for (auto& response : responses)
+        {
+            response.mutable_status()->set_error_code(
+                    ErrorCode::ROUTING_ERROR_NOT_READY);
+            response.mutable_status()->set_msg("Navigator is not ready!");
+        }
+    }
+    else
+    {
+        // requests are claimed one by one so that long routes do not stall a
+        // statically assigned chunk, all search state lives on the worker
+        std::atomic<int> next_index(0);
+        auto worker = [&]() {
+            int index = next_index.fetch_add(1);
+            while (index < request_num)
+            {
+                const auto start = std::chrono::steady_clock::now();
+                success[index] = ProcessRequest(batch_request.request(index),
+                                                &responses[index]);
+                const auto end = std::chrono::steady_clock::now();
+                latency_ms[index] =
+                        std::chrono::duration<double, std::milli>(end - start)
+                                .count();
+                index = next_index.fetch_add(1);
+            }
+        };
+        std::vector<std::thread> workers;
+        workers.reserve(thread_num - 1);
+        for (int i = 1; i < thread_num; ++i)
+        {
+            workers.emplace_back(worker);
+        }
+        worker();
+        for (auto& thread : workers)
+        {
+            thread.join();
+        }
+    }
+    const double total_time_ms =
+            std::chrono::duration<double, std::milli>(
+                    std::chrono::steady_clock::now() - batch_start)
+                    .count();
+
+    uint32_t success_num = 0;
+    double max_latency_ms = 0.0;
+    double sum_latency_ms = 0.0;
+    for (int i = 0; i < request_num; ++i)
+    {
+        batch_response->add_response()->Swap(&responses[i]);
+        batch_response->add_latency_ms(latency_ms[i]);
+        success_num += success[i] ? 1 : 0;
+        max_latency_ms = std::max(max_latency_ms, latency_ms[i]);
+        sum_latency_ms += latency_ms[i];
+    }
+    batch_response->set_success_num(success_num);
+    batch_response->set_thread_num(thread_num);
+    batch_response->set_total_time_ms(total_time_ms);
+    batch_response->set_max_latency_ms(max_latency_ms);
+    batch_response->set_mean_latency_ms(
+            request_num > 0 ? sum_latency_ms / request_num : 0.0);
+    batch_response->set_throughput(
+            total_time_ms > 0.0 ? request_num * 1000.0 / total_time_ms : 0.0);
+
+    AINFO << "Batch routing: " << success_num << "/" << request_num
+          << " succeeded with " << thread_num << " threads in "
+          << total_time_ms << " ms, max latency " << max_latency_ms << " ms";
+    return success_num == static_cast<uint32_t>(request_num);
 }
 
 }  // namespace routing
@@ -24,6 +24,7 @@
 #include "modules/common/status/status.h"
 #include "modules/map/hdmap/hdmap_util.h"
 #include "modules/routing/core/navigator.h"
+#include "modules/routing/proto/routing_batch.pb.h"
 #include "modules/routing/proto/routing_config.pb.h"
 
 namespace apollo
@@ -62,6 +63,15 @@ public:
     bool Process(const std::shared_ptr<RoutingRequest> &routing_request,
                  RoutingResponse *const routing_response);
 
+    /**
+     * @brief solve all requests of a batch in parallel against the shared
+     * topo graph. Responses keep the order of the requests, per request
+     * latency and batch throughput are filled into the batch response.
+     * @return true if every request is routed successfully
+     */
+    bool ProcessBatch(const RoutingBatchRequest &batch_request,
+                      RoutingBatchResponse *const batch_response) const;
+
     std::vector<NodeWithRange> get_result_nodes()
     {
         if (navigator_ptr_ != nullptr)
@@ -77,12 +87,23 @@ public:
 
 private:
     std::vector<RoutingRequest> FillLaneInfoIfMissing(
-            const RoutingRequest &routing_request);
+            const RoutingRequest &routing_request) const;
 
     bool GetParkingID(const apollo::common::PointENU &parking_point,
-                      std::string *parking_space_id);
+                      std::string *parking_space_id) const;
 
-    bool FillParkingID(RoutingResponse *routing_response);
+    bool FillParkingID(RoutingResponse *routing_response) const;
+
+    /**
+     * @brief route every lane-filled variant of a request and keep the
+     * shortest route. The status of the first failure is kept if no route
+     * is found.
+     * @param result_nodes nodes of the last route found, optional
+     */
+    bool ProcessRequest(
+            const RoutingRequest &routing_request,
+            RoutingResponse *const routing_response,
+            std::vector<NodeWithRange> *const result_nodes = nullptr) const;
 
 private:
     std::unique_ptr<Navigator> navigator_ptr_;
@@ -54,11 +54,6 @@ struct SearchNode
     }
 };
 
-double GetCostToNeighbor(const TopoEdge* edge)
-{
-    return (edge->Cost() + edge->ToNode()->Cost());
-}
-
 const TopoNode* GetLargestNode(const std::vector<const TopoNode*>& nodes)
 {
     double max_range = 0.0;
@@ -242,8 +237,9 @@ bool Reconstruct(
 
 }  // namespace
 
-AStarStrategy::AStarStrategy(bool enable_change) :
-    change_lane_enabled_(enable_change)
+AStarStrategy::AStarStrategy(bool enable_change,
+                             const TopoLandmarkIndex* landmark_index) :
+    change_lane_enabled_(enable_change), landmark_index_(landmark_index)
 {
 }
 
@@ -259,6 +255,16 @@ void AStarStrategy::Clear()
 double AStarStrategy::HeuristicCost(const TopoNode* src_node,
                                     const TopoNode* dest_node)
 {
+    if (landmark_index_ != nullptr)
+    {
+        const double lower_bound =
+                landmark_index_->LowerBound(src_node, dest_node);
+        if (lower_bound >= 0.0)
+        {
+            return lower_bound;
+        }
+    }
+    // fall back to anchor point distance for nodes unknown to the index
     const auto& src_point = src_node->AnchorPoint();
     const auto& dest_point = dest_node->AnchorPoint();
     double distance = std::fabs(src_point.x() - dest_point.x()) +
@@ -337,15 +343,11 @@ bool AStarStrategy::Search(const TopoGraph* graph,
             {
                 continue;
             }
-            tentative_g_score =
-                    g_score_[current_node.topo_node] + GetCostToNeighbor(edge);
-            if (edge->Type() != TopoEdgeType::TET_FORWARD)
-            {
-                tentative_g_score -=
-                        (edge->FromNode()->Cost() + edge->ToNode()->Cost()) / 2;
-            }
-            double f = tentative_g_score + HeuristicCost(to_node, dest_node);
-            if (open_set_.count(to_node) != 0 && f >= g_score_[to_node])
+            // the landmark index is built on the same edge costs
+            tentative_g_score = g_score_[current_node.topo_node] +
+                                TopoLandmarkIndex::EdgeCost(edge);
+            if (open_set_.count(to_node) != 0 &&
+                tentative_g_score >= g_score_[to_node])
             {
                 continue;
             }
@@ -372,9 +374,11 @@ bool AStarStrategy::Search(const TopoGraph* graph,
                 enter_s_[to_node] = to_node_enter_s;
             }
 
-            g_score_[to_node] = f;
+            // g only holds the path cost, the heuristic only orders the queue
+            g_score_[to_node] = tentative_g_score;
             SearchNode next_node(to_node);
-            next_node.f = f;
+            next_node.f =
+                    tentative_g_score + HeuristicCost(to_node, dest_node);
             open_set_detail.push(next_node);
             came_from_[to_node] = from_node;
             if (open_set_.count(to_node) == 0)
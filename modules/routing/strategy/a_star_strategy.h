@@ -20,6 +20,7 @@
 #include <unordered_set>
 #include <vector>
 
+#include "modules/routing/graph/topo_landmark_index.h"
 #include "modules/routing/strategy/strategy.h"
 
 namespace apollo
@@ -29,7 +30,8 @@ namespace routing
 class AStarStrategy : public Strategy
 {
 public:
-    explicit AStarStrategy(bool enable_change);
+    explicit AStarStrategy(bool enable_change,
+                           const TopoLandmarkIndex* landmark_index = nullptr);
     ~AStarStrategy() = default;
 
     virtual bool Search(const TopoGraph* graph, const SubTopoGraph* sub_graph,
@@ -44,6 +46,7 @@ private:
 
 private:
     bool change_lane_enabled_;
+    const TopoLandmarkIndex* landmark_index_ = nullptr;
     std::unordered_set<const TopoNode*> open_set_;
     std::unordered_set<const TopoNode*> closed_set_;
     std::unordered_map<const TopoNode*, const TopoNode*> came_from_;
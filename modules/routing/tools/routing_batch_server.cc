@@ -0,0 +1,58 @@
+/******************************************************************************
+ * Copyright 2018 The Apollo Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *****************************************************************************/
+
+/**
+ * @file
+ * @brief cyber service solving RoutingBatchRequest in parallel, e.g. for
+ * dispatch and fleet ETA tooling. Usage:
+ *   routing_batch_server --map_dir=... [--routing_batch_thread_num=N]
+ */
+
+#include "cyber/cyber.h"
+#include "modules/common/util/message_util.h"
+#include "modules/routing/common/routing_gflags.h"
+#include "modules/routing/proto/routing_batch.pb.h"
+#include "modules/routing/routing.h"
+
+using apollo::routing::RoutingBatchRequest;
+using apollo::routing::RoutingBatchResponse;
+
+int main(int argc, char *argv[]) {
+  google::ParseCommandLineFlags(&argc, &argv, true);
+  apollo::cyber::Init(argv[0]);
+
+  apollo::routing::Routing routing;
+  if (!routing.Init().ok() || !routing.Start().ok()) {
+    AERROR << "Failed to start routing.";
+    return -1;
+  }
+
+  std::shared_ptr<apollo::cyber::Node> node(
+      apollo::cyber::CreateNode("routing_batch_server"));
+  auto service = node->CreateService<RoutingBatchRequest, RoutingBatchResponse>(
+      FLAGS_routing_batch_service_name,
+      [&routing](const std::shared_ptr<RoutingBatchRequest> &request,
+                 std::shared_ptr<RoutingBatchResponse> &response) {
+        routing.ProcessBatch(*request, response.get());
+        apollo::common::util::FillHeader(FLAGS_routing_node_name,
+                                         response.get());
+      });
+  AINFO << "Batch routing service is ready: "
+        << FLAGS_routing_batch_service_name;
+
+  apollo::cyber::WaitForShutdown();
+  return 0;
+}
@@ -17,6 +17,7 @@
 #include "cyber/common/file.h"
 #include "modules/map/hdmap/hdmap_util.h"
 #include "modules/routing/common/routing_gflags.h"
+#include "modules/routing/graph/topo_landmark_index.h"
 #include "modules/routing/topo_creator/graph_creator.h"
 
 int main(int argc, char **argv) {
@@ -39,5 +40,21 @@ int main(int argc, char **argv) {
 
   AINFO << "Create routing topo successfully from " << base_map << " to "
         << routing_map;
+
+  if (FLAGS_enable_routing_landmark_heuristic) {
+    apollo::routing::Graph graph;
+    apollo::routing::TopoGraph topo_graph;
+    apollo::routing::TopoLandmarkIndex landmark_index;
+    const auto index_file =
+        apollo::routing::TopoLandmarkIndex::IndexFilePath(routing_map);
+    if (apollo::cyber::common::GetProtoFromFile(routing_map, &graph) &&
+        topo_graph.LoadGraph(graph) &&
+        landmark_index.Build(topo_graph, FLAGS_routing_landmark_num) &&
+        landmark_index.Save(index_file)) {
+      AINFO << "Create routing landmark index " << index_file;
+    } else {
+      AWARN << "Failed to create routing landmark index " << index_file;
+    }
+  }
   return 0;
 }
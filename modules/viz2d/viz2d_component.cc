@@ -62,6 +62,14 @@ int viz2d_component::init()
                 control_cmd_.CopyFrom(*cmd);
             });
 
+    control_latency_reader_ = node_->CreateReader<planning::LatencyStats>(
+            FLAGS_control_latency_topic,
+            [this](const std::shared_ptr<planning::LatencyStats>& latency) {
+                ADEBUG << "Received control latency: run callback.";
+                std::lock_guard<std::mutex> lock(mutex_);
+                control_latency_.CopyFrom(*latency);
+            });
+
     localization_reader_ = node_->CreateReader<
             localization::LocalizationEstimate>(
             FLAGS_localization_topic,
@@ -234,6 +242,8 @@ int viz2d_component::data_tanslate(double max_steering_wheel_angle_,
         viz_subscribe_.control.Clear();
         viz_subscribe_.control.CopyFrom(control_cmd_);
 
+        viz_subscribe_.control_latency.CopyFrom(control_latency_);
+
         is_new_route_ = false;
 
         is_new_route_ =
@@ -613,6 +623,8 @@ int viz2d_component::process(double max_steering_wheel_angle_)
 
     viz2d_draw_control_commond_info(main_window_, control_data_.y(), control_data_.x());
 
+    viz2d_draw_control_latency(main_window_, viz_subscribe_.control_latency);
+
     // draw bev rtk status
     viz2d_draw_rtk_state(main_window_, viz_subscribe_.localization_estimate,
                         &veh_global_pose);
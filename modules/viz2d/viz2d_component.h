@@ -58,6 +58,9 @@ private:
     std::shared_ptr<apollo::cyber::Reader<apollo::control::ControlCommand>>
             control_cmd_reader_;
 
+    std::shared_ptr<apollo::cyber::Reader<apollo::planning::LatencyStats>>
+            control_latency_reader_;
+
     std::shared_ptr<cyber::Reader<apollo::planning::ADCTrajectory>>
             trajectory_reader_;
 
@@ -102,6 +105,7 @@ private:
     // external data
     apollo::canbus::Chassis chassis_;
     apollo::control::ControlCommand control_cmd_;
+    apollo::planning::LatencyStats control_latency_;
     apollo::prediction::PredictionObstacles prediction_;
 
     apollo::perception::PerceptionObstacles perception_;
@@ -44,8 +44,9 @@ int generate_obs_by_cv(
         std::shared_ptr<perception::PerceptionObstacles> &obs_list,
         const Pose2D&pose);
 
-int draw_obs_list(std::shared_ptr<perception::PerceptionObstacles> &obs_list,
-                  const Pose2D &base_pose, viz2d_image *window);
+int draw_obs_list(
+        const std::shared_ptr<const perception::PerceptionObstacles> &obs_list,
+        const Pose2D &base_pose, viz2d_image *window);
 
 int draw_obs_list(perception::PerceptionObstacles *obs_list,
                   const Pose2D&base_pose, viz2d_image *window);
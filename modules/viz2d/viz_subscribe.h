@@ -52,6 +52,7 @@ struct viz_subscribe
     // relative_map::MapMsg relative_map;
     // storytelling::Stories stories;
     control::ControlCommand control;
+    planning::LatencyStats control_latency;
 
     // perception publish obs. not hmi generated obs
     perception::PerceptionObstacles perception;
@@ -797,6 +797,69 @@ int viz2d_draw_control_commond_info(viz2d_image *viz2d, double acc,
 
 
 
+int viz2d_draw_control_latency(viz2d_image *viz2d,
+                               const planning::LatencyStats &latency)
+{
+    CvScalar text_color;
+
+    if (viz2d == nullptr)
+    {
+        return -1;
+    }
+
+    viz2d_get_color(&text_color, viz2d_colors_white);
+
+    CvFont windows_font;
+    viz2d_get_cvfont(&windows_font, &(viz2d->font));
+
+    CvPoint text_center;
+    text_center.x = 100;
+    text_center.y = 60;
+
+    char str[128];
+    sprintf(str, "control latency (ms): last cycle %.2f",
+            latency.total_time_ms());
+    cvPutText(viz2d->image, str, text_center, &windows_font, text_color);
+
+    // task stats are named "<item>.<percentile>", one row per item
+    std::string row;
+    std::string row_item;
+    for (int i = 0; i <= latency.task_stats_size(); i++)
+    {
+        std::string item;
+        std::string percentile;
+        if (i < latency.task_stats_size())
+        {
+            const std::string &name = latency.task_stats(i).name();
+            const std::size_t dot = name.rfind('.');
+            item = name.substr(0, dot);
+            percentile = dot == std::string::npos ? "" : name.substr(dot + 1);
+        }
+
+        if (item != row_item || i == latency.task_stats_size())
+        {
+            if (!row.empty())
+            {
+                text_center.y += 20;
+                cvPutText(viz2d->image, row.c_str(), text_center,
+                          &windows_font, text_color);
+            }
+            row = item + ":";
+            row_item = item;
+        }
+
+        if (i < latency.task_stats_size())
+        {
+            sprintf(str, " %s %.2f", percentile.c_str(),
+                    latency.task_stats(i).time_ms());
+            row += str;
+        }
+    }
+
+    return 0;
+}
+
+
 static double calc_turn_radius(double lfr, double steering)
 {
     double rad = steering;
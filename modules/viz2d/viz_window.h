@@ -14,6 +14,7 @@
 
 #include "modules/planning/reference_line/reference_line.h"
 #include "modules/planning/common/reference_line_info.h"
+#include "modules/planning/proto/planning.pb.h"
 
 #include "modules/common/util/debug_mode.h"
 #include "modules/viz2d/display_config.pb.h"
@@ -45,6 +46,10 @@ int viz2d_draw_chassis_feedback(viz2d_image *viz2d, double v, double wheel);
 int viz2d_draw_control_commond_info(viz2d_image *viz2d, double acc,
                                    double wheel);
 
+// summary published by control on FLAGS_control_latency_topic
+int viz2d_draw_control_latency(viz2d_image *viz2d,
+                               const planning::LatencyStats &latency);
+
 // use radian
 int viz2d_draw_front_wheel_state(viz2d_image *viz2d, const Pose2D*veh_pose,
                                 double wheel_base, double steering,